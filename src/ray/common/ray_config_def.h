@@ -40,6 +40,11 @@ RAY_CONFIG(int64_t, raylet_heartbeat_timeout_milliseconds, 100)
 /// like should_global_gc or changed resources, will be included in the heartbeat,
 /// and gcs only broadcast the changed heartbeat.
 RAY_CONFIG(bool, light_heartbeat_enabled, false)
+/// The GCS publishes the resources of the nodes that changed since its previous
+/// publication, and the resources of all nodes once every this many heartbeat periods,
+/// so that raylets that missed a publication catch up. If this is 1, all resources are
+/// published every period.
+RAY_CONFIG(int64_t, resource_view_full_sync_period, 10)
 /// If a component has not sent a heartbeat in the last num_heartbeats_timeout
 /// heartbeat intervals, the raylet monitor process will report
 /// it as dead to the db_client table.
@@ -78,6 +83,13 @@ RAY_CONFIG(bool, object_pinning_enabled, true)
 /// LRU evicted until it is out of scope on the CREATOR of the ObjectID.
 RAY_CONFIG(bool, distributed_ref_counting_enabled, true)
 
+/// The period at which the owner of objects sends the waits for their borrowers to
+/// stop using them, and at which borrowers reply about the objects that they stopped
+/// using. The waits and the replies for the objects of the same owner and borrower
+/// are batched into one RPC per period. If this is 0, then each wait is sent in its
+/// own RPC as soon as the borrower is known.
+RAY_CONFIG(int64_t, ref_removed_batch_period_milliseconds, 10)
+
 /// Whether to record the creation sites of object references. This adds more
 /// information to `ray memstat`, but introduces a little extra overhead when
 /// creating object references.
@@ -114,10 +126,25 @@ RAY_CONFIG(bool, new_scheduler_enabled,
            getenv("RAY_ENABLE_NEW_SCHEDULER") != nullptr &&
                getenv("RAY_ENABLE_NEW_SCHEDULER") == std::string("1"))
 
+/// How the schedulers choose among the nodes that can run a task: "random",
+/// "capacity_weighted", "power_of_two" or "least_loaded" (see PlacementScorer). If
+/// empty, the legacy scheduler picks a node uniformly at random and the new scheduler
+/// picks the first node it finds.
+RAY_CONFIG(std::string, scheduler_placement_strategy, "")
+
+/// Tasks are placed on the nodes that hold the most bytes of their plasma arguments,
+/// if they can run there now and the arguments on these nodes are at least this large.
+RAY_CONFIG(uint64_t, locality_aware_scheduling_min_bytes, 1024 * 1024)
+
 // The max allowed size in bytes of a return object from direct actor calls.
 // Objects larger than this size will be spilled/promoted to plasma.
 RAY_CONFIG(int64_t, max_direct_call_object_size, 100 * 1024)
 
+/// The max bytes of objects that a worker holds in its in-memory store. Past this, the
+/// least recently used objects are spilled to plasma. The budget applies to the whole
+/// store, whichever shards the objects are in. If 0, the in-memory store is unbounded.
+RAY_CONFIG(int64_t, memory_store_max_bytes, 0)
+
 // The max gRPC message size (the gRPC internal default is 4MB). We use a higher
 // limit in Ray to avoid crashing with many small inlined task arguments.
 RAY_CONFIG(int64_t, max_grpc_message_size, 100 * 1024 * 1024)
@@ -144,6 +171,13 @@ RAY_CONFIG(int64_t, object_timeout_milliseconds, 100)
 /// for direct task submission until it must be returned to the raylet.
 RAY_CONFIG(int64_t, worker_lease_timeout_milliseconds, 500)
 
+/// The maximum duration that workers keep a leased worker that has no more tasks
+/// to run, so that it can run the next tasks that need the same resources instead
+/// of requesting a new worker lease. Idle workers are only reused for tasks whose
+/// plasma arguments are mostly on the worker's node. 0 returns idle workers to the
+/// raylet right away.
+RAY_CONFIG(int64_t, worker_lease_idle_reuse_milliseconds, 0)
+
 /// The interval at which the workers will check if their raylet has gone down.
 /// When this happens, they will kill themselves.
 RAY_CONFIG(int64_t, raylet_death_check_interval_milliseconds, 1000)
@@ -195,6 +229,35 @@ RAY_CONFIG(int, object_manager_repeated_push_delay_ms, 60000)
 /// chunks exceeds the number of available sending threads.
 RAY_CONFIG(uint64_t, object_manager_default_chunk_size, 1000000)
 
+/// Whether the object manager pushes object chunks straight from plasma memory, rather
+/// than copying them into protobuf requests. All the nodes of a cluster must support
+/// this when it is enabled. Off by default until it is validated against the gRPC
+/// version that Ray is built with.
+RAY_CONFIG(bool, object_manager_zero_copy_push, false)
+
+/// The maximum number of nodes that the object manager pulls the chunks of an object
+/// from at once. If this is 1, each object is pulled from one node.
+RAY_CONFIG(int, object_manager_max_pull_sources, 8)
+
+/// When an object is pulled from several nodes, the number of chunks that each node is
+/// asked for before it delivers them.
+RAY_CONFIG(int, object_manager_pull_chunks_per_source, 4)
+
+/// Whether the object manager sizes the chunks of each object it sends according to
+/// the size of the object and the rate at which the receiving node received objects
+/// from it. Otherwise, objects are split into chunks of
+/// object_manager_default_chunk_size.
+RAY_CONFIG(bool, object_manager_adaptive_chunk_size, true)
+
+/// The minimum and maximum sizes of the chunks chosen by the adaptive chunk size.
+/// The maximum must stay below the maximum gRPC message size.
+RAY_CONFIG(uint64_t, object_manager_min_chunk_size, 64 * 1024)
+RAY_CONFIG(uint64_t, object_manager_max_chunk_size, 64 * 1024 * 1024)
+
+/// How long sending a chunk to a node should take with the adaptive chunk size, in
+/// milliseconds.
+RAY_CONFIG(int64_t, object_manager_chunk_target_ms, 10)
+
 /// Number of workers per Python worker process
 RAY_CONFIG(int, num_workers_per_process_python, 1)
 
@@ -261,6 +324,43 @@ RAY_CONFIG(int32_t, ping_gcs_rpc_server_max_retries, 1)
 /// Whether start the Plasma Store as a Raylet thread.
 RAY_CONFIG(bool, plasma_store_as_thread, false)
 
+/// Whether the Plasma Store serves small objects from per-size-class slabs
+/// instead of allocating each of them from dlmalloc.
+RAY_CONFIG(bool, plasma_slab_allocator_enabled, false)
+
+/// Objects up to this size (data plus metadata, in bytes) are allocated from
+/// slabs when the slab allocator is enabled.
+RAY_CONFIG(uint64_t, plasma_slab_max_object_size, 1024 * 1024)
+
+/// The minimum number of bytes the slab allocator reserves at once for a size
+/// class. Slabs of the larger size classes hold at least 8 objects.
+RAY_CONFIG(uint64_t, plasma_slab_min_slab_size, 1024 * 1024)
+
+/// The number of entries in the shared-memory ring that each plasma client uses
+/// to release objects without sending a message to the store. 0 disables the
+/// rings, in which case every release is sent over the socket.
+RAY_CONFIG(uint32_t, plasma_release_ring_capacity, 1024)
+
+/// The interval at which the Plasma Store drains the release rings of clients
+/// that are not sending any messages.
+RAY_CONFIG(uint64_t, plasma_release_ring_drain_interval_ms, 10)
+
+/// Whether the Plasma Store should place objects on the NUMA node of the
+/// worker that creates them. This gives each NUMA node its own part of the
+/// object store memory.
+RAY_CONFIG(bool, plasma_numa_arenas_enabled, false)
+
+/// The number of threads the Plasma Store uses to handle client connections.
+/// Clients are spread over the threads, which read requests and write replies
+/// in parallel. 0 handles all clients on the store's main thread.
+RAY_CONFIG(uint32_t, plasma_store_num_threads, 0)
+
+/// The policy the Plasma Store uses to choose which unused objects to evict:
+/// "lru" (least recently used), "2q" (objects used once are evicted before
+/// objects used again) or "gdsf" (GreedyDual-Size-Frequency, large objects
+/// that are rarely used are evicted first).
+RAY_CONFIG(std::string, plasma_eviction_policy, "lru")
+
 /// The interval at which the gcs client will check if the address of gcs service has
 /// changed. When the address changed, we will resubscribe again.
 RAY_CONFIG(int64_t, gcs_service_address_check_interval_milliseconds, 1000)
@@ -1,10 +1,13 @@
 #include "ray/common/task/scheduling_resources.h"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "ray/common/bundle_spec.h"
+#include "ray/common/task/scheduling_ids.h"
 #include "ray/util/logging.h"
 
 namespace ray {
@@ -73,22 +76,72 @@ double FractionalResourceQuantity::ToDouble() const {
   return static_cast<double>(resource_quantity_) / kResourceConversionFactor;
 }
 
+namespace {
+
+/// The resource names that were interned by this process. Names are never removed, so
+/// that the ids in any resource set stay valid.
+struct InternedResourceNames {
+  absl::Mutex mutex;
+  StringIdMap names GUARDED_BY(mutex);
+};
+
+InternedResourceNames &GetInternedResourceNames() {
+  static auto *interned = new InternedResourceNames();
+  return *interned;
+}
+
+/// Return the interned id of a resource name, or -1 if it was not interned. Unlike
+/// ResourceSet::GetResourceId, this does not intern the name, so looking up resources
+/// that no set has does not grow the interned names.
+int64_t FindResourceId(const std::string &resource_name) {
+  auto &interned = GetInternedResourceNames();
+  absl::ReaderMutexLock lock(&interned.mutex);
+  return interned.names.Get(resource_name);
+}
+
+bool CompareResourceIds(const ResourceSet::ResourceAmount &resource, int64_t id) {
+  return resource.first < id;
+}
+
+}  // namespace
+
+int64_t ResourceSet::GetResourceId(const std::string &resource_name) {
+  int64_t resource_id = FindResourceId(resource_name);
+  if (resource_id != -1) {
+    return resource_id;
+  }
+  auto &interned = GetInternedResourceNames();
+  absl::MutexLock lock(&interned.mutex);
+  return interned.names.Insert(resource_name);
+}
+
+std::string ResourceSet::GetResourceName(int64_t resource_id) {
+  auto &interned = GetInternedResourceNames();
+  absl::ReaderMutexLock lock(&interned.mutex);
+  return interned.names.Get(static_cast<uint64_t>(resource_id));
+}
+
 ResourceSet::ResourceSet() {}
 
 ResourceSet::ResourceSet(
-    const std::unordered_map<std::string, FractionalResourceQuantity> &resource_map)
-    : resource_capacity_(resource_map) {
+    const std::unordered_map<std::string, FractionalResourceQuantity> &resource_map) {
+  resource_capacity_.reserve(resource_map.size());
   for (auto const &resource_pair : resource_map) {
     RAY_CHECK(resource_pair.second > 0);
+    resource_capacity_.emplace_back(GetResourceId(resource_pair.first),
+                                    resource_pair.second);
   }
+  std::sort(resource_capacity_.begin(), resource_capacity_.end());
 }
 
 ResourceSet::ResourceSet(const std::unordered_map<std::string, double> &resource_map) {
+  resource_capacity_.reserve(resource_map.size());
   for (auto const &resource_pair : resource_map) {
     RAY_CHECK(resource_pair.second > 0);
-    resource_capacity_[resource_pair.first] =
-        FractionalResourceQuantity(resource_pair.second);
+    resource_capacity_.emplace_back(GetResourceId(resource_pair.first),
+                                    FractionalResourceQuantity(resource_pair.second));
   }
+  std::sort(resource_capacity_.begin(), resource_capacity_.end());
 }
 
 ResourceSet::ResourceSet(const std::vector<std::string> &resource_labels,
@@ -96,15 +149,40 @@ ResourceSet::ResourceSet(const std::vector<std::string> &resource_labels,
   RAY_CHECK(resource_labels.size() == resource_capacity.size());
   for (size_t i = 0; i < resource_labels.size(); i++) {
     RAY_CHECK(resource_capacity[i] > 0);
-    resource_capacity_[resource_labels[i]] =
+    GetOrAddResource(GetResourceId(resource_labels[i])) =
         FractionalResourceQuantity(resource_capacity[i]);
   }
 }
 
 ResourceSet::~ResourceSet() {}
 
+FractionalResourceQuantity *ResourceSet::FindResource(int64_t resource_id) {
+  auto it = std::lower_bound(resource_capacity_.begin(), resource_capacity_.end(),
+                             resource_id, CompareResourceIds);
+  if (it == resource_capacity_.end() || it->first != resource_id) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+FractionalResourceQuantity &ResourceSet::GetOrAddResource(int64_t resource_id) {
+  auto it = std::lower_bound(resource_capacity_.begin(), resource_capacity_.end(),
+                             resource_id, CompareResourceIds);
+  if (it == resource_capacity_.end() || it->first != resource_id) {
+    it = resource_capacity_.emplace(it, resource_id, 0);
+  }
+  return it->second;
+}
+
+void ResourceSet::RemoveEmptyResources() {
+  resource_capacity_.erase(
+      std::remove_if(resource_capacity_.begin(), resource_capacity_.end(),
+                     [](const ResourceAmount &resource) { return resource.second <= 0; }),
+      resource_capacity_.end());
+}
+
 bool ResourceSet::operator==(const ResourceSet &rhs) const {
-  return (this->IsSubset(rhs) && rhs.IsSubset(*this));
+  return resource_capacity_ == rhs.resource_capacity_;
 }
 
 bool ResourceSet::IsEmpty() const {
@@ -113,12 +191,20 @@ bool ResourceSet::IsEmpty() const {
 }
 
 bool ResourceSet::IsSubset(const ResourceSet &other) const {
-  // Check to make sure all keys of this are in other.
+  // Check to make sure all keys of this are in other. Both sets are sorted, so walk
+  // them together.
+  auto other_it = other.resource_capacity_.begin();
   for (const auto &resource_pair : resource_capacity_) {
-    const auto &resource_name = resource_pair.first;
-    const FractionalResourceQuantity &lhs_quantity = resource_pair.second;
-    const FractionalResourceQuantity &rhs_quantity = other.GetResource(resource_name);
-    if (lhs_quantity > rhs_quantity) {
+    while (other_it != other.resource_capacity_.end() &&
+           other_it->first < resource_pair.first) {
+      other_it++;
+    }
+    if (other_it == other.resource_capacity_.end() ||
+        other_it->first != resource_pair.first) {
+      // Resource not found in rhs, so its capacity there is 0.
+      return false;
+    }
+    if (resource_pair.second > other_it->second) {
       // Resource found in rhs, but lhs capacity exceeds rhs capacity.
       return false;
     }
@@ -132,20 +218,21 @@ bool ResourceSet::IsSuperset(const ResourceSet &other) const {
 }
 
 /// Test whether this ResourceSet is precisely equal to the other ResourceSet.
-bool ResourceSet::IsEqual(const ResourceSet &rhs) const {
-  return (this->IsSubset(rhs) && rhs.IsSubset(*this));
-}
+bool ResourceSet::IsEqual(const ResourceSet &rhs) const { return *this == rhs; }
 
 void ResourceSet::AddOrUpdateResource(const std::string &resource_name,
                                       const FractionalResourceQuantity &capacity) {
   if (capacity > 0) {
-    resource_capacity_[resource_name] = capacity;
+    GetOrAddResource(GetResourceId(resource_name)) = capacity;
   }
 }
 
 bool ResourceSet::DeleteResource(const std::string &resource_name) {
-  if (resource_capacity_.count(resource_name) == 1) {
-    resource_capacity_.erase(resource_name);
+  int64_t resource_id = FindResourceId(resource_name);
+  auto it = std::lower_bound(resource_capacity_.begin(), resource_capacity_.end(),
+                             resource_id, CompareResourceIds);
+  if (it != resource_capacity_.end() && it->first == resource_id) {
+    resource_capacity_.erase(it);
     return true;
   } else {
     return false;
@@ -155,64 +242,64 @@ bool ResourceSet::DeleteResource(const std::string &resource_name) {
 void ResourceSet::SubtractResources(const ResourceSet &other) {
   // Subtract the resources, make sure none goes below zero and delete any if new capacity
   // is zero.
-  for (const auto &resource_pair : other.GetResourceAmountMap()) {
-    const std::string &resource_label = resource_pair.first;
-    const FractionalResourceQuantity &resource_capacity = resource_pair.second;
-    if (resource_capacity_.count(resource_label) == 1) {
-      resource_capacity_[resource_label] -= resource_capacity;
+  auto it = resource_capacity_.begin();
+  for (const auto &resource_pair : other.resource_capacity_) {
+    while (it != resource_capacity_.end() && it->first < resource_pair.first) {
+      it++;
     }
-    if (resource_capacity_[resource_label] <= 0) {
-      resource_capacity_.erase(resource_label);
+    if (it != resource_capacity_.end() && it->first == resource_pair.first) {
+      it->second -= resource_pair.second;
     }
   }
+  RemoveEmptyResources();
 }
 
 void ResourceSet::SubtractResourcesStrict(const ResourceSet &other) {
   // Subtract the resources, make sure none goes below zero and delete any if new capacity
   // is zero.
-  for (const auto &resource_pair : other.GetResourceAmountMap()) {
-    const std::string &resource_label = resource_pair.first;
+  auto it = resource_capacity_.begin();
+  for (const auto &resource_pair : other.resource_capacity_) {
     const FractionalResourceQuantity &resource_capacity = resource_pair.second;
-    RAY_CHECK(resource_capacity_.count(resource_label) == 1)
-        << "Attempt to acquire unknown resource: " << resource_label << " capacity "
+    while (it != resource_capacity_.end() && it->first < resource_pair.first) {
+      it++;
+    }
+    RAY_CHECK(it != resource_capacity_.end() && it->first == resource_pair.first)
+        << "Attempt to acquire unknown resource: "
+        << GetResourceName(resource_pair.first) << " capacity "
         << resource_capacity.ToDouble();
-    resource_capacity_[resource_label] -= resource_capacity;
-
-    // Ensure that quantity is positive. Note, we have to have the check before
-    // erasing the object to make sure that it doesn't get added back.
-    RAY_CHECK(resource_capacity_[resource_label] >= 0)
-        << "Capacity of resource after subtraction is negative, "
-        << resource_capacity_[resource_label].ToDouble() << ".";
+    it->second -= resource_capacity;
 
-    if (resource_capacity_[resource_label] == 0) {
-      resource_capacity_.erase(resource_label);
-    }
+    // Ensure that quantity is positive.
+    RAY_CHECK(it->second >= 0) << "Capacity of resource after subtraction is negative, "
+                               << it->second.ToDouble() << ".";
   }
+  RemoveEmptyResources();
 }
 
 // Add a set of resources to the current set of resources subject to upper limits on
 // capacity from the total_resource set
 void ResourceSet::AddResourcesCapacityConstrained(const ResourceSet &other,
                                                   const ResourceSet &total_resources) {
-  const std::unordered_map<std::string, FractionalResourceQuantity> &total_resource_map =
-      total_resources.GetResourceAmountMap();
-  for (const auto &resource_pair : other.GetResourceAmountMap()) {
-    const std::string &to_add_resource_label = resource_pair.first;
+  auto total_it = total_resources.resource_capacity_.begin();
+  for (const auto &resource_pair : other.resource_capacity_) {
     const FractionalResourceQuantity &to_add_resource_capacity = resource_pair.second;
-    if (total_resource_map.count(to_add_resource_label) != 0) {
+    while (total_it != total_resources.resource_capacity_.end() &&
+           total_it->first < resource_pair.first) {
+      total_it++;
+    }
+    if (total_it != total_resources.resource_capacity_.end() &&
+        total_it->first == resource_pair.first) {
       // If resource exists in total map, add to the local capacity map.
       // If the new capacity will be greater the total capacity, set the new capacity to
       // total capacity (capping to the total)
-      const FractionalResourceQuantity &total_capacity =
-          total_resource_map.at(to_add_resource_label);
-      resource_capacity_[to_add_resource_label] =
-          std::min(resource_capacity_[to_add_resource_label] + to_add_resource_capacity,
-                   total_capacity);
+      const FractionalResourceQuantity &total_capacity = total_it->second;
+      auto &capacity = GetOrAddResource(resource_pair.first);
+      capacity = std::min(capacity + to_add_resource_capacity, total_capacity);
     } else {
       // Resource does not exist in the total map, it probably got deleted from the total.
       // Don't panic, do nothing and simply continue.
       RAY_LOG(DEBUG) << "[AddResourcesCapacityConstrained] Resource "
-                     << to_add_resource_label
+                     << GetResourceName(resource_pair.first)
                      << " not found in the total resource map. It probably got deleted, "
                         "not adding back to resource_capacity_.";
     }
@@ -221,27 +308,40 @@ void ResourceSet::AddResourcesCapacityConstrained(const ResourceSet &other,
 
 // Perform an outer join.
 void ResourceSet::AddResources(const ResourceSet &other) {
-  for (const auto &resource_pair : other.GetResourceAmountMap()) {
-    const std::string &resource_label = resource_pair.first;
-    const FractionalResourceQuantity &resource_capacity = resource_pair.second;
-    resource_capacity_[resource_label] += resource_capacity;
+  std::vector<ResourceAmount> result;
+  result.reserve(resource_capacity_.size() + other.resource_capacity_.size());
+  auto it = resource_capacity_.begin();
+  auto other_it = other.resource_capacity_.begin();
+  while (it != resource_capacity_.end() || other_it != other.resource_capacity_.end()) {
+    if (other_it == other.resource_capacity_.end() ||
+        (it != resource_capacity_.end() && it->first < other_it->first)) {
+      result.push_back(*it++);
+    } else if (it == resource_capacity_.end() || other_it->first < it->first) {
+      result.push_back(*other_it++);
+    } else {
+      result.emplace_back(it->first, it->second + other_it->second);
+      it++;
+      other_it++;
+    }
   }
+  resource_capacity_.swap(result);
 }
 
 void ResourceSet::CommitBundleResources(const PlacementGroupID &group_id,
                                         const int bundle_index,
                                         const ResourceSet &other) {
-  for (const auto &resource_pair : other.GetResourceAmountMap()) {
+  for (const auto &resource_pair : other.GetResourceAmounts()) {
+    const std::string resource_name = GetResourceName(resource_pair.first);
     // With bundle index (e.g., CPU_group_i_zzz).
     const std::string &resource_label =
-        FormatPlacementGroupResource(resource_pair.first, group_id, bundle_index);
+        FormatPlacementGroupResource(resource_name, group_id, bundle_index);
     const FractionalResourceQuantity &resource_capacity = resource_pair.second;
-    resource_capacity_[resource_label] += resource_capacity;
+    GetOrAddResource(GetResourceId(resource_label)) += resource_capacity;
 
     // Without bundle index (e.g., CPU_group_zzz).
     const std::string &wildcard_label =
-        FormatPlacementGroupResource(resource_pair.first, group_id, -1);
-    resource_capacity_[wildcard_label] += resource_capacity;
+        FormatPlacementGroupResource(resource_name, group_id, -1);
+    GetOrAddResource(GetResourceId(wildcard_label)) += resource_capacity;
   }
 }
 
@@ -249,7 +349,7 @@ void ResourceSet::ReturnBundleResources(const PlacementGroupID &group_id,
                                         const int bundle_index) {
   absl::flat_hash_map<std::string, FractionalResourceQuantity> to_restore;
   for (auto iter = resource_capacity_.begin(); iter != resource_capacity_.end();) {
-    const std::string &bundle_resource_label = iter->first;
+    const std::string &bundle_resource_label = GetResourceName(iter->first);
     // We only consider the indexed resources, ignoring the wildcard resource.
     // This is because when multiple bundles are created on one node, the quantity
     // of the wildcard resources contains resources from multiple bundles.
@@ -264,29 +364,33 @@ void ResourceSet::ReturnBundleResources(const PlacementGroupID &group_id,
   }
   // For each matching resource to restore (e.g., key like CPU, GPU).
   for (const auto &pair : to_restore) {
-    resource_capacity_[pair.first] += pair.second;
+    GetOrAddResource(GetResourceId(pair.first)) += pair.second;
     auto wildcard_resource = FormatPlacementGroupResource(pair.first, group_id, -1);
-    resource_capacity_[wildcard_resource] -= pair.second;
-    if (resource_capacity_[wildcard_resource] <= 0) {
-      resource_capacity_.erase(wildcard_resource);
-    }
+    GetOrAddResource(GetResourceId(wildcard_resource)) -= pair.second;
   }
+  RemoveEmptyResources();
 }
 
 FractionalResourceQuantity ResourceSet::GetResource(
     const std::string &resource_name) const {
-  if (resource_capacity_.count(resource_name) == 0) {
+  return GetResource(FindResourceId(resource_name));
+}
+
+FractionalResourceQuantity ResourceSet::GetResource(int64_t resource_id) const {
+  auto it = std::lower_bound(resource_capacity_.begin(), resource_capacity_.end(),
+                             resource_id, CompareResourceIds);
+  if (it == resource_capacity_.end() || it->first != resource_id) {
     return 0;
   }
-  const FractionalResourceQuantity &capacity = resource_capacity_.at(resource_name);
-  return capacity;
+  return it->second;
 }
 
 const ResourceSet ResourceSet::GetNumCpus() const {
   ResourceSet cpu_resource_set;
   const FractionalResourceQuantity cpu_quantity = GetResource(kCPU_ResourceLabel);
   if (cpu_quantity > 0) {
-    cpu_resource_set.resource_capacity_[kCPU_ResourceLabel] = cpu_quantity;
+    cpu_resource_set.resource_capacity_.emplace_back(GetResourceId(kCPU_ResourceLabel),
+                                                     cpu_quantity);
   }
   return cpu_resource_set;
 }
@@ -310,16 +414,19 @@ const std::string ResourceSet::ToString() const {
     // Convert the first element to a string.
     if (it != resource_capacity_.end()) {
       double resource_amount = (it->second).ToDouble();
+      const auto resource_name = GetResourceName(it->first);
       return_string +=
-          "{" + it->first + ": " + format_resource(it->first, resource_amount) + "}";
+          "{" + resource_name + ": " + format_resource(resource_name, resource_amount) +
+          "}";
       it++;
     }
 
     // Add the remaining elements to the string (along with a comma).
     for (; it != resource_capacity_.end(); ++it) {
       double resource_amount = (it->second).ToDouble();
-      return_string +=
-          ", {" + it->first + ": " + format_resource(it->first, resource_amount) + "}";
+      const auto resource_name = GetResourceName(it->first);
+      return_string += ", {" + resource_name + ": " +
+                       format_resource(resource_name, resource_amount) + "}";
     }
 
     return return_string;
@@ -329,14 +436,18 @@ const std::string ResourceSet::ToString() const {
 const std::unordered_map<std::string, double> ResourceSet::GetResourceMap() const {
   std::unordered_map<std::string, double> result;
   for (const auto &resource_pair : resource_capacity_) {
-    result[resource_pair.first] = resource_pair.second.ToDouble();
+    result[GetResourceName(resource_pair.first)] = resource_pair.second.ToDouble();
   }
   return result;
 };
 
-const std::unordered_map<std::string, FractionalResourceQuantity>
-    &ResourceSet::GetResourceAmountMap() const {
-  return resource_capacity_;
+std::unordered_map<std::string, FractionalResourceQuantity>
+ResourceSet::GetResourceAmountMap() const {
+  std::unordered_map<std::string, FractionalResourceQuantity> result;
+  for (const auto &resource_pair : resource_capacity_) {
+    result[GetResourceName(resource_pair.first)] = resource_pair.second;
+  }
+  return result;
 };
 
 /// ResourceIds class implementation
@@ -598,8 +709,8 @@ ResourceIdSet::ResourceIdSet(
     : available_resources_(available_resources) {}
 
 bool ResourceIdSet::Contains(const ResourceSet &resource_set) const {
-  for (auto const &resource_pair : resource_set.GetResourceAmountMap()) {
-    auto const &resource_name = resource_pair.first;
+  for (auto const &resource_pair : resource_set.GetResourceAmounts()) {
+    auto const resource_name = ResourceSet::GetResourceName(resource_pair.first);
     const FractionalResourceQuantity &resource_quantity = resource_pair.second;
 
     auto it = available_resources_.find(resource_name);
@@ -617,8 +728,8 @@ bool ResourceIdSet::Contains(const ResourceSet &resource_set) const {
 ResourceIdSet ResourceIdSet::Acquire(const ResourceSet &resource_set) {
   std::unordered_map<std::string, ResourceIds> acquired_resources;
 
-  for (auto const &resource_pair : resource_set.GetResourceAmountMap()) {
-    auto const &resource_name = resource_pair.first;
+  for (auto const &resource_pair : resource_set.GetResourceAmounts()) {
+    auto const resource_name = ResourceSet::GetResourceName(resource_pair.first);
     const FractionalResourceQuantity &resource_quantity = resource_pair.second;
 
     auto it = available_resources_.find(resource_name);
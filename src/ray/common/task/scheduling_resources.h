@@ -3,6 +3,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "ray/common/id.h"
@@ -65,8 +66,15 @@ class FractionalResourceQuantity {
 /// \class ResourceSet
 /// \brief Encapsulates and operates on a set of resources, including CPUs,
 /// GPUs, and custom labels.
+///
+/// Resource names are interned once per process, and the resources of a set are kept
+/// sorted by the ids of their names, so that operations on two sets merge them rather
+/// than hash and compare strings.
 class ResourceSet {
  public:
+  /// The id of an interned resource name, and the capacity of the resource.
+  using ResourceAmount = std::pair<int64_t, FractionalResourceQuantity>;
+
   static std::shared_ptr<ResourceSet> Nil() {
     static auto nil = std::make_shared<ResourceSet>();
     return nil;
@@ -198,6 +206,13 @@ class ResourceSet {
   /// does not exist.
   FractionalResourceQuantity GetResource(const std::string &resource_name) const;
 
+  /// Return the capacity value associated with the specified resource.
+  ///
+  /// \param resource_id: Interned id of the resource name, see GetResourceId.
+  /// \return The capacity value associated with the specified resource, zero if resource
+  /// does not exist.
+  FractionalResourceQuantity GetResource(int64_t resource_id) const;
+
   /// Return the number of CPUs.
   ///
   /// \return Number of CPUs.
@@ -218,17 +233,50 @@ class ResourceSet {
   const std::unordered_map<std::string, double> GetResourceMap() const;
 
   /// \brief Return a map of the resource and size in FractionalResourceQuantity. Note,
-  /// size is in kResourceConversionFactor of a unit.
+  /// size is in kResourceConversionFactor of a unit. The map is built on each call,
+  /// since the set is keyed by interned ids and may be read by many threads at once;
+  /// prefer GetResourceAmounts in hot paths.
   ///
   /// \return map of resource in string to size in FractionalResourceQuantity.
-  const std::unordered_map<std::string, FractionalResourceQuantity>
-      &GetResourceAmountMap() const;
+  std::unordered_map<std::string, FractionalResourceQuantity> GetResourceAmountMap()
+      const;
+
+  /// \brief Return the resources, sorted by the interned ids of their names. Unlike
+  /// the maps above, this neither copies the resources nor looks up their names.
+  ///
+  /// \return vector of resource id and size in FractionalResourceQuantity.
+  const std::vector<ResourceAmount> &GetResourceAmounts() const {
+    return resource_capacity_;
+  }
 
   const std::string ToString() const;
 
+  /// \brief Return the interned id of a resource name, interning the name if needed.
+  /// This is thread safe.
+  ///
+  /// \param resource_name: Name of the resource.
+  /// \return The id of the resource name.
+  static int64_t GetResourceId(const std::string &resource_name);
+
+  /// \brief Return the resource name of an interned id. This is thread safe.
+  ///
+  /// \param resource_id: Id returned by GetResourceId.
+  /// \return The name of the resource.
+  static std::string GetResourceName(int64_t resource_id);
+
  private:
-  /// Resource capacity map.
-  std::unordered_map<std::string, FractionalResourceQuantity> resource_capacity_;
+  /// Return the capacity of a resource, or nullptr if the set does not have it.
+  FractionalResourceQuantity *FindResource(int64_t resource_id);
+
+  /// Return the capacity of a resource, adding it with a capacity of 0 if the set does
+  /// not have it.
+  FractionalResourceQuantity &GetOrAddResource(int64_t resource_id);
+
+  /// Remove the resources whose capacity is not positive.
+  void RemoveEmptyResources();
+
+  /// Resource capacities, sorted by resource id.
+  std::vector<ResourceAmount> resource_capacity_;
 };
 
 /// \class ResourceIds
@@ -634,10 +682,10 @@ namespace std {
 template <>
 struct hash<ray::ResourceSet> {
   size_t operator()(ray::ResourceSet const &k) const {
-    size_t seed = k.GetResourceMap().size();
-    for (auto &elem : k.GetResourceMap()) {
-      seed ^= std::hash<std::string>()(elem.first);
-      seed ^= std::hash<double>()(elem.second);
+    size_t seed = k.GetResourceAmounts().size();
+    for (auto &elem : k.GetResourceAmounts()) {
+      seed ^= std::hash<int64_t>()(elem.first);
+      seed ^= std::hash<double>()(elem.second.ToDouble());
     }
     return seed;
   }
@@ -32,6 +32,37 @@ class SchedulingResourcesTest : public ::testing::Test {
   std::shared_ptr<ResourceIdSet> resource_id_set;
 };
 
+TEST_F(SchedulingResourcesTest, ResourceSetOperations) {
+  ResourceSet node({"CPU", "GPU", "custom"}, {4, 2, 1});
+  ResourceSet task({"CPU", "custom"}, {1, 0.5});
+  ASSERT_TRUE(task.IsSubset(node));
+  ASSERT_FALSE(node.IsSubset(task));
+  ASSERT_FALSE(ResourceSet({"other"}, {1}).IsSubset(node));
+  ASSERT_EQ(node.GetResource(ResourceSet::GetResourceId("GPU")), 2);
+  ASSERT_EQ(node.GetResource("missing"), 0);
+
+  // Resources that are used up are removed.
+  node.SubtractResources(task);
+  node.SubtractResources(task);
+  ASSERT_EQ(node, ResourceSet({"CPU", "GPU"}, {2, 2}));
+  node.SubtractResourcesStrict(ResourceSet({"GPU"}, {2}));
+  ASSERT_EQ(node, ResourceSet({"CPU"}, {2}));
+
+  // Missing resources are added.
+  node.AddResources(ResourceSet({"CPU", "custom", "new"}, {1, 0.5, 3}));
+  ASSERT_EQ(node, ResourceSet({"new", "CPU", "custom"}, {3, 3, 0.5}));
+  ASSERT_EQ(node.GetResourceMap(),
+            (std::unordered_map<std::string, double>{
+                {"CPU", 3}, {"custom", 0.5}, {"new", 3}}));
+  ASSERT_TRUE(node.DeleteResource("new"));
+  ASSERT_FALSE(node.DeleteResource("new"));
+
+  // Resources are added up to their total.
+  node.AddResourcesCapacityConstrained(ResourceSet({"CPU", "GPU", "custom"}, {2, 1, 1}),
+                                       ResourceSet({"CPU", "GPU"}, {4, 2}));
+  ASSERT_EQ(node, ResourceSet({"CPU", "GPU", "custom"}, {4, 1, 0.5}));
+}
+
 TEST_F(SchedulingResourcesTest, CommitBundleResources) {
   PlacementGroupID group_id = PlacementGroupID::FromRandom();
   std::vector<std::string> resource_labels = {"CPU"};
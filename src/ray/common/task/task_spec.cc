@@ -1,45 +1,114 @@
 #include "ray/common/task/task_spec.h"
 
 #include <sstream>
+#include <tuple>
 
+#include "absl/hash/hash.h"
 #include "ray/util/logging.h"
 
 namespace ray {
 
-absl::Mutex TaskSpecification::mutex_;
-std::unordered_map<SchedulingClassDescriptor, SchedulingClass>
-    TaskSpecification::sched_cls_to_id_;
-std::unordered_map<SchedulingClass, SchedulingClassDescriptor>
-    TaskSpecification::sched_id_to_cls_;
-int TaskSpecification::next_sched_id_;
+TaskSpecification::SchedulingClassShard
+    TaskSpecification::sched_cls_shards_[kNumSchedulingClassShards];
+std::atomic<TaskSpecification::SchedulingClassDirectory *>
+    TaskSpecification::sched_id_to_cls_[kNumSchedulingClassDirectories];
+absl::Mutex TaskSpecification::chunks_mutex_;
+std::atomic<int> TaskSpecification::next_sched_id_;
+
+size_t TaskSpecification::HashSchedulingClassDescriptor(
+    const SchedulingClassDescriptor &sched_cls) {
+  const auto &resources = sched_cls.GetResourceAmounts();
+  size_t seed = resources.size();
+  for (const auto &resource : resources) {
+    seed = absl::Hash<std::tuple<size_t, int64_t, double>>()(
+        std::make_tuple(seed, resource.first, resource.second.ToDouble()));
+  }
+  return seed;
+}
+
+std::atomic<SchedulingClassDescriptor *> *TaskSpecification::GetSchedulingClassSlot(
+    SchedulingClass id, bool allocate) {
+  size_t index = static_cast<size_t>(id);
+  auto &directory =
+      sched_id_to_cls_[index / (kSchedulingClassesPerChunk *
+                                kSchedulingClassChunksPerDirectory)];
+  if (directory.load(std::memory_order_acquire) == nullptr) {
+    if (!allocate) {
+      return nullptr;
+    }
+    absl::MutexLock chunks_lock(&chunks_mutex_);
+    if (directory.load(std::memory_order_relaxed) == nullptr) {
+      directory.store(new SchedulingClassDirectory(), std::memory_order_release);
+    }
+  }
+  auto &chunk = directory.load(std::memory_order_acquire)
+                    ->chunks[(index / kSchedulingClassesPerChunk) %
+                             kSchedulingClassChunksPerDirectory];
+  if (chunk.load(std::memory_order_acquire) == nullptr) {
+    if (!allocate) {
+      return nullptr;
+    }
+    absl::MutexLock chunks_lock(&chunks_mutex_);
+    if (chunk.load(std::memory_order_relaxed) == nullptr) {
+      chunk.store(new SchedulingClassChunk(), std::memory_order_release);
+    }
+  }
+  return &chunk.load(std::memory_order_acquire)
+              ->descriptors[index % kSchedulingClassesPerChunk];
+}
 
 SchedulingClassDescriptor &TaskSpecification::GetSchedulingClassDescriptor(
     SchedulingClass id) {
-  absl::MutexLock lock(&mutex_);
-  auto it = sched_id_to_cls_.find(id);
-  RAY_CHECK(it != sched_id_to_cls_.end()) << "invalid id: " << id;
-  return it->second;
+  RAY_CHECK(id > 0) << "invalid id: " << id;
+  auto slot = GetSchedulingClassSlot(id, /*allocate=*/false);
+  RAY_CHECK(slot != nullptr) << "invalid id: " << id;
+  auto descriptor = slot->load(std::memory_order_acquire);
+  RAY_CHECK(descriptor != nullptr) << "invalid id: " << id;
+  return *descriptor;
 }
 
 SchedulingClass TaskSpecification::GetSchedulingClass(const ResourceSet &sched_cls) {
-  SchedulingClass sched_cls_id;
-  absl::MutexLock lock(&mutex_);
-  auto it = sched_cls_to_id_.find(sched_cls);
-  if (it == sched_cls_to_id_.end()) {
-    sched_cls_id = ++next_sched_id_;
-    // TODO(ekl) we might want to try cleaning up task types in these cases
-    if (sched_cls_id > 100) {
-      RAY_LOG(WARNING) << "More than " << sched_cls_id
-                       << " types of tasks seen, this may reduce performance.";
-    } else if (sched_cls_id > 1000) {
-      RAY_LOG(ERROR) << "More than " << sched_cls_id
-                     << " types of tasks seen, this may reduce performance.";
+  size_t hash = HashSchedulingClassDescriptor(sched_cls);
+  auto &shard = sched_cls_shards_[hash % kNumSchedulingClassShards];
+  auto find_class = [&shard, &sched_cls, hash]() {
+    auto it = shard.classes.find(hash);
+    if (it != shard.classes.end()) {
+      for (auto id : it->second) {
+        if (GetSchedulingClassDescriptor(id) == sched_cls) {
+          return id;
+        }
+      }
     }
-    sched_cls_to_id_[sched_cls] = sched_cls_id;
-    sched_id_to_cls_[sched_cls_id] = sched_cls;
-  } else {
-    sched_cls_id = it->second;
+    return 0;
+  };
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto sched_cls_id = find_class();
+    if (sched_cls_id != 0) {
+      return sched_cls_id;
+    }
+  }
+
+  absl::MutexLock lock(&shard.mutex);
+  // Another thread may have added the class since the reader lock was released.
+  SchedulingClass sched_cls_id = find_class();
+  if (sched_cls_id != 0) {
+    return sched_cls_id;
+  }
+  sched_cls_id = ++next_sched_id_;
+  // TODO(ekl) we might want to try cleaning up task types in these cases
+  if (sched_cls_id > 100) {
+    RAY_LOG(WARNING) << "More than " << sched_cls_id
+                     << " types of tasks seen, this may reduce performance.";
+  } else if (sched_cls_id > 1000) {
+    RAY_LOG(ERROR) << "More than " << sched_cls_id
+                   << " types of tasks seen, this may reduce performance.";
   }
+  // The descriptor is published before the class is, so that the descriptor of any
+  // class that a thread has seen can be read without a lock.
+  GetSchedulingClassSlot(sched_cls_id, /*allocate=*/true)
+      ->store(new SchedulingClassDescriptor(sched_cls), std::memory_order_release);
+  shard.classes[hash].push_back(sched_cls_id);
   return sched_cls_id;
 }
 
@@ -77,7 +146,7 @@ void TaskSpecification::ComputeResources() {
     // the actor tasks need not be scheduled.
 
     // Map the scheduling class descriptor to an integer for performance.
-    auto sched_cls = GetRequiredResources();
+    const auto &sched_cls = GetRequiredResources();
     sched_cls_id_ = GetSchedulingClass(sched_cls);
   }
 }
@@ -173,6 +242,21 @@ std::vector<ObjectID> TaskSpecification::GetDependencyIds() const {
   return dependencies;
 }
 
+std::vector<NodeID> TaskSpecification::GetPreferredNodes(uint64_t min_bytes) const {
+  std::vector<NodeID> nodes;
+  uint64_t max_bytes = min_bytes;
+  for (const auto &locality : message_->argument_locality()) {
+    if (locality.argument_bytes() > max_bytes) {
+      nodes.clear();
+      max_bytes = locality.argument_bytes();
+    }
+    if (locality.argument_bytes() == max_bytes) {
+      nodes.push_back(NodeID::FromBinary(locality.node_id()));
+    }
+  }
+  return nodes;
+}
+
 std::vector<rpc::ObjectReference> TaskSpecification::GetDependencies() const {
   std::vector<rpc::ObjectReference> dependencies;
   for (size_t i = 0; i < NumArgs(); ++i) {
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/function_descriptor.h"
 #include "ray/common/grpc_util.h"
@@ -131,6 +135,14 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   /// \return The recomputed dependencies for the task.
   std::vector<rpc::ObjectReference> GetDependencies() const;
 
+  /// Return the nodes that hold the most bytes of the plasma arguments of this task,
+  /// according to the argument locality set by its owner.
+  ///
+  /// \param min_bytes The nodes are only returned if they hold at least this many
+  /// bytes, since smaller arguments are cheap to move.
+  /// \return The nodes, which all hold the same number of bytes.
+  std::vector<NodeID> GetPreferredNodes(uint64_t min_bytes) const;
+
   std::unordered_map<std::string, std::string> OverrideEnvironmentVariables() const;
 
   bool IsDriverTask() const;
@@ -212,15 +224,61 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   /// Cached scheduling class of this task.
   SchedulingClass sched_cls_id_;
 
-  /// Below static fields could be mutated in `ComputeResources` concurrently due to
-  /// multi-threading, we need a mutex to protect it.
-  static absl::Mutex mutex_;
-  /// Keep global static id mappings for SchedulingClass for performance.
-  static std::unordered_map<SchedulingClassDescriptor, SchedulingClass> sched_cls_to_id_
-      GUARDED_BY(mutex_);
-  static std::unordered_map<SchedulingClass, SchedulingClassDescriptor> sched_id_to_cls_
-      GUARDED_BY(mutex_);
-  static int next_sched_id_ GUARDED_BY(mutex_);
+  /// Scheduling classes are looked up for every task spec that is constructed, by
+  /// all the threads that submit tasks, and are almost never added. Descriptors are
+  /// therefore sharded by their hash, each shard with its own reader-writer lock, and
+  /// the descriptors of the classes are read without taking any lock.
+  static const size_t kNumSchedulingClassShards = 16;
+  static const size_t kSchedulingClassesPerChunk = 1024;
+  static const size_t kSchedulingClassChunksPerDirectory = 1024;
+  /// Enough directories for every positive scheduling class.
+  static const size_t kNumSchedulingClassDirectories =
+      static_cast<size_t>(std::numeric_limits<SchedulingClass>::max()) /
+          (kSchedulingClassesPerChunk * kSchedulingClassChunksPerDirectory) +
+      1;
+
+  /// A shard of the mapping from descriptors to scheduling classes. Classes are keyed
+  /// by the hash of their descriptor, so that the descriptor is hashed once per lookup
+  /// and only compared to the descriptors that have the same hash.
+  struct SchedulingClassShard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<size_t, absl::InlinedVector<SchedulingClass, 1>> classes
+        GUARDED_BY(mutex);
+  };
+
+  /// The descriptors of a range of scheduling classes. A descriptor is set before the
+  /// class is returned to anyone, and is never changed afterwards.
+  struct SchedulingClassChunk {
+    std::atomic<SchedulingClassDescriptor *> descriptors[kSchedulingClassesPerChunk];
+  };
+
+  /// The chunks of a range of scheduling classes.
+  struct SchedulingClassDirectory {
+    std::atomic<SchedulingClassChunk *> chunks[kSchedulingClassChunksPerDirectory];
+  };
+
+  /// Return where the descriptor of a scheduling class is stored.
+  ///
+  /// \param id The scheduling class.
+  /// \param allocate Whether to allocate the directory and chunk of the class if they
+  /// do not exist yet.
+  /// \return The descriptor's slot, or nullptr if it does not exist and `allocate` is
+  /// false.
+  static std::atomic<SchedulingClassDescriptor *> *GetSchedulingClassSlot(
+      SchedulingClass id, bool allocate);
+
+  /// Hash a descriptor without copying its resources.
+  static size_t HashSchedulingClassDescriptor(const SchedulingClassDescriptor &sched_cls);
+
+  static SchedulingClassShard sched_cls_shards_[kNumSchedulingClassShards];
+  /// The descriptors of the scheduling classes, indexed by class. Directories and
+  /// chunks are allocated as classes are added and are never freed, so the table grows
+  /// with the number of classes without ever moving a descriptor.
+  static std::atomic<SchedulingClassDirectory *>
+      sched_id_to_cls_[kNumSchedulingClassDirectories];
+  /// Protects the allocation of directories and chunks.
+  static absl::Mutex chunks_mutex_;
+  static std::atomic<int> next_sched_id_;
 };
 
 }  // namespace ray
@@ -0,0 +1,132 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/task/task_spec.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+TEST(TaskSpecTest, TestSchedulingClass) {
+  ResourceSet resources({"CPU", "GPU", "custom_a"}, {1, 2, 0.5});
+  auto sched_cls_id = TaskSpecification::GetSchedulingClass(resources);
+  ASSERT_GT(sched_cls_id, 0);
+  ASSERT_EQ(TaskSpecification::GetSchedulingClassDescriptor(sched_cls_id), resources);
+
+  // The order in which the resources were added does not matter.
+  ResourceSet same_resources({"custom_a", "GPU", "CPU"}, {0.5, 2, 1});
+  ASSERT_EQ(TaskSpecification::GetSchedulingClass(same_resources), sched_cls_id);
+
+  ResourceSet other_resources({"CPU", "GPU", "custom_a"}, {1, 2, 0.25});
+  auto other_sched_cls_id = TaskSpecification::GetSchedulingClass(other_resources);
+  ASSERT_NE(other_sched_cls_id, sched_cls_id);
+  ASSERT_EQ(TaskSpecification::GetSchedulingClassDescriptor(other_sched_cls_id),
+            other_resources);
+
+  // The scheduling class of a task is computed from its required resources.
+  rpc::TaskSpec message;
+  (*message.mutable_required_resources())["CPU"] = 1;
+  (*message.mutable_required_resources())["GPU"] = 2;
+  (*message.mutable_required_resources())["custom_a"] = 0.5;
+  ASSERT_EQ(TaskSpecification(message).GetSchedulingClass(), sched_cls_id);
+}
+
+TEST(TaskSpecTest, TestConcurrentSchedulingClass) {
+  const int num_threads = 8;
+  const int num_classes = 2000;
+  std::vector<std::vector<SchedulingClass>> sched_cls_ids(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([i, &sched_cls_ids]() {
+      // Each thread adds the same classes, in a different order.
+      sched_cls_ids[i].resize(num_classes);
+      for (int j = 0; j < num_classes; j++) {
+        int k = (j + i * num_classes / num_threads) % num_classes;
+        ResourceSet resources({"CPU", "concurrent"}, {1, k + 1.0});
+        sched_cls_ids[i][k] = TaskSpecification::GetSchedulingClass(resources);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 1; i < num_threads; i++) {
+    ASSERT_EQ(sched_cls_ids[i], sched_cls_ids[0]);
+  }
+  std::unordered_set<SchedulingClass> unique_ids(sched_cls_ids[0].begin(),
+                                                 sched_cls_ids[0].end());
+  ASSERT_EQ(unique_ids.size(), num_classes);
+  for (int k = 0; k < num_classes; k++) {
+    ResourceSet resources({"CPU", "concurrent"}, {1, k + 1.0});
+    ASSERT_EQ(TaskSpecification::GetSchedulingClassDescriptor(sched_cls_ids[0][k]),
+              resources);
+  }
+}
+
+// The table of scheduling classes grows past its first directory rather than running
+// out of room.
+TEST(TaskSpecTest, TestManySchedulingClasses) {
+  const int num_classes = 1100 * 1024;
+  SchedulingClass sched_cls_id = 0;
+  for (int k = 0; k < num_classes; k++) {
+    ResourceSet resources({"CPU", "many"}, {1, k + 1.0});
+    sched_cls_id = TaskSpecification::GetSchedulingClass(resources);
+  }
+  ASSERT_GE(sched_cls_id, num_classes);
+  ResourceSet resources({"CPU", "many"}, {1, static_cast<double>(num_classes)});
+  ASSERT_EQ(TaskSpecification::GetSchedulingClassDescriptor(sched_cls_id), resources);
+}
+
+/// Measure the rate at which task specs are constructed as the number of threads that
+/// submit tasks grows. The tasks have a few scheduling classes, as is typical.
+TEST(TaskSpecTest, DISABLED_TestSubmissionPerf) {
+  const int num_tasks_per_thread = 200000;
+  const int num_classes = 4;
+  std::vector<rpc::TaskSpec> messages(num_classes);
+  for (int i = 0; i < num_classes; i++) {
+    (*messages[i].mutable_required_resources())["CPU"] = 1;
+    (*messages[i].mutable_required_resources())["memory"] = 100 * (i + 1);
+    (*messages[i].mutable_required_resources())["custom_resource"] = 0.5;
+  }
+  for (int num_threads : {1, 2, 4, 8, 16}) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_threads; i++) {
+      threads.emplace_back([i, &messages]() {
+        for (int j = 0; j < num_tasks_per_thread; j++) {
+          TaskSpecification task_spec(messages[(i + j) % num_classes]);
+          RAY_CHECK(task_spec.GetSchedulingClass() > 0);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    RAY_LOG(INFO) << num_threads << " threads: "
+                  << num_tasks_per_thread * num_threads * 1.0 / elapsed_us
+                  << " million task specs per second";
+  }
+}
+
+}  // namespace ray
@@ -278,6 +278,7 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       client_call_manager_(new rpc::ClientCallManager(io_service_)),
       death_check_timer_(io_service_),
       internal_timer_(io_service_),
+      spill_service_work_(spill_service_),
       task_queue_length_(0),
       num_executed_tasks_(0),
       task_execution_service_work_(task_execution_service_),
@@ -368,10 +369,12 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
 
   reference_counter_ = std::make_shared<ReferenceCounter>(
       rpc_address_, RayConfig::instance().distributed_ref_counting_enabled(),
-      RayConfig::instance().lineage_pinning_enabled(), [this](const rpc::Address &addr) {
+      RayConfig::instance().lineage_pinning_enabled(),
+      [this](const rpc::Address &addr) {
         return std::shared_ptr<rpc::CoreWorkerClient>(
             new rpc::CoreWorkerClient(addr, *client_call_manager_));
-      });
+      },
+      boost::asio::steady_timer(io_service_));
 
   if (options_.worker_type == ray::WorkerType::WORKER) {
     death_check_timer_.expires_from_now(boost::asio::chrono::milliseconds(
@@ -396,7 +399,19 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
         return Status::OK();
       },
       options_.ref_counting_enabled ? reference_counter_ : nullptr, local_raylet_client_,
-      options_.check_signals));
+      options_.check_signals, RayConfig::instance().memory_store_max_bytes(),
+      [this](const RayObject &object, const ObjectID &object_id) {
+        return StoreObjectInPlasma(object, object_id);
+      },
+      [this](const ObjectID &object_id) {
+        auto status = plasma_store_provider_->Delete({object_id}, /*local_only=*/true,
+                                                     /*delete_creating_tasks=*/false);
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Failed to delete spilled object " << object_id
+                         << " from plasma, might cause a leak in plasma: " << status;
+        }
+      },
+      [this](std::function<void()> spill) { spill_service_.post(spill); }));
 
   auto check_node_alive_fn = [this](const NodeID &node_id) {
     auto node = gcs_client_->Nodes().Get(node_id);
@@ -478,6 +493,7 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
           RayConfig::instance().worker_lease_timeout_milliseconds(),
           std::move(actor_creator),
           RayConfig::instance().max_tasks_in_flight_per_worker(),
+          boost::asio::steady_timer(io_service_), reference_counter_,
           boost::asio::steady_timer(io_service_)));
   future_resolver_.reset(
       new FutureResolver(memory_store_, core_worker_client_pool_, rpc_address_));
@@ -525,7 +541,10 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
 
   // Start the IO thread after all other members have been initialized, in case
   // the thread calls back into any of our members.
-  io_thread_ = std::thread(&CoreWorker::RunIOService, this);
+  io_thread_ = std::thread([this]() { RunIOService(io_service_); });
+  if (RayConfig::instance().memory_store_max_bytes() > 0) {
+    spill_thread_ = std::thread([this]() { RunIOService(spill_service_); });
+  }
   // Tell the raylet the port that we are listening on.
   // NOTE: This also marks the worker as available in Raylet. We do this at the
   // very end in case there is a problem during construction.
@@ -534,6 +553,7 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
 
 void CoreWorker::Shutdown() {
   io_service_.stop();
+  spill_service_.stop();
   if (options_.worker_type == WorkerType::WORKER) {
     task_execution_service_.stop();
   }
@@ -604,7 +624,7 @@ void CoreWorker::Exit(bool intentional) {
   task_manager_->DrainAndShutdown(drain_references_callback);
 }
 
-void CoreWorker::RunIOService() {
+void CoreWorker::RunIOService(boost::asio::io_service &io_service) {
 #ifndef _WIN32
   // Block SIGINT and SIGTERM so they will be handled by the main thread.
   sigset_t mask;
@@ -614,7 +634,7 @@ void CoreWorker::RunIOService() {
   pthread_sigmask(SIG_BLOCK, &mask, NULL);
 #endif
 
-  io_service_.run();
+  io_service.run();
 }
 
 void CoreWorker::OnNodeRemoved(const rpc::GcsNodeInfo &node_info) {
@@ -637,6 +657,9 @@ void CoreWorker::WaitForShutdown() {
   if (io_thread_.joinable()) {
     io_thread_.join();
   }
+  if (spill_thread_.joinable()) {
+    spill_thread_.join();
+  }
   if (gcs_client_) {
     gcs_client_->Disconnect();
   }
@@ -748,10 +771,16 @@ CoreWorker::GetAllReferenceCounts() const {
 }
 
 void CoreWorker::PutObjectIntoPlasma(const RayObject &object, const ObjectID &object_id) {
+  RAY_CHECK_OK(StoreObjectInPlasma(object, object_id));
+  RAY_CHECK(memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+}
+
+Status CoreWorker::StoreObjectInPlasma(const RayObject &object,
+                                       const ObjectID &object_id) {
   bool object_exists;
-  // This call will only be used by PromoteObjectToPlasma, which means that the
-  // object will always owned by us.
-  RAY_CHECK_OK(plasma_store_provider_->Put(
+  // This call will only be used by PromoteObjectToPlasma and by spilling, which means
+  // that the object will always owned by us.
+  RAY_RETURN_NOT_OK(plasma_store_provider_->Put(
       object, object_id, /* owner_address = */ rpc_address_, &object_exists));
   if (!object_exists) {
     // Tell the raylet to pin the object **after** it is created.
@@ -767,7 +796,7 @@ void CoreWorker::PutObjectIntoPlasma(const RayObject &object, const ObjectID &ob
           }
         });
   }
-  RAY_CHECK(memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+  return Status::OK();
 }
 
 void CoreWorker::PromoteObjectToPlasma(const ObjectID &object_id) {
@@ -867,6 +896,67 @@ Status CoreWorker::Put(const RayObject &object,
   return Status::OK();
 }
 
+Status CoreWorker::Put(const std::vector<std::shared_ptr<RayObject>> &objects,
+                       const std::vector<std::vector<ObjectID>> &contained_object_ids,
+                       std::vector<ObjectID> *object_ids) {
+  RAY_CHECK(objects.size() == contained_object_ids.size());
+  object_ids->clear();
+  std::vector<std::shared_ptr<RayObject>> plasma_objects;
+  std::vector<ObjectID> plasma_object_ids;
+  for (size_t i = 0; i < objects.size(); i++) {
+    ObjectID object_id = ObjectID::FromIndex(worker_context_.GetCurrentTaskID(),
+                                             worker_context_.GetNextPutIndex());
+    object_ids->push_back(object_id);
+    reference_counter_->AddOwnedObject(
+        object_id, contained_object_ids[i], rpc_address_, CurrentCallSite(),
+        objects[i]->GetSize(), /*is_reconstructable=*/false,
+        NodeID::FromBinary(rpc_address_.raylet_id()));
+    if (options_.is_local_mode ||
+        (RayConfig::instance().put_small_object_in_memory_store() &&
+         static_cast<int64_t>(objects[i]->GetSize()) <
+             RayConfig::instance().max_direct_call_object_size())) {
+      RAY_LOG(DEBUG) << "Put " << object_id << " in memory store";
+      RAY_CHECK(memory_store_->Put(*objects[i], object_id));
+    } else {
+      plasma_objects.push_back(objects[i]);
+      plasma_object_ids.push_back(object_id);
+    }
+  }
+  if (plasma_objects.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<bool> object_exists;
+  RAY_RETURN_NOT_OK(plasma_store_provider_->Put(plasma_objects, plasma_object_ids,
+                                                /* owner_address = */ rpc_address_,
+                                                &object_exists));
+  std::vector<ObjectID> created_ids;
+  for (size_t i = 0; i < plasma_object_ids.size(); i++) {
+    if (!object_exists[i]) {
+      created_ids.push_back(plasma_object_ids[i]);
+    }
+  }
+  if (!created_ids.empty()) {
+    // Tell the raylet to pin the objects **after** they are created.
+    RAY_LOG(DEBUG) << "Pinning " << created_ids.size() << " put objects";
+    local_raylet_client_->PinObjectIDs(
+        rpc_address_, created_ids,
+        [this, created_ids](const Status &status, const rpc::PinObjectIDsReply &reply) {
+          // Only release the objects once the raylet has responded to avoid the race
+          // condition that the objects could be evicted before the raylet pins them.
+          if (!plasma_store_provider_->Release(created_ids).ok()) {
+            RAY_LOG(ERROR) << "Failed to release " << created_ids.size()
+                           << " ObjectIDs, might cause a leak in plasma.";
+          }
+        });
+  }
+  for (const auto &object_id : plasma_object_ids) {
+    RAY_CHECK(
+        memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+  }
+  return Status::OK();
+}
+
 Status CoreWorker::Create(const std::shared_ptr<Buffer> &metadata, const size_t data_size,
                           const std::vector<ObjectID> &contained_object_ids,
                           ObjectID *object_id, std::shared_ptr<Buffer> *data) {
@@ -927,6 +1017,33 @@ Status CoreWorker::Seal(const ObjectID &object_id, bool pin_object,
   return Status::OK();
 }
 
+Status CoreWorker::Seal(const std::vector<ObjectID> &object_ids, bool pin_object,
+                        const absl::optional<rpc::Address> &owner_address) {
+  RAY_RETURN_NOT_OK(plasma_store_provider_->Seal(object_ids));
+  if (pin_object) {
+    // Tell the raylet to pin the objects **after** they are created.
+    RAY_LOG(DEBUG) << "Pinning " << object_ids.size() << " sealed objects";
+    local_raylet_client_->PinObjectIDs(
+        owner_address.has_value() ? *owner_address : rpc_address_, object_ids,
+        [this, object_ids](const Status &status, const rpc::PinObjectIDsReply &reply) {
+          // Only release the objects once the raylet has responded to avoid the race
+          // condition that the objects could be evicted before the raylet pins them.
+          if (!plasma_store_provider_->Release(object_ids).ok()) {
+            RAY_LOG(ERROR) << "Failed to release " << object_ids.size()
+                           << " ObjectIDs, might cause a leak in plasma.";
+          }
+        });
+  } else {
+    RAY_RETURN_NOT_OK(plasma_store_provider_->Release(object_ids));
+    reference_counter_->FreePlasmaObjects(object_ids);
+  }
+  for (const auto &object_id : object_ids) {
+    RAY_CHECK(
+        memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+  }
+  return Status::OK();
+}
+
 Status CoreWorker::Get(const std::vector<ObjectID> &ids, const int64_t timeout_ms,
                        std::vector<std::shared_ptr<RayObject>> *results,
                        bool plasma_objects_only) {
@@ -1655,9 +1772,11 @@ Status CoreWorker::AllocateReturnObjects(
                                  ? rpc::Address()
                                  : worker_context_.GetCurrentTask()->CallerAddress());
 
+  std::vector<std::shared_ptr<Buffer>> data_buffers(object_ids.size());
+  // The indices of the return objects that are too large for the memory store. These
+  // are created in plasma with a single request.
+  std::vector<size_t> plasma_indices;
   for (size_t i = 0; i < object_ids.size(); i++) {
-    bool object_already_exists = false;
-    std::shared_ptr<Buffer> data_buffer;
     if (data_sizes[i] > 0) {
       RAY_LOG(DEBUG) << "Creating return object " << object_ids[i];
       // Mark this object as containing other object IDs. The ref counter will
@@ -1671,17 +1790,44 @@ Status CoreWorker::AllocateReturnObjects(
       if (options_.is_local_mode ||
           static_cast<int64_t>(data_sizes[i]) <
               RayConfig::instance().max_direct_call_object_size()) {
-        data_buffer = std::make_shared<LocalMemoryBuffer>(data_sizes[i]);
+        data_buffers[i] = std::make_shared<LocalMemoryBuffer>(data_sizes[i]);
       } else {
-        RAY_RETURN_NOT_OK(Create(metadatas[i], data_sizes[i], object_ids[i],
-                                 owner_address, &data_buffer));
-        object_already_exists = !data_buffer;
+        plasma_indices.push_back(i);
       }
     }
+  }
+
+  std::vector<bool> object_already_exists(object_ids.size(), false);
+  if (plasma_indices.size() == 1) {
+    size_t i = plasma_indices.front();
+    RAY_RETURN_NOT_OK(Create(metadatas[i], data_sizes[i], object_ids[i], owner_address,
+                             &data_buffers[i]));
+    object_already_exists[i] = !data_buffers[i];
+  } else if (!plasma_indices.empty()) {
+    std::vector<ObjectID> plasma_object_ids;
+    std::vector<size_t> plasma_data_sizes;
+    std::vector<std::shared_ptr<Buffer>> plasma_metadatas;
+    for (size_t i : plasma_indices) {
+      plasma_object_ids.push_back(object_ids[i]);
+      plasma_data_sizes.push_back(data_sizes[i]);
+      plasma_metadatas.push_back(metadatas[i]);
+    }
+    std::vector<std::shared_ptr<Buffer>> plasma_buffers;
+    RAY_RETURN_NOT_OK(plasma_store_provider_->Create(plasma_metadatas, plasma_data_sizes,
+                                                     plasma_object_ids, owner_address,
+                                                     &plasma_buffers));
+    for (size_t j = 0; j < plasma_indices.size(); j++) {
+      size_t i = plasma_indices[j];
+      data_buffers[i] = plasma_buffers[j];
+      object_already_exists[i] = !data_buffers[i];
+    }
+  }
+
+  for (size_t i = 0; i < object_ids.size(); i++) {
     // Leave the return object as a nullptr if the object already exists.
-    if (!object_already_exists) {
-      return_objects->at(i) =
-          std::make_shared<RayObject>(data_buffer, metadatas[i], contained_object_ids[i]);
+    if (!object_already_exists[i]) {
+      return_objects->at(i) = std::make_shared<RayObject>(data_buffers[i], metadatas[i],
+                                                          contained_object_ids[i]);
     }
   }
 
@@ -1751,6 +1897,7 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
   absl::optional<rpc::Address> caller_address(
       options_.is_local_mode ? absl::optional<rpc::Address>()
                              : worker_context_.GetCurrentTask()->CallerAddress());
+  std::vector<ObjectID> plasma_return_ids;
   for (size_t i = 0; i < return_objects->size(); i++) {
     // The object is nullptr if it already existed in the object store.
     if (!return_objects->at(i)) {
@@ -1758,10 +1905,18 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
     }
     if (return_objects->at(i)->GetData() != nullptr &&
         return_objects->at(i)->GetData()->IsPlasmaBuffer()) {
-      if (!Seal(return_ids[i], /*pin_object=*/true, caller_address).ok()) {
-        RAY_LOG(FATAL) << "Task " << task_spec.TaskId() << " failed to seal object "
-                       << return_ids[i] << " in store: " << status.message();
-      }
+      plasma_return_ids.push_back(return_ids[i]);
+    }
+  }
+  if (!plasma_return_ids.empty()) {
+    Status seal_status =
+        plasma_return_ids.size() == 1
+            ? Seal(plasma_return_ids.front(), /*pin_object=*/true, caller_address)
+            : Seal(plasma_return_ids, /*pin_object=*/true, caller_address);
+    if (!seal_status.ok()) {
+      RAY_LOG(FATAL) << "Task " << task_spec.TaskId() << " failed to seal "
+                     << plasma_return_ids.size()
+                     << " return objects in store: " << seal_status.message();
     }
   }
 
@@ -2111,6 +2266,16 @@ void CoreWorker::HandleWaitForRefRemoved(const rpc::WaitForRefRemovedRequest &re
                                             ref_removed_callback);
 }
 
+void CoreWorker::HandleWaitForRefsRemoved(const rpc::WaitForRefsRemovedRequest &request,
+                                          rpc::WaitForRefsRemovedReply *reply,
+                                          rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+  reference_counter_->HandleWaitForRefsRemoved(request, reply, send_reply_callback);
+}
+
 void CoreWorker::HandleRemoteCancelTask(const rpc::RemoteCancelTaskRequest &request,
                                         rpc::RemoteCancelTaskReply *reply,
                                         rpc::SendReplyCallback send_reply_callback) {
@@ -402,6 +402,14 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// appended to the serialized object ID.
   void PutObjectIntoPlasma(const RayObject &object, const ObjectID &object_id);
 
+  /// Put an object into plasma and pin it, without adding a marker that it is in
+  /// plasma to the memory store. This is used by the memory store to spill objects.
+  ///
+  /// \param[in] The ray object.
+  /// \param[in] object_id The object ID to serialize.
+  /// \return Status, e.g., if the plasma store is full.
+  Status StoreObjectInPlasma(const RayObject &object, const ObjectID &object_id);
+
   /// Promote an object to plasma. If the
   /// object already exists locally, it will be put into the plasma store. If
   /// it doesn't yet exist, it will be spilled to plasma once available.
@@ -487,6 +495,17 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   Status Put(const RayObject &object, const std::vector<ObjectID> &contained_object_ids,
              const ObjectID &object_id, bool pin_object = false);
 
+  /// Put a number of objects into object store. The objects that go to plasma are
+  /// created, sealed and pinned with a single request to the store and raylet each.
+  ///
+  /// \param[in] objects The ray objects.
+  /// \param[in] contained_object_ids The IDs serialized in each object.
+  /// \param[out] object_ids Generated IDs of the objects.
+  /// \return Status.
+  Status Put(const std::vector<std::shared_ptr<RayObject>> &objects,
+             const std::vector<std::vector<ObjectID>> &contained_object_ids,
+             std::vector<ObjectID> *object_ids);
+
   /// Create and return a buffer in the object store that can be directly written
   /// into. After writing to the buffer, the caller must call `Seal()` to finalize
   /// the object. The `Create()` and `Seal()` combination is an alternative interface
@@ -528,6 +547,17 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   Status Seal(const ObjectID &object_id, bool pin_object,
               const absl::optional<rpc::Address> &owner_address = absl::nullopt);
 
+  /// Finalize placing a number of objects into the object store with a single request
+  /// to the store. This is equivalent to calling `Seal()` on each of the objects.
+  ///
+  /// \param[in] object_ids Object IDs corresponding to the objects.
+  /// \param[in] pin_object Whether or not to pin the objects at the local raylet.
+  /// \param[in] owner_address Address of the owner of the objects who will be contacted
+  /// by the raylet if the objects are pinned. If not provided, defaults to this worker.
+  /// \return Status.
+  Status Seal(const std::vector<ObjectID> &object_ids, bool pin_object,
+              const absl::optional<rpc::Address> &owner_address = absl::nullopt);
+
   /// Get a list of objects from the object store. Objects that failed to be retrieved
   /// will be returned as nullptrs.
   ///
@@ -833,6 +863,11 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                                rpc::WaitForRefRemovedReply *reply,
                                rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandleWaitForRefsRemoved(const rpc::WaitForRefsRemovedRequest &request,
+                                rpc::WaitForRefsRemovedReply *reply,
+                                rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleAddObjectLocationOwner(const rpc::AddObjectLocationOwnerRequest &request,
                                     rpc::AddObjectLocationOwnerReply *reply,
@@ -917,8 +952,9 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
 
   void SetActorId(const ActorID &actor_id);
 
-  /// Run the io_service_ event loop. This should be called in a background thread.
-  void RunIOService();
+  /// Run an event loop, e.g., io_service_. This should be called in a background
+  /// thread.
+  void RunIOService(boost::asio::io_service &io_service);
 
   /// (WORKER mode only) Exit the worker. This is the entrypoint used to shutdown a
   /// worker.
@@ -1108,6 +1144,16 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   // Thread that runs a boost::asio service to process IO events.
   std::thread io_thread_;
 
+  /// Event loop where the memory store spills objects to plasma, which may block
+  /// while the plasma store is full. Only run if the memory store is bounded.
+  boost::asio::io_service spill_service_;
+
+  /// Keeps the spill_service_ alive.
+  boost::asio::io_service::work spill_service_work_;
+
+  /// Thread that runs spill_service_.
+  std::thread spill_thread_;
+
   // Keeps track of object ID reference counts.
   std::shared_ptr<ReferenceCounter> reference_counter_;
 
@@ -30,24 +30,73 @@ namespace {}  // namespace
 
 namespace ray {
 
+const std::string ReferenceCounter::kUnknownCallSite = "<unknown>";
+
+const std::string *ReferenceCounter::InternCallSite(Shard *shard,
+                                                    const std::string &call_site) {
+  return &*shard->call_sites.insert(call_site).first;
+}
+
+std::shared_ptr<const rpc::Address> ReferenceCounter::InternOwnerAddress(
+    Shard *shard, const rpc::Address &address) {
+  auto &owner_addresses = shard->owner_addresses;
+  auto it = owner_addresses.find(address.worker_id());
+  if (it != owner_addresses.end()) {
+    const auto &interned = *it->second;
+    if (interned.port() == address.port() &&
+        interned.ip_address() == address.ip_address() &&
+        interned.raylet_id() == address.raylet_id()) {
+      return it->second;
+    }
+    // This is another worker with the same ID, which only happens in tests.
+    return std::make_shared<const rpc::Address>(address);
+  }
+
+  // Remove the addresses of the owners that we stopped referencing once the table
+  // doubled in size, so that it does not grow with the number of workers over time.
+  if (owner_addresses.size() >= 2 * shard->num_owner_addresses_in_use + 16) {
+    for (auto unused = owner_addresses.begin(); unused != owner_addresses.end();) {
+      if (unused->second.use_count() == 1) {
+        owner_addresses.erase(unused++);
+      } else {
+        unused++;
+      }
+    }
+    shard->num_owner_addresses_in_use = owner_addresses.size();
+  }
+  auto interned = std::make_shared<const rpc::Address>(address);
+  owner_addresses.emplace(address.worker_id(), interned);
+  return interned;
+}
+
 void ReferenceCounter::DrainAndShutdown(std::function<void()> shutdown) {
   absl::MutexLock lock(&mutex_);
-  if (object_id_refs_.empty()) {
+  size_t num_objects = 0;
+  for (auto &shard : shards_) {
+    num_objects += Refs(shard).size();
+  }
+  if (num_objects == 0) {
     shutdown();
   } else {
     RAY_LOG(WARNING)
-        << "This worker is still managing " << object_id_refs_.size()
+        << "This worker is still managing " << num_objects
         << " objects, waiting for them to go out of scope before shutting down.";
     shutdown_hook_ = shutdown;
   }
 }
 
 void ReferenceCounter::ShutdownIfNeeded() {
-  if (shutdown_hook_ && object_id_refs_.empty()) {
-    RAY_LOG(WARNING)
-        << "All object references have gone out of scope, shutting down worker.";
-    shutdown_hook_();
+  if (!shutdown_hook_) {
+    return;
+  }
+  for (auto &shard : shards_) {
+    if (!Refs(shard).empty()) {
+      return;
+    }
   }
+  RAY_LOG(WARNING)
+      << "All object references have gone out of scope, shutting down worker.";
+  shutdown_hook_();
 }
 
 ReferenceCounter::ReferenceTable ReferenceCounter::ReferenceTableFromProto(
@@ -79,8 +128,9 @@ bool ReferenceCounter::AddBorrowedObject(const ObjectID &object_id,
 bool ReferenceCounter::AddBorrowedObjectInternal(const ObjectID &object_id,
                                                  const ObjectID &outer_id,
                                                  const rpc::Address &owner_address) {
-  auto it = object_id_refs_.find(object_id);
-  RAY_CHECK(it != object_id_refs_.end());
+  auto &shard = GetShard(object_id);
+  auto it = Refs(shard).find(object_id);
+  RAY_CHECK(it != Refs(shard).end());
 
   RAY_LOG(DEBUG) << "Adding borrowed object " << object_id;
   // Skip adding this object as a borrower if we already have ownership info.
@@ -91,11 +141,17 @@ bool ReferenceCounter::AddBorrowedObjectInternal(const ObjectID &object_id,
     return false;
   }
 
-  it->second.owner_address = owner_address;
+  {
+    // The interned addresses are shared with the holders of the shard's mutex. Taking
+    // it is uncontended while mutex_ is held exclusively.
+    absl::MutexLock shard_lock(&shard.mutex);
+    it->second.owner_address = InternOwnerAddress(&shard, owner_address);
+  }
 
   if (!outer_id.IsNil()) {
-    auto outer_it = object_id_refs_.find(outer_id);
-    if (outer_it != object_id_refs_.end() && !outer_it->second.owned_by_us) {
+    auto &outer_refs = Refs(outer_id);
+    auto outer_it = outer_refs.find(outer_id);
+    if (outer_it != outer_refs.end() && !outer_it->second.owned_by_us) {
       RAY_LOG(DEBUG) << "Setting borrowed inner ID " << object_id
                      << " contained_in_borrowed: " << outer_id;
       RAY_CHECK(!it->second.contained_in_borrowed_id.has_value());
@@ -110,31 +166,33 @@ void ReferenceCounter::AddObjectRefStats(
     const absl::flat_hash_map<ObjectID, std::pair<int64_t, std::string>> pinned_objects,
     rpc::CoreWorkerStats *stats) const {
   absl::MutexLock lock(&mutex_);
-  for (const auto &ref : object_id_refs_) {
-    auto ref_proto = stats->add_object_refs();
-    ref_proto->set_object_id(ref.first.Binary());
-    ref_proto->set_call_site(ref.second.call_site);
-    ref_proto->set_object_size(ref.second.object_size);
-    ref_proto->set_local_ref_count(ref.second.local_ref_count);
-    ref_proto->set_submitted_task_ref_count(ref.second.submitted_task_ref_count);
-    auto it = pinned_objects.find(ref.first);
-    if (it != pinned_objects.end()) {
-      ref_proto->set_pinned_in_memory(true);
-      // If some info isn't available, fallback to getting it from the pinned info.
-      if (ref.second.object_size <= 0) {
-        ref_proto->set_object_size(it->second.first);
+  for (auto &shard : shards_) {
+    for (const auto &ref : Refs(shard)) {
+      auto ref_proto = stats->add_object_refs();
+      ref_proto->set_object_id(ref.first.Binary());
+      ref_proto->set_call_site(*ref.second.call_site);
+      ref_proto->set_object_size(ref.second.object_size);
+      ref_proto->set_local_ref_count(ref.second.local_ref_count);
+      ref_proto->set_submitted_task_ref_count(ref.second.submitted_task_ref_count);
+      auto it = pinned_objects.find(ref.first);
+      if (it != pinned_objects.end()) {
+        ref_proto->set_pinned_in_memory(true);
+        // If some info isn't available, fallback to getting it from the pinned info.
+        if (ref.second.object_size <= 0) {
+          ref_proto->set_object_size(it->second.first);
+        }
+        if (ref.second.call_site->empty()) {
+          ref_proto->set_call_site(it->second.second);
+        }
       }
-      if (ref.second.call_site.empty()) {
-        ref_proto->set_call_site(it->second.second);
+      for (const auto &obj_id : ref.second.contained_in_owned) {
+        ref_proto->add_contained_in_owned(obj_id.Binary());
       }
     }
-    for (const auto &obj_id : ref.second.contained_in_owned) {
-      ref_proto->add_contained_in_owned(obj_id.Binary());
-    }
   }
   // Also include any unreferenced objects that are pinned in memory.
   for (const auto &entry : pinned_objects) {
-    if (object_id_refs_.find(entry.first) == object_id_refs_.end()) {
+    if (Refs(entry.first).count(entry.first) == 0) {
       auto ref_proto = stats->add_object_refs();
       ref_proto->set_object_id(entry.first.Binary());
       ref_proto->set_object_size(entry.second.first);
@@ -151,15 +209,26 @@ void ReferenceCounter::AddOwnedObject(const ObjectID &object_id,
                                       const int64_t object_size, bool is_reconstructable,
                                       const absl::optional<NodeID> &pinned_at_raylet_id) {
   RAY_LOG(DEBUG) << "Adding owned object " << object_id;
-  absl::MutexLock lock(&mutex_);
-  RAY_CHECK(object_id_refs_.count(object_id) == 0)
-      << "Tried to create an owned object that already exists: " << object_id;
-  // If the entry doesn't exist, we initialize the direct reference count to zero
-  // because this corresponds to a submitted task whose return ObjectID will be created
-  // in the frontend language, incrementing the reference count.
-  object_id_refs_.emplace(object_id, Reference(owner_address, call_site, object_size,
-                                               is_reconstructable, pinned_at_raylet_id));
-  if (!inner_ids.empty()) {
+  auto add_reference = [&]() {
+    // The shard is locked even when mutex_ is held exclusively, which is uncontended.
+    auto &shard = GetShard(object_id);
+    absl::MutexLock shard_lock(&shard.mutex);
+    RAY_CHECK(shard.refs.count(object_id) == 0)
+        << "Tried to create an owned object that already exists: " << object_id;
+    // If the entry doesn't exist, we initialize the direct reference count to zero
+    // because this corresponds to a submitted task whose return ObjectID will be
+    // created in the frontend language, incrementing the reference count.
+    shard.refs.emplace(object_id,
+                       Reference(InternOwnerAddress(&shard, owner_address),
+                                 InternCallSite(&shard, call_site), object_size,
+                                 is_reconstructable, pinned_at_raylet_id));
+  };
+  if (inner_ids.empty()) {
+    absl::ReaderMutexLock lock(&mutex_);
+    add_reference();
+  } else {
+    absl::MutexLock lock(&mutex_);
+    add_reference();
     // Mark that this object ID contains other inner IDs. Then, we will not GC
     // the inner objects until the outer object ID goes out of scope.
     AddNestedObjectIdsInternal(object_id, inner_ids, rpc_address_);
@@ -167,20 +236,25 @@ void ReferenceCounter::AddOwnedObject(const ObjectID &object_id,
 }
 
 void ReferenceCounter::UpdateObjectSize(const ObjectID &object_id, int64_t object_size) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it != object_id_refs_.end()) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it != shard.refs.end()) {
     it->second.object_size = object_size;
   }
 }
 
 void ReferenceCounter::AddLocalReference(const ObjectID &object_id,
                                          const std::string &call_site) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it == shard.refs.end()) {
     // NOTE: ownership info for these objects must be added later via AddBorrowedObject.
-    it = object_id_refs_.emplace(object_id, Reference(call_site, -1)).first;
+    it = shard.refs.emplace(object_id, Reference(InternCallSite(&shard, call_site), -1))
+             .first;
   }
   it->second.local_ref_count++;
   RAY_LOG(DEBUG) << "Add local reference " << object_id;
@@ -189,9 +263,25 @@ void ReferenceCounter::AddLocalReference(const ObjectID &object_id,
 
 void ReferenceCounter::RemoveLocalReference(const ObjectID &object_id,
                                             std::vector<ObjectID> *deleted) {
+  auto &shard = GetShard(object_id);
+  {
+    // Most references are still in scope once a local reference is removed, which
+    // only needs the lock of the object's shard.
+    absl::ReaderMutexLock lock(&mutex_);
+    absl::MutexLock shard_lock(&shard.mutex);
+    auto it = shard.refs.find(object_id);
+    if (it != shard.refs.end() && it->second.local_ref_count > 0 &&
+        it->second.RefCount() > 1) {
+      it->second.local_ref_count--;
+      RAY_LOG(DEBUG) << "Remove local reference " << object_id;
+      PRINT_REF_COUNT(it);
+      return;
+    }
+  }
+
   absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
+  auto it = Refs(shard).find(object_id);
+  if (it == Refs(shard).end()) {
     RAY_LOG(WARNING) << "Tried to decrease ref count for nonexistent object ID: "
                      << object_id;
     return;
@@ -213,32 +303,45 @@ void ReferenceCounter::RemoveLocalReference(const ObjectID &object_id,
 void ReferenceCounter::UpdateSubmittedTaskReferences(
     const std::vector<ObjectID> &argument_ids_to_add,
     const std::vector<ObjectID> &argument_ids_to_remove, std::vector<ObjectID> *deleted) {
-  absl::MutexLock lock(&mutex_);
-  for (const ObjectID &argument_id : argument_ids_to_add) {
-    RAY_LOG(DEBUG) << "Increment ref count for submitted task argument " << argument_id;
-    auto it = object_id_refs_.find(argument_id);
-    if (it == object_id_refs_.end()) {
-      // This happens if a large argument is transparently passed by reference
-      // because we don't hold a Python reference to its ObjectID.
-      it = object_id_refs_.emplace(argument_id, Reference()).first;
+  std::vector<ObjectID> remaining_ids_to_remove;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    for (const ObjectID &argument_id : argument_ids_to_add) {
+      RAY_LOG(DEBUG) << "Increment ref count for submitted task argument "
+                     << argument_id;
+      auto &shard = GetShard(argument_id);
+      absl::MutexLock shard_lock(&shard.mutex);
+      auto it = shard.refs.find(argument_id);
+      if (it == shard.refs.end()) {
+        // This happens if a large argument is transparently passed by reference
+        // because we don't hold a Python reference to its ObjectID.
+        it = shard.refs.emplace(argument_id, Reference()).first;
+      }
+      it->second.submitted_task_ref_count++;
+      // The lineage ref will get released once the task finishes and cannot be
+      // retried again.
+      it->second.lineage_ref_count++;
     }
-    it->second.submitted_task_ref_count++;
-    // The lineage ref will get released once the task finishes and cannot be
-    // retried again.
-    it->second.lineage_ref_count++;
+    // Release the submitted task ref and the lineage ref for any argument IDs
+    // whose values were inlined.
+    remaining_ids_to_remove = RemoveSubmittedTaskReferencesShared(
+        argument_ids_to_remove, /*release_lineage=*/true);
+  }
+  if (!remaining_ids_to_remove.empty()) {
+    absl::MutexLock lock(&mutex_);
+    RemoveSubmittedTaskReferences(remaining_ids_to_remove, /*release_lineage=*/true,
+                                  deleted);
   }
-  // Release the submitted task ref and the lineage ref for any argument IDs
-  // whose values were inlined.
-  RemoveSubmittedTaskReferences(argument_ids_to_remove, /*release_lineage=*/true,
-                                deleted);
 }
 
 void ReferenceCounter::UpdateResubmittedTaskReferences(
     const std::vector<ObjectID> &argument_ids) {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   for (const ObjectID &argument_id : argument_ids) {
-    auto it = object_id_refs_.find(argument_id);
-    RAY_CHECK(it != object_id_refs_.end());
+    auto &shard = GetShard(argument_id);
+    absl::MutexLock shard_lock(&shard.mutex);
+    auto it = shard.refs.find(argument_id);
+    RAY_CHECK(it != shard.refs.end());
     it->second.submitted_task_ref_count++;
   }
 }
@@ -247,6 +350,17 @@ void ReferenceCounter::UpdateFinishedTaskReferences(
     const std::vector<ObjectID> &argument_ids, bool release_lineage,
     const rpc::Address &worker_addr, const ReferenceTableProto &borrowed_refs,
     std::vector<ObjectID> *deleted) {
+  std::vector<ObjectID> remaining_ids = argument_ids;
+  if (borrowed_refs.empty()) {
+    // There are no borrowers to merge, so the references that stay in scope can be
+    // removed with the locks of their shards.
+    absl::ReaderMutexLock lock(&mutex_);
+    remaining_ids = RemoveSubmittedTaskReferencesShared(argument_ids, release_lineage);
+    if (remaining_ids.empty()) {
+      return;
+    }
+  }
+
   absl::MutexLock lock(&mutex_);
   // Must merge the borrower refs before decrementing any ref counts. This is
   // to make sure that for serialized IDs, we increment the borrower count for
@@ -256,11 +370,11 @@ void ReferenceCounter::UpdateFinishedTaskReferences(
   if (!refs.empty()) {
     RAY_CHECK(!WorkerID::FromBinary(worker_addr.worker_id()).IsNil());
   }
-  for (const ObjectID &argument_id : argument_ids) {
+  for (const ObjectID &argument_id : remaining_ids) {
     MergeRemoteBorrowers(argument_id, worker_addr, refs);
   }
 
-  RemoveSubmittedTaskReferences(argument_ids, release_lineage, deleted);
+  RemoveSubmittedTaskReferences(remaining_ids, release_lineage, deleted);
 }
 
 void ReferenceCounter::ReleaseLineageReferences(
@@ -272,8 +386,9 @@ void ReferenceCounter::ReleaseLineageReferences(
 void ReferenceCounter::ReleaseLineageReferencesInternal(
     const std::vector<ObjectID> &argument_ids) {
   for (const ObjectID &argument_id : argument_ids) {
-    auto it = object_id_refs_.find(argument_id);
-    if (it == object_id_refs_.end()) {
+    auto &refs = Refs(argument_id);
+    auto it = refs.find(argument_id);
+    if (it == refs.end()) {
       // References can get evicted early when lineage pinning is disabled.
       RAY_CHECK(!lineage_pinning_enabled_);
       continue;
@@ -296,13 +411,40 @@ void ReferenceCounter::ReleaseLineageReferencesInternal(
   }
 }
 
+std::vector<ObjectID> ReferenceCounter::RemoveSubmittedTaskReferencesShared(
+    const std::vector<ObjectID> &argument_ids, bool release_lineage) {
+  std::vector<ObjectID> remaining_ids;
+  for (const ObjectID &argument_id : argument_ids) {
+    auto &shard = GetShard(argument_id);
+    absl::MutexLock shard_lock(&shard.mutex);
+    auto it = shard.refs.find(argument_id);
+    if (it == shard.refs.end() || it->second.RefCount() <= 1) {
+      remaining_ids.push_back(argument_id);
+      continue;
+    }
+    RAY_LOG(DEBUG) << "Releasing ref for submitted task argument " << argument_id;
+    RAY_CHECK(it->second.submitted_task_ref_count > 0);
+    it->second.submitted_task_ref_count--;
+    if (release_lineage) {
+      if (it->second.lineage_ref_count > 0) {
+        it->second.lineage_ref_count--;
+      } else {
+        // References can get evicted early when lineage pinning is disabled.
+        RAY_CHECK(!lineage_pinning_enabled_);
+      }
+    }
+  }
+  return remaining_ids;
+}
+
 void ReferenceCounter::RemoveSubmittedTaskReferences(
     const std::vector<ObjectID> &argument_ids, bool release_lineage,
     std::vector<ObjectID> *deleted) {
   for (const ObjectID &argument_id : argument_ids) {
     RAY_LOG(DEBUG) << "Releasing ref for submitted task argument " << argument_id;
-    auto it = object_id_refs_.find(argument_id);
-    if (it == object_id_refs_.end()) {
+    auto &refs = Refs(argument_id);
+    auto it = refs.find(argument_id);
+    if (it == refs.end()) {
       RAY_LOG(WARNING) << "Tried to decrease ref count for nonexistent object ID: "
                        << argument_id;
       return;
@@ -325,14 +467,16 @@ void ReferenceCounter::RemoveSubmittedTaskReferences(
 
 bool ReferenceCounter::GetOwner(const ObjectID &object_id,
                                 rpc::Address *owner_address) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   return GetOwnerInternal(object_id, owner_address);
 }
 
 bool ReferenceCounter::GetOwnerInternal(const ObjectID &object_id,
                                         rpc::Address *owner_address) const {
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it == shard.refs.end()) {
     return false;
   }
 
@@ -346,7 +490,7 @@ bool ReferenceCounter::GetOwnerInternal(const ObjectID &object_id,
 
 std::vector<rpc::Address> ReferenceCounter::GetOwnerAddresses(
     const std::vector<ObjectID> object_ids) const {
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   std::vector<rpc::Address> owner_addresses;
   for (const auto &object_id : object_ids) {
     rpc::Address owner_addr;
@@ -370,22 +514,25 @@ std::vector<rpc::Address> ReferenceCounter::GetOwnerAddresses(
 }
 
 bool ReferenceCounter::IsPlasmaObjectFreed(const ObjectID &object_id) const {
-  absl::MutexLock lock(&mutex_);
-  return freed_objects_.find(object_id) != freed_objects_.end();
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  return shard.freed_objects.find(object_id) != shard.freed_objects.end();
 }
 
 void ReferenceCounter::FreePlasmaObjects(const std::vector<ObjectID> &object_ids) {
   absl::MutexLock lock(&mutex_);
   for (const ObjectID &object_id : object_ids) {
-    auto it = object_id_refs_.find(object_id);
-    if (it == object_id_refs_.end()) {
+    auto &refs = Refs(object_id);
+    auto it = refs.find(object_id);
+    if (it == refs.end()) {
       RAY_LOG(WARNING) << "Tried to free an object " << object_id
                        << " that is already out of scope";
       continue;
     }
     // The object is still in scope. It will be removed from this set
     // once its Reference has been deleted.
-    freed_objects_.insert(object_id);
+    FreedObjects(object_id).insert(object_id);
     if (!it->second.owned_by_us) {
       RAY_LOG(WARNING)
           << "Tried to free an object " << object_id
@@ -425,8 +572,9 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
     // ref count across all processes is 0.
     should_delete_value = true;
     for (const auto &inner_id : it->second.contains) {
-      auto inner_it = object_id_refs_.find(inner_id);
-      if (inner_it != object_id_refs_.end()) {
+      auto &inner_refs = Refs(inner_id);
+      auto inner_it = inner_refs.find(inner_id);
+      if (inner_it != inner_refs.end()) {
         RAY_LOG(DEBUG) << "Try to delete inner object " << inner_id;
         if (it->second.owned_by_us) {
           // If this object ID was nested in an owned object, make sure that
@@ -462,8 +610,8 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
       ReleaseLineageReferencesInternal(ids_to_release);
     }
 
-    freed_objects_.erase(id);
-    object_id_refs_.erase(it);
+    FreedObjects(id).erase(id);
+    Refs(id).erase(it);
     ShutdownIfNeeded();
   }
 }
@@ -479,16 +627,18 @@ void ReferenceCounter::ReleasePlasmaObject(ReferenceTable::iterator it) {
 
 bool ReferenceCounter::SetDeleteCallback(
     const ObjectID &object_id, const std::function<void(const ObjectID &)> callback) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it == shard.refs.end()) {
     return false;
   } else if (it->second.OutOfScope(lineage_pinning_enabled_) &&
              !it->second.ShouldDelete(lineage_pinning_enabled_)) {
     // The object has already gone out of scope but cannot be deleted yet. Do
     // not set the deletion callback because it may never get called.
     return false;
-  } else if (freed_objects_.count(object_id) > 0) {
+  } else if (shard.freed_objects.count(object_id) > 0) {
     // The object has been freed by the language frontend, so it
     // should be deleted immediately.
     return false;
@@ -511,11 +661,14 @@ std::vector<ObjectID> ReferenceCounter::ResetObjectsOnRemovedNode(
     const NodeID &raylet_id) {
   absl::MutexLock lock(&mutex_);
   std::vector<ObjectID> lost_objects;
-  for (auto it = object_id_refs_.begin(); it != object_id_refs_.end(); it++) {
-    const auto &object_id = it->first;
-    if (it->second.pinned_at_raylet_id.value_or(NodeID::Nil()) == raylet_id) {
-      lost_objects.push_back(object_id);
-      ReleasePlasmaObject(it);
+  for (auto &shard : shards_) {
+    auto &refs = Refs(shard);
+    for (auto it = refs.begin(); it != refs.end(); it++) {
+      const auto &object_id = it->first;
+      if (it->second.pinned_at_raylet_id.value_or(NodeID::Nil()) == raylet_id) {
+        lost_objects.push_back(object_id);
+        ReleasePlasmaObject(it);
+      }
     }
   }
   return lost_objects;
@@ -523,10 +676,12 @@ std::vector<ObjectID> ReferenceCounter::ResetObjectsOnRemovedNode(
 
 void ReferenceCounter::UpdateObjectPinnedAtRaylet(const ObjectID &object_id,
                                                   const NodeID &raylet_id) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it != object_id_refs_.end()) {
-    if (freed_objects_.count(object_id) > 0) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it != shard.refs.end()) {
+    if (shard.freed_objects.count(object_id) > 0) {
       // The object has been freed by the language frontend.
       return;
     }
@@ -545,9 +700,11 @@ void ReferenceCounter::UpdateObjectPinnedAtRaylet(const ObjectID &object_id,
 bool ReferenceCounter::IsPlasmaObjectPinnedOrSpilled(const ObjectID &object_id,
                                                      NodeID *pinned_at,
                                                      bool *spilled) const {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it != object_id_refs_.end()) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it != shard.refs.end()) {
     if (it->second.owned_by_us) {
       *spilled = it->second.spilled;
       *pinned_at = it->second.pinned_at_raylet_id.value_or(NodeID::Nil());
@@ -558,21 +715,28 @@ bool ReferenceCounter::IsPlasmaObjectPinnedOrSpilled(const ObjectID &object_id,
 }
 
 bool ReferenceCounter::HasReference(const ObjectID &object_id) const {
-  absl::MutexLock lock(&mutex_);
-  return object_id_refs_.find(object_id) != object_id_refs_.end();
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  return shard.refs.find(object_id) != shard.refs.end();
 }
 
 size_t ReferenceCounter::NumObjectIDsInScope() const {
   absl::MutexLock lock(&mutex_);
-  return object_id_refs_.size();
+  size_t num_objects = 0;
+  for (auto &shard : shards_) {
+    num_objects += Refs(shard).size();
+  }
+  return num_objects;
 }
 
 std::unordered_set<ObjectID> ReferenceCounter::GetAllInScopeObjectIDs() const {
   absl::MutexLock lock(&mutex_);
   std::unordered_set<ObjectID> in_scope_object_ids;
-  in_scope_object_ids.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
-    in_scope_object_ids.insert(it.first);
+  for (auto &shard : shards_) {
+    for (const auto &it : Refs(shard)) {
+      in_scope_object_ids.insert(it.first);
+    }
   }
   return in_scope_object_ids;
 }
@@ -581,11 +745,12 @@ std::unordered_map<ObjectID, std::pair<size_t, size_t>>
 ReferenceCounter::GetAllReferenceCounts() const {
   absl::MutexLock lock(&mutex_);
   std::unordered_map<ObjectID, std::pair<size_t, size_t>> all_ref_counts;
-  all_ref_counts.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
-    all_ref_counts.emplace(it.first,
-                           std::pair<size_t, size_t>(it.second.local_ref_count,
-                                                     it.second.submitted_task_ref_count));
+  for (auto &shard : shards_) {
+    for (const auto &it : Refs(shard)) {
+      all_ref_counts.emplace(
+          it.first, std::pair<size_t, size_t>(it.second.local_ref_count,
+                                              it.second.submitted_task_ref_count));
+    }
   }
   return all_ref_counts;
 }
@@ -613,8 +778,9 @@ void ReferenceCounter::GetAndClearLocalBorrowers(
 bool ReferenceCounter::GetAndClearLocalBorrowersInternal(const ObjectID &object_id,
                                                          ReferenceTable *borrowed_refs) {
   RAY_LOG(DEBUG) << "Pop " << object_id;
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
+  if (it == refs.end()) {
     return false;
   }
 
@@ -668,9 +834,10 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
                  << " submitted: " << borrower_ref.submitted_task_ref_count
                  << " contained_in_owned " << borrower_ref.contained_in_owned.size();
 
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
-    it = object_id_refs_.emplace(object_id, Reference()).first;
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
+  if (it == refs.end()) {
+    it = refs.emplace(object_id, Reference()).first;
   }
   if (!it->second.owner_address && borrower_ref.contained_in_borrowed_id.has_value()) {
     // We don't have owner information about this object ID yet and the worker
@@ -738,6 +905,15 @@ void ReferenceCounter::WaitForRefRemoved(const ReferenceTable::iterator &ref_it,
   request.set_contained_in_id(contained_in_id.Binary());
   request.set_intended_worker_id(addr.worker_id.Binary());
 
+  if (ref_removed_batch_timer_ && ref_removed_batch_period_ms_ > 0) {
+    // Send the waits for the same borrower in one RPC at the end of the period.
+    request.clear_intended_worker_id();
+    ref_removed_waits_[addr].objects.insert(object_id);
+    pending_ref_removed_waits_[addr].push_back(std::move(request));
+    ArmRefRemovedBatchTimer();
+    return;
+  }
+
   auto conn = borrower_pool_.GetOrConnect(addr.ToProto());
 
   RAY_LOG(DEBUG) << "Sending WaitForRefRemoved to borrower " << addr.ip_address << ":"
@@ -750,20 +926,95 @@ void ReferenceCounter::WaitForRefRemoved(const ReferenceTable::iterator &ref_it,
         RAY_LOG(DEBUG) << "Received reply from borrower " << addr.ip_address << ":"
                        << addr.port << " of object " << object_id;
         absl::MutexLock lock(&mutex_);
+        HandleBorrowerRefRemoved(object_id, addr, reply);
+      });
+}
 
-        // Merge in any new borrowers that the previous borrower learned of.
-        const ReferenceTable new_borrower_refs =
-            ReferenceTableFromProto(reply.borrowed_refs());
-        MergeRemoteBorrowers(object_id, addr, new_borrower_refs);
+void ReferenceCounter::HandleBorrowerRefRemoved(
+    const ObjectID &object_id, const rpc::WorkerAddress &addr,
+    const rpc::WaitForRefRemovedReply &reply) {
+  // Merge in any new borrowers that the previous borrower learned of.
+  const ReferenceTable new_borrower_refs = ReferenceTableFromProto(reply.borrowed_refs());
+  MergeRemoteBorrowers(object_id, addr, new_borrower_refs);
+
+  // Erase the previous borrower.
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
+  RAY_CHECK(it != refs.end());
+  RAY_CHECK(it->second.borrowers.erase(addr));
+  DeleteReferenceInternal(it, nullptr);
+}
+
+void ReferenceCounter::SendWaitForRefsRemoved(
+    const rpc::WorkerAddress &addr, std::vector<rpc::WaitForRefRemovedRequest> requests) {
+  rpc::WaitForRefsRemovedRequest request;
+  request.set_intended_worker_id(addr.worker_id.Binary());
+  request.set_owner_worker_id(rpc_address_.worker_id.Binary());
+  for (auto &wait : requests) {
+    request.add_requests()->Swap(&wait);
+  }
+  ref_removed_waits_[addr].num_requests_in_flight++;
+  auto conn = borrower_pool_.GetOrConnect(addr.ToProto());
 
-        // Erase the previous borrower.
-        auto it = object_id_refs_.find(object_id);
-        RAY_CHECK(it != object_id_refs_.end());
-        RAY_CHECK(it->second.borrowers.erase(addr));
-        DeleteReferenceInternal(it, nullptr);
+  RAY_LOG(DEBUG) << "Sending WaitForRefsRemoved to borrower " << addr.ip_address << ":"
+                 << addr.port << " for " << request.requests_size() << " new objects";
+  conn->WaitForRefsRemoved(
+      request, [this, addr](const Status &status,
+                            const rpc::WaitForRefsRemovedReply &reply) {
+        RAY_LOG(DEBUG) << "Received reply from borrower " << addr.ip_address << ":"
+                       << addr.port << " for " << reply.removed_object_ids_size()
+                       << " objects";
+        absl::MutexLock lock(&mutex_);
+        HandleBorrowerRefsRemoved(addr, status, reply);
       });
 }
 
+void ReferenceCounter::HandleBorrowerRefsRemoved(
+    const rpc::WorkerAddress &addr, const Status &status,
+    const rpc::WaitForRefsRemovedReply &reply) {
+  auto it = ref_removed_waits_.find(addr);
+  if (it == ref_removed_waits_.end()) {
+    // We already stopped waiting for the borrower, because it failed.
+    return;
+  }
+  it->second.num_requests_in_flight--;
+  if (!status.ok()) {
+    // The borrower failed, so it no longer uses any of the objects.
+    const auto objects = std::move(it->second.objects);
+    ref_removed_waits_.erase(it);
+    pending_ref_removed_waits_.erase(addr);
+    for (const auto &object_id : objects) {
+      HandleBorrowerRefRemoved(object_id, addr, rpc::WaitForRefRemovedReply());
+    }
+    return;
+  }
+
+  RAY_CHECK(reply.removed_object_ids_size() == reply.replies_size());
+  for (int i = 0; i < reply.removed_object_ids_size(); i++) {
+    const auto object_id = ObjectID::FromBinary(reply.removed_object_ids(i));
+    // Handling a removed object may wait for new borrowers, so look the borrower up
+    // again each time.
+    it = ref_removed_waits_.find(addr);
+    if (it != ref_removed_waits_.end() && it->second.objects.erase(object_id) > 0) {
+      HandleBorrowerRefRemoved(object_id, addr, reply.replies(i));
+    }
+  }
+
+  it = ref_removed_waits_.find(addr);
+  if (it == ref_removed_waits_.end() || it->second.num_requests_in_flight > 0 ||
+      pending_ref_removed_waits_.contains(addr)) {
+    // The borrower replies about the remaining objects to the other requests.
+    return;
+  }
+  if (it->second.objects.empty()) {
+    ref_removed_waits_.erase(it);
+  } else {
+    // Wait for the borrower to reply about the remaining objects, which it already
+    // knows about.
+    SendWaitForRefsRemoved(addr, {});
+  }
+}
+
 void ReferenceCounter::AddNestedObjectIds(const ObjectID &object_id,
                                           const std::vector<ObjectID> &inner_ids,
                                           const rpc::WorkerAddress &owner_address) {
@@ -775,19 +1026,21 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
     const ObjectID &object_id, const std::vector<ObjectID> &inner_ids,
     const rpc::WorkerAddress &owner_address) {
   RAY_CHECK(!owner_address.worker_id.IsNil());
-  auto it = object_id_refs_.find(object_id);
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
   if (owner_address.worker_id == rpc_address_.worker_id) {
     // We own object_id. This is a `ray.put()` case OR returning an object ID
     // from a task and the task's caller executed in the same process as us.
-    if (it != object_id_refs_.end()) {
+    if (it != refs.end()) {
       RAY_CHECK(it->second.owned_by_us);
       // The outer object is still in scope. Mark the inner ones as being
       // contained in the outer object ID so we do not GC the inner objects
       // until the outer object goes out of scope.
       for (const auto &inner_id : inner_ids) {
         it->second.contains.insert(inner_id);
-        auto inner_it = object_id_refs_.find(inner_id);
-        RAY_CHECK(inner_it != object_id_refs_.end());
+        auto &inner_refs = Refs(inner_id);
+        auto inner_it = inner_refs.find(inner_id);
+        RAY_CHECK(inner_it != inner_refs.end());
         RAY_LOG(DEBUG) << "Setting inner ID " << inner_id
                        << " contained_in_owned: " << object_id;
         inner_it->second.contained_in_owned.insert(object_id);
@@ -800,8 +1053,9 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       RAY_LOG(DEBUG) << "Adding borrower " << owner_address.ip_address << ":"
                      << owner_address.port << " to id " << inner_id
                      << ", borrower owns outer ID " << object_id;
-      auto inner_it = object_id_refs_.find(inner_id);
-      RAY_CHECK(inner_it != object_id_refs_.end());
+      auto &inner_refs = Refs(inner_id);
+      auto inner_it = inner_refs.find(inner_id);
+      RAY_CHECK(inner_it != inner_refs.end());
       // Add the task's caller as a borrower.
       if (inner_it->second.owned_by_us) {
         auto inserted = inner_it->second.borrowers.insert(owner_address).second;
@@ -823,14 +1077,23 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
 void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id,
                                         rpc::WaitForRefRemovedReply *reply,
                                         rpc::SendReplyCallback send_reply_callback) {
+  PopulateRefRemovedReply(object_id, reply);
+  RAY_LOG(DEBUG) << "Replying to WaitForRefRemoved, reply has "
+                 << reply->borrowed_refs().size();
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void ReferenceCounter::PopulateRefRemovedReply(const ObjectID &object_id,
+                                               rpc::WaitForRefRemovedReply *reply) {
   ReferenceTable borrowed_refs;
   RAY_UNUSED(GetAndClearLocalBorrowersInternal(object_id, &borrowed_refs));
   for (const auto &pair : borrowed_refs) {
     RAY_LOG(DEBUG) << pair.first << " has " << pair.second.borrowers.size()
                    << " borrowers";
   }
-  auto it = object_id_refs_.find(object_id);
-  if (it != object_id_refs_.end()) {
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
+  if (it != refs.end()) {
     // We should only have called this callback once our local ref count for
     // the object was zero. Also, we should have stripped all distributed ref
     // count information and returned it to the owner. Therefore, it should be
@@ -839,10 +1102,93 @@ void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id,
   }
   // Send the owner information about any new borrowers.
   ReferenceTableToProto(borrowed_refs, reply->mutable_borrowed_refs());
+}
 
-  RAY_LOG(DEBUG) << "Replying to WaitForRefRemoved, reply has "
-                 << reply->borrowed_refs().size();
-  send_reply_callback(Status::OK(), nullptr, nullptr);
+void ReferenceCounter::HandleWaitForRefsRemoved(
+    const rpc::WaitForRefsRemovedRequest &request, rpc::WaitForRefsRemovedReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  absl::MutexLock lock(&mutex_);
+  const auto owner_id = WorkerID::FromBinary(request.owner_worker_id());
+  // The callbacks stay set across our replies, until we stop borrowing the objects.
+  for (const auto &wait : request.requests()) {
+    SetRefRemovedCallbackInternal(
+        ObjectID::FromBinary(wait.reference().object_id()),
+        ObjectID::FromBinary(wait.contained_in_id()), wait.reference().owner_address(),
+        [this, owner_id](const ObjectID &object_id) {
+          AddRemovedRefToOutbox(owner_id, object_id);
+        });
+  }
+  ref_removed_outboxes_[owner_id].requests.emplace_back(reply, send_reply_callback);
+  if (!ref_removed_batch_timer_ || ref_removed_batch_period_ms_ <= 0) {
+    SendRemovedRefs(owner_id);
+  }
+}
+
+void ReferenceCounter::AddRemovedRefToOutbox(const WorkerID &owner_id,
+                                             const ObjectID &object_id) {
+  auto &removed = ref_removed_outboxes_[owner_id].removed;
+  removed.add_removed_object_ids(object_id.Binary());
+  PopulateRefRemovedReply(object_id, removed.add_replies());
+  if (!ref_removed_batch_timer_ || ref_removed_batch_period_ms_ <= 0) {
+    SendRemovedRefs(owner_id);
+  } else {
+    // Reply at the end of the period, with the other objects that we stop borrowing
+    // by then.
+    ArmRefRemovedBatchTimer();
+  }
+}
+
+void ReferenceCounter::SendRemovedRefs(const WorkerID &owner_id) {
+  auto it = ref_removed_outboxes_.find(owner_id);
+  if (it == ref_removed_outboxes_.end()) {
+    return;
+  }
+  auto &outbox = it->second;
+  if (outbox.removed.removed_object_ids_size() == 0 || outbox.requests.empty()) {
+    return;
+  }
+  auto request = std::move(outbox.requests.front());
+  outbox.requests.pop_front();
+  request.first->Swap(&outbox.removed);
+  outbox.removed.Clear();
+  if (outbox.requests.empty()) {
+    // The outbox is created again once we stop borrowing another object of the owner.
+    ref_removed_outboxes_.erase(it);
+  }
+  RAY_LOG(DEBUG) << "Replying to WaitForRefsRemoved, reply has "
+                 << request.first->removed_object_ids_size() << " objects";
+  request.second(Status::OK(), nullptr, nullptr);
+}
+
+void ReferenceCounter::ArmRefRemovedBatchTimer() {
+  if (ref_removed_batch_timer_armed_) {
+    return;
+  }
+  ref_removed_batch_timer_armed_ = true;
+  ref_removed_batch_timer_->expires_from_now(
+      boost::asio::chrono::milliseconds(ref_removed_batch_period_ms_));
+  ref_removed_batch_timer_->async_wait(
+      [this](const boost::system::error_code &error) { FlushRefRemovedBatches(error); });
+}
+
+void ReferenceCounter::FlushRefRemovedBatches(const boost::system::error_code &error) {
+  if (error == boost::asio::error::operation_aborted) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  ref_removed_batch_timer_armed_ = false;
+  std::vector<WorkerID> owner_ids;
+  for (const auto &entry : ref_removed_outboxes_) {
+    owner_ids.push_back(entry.first);
+  }
+  for (const auto &owner_id : owner_ids) {
+    SendRemovedRefs(owner_id);
+  }
+  auto pending_waits = std::move(pending_ref_removed_waits_);
+  pending_ref_removed_waits_.clear();
+  for (auto &entry : pending_waits) {
+    SendWaitForRefsRemoved(entry.first, std::move(entry.second));
+  }
 }
 
 void ReferenceCounter::SetRefRemovedCallback(
@@ -850,12 +1196,21 @@ void ReferenceCounter::SetRefRemovedCallback(
     const rpc::Address &owner_address,
     const ReferenceCounter::ReferenceRemovedCallback &ref_removed_callback) {
   absl::MutexLock lock(&mutex_);
+  SetRefRemovedCallbackInternal(object_id, contained_in_id, owner_address,
+                                ref_removed_callback);
+}
+
+void ReferenceCounter::SetRefRemovedCallbackInternal(
+    const ObjectID &object_id, const ObjectID &contained_in_id,
+    const rpc::Address &owner_address,
+    const ReferenceCounter::ReferenceRemovedCallback &ref_removed_callback) {
   RAY_LOG(DEBUG) << "Received WaitForRefRemoved " << object_id << " contained in "
                  << contained_in_id;
 
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
-    it = object_id_refs_.emplace(object_id, Reference()).first;
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
+  if (it == refs.end()) {
+    it = refs.emplace(object_id, Reference()).first;
   }
 
   // If we are borrowing the ID because we own an object that contains it, then
@@ -897,27 +1252,33 @@ void ReferenceCounter::SetReleaseLineageCallback(
 
 void ReferenceCounter::AddObjectLocation(const ObjectID &object_id,
                                          const NodeID &node_id) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_locations_.find(object_id);
-  if (it == object_id_locations_.end()) {
-    it = object_id_locations_.emplace(object_id, absl::flat_hash_set<NodeID>()).first;
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.locations.find(object_id);
+  if (it == shard.locations.end()) {
+    it = shard.locations.emplace(object_id, absl::flat_hash_set<NodeID>()).first;
   }
   it->second.insert(node_id);
 }
 
 void ReferenceCounter::RemoveObjectLocation(const ObjectID &object_id,
                                             const NodeID &node_id) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_locations_.find(object_id);
-  RAY_CHECK(it != object_id_locations_.end());
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.locations.find(object_id);
+  RAY_CHECK(it != shard.locations.end());
   it->second.erase(node_id);
 }
 
 std::unordered_set<NodeID> ReferenceCounter::GetObjectLocations(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mutex_);
-  auto it = object_id_locations_.find(object_id);
-  RAY_CHECK(it != object_id_locations_.end());
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.locations.find(object_id);
+  RAY_CHECK(it != shard.locations.end());
   std::unordered_set<NodeID> locations;
   for (const auto &location : it->second) {
     locations.insert(location);
@@ -925,10 +1286,36 @@ std::unordered_set<NodeID> ReferenceCounter::GetObjectLocations(
   return locations;
 }
 
+absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
+    const ObjectID &object_id) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto &shard = GetShard(object_id);
+  absl::MutexLock shard_lock(&shard.mutex);
+  auto it = shard.refs.find(object_id);
+  if (it == shard.refs.end() || it->second.object_size < 0) {
+    return absl::nullopt;
+  }
+  LocalityData locality_data;
+  locality_data.object_size = it->second.object_size;
+  if (it->second.pinned_at_raylet_id.has_value()) {
+    locality_data.nodes_containing_object.insert(*it->second.pinned_at_raylet_id);
+  }
+  auto locations = shard.locations.find(object_id);
+  if (locations != shard.locations.end()) {
+    locality_data.nodes_containing_object.insert(locations->second.begin(),
+                                                 locations->second.end());
+  }
+  if (locality_data.nodes_containing_object.empty()) {
+    return absl::nullopt;
+  }
+  return locality_data;
+}
+
 void ReferenceCounter::HandleObjectSpilled(const ObjectID &object_id) {
   absl::MutexLock lock(&mutex_);
-  auto it = object_id_refs_.find(object_id);
-  if (it == object_id_refs_.end()) {
+  auto &refs = Refs(object_id);
+  auto it = refs.find(object_id);
+  if (it == refs.end()) {
     RAY_LOG(WARNING) << "Spilled object " << object_id << " already out of scope";
     return;
   }
@@ -941,7 +1328,8 @@ void ReferenceCounter::HandleObjectSpilled(const ObjectID &object_id) {
 ReferenceCounter::Reference ReferenceCounter::Reference::FromProto(
     const rpc::ObjectReferenceCount &ref_count) {
   Reference ref;
-  ref.owner_address = ref_count.reference().owner_address();
+  ref.owner_address =
+      std::make_shared<const rpc::Address>(ref_count.reference().owner_address());
   ref.local_ref_count = ref_count.has_local_ref() ? 1 : 0;
 
   for (const auto &borrower : ref_count.borrowers()) {
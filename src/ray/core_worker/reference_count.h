@@ -14,13 +14,19 @@
 
 #pragma once
 
+#include <array>
+#include <deque>
+#include <boost/asio.hpp>
 #include <boost/bind.hpp>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
+#include "ray/common/ray_config.h"
 #include "ray/rpc/grpc_server.h"
 #include "ray/rpc/worker/core_worker_client.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
@@ -48,9 +54,37 @@ class ReferenceCounterInterface {
   virtual ~ReferenceCounterInterface() {}
 };
 
+/// The size of an object and the nodes that hold a copy of it.
+struct LocalityData {
+  uint64_t object_size;
+  absl::flat_hash_set<NodeID> nodes_containing_object;
+};
+
+/// Interface for the locality data of the objects, used to run tasks where their
+/// arguments are.
+class LocalityDataProviderInterface {
+ public:
+  /// Get the locality data of an object.
+  ///
+  /// \param[in] object_id The object.
+  /// \return The locality data, or nullopt if the size of the object or the nodes that
+  /// hold it are not known.
+  virtual absl::optional<LocalityData> GetLocalityData(const ObjectID &object_id) = 0;
+
+  virtual ~LocalityDataProviderInterface() {}
+};
+
 /// Class used by the core worker to keep track of ObjectID reference counts for garbage
 /// collection. This class is thread safe.
-class ReferenceCounter : public ReferenceCounterInterface {
+///
+/// The state of the objects is split into shards by object ID, so that the threads
+/// that add and remove references to different objects do not contend on a single
+/// lock. An operation that only touches one object holds mutex_ in shared mode and the
+/// lock of the object's shard. An operation that touches several objects, e.g., to
+/// delete a reference along with the references nested in it, or to merge the
+/// borrowers of a task's arguments, holds mutex_ exclusively and takes no shard lock.
+class ReferenceCounter : public ReferenceCounterInterface,
+                         public LocalityDataProviderInterface {
  public:
   using ReferenceTableProto =
       ::google::protobuf::RepeatedPtrField<rpc::ObjectReferenceCount>;
@@ -58,16 +92,28 @@ class ReferenceCounter : public ReferenceCounterInterface {
   using LineageReleasedCallback =
       std::function<void(const ObjectID &, std::vector<ObjectID> *)>;
 
-  ReferenceCounter(const rpc::WorkerAddress &rpc_address,
-                   bool distributed_ref_counting_enabled = true,
-                   bool lineage_pinning_enabled = false,
-                   rpc::ClientFactoryFn client_factory = nullptr)
+  /// Create a ReferenceCounter.
+  ///
+  /// \param ref_removed_batch_timer The timer used to batch the waits for borrowers
+  /// to stop using objects, and the replies to these waits. If this is not set, then
+  /// each wait is sent in its own RPC.
+  ReferenceCounter(
+      const rpc::WorkerAddress &rpc_address, bool distributed_ref_counting_enabled = true,
+      bool lineage_pinning_enabled = false, rpc::ClientFactoryFn client_factory = nullptr,
+      absl::optional<boost::asio::steady_timer> ref_removed_batch_timer = absl::nullopt)
       : rpc_address_(rpc_address),
         distributed_ref_counting_enabled_(distributed_ref_counting_enabled),
         lineage_pinning_enabled_(lineage_pinning_enabled),
-        borrower_pool_(client_factory) {}
-
-  ~ReferenceCounter() {}
+        borrower_pool_(client_factory),
+        ref_removed_batch_timer_(std::move(ref_removed_batch_timer)),
+        ref_removed_batch_period_ms_(
+            RayConfig::instance().ref_removed_batch_period_milliseconds()) {}
+
+  ~ReferenceCounter() {
+    if (ref_removed_batch_timer_) {
+      ref_removed_batch_timer_->cancel();
+    }
+  }
 
   /// Wait for all object references to go out of scope, and then shutdown.
   ///
@@ -266,6 +312,21 @@ class ReferenceCounter : public ReferenceCounterInterface {
                         rpc::SendReplyCallback send_reply_callback)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Respond to the owner of a batch of objects once we are no longer borrowing some
+  /// of them. We keep waiting for the objects of the owner's earlier requests, so the
+  /// owner only sends the objects that are new. The reply holds the objects of any of
+  /// these requests that we stopped borrowing by the end of the batching period and
+  /// did not reply about yet.
+  ///
+  /// \param[in] request The new objects that we are borrowing.
+  /// \param[in] reply A reply sent to the owner when we are no longer borrowing some
+  /// of its objects. It holds the reply of HandleRefRemoved for each of them.
+  /// \param[in] send_reply_callback The callback to send the reply.
+  void HandleWaitForRefsRemoved(const rpc::WaitForRefsRemovedRequest &request,
+                                rpc::WaitForRefsRemovedReply *reply,
+                                rpc::SendReplyCallback send_reply_callback)
+      LOCKS_EXCLUDED(mutex_);
+
   /// Returns the total number of ObjectIDs currently in scope.
   size_t NumObjectIDsInScope() const LOCKS_EXCLUDED(mutex_);
 
@@ -379,6 +440,14 @@ class ReferenceCounter : public ReferenceCounterInterface {
   std::unordered_set<NodeID> GetObjectLocations(const ObjectID &object_id)
       LOCKS_EXCLUDED(mutex_);
 
+  /// Get the size of an owned object and the nodes that hold it, which are the node
+  /// where its primary copy is pinned and the ones in its location table.
+  ///
+  /// \param[in] object_id The object.
+  /// \return The locality data, or nullopt if the size or the nodes are not known.
+  absl::optional<LocalityData> GetLocalityData(const ObjectID &object_id) override
+      LOCKS_EXCLUDED(mutex_);
+
   /// Handle an object has been spilled to external storage.
   ///
   /// This notifies the primary raylet that the object is safe to release and
@@ -386,19 +455,81 @@ class ReferenceCounter : public ReferenceCounterInterface {
   void HandleObjectSpilled(const ObjectID &object_id);
 
  private:
+  /// A set or map that is only allocated once it holds an element. Most references
+  /// are never nested or borrowed, so their sets take a single pointer instead of an
+  /// empty hash table.
+  template <typename Container>
+  class LazyContainer {
+   public:
+    using const_iterator = typename Container::const_iterator;
+
+    LazyContainer() = default;
+    LazyContainer(LazyContainer &&other) = default;
+    LazyContainer &operator=(LazyContainer &&other) = default;
+    LazyContainer(const LazyContainer &other) { *this = other; }
+    LazyContainer &operator=(const LazyContainer &other) {
+      container_.reset(other.empty() ? nullptr : new Container(*other.container_));
+      return *this;
+    }
+
+    template <typename... Args>
+    auto emplace(Args &&... args) {
+      return Mutable().emplace(std::forward<Args>(args)...);
+    }
+    template <typename Value>
+    auto insert(Value &&value) {
+      return Mutable().insert(std::forward<Value>(value));
+    }
+    /// Erase an element, and free the container if it is now empty.
+    template <typename Key>
+    size_t erase(const Key &key) {
+      if (!container_) {
+        return 0;
+      }
+      size_t num_erased = container_->erase(key);
+      if (container_->empty()) {
+        container_.reset();
+      }
+      return num_erased;
+    }
+    template <typename Key>
+    size_t count(const Key &key) const {
+      return container_ ? container_->count(key) : 0;
+    }
+    void clear() { container_.reset(); }
+    size_t size() const { return container_ ? container_->size() : 0; }
+    bool empty() const { return !container_; }
+    const_iterator begin() const { return Get().begin(); }
+    const_iterator end() const { return Get().end(); }
+
+   private:
+    const Container &Get() const {
+      static const Container empty;
+      return container_ ? *container_ : empty;
+    }
+    Container &Mutable() {
+      if (!container_) {
+        container_.reset(new Container());
+      }
+      return *container_;
+    }
+
+    std::unique_ptr<Container> container_;
+  };
+
   struct Reference {
     /// Constructor for a reference whose origin is unknown.
     Reference() {}
-    Reference(std::string call_site, const int64_t object_size)
+    Reference(const std::string *call_site, const int64_t object_size)
         : call_site(call_site), object_size(object_size) {}
     /// Constructor for a reference that we created.
-    Reference(const rpc::Address &owner_address, std::string call_site,
-              const int64_t object_size, bool is_reconstructable,
-              const absl::optional<NodeID> &pinned_at_raylet_id)
+    Reference(std::shared_ptr<const rpc::Address> owner_address,
+              const std::string *call_site, const int64_t object_size,
+              bool is_reconstructable, const absl::optional<NodeID> &pinned_at_raylet_id)
         : call_site(call_site),
           object_size(object_size),
           owned_by_us(true),
-          owner_address(owner_address),
+          owner_address(std::move(owner_address)),
           pinned_at_raylet_id(pinned_at_raylet_id),
           is_reconstructable(is_reconstructable) {}
 
@@ -451,8 +582,9 @@ class ReferenceCounter : public ReferenceCounterInterface {
       }
     }
 
-    /// Description of the call site where the reference was created.
-    std::string call_site = "<unknown>";
+    /// Description of the call site where the reference was created. Call sites are
+    /// interned, since many references are created at the same call site.
+    const std::string *call_site = &kUnknownCallSite;
     /// Object size if known, otherwise -1;
     int64_t object_size = -1;
 
@@ -463,8 +595,9 @@ class ReferenceCounter : public ReferenceCounterInterface {
     /// The object's owner's address, if we know it. If this process is the
     /// owner, then this is added during creation of the Reference. If this is
     /// process is a borrower, the borrower must add the owner's address before
-    /// using the ObjectID.
-    absl::optional<rpc::Address> owner_address;
+    /// using the ObjectID. Owner addresses are interned, since the references of a
+    /// worker are owned by few workers.
+    std::shared_ptr<const rpc::Address> owner_address;
     // If this object is owned by us and stored in plasma, and reference
     // counting is enabled, then some raylet must be pinning the object value.
     // This is the address of that raylet.
@@ -484,7 +617,7 @@ class ReferenceCounter : public ReferenceCounterInterface {
     ///  1. We call ray.put() and store the inner ID(s) in the outer object.
     ///  2. A task that we submitted returned an ID(s).
     /// ObjectIDs are erased from this field when their Reference is deleted.
-    absl::flat_hash_set<ObjectID> contained_in_owned;
+    LazyContainer<absl::flat_hash_set<ObjectID>> contained_in_owned;
     /// An Object ID that we (or one of our children) borrowed that contains
     /// this object ID, which is also borrowed. This is used in cases where an
     /// ObjectID is nested. We need to notify the owner of the outer ID of any
@@ -508,7 +641,7 @@ class ReferenceCounter : public ReferenceCounterInterface {
     ///  1. We call ray.put() on this ID and store the contained IDs.
     ///  2. We call ray.get() on an ID whose contents we do not know and we
     ///     discover that it contains these IDs.
-    absl::flat_hash_set<ObjectID> contains;
+    LazyContainer<absl::flat_hash_set<ObjectID>> contains;
     /// A list of processes that are we gave a reference to that are still
     /// borrowing the ID. This field is updated in 2 cases:
     ///  1. If we are a borrower of the ID, then we add a process to this list
@@ -520,14 +653,14 @@ class ReferenceCounter : public ReferenceCounterInterface {
     ///     we hear from a borrower that it has passed the ID to other
     ///     borrowers. A borrower is removed from the list when it responds
     ///     that it is no longer using the reference.
-    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
+    LazyContainer<absl::flat_hash_set<rpc::WorkerAddress>> borrowers;
     /// When a process that is borrowing an object ID stores the ID inside the
     /// return value of a task that it executes, the caller of the task is also
     /// considered a borrower for as long as its reference to the task's return
     /// ID stays in scope. Thus, the borrower must notify the owner that the
     /// task's caller is also a borrower. The key is the task's return ID, and
     /// the value is the task ID and address of the task's caller.
-    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
+    LazyContainer<absl::flat_hash_map<ObjectID, rpc::WorkerAddress>> stored_in_objects;
     /// The number of tasks that depend on this object that may be retried in
     /// the future (pending execution or finished but retryable). If the object
     /// is inlined (not stored in plasma), then its lineage ref count is 0
@@ -544,11 +677,103 @@ class ReferenceCounter : public ReferenceCounterInterface {
     std::function<void(const ObjectID &)> on_ref_removed;
   };
 
-  using ReferenceTable = absl::flat_hash_map<ObjectID, Reference>;
+  /// References are stored in nodes, so that the table does not hold the unused
+  /// capacity of its slots for each of the large Reference entries.
+  using ReferenceTable = absl::node_hash_map<ObjectID, Reference>;
 
+  /// The call site of references whose call site is not known.
+  static const std::string kUnknownCallSite;
+
+  using LocationTable = absl::flat_hash_map<ObjectID, absl::flat_hash_set<NodeID>>;
+
+  /// The state of the objects whose ID maps to a shard. This is guarded by mutex_
+  /// held exclusively, or by mutex_ held in shared mode together with the shard's
+  /// mutex. Code that holds the shard's mutex accesses the fields directly; code that
+  /// holds mutex_ exclusively goes through the accessors below.
+  struct Shard {
+    absl::Mutex mutex;
+
+    /// Holds all reference counts and dependency information for tracked ObjectIDs.
+    ReferenceTable refs GUARDED_BY(mutex);
+
+    /// Holds the client information for the owned objects. This table is seperate
+    /// from the reference table because we add object reference after putting object
+    /// into the plasma store and add the location to the object directory. Therefore
+    /// we will receive object location information before the reference is created.
+    LocationTable locations GUARDED_BY(mutex);
+
+    /// Objects whose values have been freed by the language frontend.
+    /// The values in plasma will not be pinned. An object ID is
+    /// removed from this set once its Reference has been deleted
+    /// locally.
+    absl::flat_hash_set<ObjectID> freed_objects GUARDED_BY(mutex);
+
+    /// The call sites of the references. These are never removed, since there are
+    /// few call sites in a program.
+    absl::node_hash_set<std::string> call_sites GUARDED_BY(mutex);
+
+    /// The owner addresses of the references, keyed by the ID of the owner.
+    absl::flat_hash_map<std::string, std::shared_ptr<const rpc::Address>>
+        owner_addresses GUARDED_BY(mutex);
+
+    /// The number of owner addresses after the unused ones were last removed.
+    size_t num_owner_addresses_in_use GUARDED_BY(mutex) = 0;
+  };
+
+  /// The number of shards of the reference counting state.
+  static constexpr size_t kNumShards = 32;
+
+  /// Return the shard that holds the state of an object.
+  Shard &GetShard(const ObjectID &object_id) const {
+    return shards_[object_id.Hash() % kNumShards];
+  }
+
+  /// Return the references of a shard, without its mutex. mutex_ must be held
+  /// exclusively, which excludes the holders of the shard's mutex.
+  ReferenceTable &Refs(Shard &shard) const EXCLUSIVE_LOCKS_REQUIRED(mutex_)
+      NO_THREAD_SAFETY_ANALYSIS {
+    mutex_.AssertHeld();
+    return shard.refs;
+  }
+
+  /// Return the references of the shard of an object. mutex_ must be held
+  /// exclusively.
+  ReferenceTable &Refs(const ObjectID &object_id) const EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return Refs(GetShard(object_id));
+  }
+
+  /// Return the freed objects of the shard of an object. mutex_ must be held
+  /// exclusively.
+  absl::flat_hash_set<ObjectID> &FreedObjects(const ObjectID &object_id) const
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) NO_THREAD_SAFETY_ANALYSIS {
+    mutex_.AssertHeld();
+    return GetShard(object_id).freed_objects;
+  }
+
+  /// Return the interned copy of a call site, from the shard of the reference that
+  /// uses it.
+  static const std::string *InternCallSite(Shard *shard, const std::string &call_site)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->mutex);
+
+  /// Return the interned copy of an owner address, from the shard of the reference
+  /// that uses it.
+  static std::shared_ptr<const rpc::Address> InternOwnerAddress(
+      Shard *shard, const rpc::Address &address) EXCLUSIVE_LOCKS_REQUIRED(shard->mutex);
+
+  /// Remove the references for the provided object IDs that correspond to them
+  /// being dependencies to a submitted task, as long as this does not take their
+  /// reference count to zero. This only needs the lock of each object's shard.
+  ///
+  /// \return The arguments whose references were not removed, because removing them
+  /// needs mutex_ to be held exclusively.
+  std::vector<ObjectID> RemoveSubmittedTaskReferencesShared(
+      const std::vector<ObjectID> &argument_ids, bool release_lineage)
+      SHARED_LOCKS_REQUIRED(mutex_);
+
+  /// Get the owner address of an object. This takes the lock of the object's shard.
   bool GetOwnerInternal(const ObjectID &object_id,
                         rpc::Address *owner_address = nullptr) const
-      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+      SHARED_LOCKS_REQUIRED(mutex_);
 
   /// Release the pinned plasma object, if any. Also unsets the raylet address
   /// that the object was pinned at, if the address was set.
@@ -641,6 +866,72 @@ class ReferenceCounter : public ReferenceCounterInterface {
                          const ObjectID &contained_in_id = ObjectID::Nil())
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Handle the reply of a borrower that is no longer using an object that we own.
+  ///
+  /// \param[in] object_id The object.
+  /// \param[in] addr The address of the borrower.
+  /// \param[in] reply The borrower's reply. It is empty if the borrower failed.
+  void HandleBorrowerRefRemoved(const ObjectID &object_id,
+                                const rpc::WorkerAddress &addr,
+                                const rpc::WaitForRefRemovedReply &reply)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Send the batched waits for a borrower to stop using objects that we own. The
+  /// borrower keeps waiting for the objects of earlier requests, so this only holds
+  /// the new objects, and is empty to wait for more replies about the earlier ones.
+  ///
+  /// \param[in] addr The address of the borrower.
+  /// \param[in] requests The waits for each new object.
+  void SendWaitForRefsRemoved(const rpc::WorkerAddress &addr,
+                              std::vector<rpc::WaitForRefRemovedRequest> requests)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Populate the reply to the owner of an object that we are no longer borrowing.
+  void PopulateRefRemovedReply(const ObjectID &object_id,
+                               rpc::WaitForRefRemovedReply *reply)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Helper method to set the callback for when we are no longer borrowing an object.
+  void SetRefRemovedCallbackInternal(const ObjectID &object_id,
+                                     const ObjectID &contained_in_id,
+                                     const rpc::Address &owner_address,
+                                     const ReferenceRemovedCallback &ref_removed_callback)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Handle the reply of a borrower to a batch of waits.
+  ///
+  /// \param[in] addr The address of the borrower.
+  /// \param[in] status Whether the borrower replied. Otherwise, it failed.
+  /// \param[in] reply The objects that the borrower is no longer using.
+  void HandleBorrowerRefsRemoved(const rpc::WorkerAddress &addr, const Status &status,
+                                 const rpc::WaitForRefsRemovedReply &reply)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// The objects that an owner waits for us to stop borrowing, which we stopped
+  /// borrowing, and the owner's requests that we can reply with them.
+  struct RefRemovedOutbox {
+    /// The objects that we stopped borrowing and did not reply about yet.
+    rpc::WaitForRefsRemovedReply removed;
+    /// The owner's requests that were not replied to yet, oldest first.
+    std::deque<std::pair<rpc::WaitForRefsRemovedReply *, rpc::SendReplyCallback>>
+        requests;
+  };
+
+  /// Add an object that we stopped borrowing to the outbox of its owner.
+  void AddRemovedRefToOutbox(const WorkerID &owner_id, const ObjectID &object_id)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Reply to the oldest request of an owner with the objects in its outbox, if there
+  /// are both.
+  void SendRemovedRefs(const WorkerID &owner_id) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Arm the timer that sends the batched waits and replies, if it is not armed.
+  void ArmRefRemovedBatchTimer() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Send the batched waits and replies.
+  void FlushRefRemovedBatches(const boost::system::error_code &error)
+      LOCKS_EXCLUDED(mutex_);
+
   /// Helper method to add an object that we are borrowing. This is used when
   /// deserializing IDs from a task's arguments, or when deserializing an ID
   /// during ray.get().
@@ -649,8 +940,8 @@ class ReferenceCounter : public ReferenceCounterInterface {
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   /// Helper method to delete an entry from the reference map and run any necessary
-  /// callbacks. Assumes that the entry is in object_id_refs_ and invalidates the
-  /// iterator.
+  /// callbacks. Assumes that the entry is in the table of its shard and invalidates
+  /// the iterator.
   void DeleteReferenceInternal(ReferenceTable::iterator entry,
                                std::vector<ObjectID> *deleted)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -683,25 +974,43 @@ class ReferenceCounter : public ReferenceCounterInterface {
   /// borrower's ref count for the ID goes to 0.
   rpc::CoreWorkerClientPool borrower_pool_;
 
-  /// Protects access to the reference counting state.
+  /// Protects access to the reference counting state. See the comment on this class
+  /// for when it is held in shared mode and when it is held exclusively.
   mutable absl::Mutex mutex_;
 
-  /// Holds all reference counts and dependency information for tracked ObjectIDs.
-  ReferenceTable object_id_refs_ GUARDED_BY(mutex_);
+  /// The state of the tracked ObjectIDs, split by object ID.
+  mutable std::array<Shard, kNumShards> shards_;
 
-  using LocationTable = absl::flat_hash_map<ObjectID, absl::flat_hash_set<NodeID>>;
+  /// The timer used to batch the waits for borrowers to stop using objects, and the
+  /// replies to these waits.
+  absl::optional<boost::asio::steady_timer> ref_removed_batch_timer_ GUARDED_BY(mutex_);
+
+  /// Whether the ref removed batch timer is armed.
+  bool ref_removed_batch_timer_armed_ GUARDED_BY(mutex_) = false;
+
+  /// The batching period of the waits and the replies.
+  const int64_t ref_removed_batch_period_ms_;
+
+  /// The waits for borrowers to stop using objects that we own, which are not sent
+  /// yet. They are sent at the end of the batching period, in one RPC per borrower.
+  absl::flat_hash_map<rpc::WorkerAddress, std::vector<rpc::WaitForRefRemovedRequest>>
+      pending_ref_removed_waits_ GUARDED_BY(mutex_);
+
+  /// The objects that we own and that a borrower was asked to reply about once it
+  /// stops using them, and the number of requests to it without a reply. Once a
+  /// borrower replies, it is sent an empty request if it still has objects to reply
+  /// about and no other request.
+  struct BorrowerRefRemovedWaits {
+    absl::flat_hash_set<ObjectID> objects;
+    int num_requests_in_flight = 0;
+  };
+  absl::flat_hash_map<rpc::WorkerAddress, BorrowerRefRemovedWaits> ref_removed_waits_
+      GUARDED_BY(mutex_);
 
-  /// Holds the client information for the owned objects. This table is seperate from
-  /// the reference table because we add object reference after putting object into the
-  /// plasma store and add the location to the object directory. Therefore we will receive
-  /// object location information before the reference is created.
-  LocationTable object_id_locations_ GUARDED_BY(mutex_);
-
-  /// Objects whose values have been freed by the language frontend.
-  /// The values in plasma will not be pinned. An object ID is
-  /// removed from this set once its Reference has been deleted
-  /// locally.
-  absl::flat_hash_set<ObjectID> freed_objects_ GUARDED_BY(mutex_);
+  /// The outboxes of the owners that wait for us to stop borrowing their objects,
+  /// keyed by owner ID.
+  absl::flat_hash_map<WorkerID, RefRemovedOutbox> ref_removed_outboxes_
+      GUARDED_BY(mutex_);
 
   /// The callback to call once an object ID that we own is no longer in scope
   /// and it has no tasks that depend on it that may be retried in the future.
@@ -14,6 +14,12 @@
 
 #include "ray/core_worker/reference_count.h"
 
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -61,11 +67,14 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     return address;
   }
 
-  MockWorkerClient(const std::string &addr, rpc::ClientFactoryFn client_factory = nullptr)
+  MockWorkerClient(const std::string &addr, rpc::ClientFactoryFn client_factory = nullptr,
+                   boost::asio::io_service *io_service = nullptr)
       : address_(CreateRandomAddress(addr)),
         rc_(rpc::WorkerAddress(address_),
             /*distributed_ref_counting_enabled=*/true,
-            /*lineage_pinning_enabled=*/false, client_factory) {}
+            /*lineage_pinning_enabled=*/false, client_factory,
+            io_service ? absl::make_optional<boost::asio::steady_timer>(*io_service)
+                       : absl::nullopt) {}
 
   void WaitForRefRemoved(
       const rpc::WaitForRefRemovedRequest &request,
@@ -95,6 +104,30 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     num_requests_++;
   }
 
+  void WaitForRefsRemoved(
+      const rpc::WaitForRefsRemovedRequest &request,
+      const rpc::ClientCallback<rpc::WaitForRefsRemovedReply> &callback) override {
+    auto r = num_batch_requests_;
+    batch_request_bytes_ += request.ByteSizeLong();
+    batch_requests_[r] = {
+        std::make_shared<rpc::WaitForRefsRemovedReply>(),
+        callback,
+    };
+
+    auto send_reply_callback = [this, r](Status status, std::function<void()> success,
+                                         std::function<void()> failure) {
+      batch_requests_[r].second(status, *batch_requests_[r].first);
+    };
+    // Use negative keys, so that the callbacks of batches and of single requests do
+    // not collide.
+    borrower_callbacks_[-1 - r] = [=]() {
+      rc_.HandleWaitForRefsRemoved(request, batch_requests_[r].first.get(),
+                                   send_reply_callback);
+    };
+
+    num_batch_requests_++;
+  }
+
   bool FlushBorrowerCallbacks() {
     if (borrower_callbacks_.empty()) {
       return false;
@@ -111,6 +144,9 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     for (const auto &request : requests_) {
       request.second.second(Status::IOError("disconnected"), *request.second.first);
     }
+    for (const auto &request : batch_requests_) {
+      request.second.second(Status::IOError("disconnected"), *request.second.first);
+    }
   }
 
   // The below methods mirror a core worker's operations, e.g., `Put` simulates
@@ -190,6 +226,11 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
                                     rpc::ClientCallback<rpc::WaitForRefRemovedReply>>>
       requests_;
   int num_requests_ = 0;
+  std::unordered_map<int, std::pair<std::shared_ptr<rpc::WaitForRefsRemovedReply>,
+                                    rpc::ClientCallback<rpc::WaitForRefsRemovedReply>>>
+      batch_requests_;
+  int num_batch_requests_ = 0;
+  size_t batch_request_bytes_ = 0;
 };
 
 // Tests basic incrementing/decrementing of direct/submitted task reference counts. An
@@ -1817,6 +1858,117 @@ TEST(DistributedReferenceCountTest, TestReturnBorrowedIdChainOutOfOrder) {
   ASSERT_FALSE(nested_worker->rc_.HasReference(inner_id));
 }
 
+// A borrower is given references to many objects, and keeps them after its task
+// returns. It stops using half of them, and then the other half. The owner's waits
+// and the borrower's replies are batched.
+//
+// @ray.remote
+// def borrower(ids):
+//     kept.extend(ids)
+//
+// ids = [ray.put(i) for i in range(10)]
+// res = borrower.remote(*ids)
+TEST(DistributedReferenceCountTest, TestBatchedRefRemoved) {
+  boost::asio::io_service io_service;
+  auto borrower = std::make_shared<MockWorkerClient>("1", nullptr, &io_service);
+  auto owner = std::make_shared<MockWorkerClient>(
+      "2", [&](const rpc::Address &addr) { return borrower; }, &io_service);
+
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 10; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    owner->Put(ids.back());
+  }
+  owner->rc_.UpdateSubmittedTaskReferences(ids);
+  for (const auto &id : ids) {
+    owner->rc_.RemoveLocalReference(id, nullptr);
+  }
+
+  // The borrower keeps a reference to each object, besides the sentinel reference
+  // of the task.
+  for (const auto &id : ids) {
+    borrower->rc_.AddLocalReference(id, "");
+    borrower->rc_.AddLocalReference(id, "");
+    borrower->rc_.AddBorrowedObject(id, ObjectID::Nil(), owner->address_);
+  }
+  ReferenceCounter::ReferenceTableProto borrower_refs;
+  borrower->rc_.GetAndClearLocalBorrowers(ids, &borrower_refs);
+  for (const auto &id : ids) {
+    borrower->rc_.RemoveLocalReference(id, nullptr);
+  }
+
+  // The owner waits for the borrower with a single request.
+  owner->rc_.UpdateFinishedTaskReferences(ids, false, borrower->address_, borrower_refs,
+                                          nullptr);
+  ASSERT_EQ(borrower->num_batch_requests_, 0);
+  io_service.run();
+  io_service.reset();
+  ASSERT_EQ(borrower->num_batch_requests_, 1);
+  ASSERT_EQ(borrower->num_requests_, 0);
+  borrower->FlushBorrowerCallbacks();
+
+  // The borrower replies about the objects that it stopped using. It still knows
+  // about the others, so the owner waits for them with an empty request.
+  for (int i = 0; i < 5; i++) {
+    borrower->rc_.RemoveLocalReference(ids[i], nullptr);
+  }
+  io_service.run();
+  io_service.reset();
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(owner->rc_.HasReference(ids[i]), i >= 5);
+    ASSERT_EQ(borrower->rc_.HasReference(ids[i]), i >= 5);
+  }
+  ASSERT_EQ(borrower->num_batch_requests_, 2);
+  borrower->FlushBorrowerCallbacks();
+
+  for (int i = 5; i < 10; i++) {
+    borrower->rc_.RemoveLocalReference(ids[i], nullptr);
+  }
+  io_service.run();
+  io_service.reset();
+  for (const auto &id : ids) {
+    ASSERT_FALSE(owner->rc_.HasReference(id));
+    ASSERT_FALSE(borrower->rc_.HasReference(id));
+  }
+  ASSERT_EQ(borrower->num_batch_requests_, 2);
+}
+
+// A borrower is given references to many objects in a batch, and fails before it
+// stops using them.
+TEST(DistributedReferenceCountTest, TestBatchedRefRemovedBorrowerFailure) {
+  boost::asio::io_service io_service;
+  auto borrower = std::make_shared<MockWorkerClient>("1", nullptr, &io_service);
+  auto owner = std::make_shared<MockWorkerClient>(
+      "2", [&](const rpc::Address &addr) { return borrower; }, &io_service);
+
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 10; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    owner->Put(ids.back());
+  }
+  owner->rc_.UpdateSubmittedTaskReferences(ids);
+  for (const auto &id : ids) {
+    owner->rc_.RemoveLocalReference(id, nullptr);
+    borrower->rc_.AddLocalReference(id, "");
+    borrower->rc_.AddLocalReference(id, "");
+    borrower->rc_.AddBorrowedObject(id, ObjectID::Nil(), owner->address_);
+  }
+  ReferenceCounter::ReferenceTableProto borrower_refs;
+  borrower->rc_.GetAndClearLocalBorrowers(ids, &borrower_refs);
+  owner->rc_.UpdateFinishedTaskReferences(ids, false, borrower->address_, borrower_refs,
+                                          nullptr);
+  io_service.run();
+  for (const auto &id : ids) {
+    ASSERT_TRUE(owner->rc_.HasReference(id));
+  }
+
+  // The borrower fails, so the owner stops waiting for all the objects.
+  borrower->FailAllWaitForRefRemovedRequests();
+  for (const auto &id : ids) {
+    ASSERT_FALSE(owner->rc_.HasReference(id));
+  }
+}
+
 // TODO: Test Pop and Merge individually.
 
 TEST_F(ReferenceCountLineageEnabledTest, TestUnreconstructableObjectOutOfScope) {
@@ -2058,6 +2210,378 @@ TEST_F(ReferenceCountTest, TestFree) {
   ASSERT_FALSE(rc->IsPlasmaObjectFreed(id));
 }
 
+// Threads race to add and remove local and submitted task references to the same
+// objects, which stay in scope through a reference that the test holds.
+TEST_F(ReferenceCountTest, TestConcurrentReferences) {
+  const int num_threads = 8;
+  const int num_objects = 100;
+  const int num_rounds = 200;
+  rpc::Address address;
+  address.set_ip_address("1234");
+  std::atomic<int> num_deleted(0);
+  auto callback = [&num_deleted](const ObjectID &object_id) { num_deleted++; };
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < num_objects; i++) {
+    ObjectID id = ObjectID::FromRandom();
+    rc->AddOwnedObject(id, {}, address, "", 0, false);
+    rc->AddLocalReference(id, "");
+    ASSERT_TRUE(rc->SetDeleteCallback(id, callback));
+    ids.push_back(id);
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([this, t, &ids]() {
+      std::vector<ObjectID> deleted;
+      for (int round = 0; round < num_rounds; round++) {
+        // Each thread starts at a different object, so that the threads update the
+        // same objects in different orders.
+        for (size_t i = 0; i < ids.size(); i++) {
+          const auto &id = ids[(i + t * ids.size() / num_threads) % ids.size()];
+          rc->AddLocalReference(id, "");
+          rc->UpdateSubmittedTaskReferences({id});
+          rc->RemoveLocalReference(id, &deleted);
+          rc->UpdateSubmittedTaskReferences({id});
+          rc->UpdateFinishedTaskReferences({id}, /*release_lineage=*/true,
+                                           empty_borrower, empty_refs, &deleted);
+          rc->AddLocalReference(id, "");
+          rc->UpdateFinishedTaskReferences({id}, /*release_lineage=*/true,
+                                           empty_borrower, empty_refs, &deleted);
+          rc->RemoveLocalReference(id, &deleted);
+        }
+      }
+      RAY_CHECK(deleted.empty());
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Only the reference of the test is left.
+  ASSERT_EQ(num_deleted, 0);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), num_objects);
+  auto counts = rc->GetAllReferenceCounts();
+  ASSERT_EQ(counts.size(), num_objects);
+  for (const auto &id : ids) {
+    ASSERT_EQ(counts[id].first, 1);
+    ASSERT_EQ(counts[id].second, 0);
+  }
+
+  std::vector<ObjectID> deleted;
+  for (const auto &id : ids) {
+    rc->RemoveLocalReference(id, &deleted);
+  }
+  ASSERT_EQ(num_deleted, num_objects);
+  ASSERT_EQ(deleted.size(), num_objects);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+}
+
+/// Return the resident set size of this process, in bytes.
+static int64_t ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+/// Measure the memory and the time taken per reference by a driver that holds 10M
+/// ObjectRefs. Most of the objects are owned by the driver and were created at a few
+/// call sites, and the rest are borrowed from a few other workers.
+TEST(ReferenceCountPerfTest, DISABLED_TestMemoryPerReference) {
+  const int num_refs = 10 * 1000 * 1000;
+  rpc::Address address;
+  address.set_ip_address("10.0.0.1");
+  address.set_port(12345);
+  address.set_raylet_id(NodeID::FromRandom().Binary());
+  address.set_worker_id(WorkerID::FromRandom().Binary());
+  ReferenceCounter rc(address);
+  std::vector<rpc::Address> borrowed_owners;
+  for (int i = 0; i < 10; i++) {
+    auto owner = address;
+    owner.set_port(i);
+    owner.set_worker_id(WorkerID::FromRandom().Binary());
+    borrowed_owners.push_back(owner);
+  }
+  std::vector<std::string> call_sites;
+  for (int i = 0; i < 100; i++) {
+    call_sites.push_back("(task call) /home/ray/workload.py:" + std::to_string(i) +
+                         ":run_stage");
+  }
+  std::vector<ObjectID> ids;
+  ids.reserve(num_refs);
+  const auto task_id = TaskID::ForFakeTask();
+  for (int i = 0; i < num_refs; i++) {
+    ids.push_back(ObjectID::FromIndex(task_id, i + 1));
+  }
+
+  int64_t rss_before = ResidentBytes();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_refs; i++) {
+    const auto &call_site = call_sites[i % call_sites.size()];
+    if (i % 10 == 0) {
+      rc.AddLocalReference(ids[i], call_site);
+      rc.AddBorrowedObject(ids[i], ObjectID::Nil(),
+                           borrowed_owners[i / 10 % borrowed_owners.size()]);
+    } else {
+      rc.AddOwnedObject(ids[i], {}, address, call_site, 1024, true);
+      rc.AddLocalReference(ids[i], call_site);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  int64_t rss_after = ResidentBytes();
+  ASSERT_EQ(rc.NumObjectIDsInScope(), num_refs);
+  RAY_LOG(INFO) << num_refs << " references: "
+                << (rss_after - rss_before) / num_refs << " bytes per reference, "
+                << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                           .count() /
+                       num_refs
+                << "ns per reference added";
+
+  for (const auto &id : ids) {
+    rc.RemoveLocalReference(id, nullptr);
+  }
+  ASSERT_EQ(rc.NumObjectIDsInScope(), 0);
+}
+
+/// Measure the throughput of threads that create, pass to tasks and release
+/// references to different objects, e.g., Python threads that release ObjectRefs while
+/// the gRPC threads process task completions.
+TEST(ReferenceCountPerfTest, DISABLED_TestConcurrentReferences) {
+  const int num_objects = 10000;
+  const int num_rounds = 20;
+  rpc::Address address;
+  address.set_ip_address("10.0.0.1");
+  address.set_port(12345);
+  address.set_raylet_id(NodeID::FromRandom().Binary());
+  address.set_worker_id(WorkerID::FromRandom().Binary());
+  rpc::Address worker_address = address;
+  worker_address.set_port(12346);
+  worker_address.set_worker_id(WorkerID::FromRandom().Binary());
+  for (int num_threads : {1, 2, 4, 8}) {
+    ReferenceCounter rc(address);
+    std::vector<std::vector<ObjectID>> ids(num_threads);
+    for (auto &thread_ids : ids) {
+      const auto task_id = TaskID::ForFakeTask();
+      for (int i = 0; i < num_objects; i++) {
+        thread_ids.push_back(ObjectID::FromIndex(task_id, i + 1));
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (const auto &thread_ids : ids) {
+      threads.emplace_back([&rc, &address, &worker_address, &thread_ids]() {
+        const ReferenceCounter::ReferenceTableProto borrowed_refs;
+        std::vector<ObjectID> deleted;
+        rpc::Address owner_address;
+        for (int round = 0; round < num_rounds; round++) {
+          for (const auto &id : thread_ids) {
+            rc.AddOwnedObject(id, {}, address, "", 1024, true);
+            rc.AddLocalReference(id, "");
+            rc.UpdateSubmittedTaskReferences({id});
+            rc.AddLocalReference(id, "");
+            rc.RemoveLocalReference(id, &deleted);
+            rc.GetOwner(id, &owner_address);
+            rc.UpdateFinishedTaskReferences({id}, /*release_lineage=*/true,
+                                            worker_address, borrowed_refs, &deleted);
+            rc.RemoveLocalReference(id, &deleted);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(rc.NumObjectIDsInScope(), 0);
+    const int64_t num_ops = 8L * num_threads * num_objects * num_rounds;
+    RAY_LOG(INFO) << num_threads << " threads: "
+                  << num_ops * 1000 /
+                         std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                                 start)
+                             .count()
+                  << " operations per ms";
+  }
+}
+
+/// Client of a borrower that measures the time that the owner takes to handle its
+/// replies.
+class TimedWorkerClient : public rpc::CoreWorkerClientInterface {
+ public:
+  TimedWorkerClient(std::shared_ptr<MockWorkerClient> borrower, int64_t *reply_ns)
+      : borrower_(borrower), reply_ns_(reply_ns) {}
+
+  void WaitForRefRemoved(
+      const rpc::WaitForRefRemovedRequest &request,
+      const rpc::ClientCallback<rpc::WaitForRefRemovedReply> &callback) override {
+    borrower_->WaitForRefRemoved(request, Timed(callback));
+  }
+
+  void WaitForRefsRemoved(
+      const rpc::WaitForRefsRemovedRequest &request,
+      const rpc::ClientCallback<rpc::WaitForRefsRemovedReply> &callback) override {
+    borrower_->WaitForRefsRemoved(request, Timed(callback));
+  }
+
+ private:
+  template <typename Reply>
+  rpc::ClientCallback<Reply> Timed(const rpc::ClientCallback<Reply> &callback) {
+    auto reply_ns = reply_ns_;
+    return [callback, reply_ns](const Status &status, const Reply &reply) {
+      auto start = std::chrono::steady_clock::now();
+      callback(status, reply);
+      *reply_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    };
+  }
+
+  std::shared_ptr<MockWorkerClient> borrower_;
+  int64_t *reply_ns_;
+};
+
+/// Measure the RPCs between the owner of the objects of a shuffle and the reducers
+/// that borrow them, and the time that the owner spends on the borrowers, with and
+/// without batching. Each reducer borrows many objects, and stops using them once it
+/// is done.
+TEST(ReferenceCountPerfTest, DISABLED_TestBatchedRefRemovedShuffle) {
+  const int num_reducers = 10;
+  const int num_objects_per_reducer = 10000;
+  for (bool batched : {false, true}) {
+    boost::asio::io_service owner_io_service;
+    boost::asio::io_service reducer_io_service;
+    std::vector<std::shared_ptr<MockWorkerClient>> reducers;
+    for (int i = 0; i < num_reducers; i++) {
+      reducers.push_back(std::make_shared<MockWorkerClient>(
+          std::to_string(i), nullptr, batched ? &reducer_io_service : nullptr));
+    }
+    int64_t owner_ns = 0;
+    auto owner = std::make_shared<MockWorkerClient>(
+        "owner",
+        [&](const rpc::Address &addr) {
+          for (const auto &reducer : reducers) {
+            if (reducer->address_.worker_id() == addr.worker_id()) {
+              return std::make_shared<TimedWorkerClient>(reducer, &owner_ns);
+            }
+          }
+          return std::shared_ptr<TimedWorkerClient>();
+        },
+        batched ? &owner_io_service : nullptr);
+
+    // Each reducer is given references to its objects, and keeps them after its task
+    // returns.
+    std::vector<std::vector<ObjectID>> ids(num_reducers);
+    std::vector<ReferenceCounter::ReferenceTableProto> reducer_refs(num_reducers);
+    for (int i = 0; i < num_reducers; i++) {
+      const auto task_id = TaskID::ForFakeTask();
+      for (int j = 0; j < num_objects_per_reducer; j++) {
+        ids[i].push_back(ObjectID::FromIndex(task_id, j + 1));
+        owner->Put(ids[i].back());
+      }
+      owner->rc_.UpdateSubmittedTaskReferences(ids[i]);
+      for (const auto &id : ids[i]) {
+        owner->rc_.RemoveLocalReference(id, nullptr);
+        reducers[i]->rc_.AddLocalReference(id, "");
+        reducers[i]->rc_.AddLocalReference(id, "");
+        reducers[i]->rc_.AddBorrowedObject(id, ObjectID::Nil(), owner->address_);
+      }
+      reducers[i]->rc_.GetAndClearLocalBorrowers(ids[i], &reducer_refs[i]);
+      for (const auto &id : ids[i]) {
+        reducers[i]->rc_.RemoveLocalReference(id, nullptr);
+      }
+    }
+
+    // The reducer tasks return, and the owner waits for the reducers to stop using
+    // the objects.
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_reducers; i++) {
+      owner->rc_.UpdateFinishedTaskReferences(ids[i], false, reducers[i]->address_,
+                                              reducer_refs[i], nullptr);
+    }
+    owner_io_service.run();
+    owner_io_service.reset();
+    owner_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+    // The reducers stop using the objects.
+    for (int i = 0; i < num_reducers; i++) {
+      reducers[i]->FlushBorrowerCallbacks();
+      for (const auto &id : ids[i]) {
+        reducers[i]->rc_.RemoveLocalReference(id, nullptr);
+      }
+    }
+    reducer_io_service.run();
+    ASSERT_EQ(owner->rc_.NumObjectIDsInScope(), 0);
+
+    int num_rpcs = 0;
+    for (const auto &reducer : reducers) {
+      num_rpcs += reducer->num_requests_ + reducer->num_batch_requests_;
+    }
+    RAY_LOG(INFO) << (batched ? "Batched" : "Not batched") << ": " << num_rpcs
+                  << " RPCs for " << num_reducers * num_objects_per_reducer
+                  << " borrowed objects, owner time " << owner_ns / 1000000 << "ms";
+  }
+}
+
+/// Measure the requests that the owner sends to a borrower that stops using many
+/// objects gradually, a few at a time, like a reducer that frees its inputs as it
+/// consumes them.
+TEST(ReferenceCountPerfTest, DISABLED_TestBatchedRefRemovedGradually) {
+  const int num_objects = 10000;
+  const int num_objects_per_step = 100;
+  boost::asio::io_service owner_io_service;
+  boost::asio::io_service borrower_io_service;
+  auto borrower = std::make_shared<MockWorkerClient>("1", nullptr, &borrower_io_service);
+  auto owner = std::make_shared<MockWorkerClient>(
+      "2", [&](const rpc::Address &addr) { return borrower; }, &owner_io_service);
+
+  std::vector<ObjectID> ids;
+  const auto task_id = TaskID::ForFakeTask();
+  for (int i = 0; i < num_objects; i++) {
+    ids.push_back(ObjectID::FromIndex(task_id, i + 1));
+    owner->Put(ids.back());
+  }
+  owner->rc_.UpdateSubmittedTaskReferences(ids);
+  for (const auto &id : ids) {
+    owner->rc_.RemoveLocalReference(id, nullptr);
+    borrower->rc_.AddLocalReference(id, "");
+    borrower->rc_.AddLocalReference(id, "");
+    borrower->rc_.AddBorrowedObject(id, ObjectID::Nil(), owner->address_);
+  }
+  ReferenceCounter::ReferenceTableProto borrower_refs;
+  borrower->rc_.GetAndClearLocalBorrowers(ids, &borrower_refs);
+  for (const auto &id : ids) {
+    borrower->rc_.RemoveLocalReference(id, nullptr);
+  }
+  owner->rc_.UpdateFinishedTaskReferences(ids, false, borrower->address_, borrower_refs,
+                                          nullptr);
+  owner_io_service.run();
+  owner_io_service.reset();
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_objects; i += num_objects_per_step) {
+    borrower->FlushBorrowerCallbacks();
+    for (int j = i; j < i + num_objects_per_step; j++) {
+      borrower->rc_.RemoveLocalReference(ids[j], nullptr);
+    }
+    borrower_io_service.run();
+    borrower_io_service.reset();
+    owner_io_service.run();
+    owner_io_service.reset();
+  }
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(owner->rc_.NumObjectIDsInScope(), 0);
+  RAY_LOG(INFO) << borrower->num_batch_requests_ << " requests of "
+                << borrower->batch_request_bytes_ << " bytes for " << num_objects
+                << " objects released in " << num_objects / num_objects_per_step
+                << " steps, "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+                       .count()
+                << "ms";
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
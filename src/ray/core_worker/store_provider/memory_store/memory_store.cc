@@ -116,22 +116,164 @@ CoreWorkerMemoryStore::CoreWorkerMemoryStore(
     std::function<void(const RayObject &, const ObjectID &)> store_in_plasma,
     std::shared_ptr<ReferenceCounter> counter,
     std::shared_ptr<raylet::RayletClient> raylet_client,
-    std::function<Status()> check_signals)
+    std::function<Status()> check_signals, int64_t max_bytes,
+    std::function<Status(const RayObject &, const ObjectID &)> spill_to_plasma,
+    std::function<void(const ObjectID &)> release_from_plasma,
+    std::function<void(std::function<void()>)> post_spill)
     : store_in_plasma_(store_in_plasma),
+      spill_to_plasma_(spill_to_plasma),
+      release_from_plasma_(release_from_plasma),
+      post_spill_(post_spill),
       ref_counter_(counter),
       raylet_client_(raylet_client),
-      check_signals_(check_signals) {}
+      check_signals_(check_signals),
+      max_bytes_(std::max<int64_t>(max_bytes, 0)) {
+  RAY_CHECK(max_bytes <= 0 || (spill_to_plasma_ != nullptr &&
+                               release_from_plasma_ != nullptr && post_spill_ != nullptr))
+      << "Cannot bound the memory store without spilling callbacks.";
+}
+
+void CoreWorkerMemoryStore::MarkAccessed(Shard &shard, const ObjectID &object_id) {
+  if (max_bytes_ == 0) {
+    return;
+  }
+  auto it = shard.spill_candidates.find(object_id);
+  if (it != shard.spill_candidates.end()) {
+    it->second->accessed.store(true, std::memory_order_relaxed);
+  }
+}
+
+void CoreWorkerMemoryStore::TrackObject(Shard &shard, const ObjectID &object_id,
+                                        int64_t size,
+                                        absl::optional<uint64_t> sequence) {
+  auto it = shard.spill_queue.emplace(
+      sequence ? shard.spill_queue.begin() : shard.spill_queue.end(), object_id, size,
+      sequence ? *sequence : next_spill_sequence_.fetch_add(1));
+  shard.spill_candidates.emplace(object_id, it);
+  spill_candidate_bytes_ += size;
+}
+
+void CoreWorkerMemoryStore::UntrackObject(Shard &shard, const ObjectID &object_id) {
+  auto it = shard.spill_candidates.find(object_id);
+  if (it != shard.spill_candidates.end()) {
+    spill_candidate_bytes_ -= it->second->size;
+    shard.spill_queue.erase(it->second);
+    shard.spill_candidates.erase(it);
+  }
+}
+
+bool CoreWorkerMemoryStore::SelectObjectToSpill(Shard **shard, ObjectID *object_id,
+                                                std::shared_ptr<RayObject> *object,
+                                                uint64_t *sequence) {
+  // Objects queued from now on were read during this selection, or were put after it
+  // started. They are spilled without going back to the queue again, so that objects
+  // that are read all the time cannot keep the selection going.
+  const uint64_t first_new_sequence = next_spill_sequence_.load();
+  while (spill_candidate_bytes_ > max_bytes_) {
+    // Find the shard whose first candidate was queued first.
+    Shard *oldest = nullptr;
+    uint64_t oldest_sequence = 0;
+    for (auto &candidate_shard : shards_) {
+      absl::ReaderMutexLock lock(&candidate_shard.mu);
+      if (!candidate_shard.spill_queue.empty() &&
+          (oldest == nullptr ||
+           candidate_shard.spill_queue.front().sequence < oldest_sequence)) {
+        oldest = &candidate_shard;
+        oldest_sequence = candidate_shard.spill_queue.front().sequence;
+      }
+    }
+    if (oldest == nullptr) {
+      return false;
+    }
+
+    absl::MutexLock lock(&oldest->mu);
+    // The queue may have changed since we looked at it. Its new first candidate is
+    // still one of the oldest, so we take it anyway.
+    if (oldest->spill_queue.empty()) {
+      continue;
+    }
+    auto &candidate = oldest->spill_queue.front();
+    if (candidate.sequence < first_new_sequence &&
+        candidate.accessed.load(std::memory_order_relaxed)) {
+      candidate.accessed.store(false, std::memory_order_relaxed);
+      candidate.sequence = next_spill_sequence_.fetch_add(1);
+      oldest->spill_queue.splice(oldest->spill_queue.end(), oldest->spill_queue,
+                                 oldest->spill_queue.begin());
+      continue;
+    }
+    *shard = oldest;
+    *object_id = candidate.object_id;
+    *object = oldest->objects[candidate.object_id];
+    *sequence = candidate.sequence;
+    UntrackObject(*oldest, *object_id);
+    return true;
+  }
+  return false;
+}
+
+void CoreWorkerMemoryStore::ScheduleSpill() {
+  if (!spill_scheduled_.exchange(true)) {
+    post_spill_([this]() { SpillObjects(); });
+  }
+}
+
+void CoreWorkerMemoryStore::SpillObjects() {
+  // Clear the flag first, so that a put that goes over the budget while we spill
+  // schedules another spill.
+  spill_scheduled_.store(false);
+  Shard *shard;
+  ObjectID object_id;
+  std::shared_ptr<RayObject> object;
+  uint64_t sequence;
+  while (SelectObjectToSpill(&shard, &object_id, &object, &sequence)) {
+    // The object stays readable from memory until it is in plasma.
+    auto status = spill_to_plasma_(*object, object_id);
+    bool deleted = false;
+    {
+      absl::MutexLock lock(&shard->mu);
+      auto it = shard->objects.find(object_id);
+      if (it == shard->objects.end() || it->second != object) {
+        deleted = true;
+      } else if (!status.ok()) {
+        RAY_LOG(WARNING) << "Failed to spill object " << object_id
+                         << " to plasma, keeping it in memory: " << status;
+        // Put the object back at the front of its queue, so that the next spill
+        // retries it first.
+        TrackObject(*shard, object_id, object->GetSize(), sequence);
+        return;
+      } else {
+        it->second = std::make_shared<RayObject>(rpc::ErrorType::OBJECT_IN_PLASMA);
+      }
+    }
+    // The object was deleted while it was spilled. Nothing refers to the plasma
+    // copy anymore, since the store never had a marker for it.
+    if (deleted && status.ok()) {
+      release_from_plasma_(object_id);
+    }
+  }
+}
 
 void CoreWorkerMemoryStore::GetAsync(
     const ObjectID &object_id, std::function<void(std::shared_ptr<RayObject>)> callback) {
+  auto &shard = GetShard(object_id);
   std::shared_ptr<RayObject> ptr;
   {
-    absl::MutexLock lock(&mu_);
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    absl::ReaderMutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
+      ptr = iter->second;
+      MarkAccessed(shard, object_id);
+    }
+  }
+  if (ptr == nullptr) {
+    absl::MutexLock lock(&shard.mu);
+    // The object may have been put since it was looked up.
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       ptr = iter->second;
+      MarkAccessed(shard, object_id);
     } else {
-      object_async_get_requests_[object_id].push_back(callback);
+      shard.object_async_get_requests[object_id].push_back(callback);
     }
   }
   // It's important for performance to run the callback outside the lock.
@@ -142,18 +284,33 @@ void CoreWorkerMemoryStore::GetAsync(
 
 std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetOrPromoteToPlasma(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mu_);
-  auto iter = objects_.find(object_id);
-  if (iter != objects_.end()) {
+  auto &shard = GetShard(object_id);
+  {
+    absl::ReaderMutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
+      auto obj = iter->second;
+      if (obj->IsInPlasmaError()) {
+        return nullptr;
+      }
+      MarkAccessed(shard, object_id);
+      return obj;
+    }
+  }
+  absl::MutexLock lock(&shard.mu);
+  // The object may have been put since it was looked up.
+  auto iter = shard.objects.find(object_id);
+  if (iter != shard.objects.end()) {
     auto obj = iter->second;
     if (obj->IsInPlasmaError()) {
       return nullptr;
     }
+    MarkAccessed(shard, object_id);
     return obj;
   }
   RAY_CHECK(store_in_plasma_ != nullptr)
       << "Cannot promote object without plasma provider callback.";
-  promoted_to_plasma_.insert(object_id);
+  shard.promoted_to_plasma.insert(object_id);
   return nullptr;
 }
 
@@ -166,33 +323,35 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
   // TODO(edoakes): we should instead return a flag to the caller to put the object in
   // plasma.
   bool should_put_in_plasma = false;
+  bool should_spill = false;
   {
-    absl::MutexLock lock(&mu_);
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
 
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       return true;  // Object already exists in the store, which is fine.
     }
 
-    auto async_callback_it = object_async_get_requests_.find(object_id);
-    if (async_callback_it != object_async_get_requests_.end()) {
+    auto async_callback_it = shard.object_async_get_requests.find(object_id);
+    if (async_callback_it != shard.object_async_get_requests.end()) {
       auto &callbacks = async_callback_it->second;
       async_callbacks = std::move(callbacks);
-      object_async_get_requests_.erase(async_callback_it);
+      shard.object_async_get_requests.erase(async_callback_it);
     }
 
-    auto promoted_it = promoted_to_plasma_.find(object_id);
-    if (promoted_it != promoted_to_plasma_.end()) {
+    auto promoted_it = shard.promoted_to_plasma.find(object_id);
+    if (promoted_it != shard.promoted_to_plasma.end()) {
       RAY_CHECK(store_in_plasma_ != nullptr);
       // Only need to promote to plasma if it wasn't already put into plasma
       // by the task that created the object.
       should_put_in_plasma = !object.IsInPlasmaError();
-      promoted_to_plasma_.erase(promoted_it);
+      shard.promoted_to_plasma.erase(promoted_it);
     }
 
     bool should_add_entry = true;
-    auto object_request_iter = object_get_requests_.find(object_id);
-    if (object_request_iter != object_get_requests_.end()) {
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
       auto &get_requests = object_request_iter->second;
       for (auto &get_request : get_requests) {
         get_request->Set(object_id, object_entry);
@@ -209,7 +368,12 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
 
     if (should_add_entry) {
       // If there is no existing get request, then add the `RayObject` to map.
-      objects_.emplace(object_id, object_entry);
+      shard.objects.emplace(object_id, object_entry);
+      // Objects that are already in plasma, or errors, are never spilled.
+      if (max_bytes_ > 0 && !should_put_in_plasma && !object_entry->IsException()) {
+        TrackObject(shard, object_id, object_entry->GetSize());
+        should_spill = spill_candidate_bytes_ > max_bytes_;
+      }
     }
   }
 
@@ -220,6 +384,9 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
     store_in_plasma_(object, object_id);
     stored_in_direct_memory = false;
   }
+  if (should_spill) {
+    ScheduleSpill();
+  }
 
   // It's important for performance to run the callbacks outside the lock.
   for (const auto &cb : async_callbacks) {
@@ -251,15 +418,17 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     absl::flat_hash_set<ObjectID> remaining_ids;
     absl::flat_hash_set<ObjectID> ids_to_remove;
 
-    absl::MutexLock lock(&mu_);
     // Check for existing objects and see if this get request can be fullfilled.
     for (size_t i = 0; i < object_ids.size() && count < num_objects; i++) {
       const auto &object_id = object_ids[i];
-      auto iter = objects_.find(object_id);
-      if (iter != objects_.end()) {
+      auto &shard = GetShard(object_id);
+      absl::ReaderMutexLock lock(&shard.mu);
+      auto iter = shard.objects.find(object_id);
+      if (iter != shard.objects.end()) {
         (*results)[i] = iter->second;
+        MarkAccessed(shard, object_id);
         if (remove_after_get) {
-          // Note that we cannot remove the object_id from `objects_` now,
+          // Note that we cannot remove the object_id from the store now,
           // because `object_ids` might have duplicate ids.
           ids_to_remove.insert(object_id);
         }
@@ -273,7 +442,10 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     // Clean up the objects if ref counting is off.
     if (ref_counter_ == nullptr) {
       for (const auto &object_id : ids_to_remove) {
-        objects_.erase(object_id);
+        auto &shard = GetShard(object_id);
+        absl::MutexLock lock(&shard.mu);
+        shard.objects.erase(object_id);
+        UntrackObject(shard, object_id);
       }
     }
 
@@ -289,7 +461,20 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
         std::make_shared<GetRequest>(std::move(remaining_ids), required_objects,
                                      remove_after_get, abort_if_any_object_is_exception);
     for (const auto &object_id : get_request->ObjectIds()) {
-      object_get_requests_[object_id].push_back(get_request);
+      auto &shard = GetShard(object_id);
+      absl::MutexLock lock(&shard.mu);
+      // The object may have been put since it was looked up.
+      auto iter = shard.objects.find(object_id);
+      if (iter != shard.objects.end()) {
+        get_request->Set(object_id, iter->second);
+        MarkAccessed(shard, object_id);
+        if (remove_after_get && ref_counter_ == nullptr) {
+          shard.objects.erase(iter);
+          UntrackObject(shard, object_id);
+        }
+      } else {
+        shard.object_get_requests[object_id].push_back(get_request);
+      }
     }
   }
 
@@ -333,29 +518,28 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     RAY_CHECK_OK(raylet_client_->NotifyDirectCallTaskUnblocked());
   }
 
-  {
-    absl::MutexLock lock(&mu_);
-    // Populate results.
-    for (size_t i = 0; i < object_ids.size(); i++) {
-      const auto &object_id = object_ids[i];
-      if ((*results)[i] == nullptr) {
-        (*results)[i] = get_request->Get(object_id);
-      }
+  // Populate results.
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    const auto &object_id = object_ids[i];
+    if ((*results)[i] == nullptr) {
+      (*results)[i] = get_request->Get(object_id);
     }
+  }
 
-    // Remove get request.
-    for (const auto &object_id : get_request->ObjectIds()) {
-      auto object_request_iter = object_get_requests_.find(object_id);
-      if (object_request_iter != object_get_requests_.end()) {
-        auto &get_requests = object_request_iter->second;
-        // Erase get_request from the vector.
-        auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
-        if (it != get_requests.end()) {
-          get_requests.erase(it);
-          // If the vector is empty, remove the object ID from the map.
-          if (get_requests.empty()) {
-            object_get_requests_.erase(object_request_iter);
-          }
+  // Remove get request.
+  for (const auto &object_id : get_request->ObjectIds()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
+      auto &get_requests = object_request_iter->second;
+      // Erase get_request from the vector.
+      auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
+      if (it != get_requests.end()) {
+        get_requests.erase(it);
+        // If the vector is empty, remove the object ID from the map.
+        if (get_requests.empty()) {
+          shard.object_get_requests.erase(object_request_iter);
         }
       }
     }
@@ -419,30 +603,35 @@ Status CoreWorkerMemoryStore::Wait(const absl::flat_hash_set<ObjectID> &object_i
 
 void CoreWorkerMemoryStore::Delete(const absl::flat_hash_set<ObjectID> &object_ids,
                                    absl::flat_hash_set<ObjectID> *plasma_ids_to_delete) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    auto it = objects_.find(object_id);
-    if (it != objects_.end()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.objects.find(object_id);
+    if (it != shard.objects.end()) {
       if (it->second->IsInPlasmaError()) {
         plasma_ids_to_delete->insert(object_id);
       } else {
-        objects_.erase(it);
+        shard.objects.erase(it);
+        UntrackObject(shard, object_id);
       }
     }
   }
 }
 
 void CoreWorkerMemoryStore::Delete(const std::vector<ObjectID> &object_ids) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    objects_.erase(object_id);
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    shard.objects.erase(object_id);
+    UntrackObject(shard, object_id);
   }
 }
 
 bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma) {
-  absl::MutexLock lock(&mu_);
-  auto it = objects_.find(object_id);
-  if (it != objects_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mu);
+  auto it = shard.objects.find(object_id);
+  if (it != shard.objects.end()) {
     if (it->second->IsInPlasmaError()) {
       *in_plasma = true;
     }
@@ -452,14 +641,16 @@ bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma)
 }
 
 MemoryStoreStats CoreWorkerMemoryStore::GetMemoryStoreStatisticalData() {
-  absl::MutexLock lock(&mu_);
   MemoryStoreStats item;
-  for (const auto &it : objects_) {
-    if (it.second->IsInPlasmaError()) {
-      item.num_in_plasma += 1;
-    } else {
-      item.num_local_objects += 1;
-      item.used_object_store_memory += it.second->GetSize();
+  for (auto &shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mu);
+    for (const auto &it : shard.objects) {
+      if (it.second->IsInPlasmaError()) {
+        item.num_in_plasma += 1;
+      } else {
+        item.num_local_objects += 1;
+        item.used_object_store_memory += it.second->GetSize();
+      }
     }
   }
   return item;
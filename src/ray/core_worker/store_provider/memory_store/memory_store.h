@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <list>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
 #include "ray/core_worker/common.h"
@@ -23,19 +28,43 @@ class CoreWorkerMemoryStore;
 /// The class provides implementations for local process memory store.
 /// An example usage for this is to retrieve the returned objects from direct
 /// actor call (see direct_actor_transport.cc).
+///
+/// The objects and the requests for them are sharded by object ID, each shard with its
+/// own lock, so that threads working on different objects do not contend. Since an
+/// object is only ever replaced by a marker that it was spilled to plasma, looking up an
+/// object that is already in the store only takes its shard's lock in shared mode.
+///
+/// If the store has a memory budget, the objects that do not fit in it are spilled to
+/// plasma through `spill_to_plasma`, least recently used first. Spilling runs through
+/// `post_spill` rather than in Put(), so that callers of Put() never wait on plasma. A
+/// spilled object is replaced by an ErrorType::OBJECT_IN_PLASMA marker, like the
+/// objects that were put in plasma in the first place, so callers fetch it from plasma.
 class CoreWorkerMemoryStore {
  public:
   /// Create a memory store.
   ///
-  /// \param[in] store_in_plasma If not null, this is used to spill to plasma.
+  /// \param[in] store_in_plasma If not null, this is used to promote objects to plasma.
   /// \param[in] counter If not null, this enables ref counting for local objects,
   ///            and the `remove_after_get` flag for Get() will be ignored.
   /// \param[in] raylet_client If not null, used to notify tasks blocked / unblocked.
+  /// \param[in] max_bytes If positive, objects are spilled to plasma to keep the
+  ///            memory used by the store under this many bytes. This requires the
+  ///            three callbacks below.
+  /// \param[in] spill_to_plasma Stores a spilled object in plasma. Unlike
+  ///            `store_in_plasma`, this must not call back into the store.
+  /// \param[in] release_from_plasma Releases the plasma copy of an object that was
+  ///            deleted from the store while it was being spilled.
+  /// \param[in] post_spill Runs the spilling of the objects over the budget, e.g., on
+  ///            a background thread. The store must outlive the posted function.
   CoreWorkerMemoryStore(
       std::function<void(const RayObject &, const ObjectID &)> store_in_plasma = nullptr,
       std::shared_ptr<ReferenceCounter> counter = nullptr,
       std::shared_ptr<raylet::RayletClient> raylet_client = nullptr,
-      std::function<Status()> check_signals = nullptr);
+      std::function<Status()> check_signals = nullptr, int64_t max_bytes = 0,
+      std::function<Status(const RayObject &, const ObjectID &)> spill_to_plasma =
+          nullptr,
+      std::function<void(const ObjectID &)> release_from_plasma = nullptr,
+      std::function<void(std::function<void()>)> post_spill = nullptr);
   ~CoreWorkerMemoryStore(){};
 
   /// Put an object with specified ID into object store.
@@ -120,8 +149,12 @@ class CoreWorkerMemoryStore {
   ///
   /// \return Count of objects in the store.
   int Size() {
-    absl::MutexLock lock(&mu_);
-    return objects_.size();
+    int size = 0;
+    for (auto &shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mu);
+      size += shard.objects.size();
+    }
+    return size;
   }
 
   /// Returns stats data of memory usage.
@@ -146,6 +179,11 @@ class CoreWorkerMemoryStore {
   /// Optional callback for putting objects into the plasma store.
   std::function<void(const RayObject &, const ObjectID &)> store_in_plasma_;
 
+  /// Callbacks used to spill objects to plasma, see the constructor.
+  std::function<Status(const RayObject &, const ObjectID &)> spill_to_plasma_;
+  std::function<void(const ObjectID &)> release_from_plasma_;
+  std::function<void(std::function<void()>)> post_spill_;
+
   /// If enabled, holds a reference to local worker ref counter. TODO(ekl) make this
   /// mandatory once Java is supported.
   std::shared_ptr<ReferenceCounter> ref_counter_ = nullptr;
@@ -153,26 +191,115 @@ class CoreWorkerMemoryStore {
   // If set, this will be used to notify worker blocked / unblocked on get calls.
   std::shared_ptr<raylet::RayletClient> raylet_client_ = nullptr;
 
-  /// Protects the data structures below.
-  mutable absl::Mutex mu_;
+  /// An object that may be spilled to plasma.
+  struct SpillCandidate {
+    SpillCandidate(const ObjectID &object_id, int64_t size, uint64_t sequence)
+        : object_id(object_id), size(size), sequence(sequence) {}
+
+    const ObjectID object_id;
+    const int64_t size;
+    /// When the object was queued for spilling, which orders the candidates of all
+    /// the shards. Candidates are queued in increasing order within a shard.
+    uint64_t sequence;
+    /// Whether the object was read since it was last considered for spilling. This is
+    /// set with the shard's lock held in shared mode.
+    std::atomic<bool> accessed{false};
+  };
+
+  /// The objects whose ID maps to a shard, and the requests for them.
+  struct Shard {
+    /// Protects the data structures below.
+    absl::Mutex mu;
+
+    /// Set of objects that should be promoted to plasma once available.
+    absl::flat_hash_set<ObjectID> promoted_to_plasma GUARDED_BY(mu);
+
+    /// Map from object ID to `RayObject`.
+    absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> objects GUARDED_BY(mu);
+
+    /// Map from object ID to its get requests.
+    absl::flat_hash_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
+        object_get_requests GUARDED_BY(mu);
+
+    /// Map from object ID to its async get requests.
+    absl::flat_hash_map<ObjectID,
+                        std::vector<std::function<void(std::shared_ptr<RayObject>)>>>
+        object_async_get_requests GUARDED_BY(mu);
+
+    /// The objects that may be spilled to plasma, in the order in which they are
+    /// considered for spilling. Only used if the store has a memory budget.
+    std::list<SpillCandidate> spill_queue GUARDED_BY(mu);
+
+    /// Map from object ID to its position in `spill_queue`.
+    absl::flat_hash_map<ObjectID, std::list<SpillCandidate>::iterator> spill_candidates
+        GUARDED_BY(mu);
+  };
+
+  /// The number of shards of the store.
+  static constexpr size_t kNumShards = 32;
 
-  /// Set of objects that should be promoted to plasma once available.
-  absl::flat_hash_set<ObjectID> promoted_to_plasma_ GUARDED_BY(mu_);
+  /// Return the shard that holds an object.
+  Shard &GetShard(const ObjectID &object_id) {
+    return shards_[object_id.Hash() % kNumShards];
+  }
+
+  /// Record that an object was read, so that it is spilled after the objects that
+  /// were not.
+  void MarkAccessed(Shard &shard, const ObjectID &object_id)
+      SHARED_LOCKS_REQUIRED(shard.mu);
+
+  /// Start considering an object for spilling.
+  ///
+  /// \param[in] sequence If set, the object goes back to the front of the spill queue
+  /// with this sequence number, since it was taken from there. Otherwise, it is
+  /// spilled after the objects already considered.
+  void TrackObject(Shard &shard, const ObjectID &object_id, int64_t size,
+                   absl::optional<uint64_t> sequence = absl::nullopt)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
+
+  /// Stop considering an object for spilling, because it was removed from the store
+  /// or chosen to be spilled.
+  void UntrackObject(Shard &shard, const ObjectID &object_id)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.mu);
 
-  /// Map from object ID to `RayObject`.
-  absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> objects_ GUARDED_BY(mu_);
+  /// Choose the next object to spill: the front of the spill queue that was queued
+  /// first among all the shards. An object that was read since it was last considered
+  /// goes back to the end of its queue instead.
+  ///
+  /// \param[out] shard The shard of the object to spill.
+  /// \param[out] object_id The ID of the object to spill, which is no longer
+  /// considered for spilling. The caller must store the object in plasma without
+  /// holding the shard's lock.
+  /// \param[out] object The object to spill.
+  /// \param[out] sequence The sequence number that the object was queued with.
+  /// \return Whether there was an object to spill.
+  bool SelectObjectToSpill(Shard **shard, ObjectID *object_id,
+                           std::shared_ptr<RayObject> *object, uint64_t *sequence);
 
-  /// Map from object ID to its get requests.
-  absl::flat_hash_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
-      object_get_requests_ GUARDED_BY(mu_);
+  /// Post a call to SpillObjects(), unless one is already pending.
+  void ScheduleSpill();
 
-  /// Map from object ID to its async get requests.
-  absl::flat_hash_map<ObjectID,
-                      std::vector<std::function<void(std::shared_ptr<RayObject>)>>>
-      object_async_get_requests_ GUARDED_BY(mu_);
+  /// Spill objects to plasma until the store fits in its memory budget, and replace
+  /// them in the store by a marker that they are in plasma. If plasma cannot take an
+  /// object, the objects not spilled yet stay in memory until the next spill.
+  void SpillObjects();
+
+  std::array<Shard, kNumShards> shards_;
 
   /// Function passed in to be called to check for signals (e.g., Ctrl-C).
   std::function<Status()> check_signals_;
+
+  /// The memory budget of the store, or 0 if the store is unbounded.
+  const int64_t max_bytes_;
+
+  /// The total size of the objects in the spill queues of all the shards.
+  std::atomic<int64_t> spill_candidate_bytes_{0};
+
+  /// The sequence number of the next object queued for spilling.
+  std::atomic<uint64_t> next_spill_sequence_{0};
+
+  /// Whether a call to SpillObjects() was posted and has not started yet.
+  std::atomic<bool> spill_scheduled_{false};
 };
 
 }  // namespace ray
@@ -156,6 +156,100 @@ Status CoreWorkerPlasmaStoreProvider::Release(const ObjectID &object_id) {
   return Status::OK();
 }
 
+Status CoreWorkerPlasmaStoreProvider::Put(
+    const std::vector<std::shared_ptr<RayObject>> &objects,
+    const std::vector<ObjectID> &object_ids, const rpc::Address &owner_address,
+    std::vector<bool> *object_exists) {
+  RAY_CHECK(objects.size() == object_ids.size());
+  std::vector<std::shared_ptr<Buffer>> metadatas;
+  std::vector<size_t> data_sizes;
+  for (size_t i = 0; i < objects.size(); i++) {
+    RAY_CHECK(!objects[i]->IsInPlasmaError()) << object_ids[i];
+    metadatas.push_back(objects[i]->GetMetadata());
+    data_sizes.push_back(objects[i]->HasData() ? objects[i]->GetData()->Size() : 0);
+  }
+  std::vector<std::shared_ptr<Buffer>> data;
+  RAY_RETURN_NOT_OK(Create(metadatas, data_sizes, object_ids, owner_address, &data));
+  std::vector<ObjectID> created_ids;
+  object_exists->assign(objects.size(), true);
+  for (size_t i = 0; i < objects.size(); i++) {
+    // data could be a nullptr if the ObjectID already existed, but this does
+    // not throw an error.
+    if (data[i] != nullptr) {
+      if (objects[i]->HasData()) {
+        memcpy(data[i]->Data(), objects[i]->GetData()->Data(),
+               objects[i]->GetData()->Size());
+      }
+      created_ids.push_back(object_ids[i]);
+      (*object_exists)[i] = false;
+    }
+  }
+  if (!created_ids.empty()) {
+    RAY_RETURN_NOT_OK(Seal(created_ids));
+  }
+  return Status::OK();
+}
+
+Status CoreWorkerPlasmaStoreProvider::Create(
+    const std::vector<std::shared_ptr<Buffer>> &metadatas,
+    const std::vector<size_t> &data_sizes, const std::vector<ObjectID> &object_ids,
+    const rpc::Address &owner_address, std::vector<std::shared_ptr<Buffer>> *data) {
+  RAY_CHECK(object_ids.size() == metadatas.size());
+  RAY_CHECK(object_ids.size() == data_sizes.size());
+  std::vector<int64_t> plasma_data_sizes;
+  std::vector<const uint8_t *> plasma_metadatas;
+  std::vector<int64_t> plasma_metadata_sizes;
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    plasma_data_sizes.push_back(data_sizes[i]);
+    plasma_metadatas.push_back(metadatas[i] ? metadatas[i]->Data() : nullptr);
+    plasma_metadata_sizes.push_back(metadatas[i] ? metadatas[i]->Size() : 0);
+  }
+  // If we cannot retry, then always evict on the first attempt.
+  bool evict_if_full =
+      RayConfig::instance().object_store_full_max_retries() == 0 ? true : evict_if_full_;
+  std::vector<std::shared_ptr<arrow::Buffer>> arrow_buffers;
+  std::vector<Status> plasma_statuses;
+  {
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    RAY_RETURN_NOT_OK(store_client_.CreateBatch(
+        object_ids, owner_address, plasma_data_sizes, plasma_metadatas,
+        plasma_metadata_sizes, &arrow_buffers, &plasma_statuses, evict_if_full));
+  }
+  data->assign(object_ids.size(), nullptr);
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    const auto &plasma_status = plasma_statuses[i];
+    if (plasma_status.IsObjectStoreFull()) {
+      // Fall back to creating the object on its own, which waits for space to
+      // free up.
+      RAY_RETURN_NOT_OK(Create(metadatas[i], data_sizes[i], object_ids[i], owner_address,
+                               &(*data)[i]));
+    } else if (plasma_status.IsObjectExists()) {
+      RAY_LOG(WARNING) << "Trying to put an object that already existed in plasma: "
+                       << object_ids[i] << ".";
+    } else {
+      RAY_RETURN_NOT_OK(plasma_status);
+      (*data)[i] = std::make_shared<PlasmaBuffer>(PlasmaBuffer(arrow_buffers[i]));
+    }
+  }
+  return Status::OK();
+}
+
+Status CoreWorkerPlasmaStoreProvider::Seal(const std::vector<ObjectID> &object_ids) {
+  {
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    RAY_RETURN_NOT_OK(store_client_.SealBatch(object_ids));
+  }
+  return Status::OK();
+}
+
+Status CoreWorkerPlasmaStoreProvider::Release(const std::vector<ObjectID> &object_ids) {
+  {
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    RAY_RETURN_NOT_OK(store_client_.ReleaseBatch(object_ids));
+  }
+  return Status::OK();
+}
+
 Status CoreWorkerPlasmaStoreProvider::FetchAndGetFromPlasmaStore(
     absl::flat_hash_set<ObjectID> &remaining, const std::vector<ObjectID> &batch_ids,
     int64_t timeout_ms, bool fetch_only, bool in_direct_call, const TaskID &task_id,
@@ -88,6 +88,46 @@ class CoreWorkerPlasmaStoreProvider {
   /// argument to Get to retrieve the object data.
   Status Release(const ObjectID &object_id);
 
+  /// Create and seal a number of objects with a single round trip to the store for
+  /// each step. This is equivalent to calling Put() on each object.
+  ///
+  /// \param[in] objects The objects to create.
+  /// \param[in] object_ids The IDs of the objects.
+  /// \param[in] owner_address The address of the objects' owner.
+  /// \param[out] object_exists Returns whether an object with the same ID already
+  /// existed, for each of the objects.
+  Status Put(const std::vector<std::shared_ptr<RayObject>> &objects,
+             const std::vector<ObjectID> &object_ids, const rpc::Address &owner_address,
+             std::vector<bool> *object_exists);
+
+  /// Create a number of objects in plasma with a single round trip to the store. This
+  /// is equivalent to calling Create() on each object. Objects that do not fit in the
+  /// store are retried one by one with the same backoff as Create().
+  ///
+  /// \param[in] metadatas The metadata of each object.
+  /// \param[in] data_sizes The size of each object.
+  /// \param[in] object_ids The IDs of the objects.
+  /// \param[in] owner_address The address of the objects' owner.
+  /// \param[out] data The mutable object buffers in plasma that can be written to. A
+  /// buffer is nullptr if the object already existed.
+  Status Create(const std::vector<std::shared_ptr<Buffer>> &metadatas,
+                const std::vector<size_t> &data_sizes,
+                const std::vector<ObjectID> &object_ids,
+                const rpc::Address &owner_address,
+                std::vector<std::shared_ptr<Buffer>> *data);
+
+  /// Seal a number of object buffers created with Create() with a single round trip
+  /// to the store.
+  ///
+  /// \param[in] object_ids The IDs of the objects.
+  Status Seal(const std::vector<ObjectID> &object_ids);
+
+  /// Release the first reference to a number of objects with a single message to the
+  /// store.
+  ///
+  /// \param[in] object_ids The IDs of the objects.
+  Status Release(const std::vector<ObjectID> &object_ids);
+
   Status Get(const absl::flat_hash_set<ObjectID> &object_ids, int64_t timeout_ms,
              const WorkerContext &ctx,
              absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results,
@@ -594,6 +594,49 @@ TEST_F(SingleNodeTest, TestDirectActorTaskSubmissionPerf) {
                 << ", which takes " << current_time_ms() - start_ms << " ms";
 }
 
+// Performance benchmark for putting objects in plasma one by one versus in a
+// single batch.
+TEST_F(SingleNodeTest, TestBatchedPlasmaPutPerf) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  // Each round has to fit in the 10MB test object store.
+  const int num_objects = 40;
+  // Large enough to skip the in-memory store.
+  const size_t object_size = RayConfig::instance().max_direct_call_object_size();
+  std::vector<uint8_t> array(object_size, 1);
+  std::vector<std::shared_ptr<RayObject>> objects;
+  for (int i = 0; i < num_objects; i++) {
+    objects.push_back(std::make_shared<RayObject>(
+        std::make_shared<LocalMemoryBuffer>(array.data(), array.size()), nullptr,
+        std::vector<ObjectID>()));
+  }
+
+  int64_t start_ms = current_time_ms();
+  std::vector<ObjectID> ids(num_objects);
+  for (int i = 0; i < num_objects; i++) {
+    RAY_CHECK_OK(core_worker.Put(*objects[i], {}, &ids[i]));
+  }
+  RAY_LOG(INFO) << "Finish putting " << num_objects << " objects one by one"
+                << ", which takes " << current_time_ms() - start_ms << " ms";
+  RAY_CHECK_OK(core_worker.Delete(ids, true, false));
+  // Wait for the plasma store to process the deletion, see TestObjectInterface.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  start_ms = current_time_ms();
+  std::vector<ObjectID> batch_ids;
+  RAY_CHECK_OK(core_worker.Put(
+      objects, std::vector<std::vector<ObjectID>>(num_objects), &batch_ids));
+  RAY_LOG(INFO) << "Finish putting " << num_objects << " objects in a batch"
+                << ", which takes " << current_time_ms() - start_ms << " ms";
+  ASSERT_EQ(batch_ids.size(), num_objects);
+
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(core_worker.Get(batch_ids, -1, &results));
+  ASSERT_EQ(results.size(), num_objects);
+  for (const auto &result : results) {
+    ASSERT_EQ(*result->GetData(), *objects[0]->GetData());
+  }
+}
+
 TEST_F(ZeroNodeTest, TestWorkerContext) {
   auto job_id = NextJobId();
 
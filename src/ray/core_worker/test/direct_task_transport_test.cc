@@ -33,6 +33,7 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
  public:
   void PushNormalTask(std::unique_ptr<rpc::PushTaskRequest> request,
                       const rpc::ClientCallback<rpc::PushTaskReply> &callback) override {
+    last_task_spec = request->task_spec();
     callbacks.push_back(callback);
   }
 
@@ -57,6 +58,7 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
 
   std::list<rpc::ClientCallback<rpc::PushTaskReply>> callbacks;
   std::list<rpc::CancelTaskRequest> kill_requests;
+  rpc::TaskSpec last_task_spec;
 };
 
 class MockTaskFinisher : public TaskFinisherInterface {
@@ -105,6 +107,7 @@ class MockRayletClient : public WorkerLeaseInterface {
       const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
       const int64_t backlog_size) override {
     num_workers_requested += 1;
+    last_resource_spec = resource_spec.GetMessage();
     callbacks.push_back(callback);
   }
 
@@ -163,10 +166,24 @@ class MockRayletClient : public WorkerLeaseInterface {
   int num_workers_returned = 0;
   int num_workers_disconnected = 0;
   int num_leases_canceled = 0;
+  rpc::TaskSpec last_resource_spec;
   std::list<rpc::ClientCallback<rpc::RequestWorkerLeaseReply>> callbacks = {};
   std::list<rpc::ClientCallback<rpc::CancelWorkerLeaseReply>> cancel_callbacks = {};
 };
 
+class MockLocalityDataProvider : public LocalityDataProviderInterface {
+ public:
+  absl::optional<LocalityData> GetLocalityData(const ObjectID &object_id) override {
+    auto it = locality_data.find(object_id);
+    if (it == locality_data.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
+  absl::flat_hash_map<ObjectID, LocalityData> locality_data;
+};
+
 class MockActorCreator : public ActorCreatorInterface {
  public:
   MockActorCreator() {}
@@ -985,6 +1002,251 @@ TEST(DirectTaskTransportTest, TestSchedulingKeys) {
   TestSchedulingKey(store, same_deps_1, same_deps_2, different_deps);
 }
 
+TEST(DirectTaskTransportTest, TestReuseWorkerAcrossSchedulingKeys) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  // Idle workers are reused, but not kept.
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, store, task_finisher, NodeID::Nil(),
+      kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      /*cancel_timer=*/absl::nullopt, /*locality_data_provider=*/nullptr,
+      /*idle_worker_timer=*/absl::nullopt, /*idle_worker_timeout_ms=*/100);
+
+  // Force plasma objects to be promoted.
+  ObjectID plasma1 = ObjectID::FromRandom();
+  ObjectID plasma2 = ObjectID::FromRandom();
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  auto plasma_data = RayObject(nullptr, meta_buffer, std::vector<ObjectID>());
+  ASSERT_TRUE(store->Put(plasma_data, plasma1));
+  ASSERT_TRUE(store->Put(plasma_data, plasma2));
+
+  // The tasks need the same resources, but have different scheduling keys because
+  // they depend on different plasma objects or have no dependencies.
+  std::unordered_map<std::string, double> resources({{"a", 1.0}});
+  ray::FunctionDescriptor descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("a", "", "", "");
+  TaskSpecification task1 = BuildTaskSpec(resources, descriptor);
+  task1.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      plasma1.Binary());
+  TaskSpecification task2 = BuildTaskSpec(resources, descriptor);
+  task2.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      plasma2.Binary());
+  TaskSpecification java_task = BuildTaskSpec(resources, descriptor);
+  java_task.GetMutableMessage().set_language(Language::JAVA);
+
+  ASSERT_TRUE(submitter.SubmitTask(task1).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task2).ok());
+  ASSERT_TRUE(submitter.SubmitTask(java_task).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+
+  // Task 1 is pushed.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+
+  // Task 1 runs successfully. The worker runs task 2 instead of being returned, and
+  // the lease request for task 2 is canceled.
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+  ASSERT_EQ(raylet_client->num_leases_canceled, 1);
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil(), true));
+
+  // Task 2 runs successfully. The worker is returned since the Java task needs a Java
+  // worker.
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+
+  // The Java task runs on its own worker.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1002, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 2);
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+
+  // Check that there are no entries left in the scheduling_key_entries_ hashmap. These
+  // would otherwise cause a memory leak.
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestReuseWorkerOnlyNearArguments) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto locality_data_provider = std::make_shared<MockLocalityDataProvider>();
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, store, task_finisher, NodeID::Nil(),
+      kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      /*cancel_timer=*/absl::nullopt, locality_data_provider,
+      /*idle_worker_timer=*/absl::nullopt, /*idle_worker_timeout_ms=*/100);
+
+  ObjectID plasma_arg = ObjectID::FromRandom();
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  ASSERT_TRUE(
+      store->Put(RayObject(nullptr, meta_buffer, std::vector<ObjectID>()), plasma_arg));
+  locality_data_provider->locality_data[plasma_arg] = {100, {NodeID::FromRandom()}};
+
+  // The tasks have different scheduling keys, and the argument of task 2 is on
+  // another node than the workers.
+  std::unordered_map<std::string, double> resources({{"a", 1.0}});
+  ray::FunctionDescriptor descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("a", "", "", "");
+  TaskSpecification task1 = BuildTaskSpec(resources, descriptor);
+  TaskSpecification task2 = BuildTaskSpec(resources, descriptor);
+  task2.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      plasma_arg.Binary());
+
+  ASSERT_TRUE(submitter.SubmitTask(task1).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task2).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+
+  // Task 1 runs successfully. The worker does not take task 2, since the raylet would
+  // run task 2 where its argument is, so it is returned.
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(raylet_client->num_leases_canceled, 0);
+
+  // Task 2 runs on the worker that was leased for it.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 2);
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestIdleWorkerKeptForReuse) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto locality_data_provider = std::make_shared<MockLocalityDataProvider>();
+  boost::asio::io_service io_service;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, store, task_finisher, NodeID::Nil(),
+      kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      /*cancel_timer=*/absl::nullopt, locality_data_provider,
+      boost::asio::steady_timer(io_service), /*idle_worker_timeout_ms=*/100);
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  TaskSpecification task1 = BuildTaskSpec(empty_resources, empty_descriptor);
+  TaskSpecification task2 = BuildTaskSpec(empty_resources, empty_descriptor);
+  TaskSpecification task3 = BuildTaskSpec(empty_resources, empty_descriptor);
+  ObjectID plasma_arg = ObjectID::FromRandom();
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  ASSERT_TRUE(
+      store->Put(RayObject(nullptr, meta_buffer, std::vector<ObjectID>()), plasma_arg));
+  locality_data_provider->locality_data[plasma_arg] = {100, {NodeID::FromRandom()}};
+  task3.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      plasma_arg.Binary());
+
+  ASSERT_TRUE(submitter.SubmitTask(task1).ok());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  // Task 1 runs successfully. The worker is kept although no task is queued.
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+
+  // Task 2 runs on the kept worker without requesting a new lease.
+  ASSERT_TRUE(submitter.SubmitTask(task2).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+
+  // Task 3 does not run on the kept worker, since its argument is on another node.
+  ASSERT_TRUE(submitter.SubmitTask(task3).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil()));
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+
+  // The workers are returned once they were idle for too long.
+  io_service.run();
+  ASSERT_EQ(raylet_client->num_workers_returned, 2);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestArgumentLocality) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto locality_data_provider = std::make_shared<MockLocalityDataProvider>();
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, store, task_finisher, NodeID::Nil(),
+      kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      /*cancel_timer=*/absl::nullopt, locality_data_provider);
+
+  ObjectID plasma1 = ObjectID::FromRandom();
+  ObjectID plasma2 = ObjectID::FromRandom();
+  ObjectID unknown = ObjectID::FromRandom();
+  std::string meta = std::to_string(static_cast<int>(rpc::ErrorType::OBJECT_IN_PLASMA));
+  auto metadata = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(meta.data()));
+  auto meta_buffer = std::make_shared<LocalMemoryBuffer>(metadata, meta.size());
+  auto plasma_data = RayObject(nullptr, meta_buffer, std::vector<ObjectID>());
+  for (const auto &object_id : {plasma1, plasma2, unknown}) {
+    ASSERT_TRUE(store->Put(plasma_data, object_id));
+  }
+  NodeID node1 = NodeID::FromRandom();
+  NodeID node2 = NodeID::FromRandom();
+  locality_data_provider->locality_data[plasma1] = {100, {node1, node2}};
+  locality_data_provider->locality_data[plasma2] = {50, {node2}};
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  TaskSpecification task = BuildTaskSpec(empty_resources, empty_descriptor);
+  for (const auto &object_id : {plasma1, plasma2, unknown}) {
+    task.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+        object_id.Binary());
+  }
+  ASSERT_TRUE(submitter.SubmitTask(task).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+
+  // The lease request holds the argument bytes on each node.
+  TaskSpecification resource_spec(raylet_client->last_resource_spec);
+  ASSERT_EQ(resource_spec.GetMessage().argument_locality_size(), 2);
+  ASSERT_EQ(resource_spec.GetPreferredNodes(0), std::vector<NodeID>{node2});
+  ASSERT_EQ(resource_spec.GetPreferredNodes(200).size(), 0);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1234, NodeID::Nil()));
+  // The locality is only sent to the raylet.
+  ASSERT_EQ(worker_client->last_task_spec.argument_locality_size(), 0);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+}
+
 TEST(DirectTaskTransportTest, TestWorkerLeaseTimeout) {
   rpc::Address address;
   auto raylet_client = std::make_shared<MockRayletClient>();
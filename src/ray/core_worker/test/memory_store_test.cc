@@ -0,0 +1,336 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/common/buffer.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+RayObject MakeObject(uint8_t *data, size_t size) {
+  return RayObject(std::make_shared<LocalMemoryBuffer>(data, size), nullptr,
+                   std::vector<ObjectID>());
+}
+
+class MemoryStoreTest : public ::testing::Test {
+ public:
+  MemoryStoreTest()
+      : store_(std::make_shared<CoreWorkerMemoryStore>()),
+        ctx_(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil()) {}
+
+ protected:
+  uint8_t data_[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::shared_ptr<CoreWorkerMemoryStore> store_;
+  WorkerContext ctx_;
+};
+
+// Objects are found and waited for across the shards of the store.
+TEST_F(MemoryStoreTest, TestGetAcrossShards) {
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 100; i++) {
+    ids.push_back(ObjectID::FromRandom());
+  }
+  for (size_t i = 0; i < ids.size() / 2; i++) {
+    ASSERT_TRUE(store_->Put(MakeObject(data_, sizeof(data_)), ids[i]));
+  }
+  ASSERT_EQ(store_->Size(), 50);
+  bool in_plasma = false;
+  ASSERT_TRUE(store_->Contains(ids[0], &in_plasma));
+  ASSERT_FALSE(in_plasma);
+  ASSERT_FALSE(store_->Contains(ids[99], &in_plasma));
+
+  std::thread putter([this, &ids]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    for (size_t i = ids.size() / 2; i < ids.size(); i++) {
+      store_->Put(MakeObject(data_, sizeof(data_)), ids[i]);
+    }
+  });
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(store_->Get(ids, ids.size(), -1, ctx_, /*remove_after_get=*/false,
+                           &results));
+  putter.join();
+  for (const auto &result : results) {
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->GetData()->Size(), sizeof(data_));
+  }
+  ASSERT_EQ(store_->GetMemoryStoreStatisticalData().num_local_objects, 100);
+
+  store_->Delete(ids);
+  ASSERT_EQ(store_->Size(), 0);
+}
+
+// An async get is either answered at once or when the object is put, even when it
+// races with the put.
+TEST_F(MemoryStoreTest, TestGetAsyncRacingPut) {
+  const int num_objects = 1000;
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < num_objects; i++) {
+    ids.push_back(ObjectID::FromRandom());
+  }
+  std::atomic<int> num_callbacks(0);
+  std::thread getter([this, &ids, &num_callbacks]() {
+    for (const auto &id : ids) {
+      store_->GetAsync(id, [&num_callbacks](std::shared_ptr<RayObject> object) {
+        RAY_CHECK(object != nullptr);
+        num_callbacks++;
+      });
+    }
+  });
+  for (const auto &id : ids) {
+    store_->Put(MakeObject(data_, sizeof(data_)), id);
+  }
+  getter.join();
+  ASSERT_EQ(num_callbacks, num_objects);
+}
+
+/// A memory store with a budget, whose spills run when the test calls RunSpills().
+class SpillingMemoryStore {
+ public:
+  explicit SpillingMemoryStore(
+      int64_t max_bytes,
+      std::function<Status(const RayObject &, const ObjectID &)> spill_to_plasma)
+      : store(std::make_shared<CoreWorkerMemoryStore>(
+            nullptr, nullptr, nullptr, nullptr, max_bytes, spill_to_plasma,
+            [this](const ObjectID &object_id) { released.insert(object_id); },
+            [this](std::function<void()> spill) { spills.push_back(spill); })) {}
+
+  void RunSpills() {
+    auto to_run = std::move(spills);
+    spills.clear();
+    for (const auto &spill : to_run) {
+      spill();
+    }
+  }
+
+  std::vector<std::function<void()>> spills;
+  absl::flat_hash_set<ObjectID> released;
+  std::shared_ptr<CoreWorkerMemoryStore> store;
+};
+
+TEST_F(MemoryStoreTest, TestSpillToPlasma) {
+  absl::flat_hash_map<ObjectID, size_t> plasma;
+  SpillingMemoryStore spilling(
+      /*max_bytes=*/1, [&plasma](const RayObject &object, const ObjectID &object_id) {
+        plasma[object_id] = object.GetData()->Size();
+        return Status::OK();
+      });
+  auto store = spilling.store;
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 10; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    ASSERT_TRUE(store->Put(MakeObject(data_, sizeof(data_)), ids.back()));
+  }
+  // Puts do not spill themselves, and schedule a single spill between them.
+  ASSERT_TRUE(plasma.empty());
+  ASSERT_EQ(spilling.spills.size(), 1);
+  spilling.RunSpills();
+  // The object is still in the store, as a marker that it is in plasma.
+  ASSERT_EQ(plasma.size(), ids.size());
+  std::vector<std::shared_ptr<RayObject>> results;
+  RAY_CHECK_OK(
+      store->Get(ids, ids.size(), 0, ctx_, /*remove_after_get=*/false, &results));
+  for (size_t i = 0; i < ids.size(); i++) {
+    ASSERT_EQ(plasma[ids[i]], sizeof(data_));
+    ASSERT_TRUE(results[i]->IsInPlasmaError());
+  }
+  ASSERT_EQ(store->GetMemoryStoreStatisticalData().num_in_plasma, 10);
+  ASSERT_EQ(store->GetMemoryStoreStatisticalData().used_object_store_memory, 0);
+  ASSERT_TRUE(spilling.released.empty());
+
+  // Errors are never spilled.
+  auto error_id = ObjectID::FromRandom();
+  store->Put(RayObject(rpc::ErrorType::TASK_EXECUTION_EXCEPTION), error_id);
+  spilling.RunSpills();
+  ASSERT_EQ(plasma.count(error_id), 0);
+
+  absl::flat_hash_set<ObjectID> plasma_ids_to_delete;
+  store->Delete(absl::flat_hash_set<ObjectID>(ids.begin(), ids.end()),
+                &plasma_ids_to_delete);
+  ASSERT_EQ(plasma_ids_to_delete.size(), ids.size());
+}
+
+TEST_F(MemoryStoreTest, TestSpillLeastRecentlyUsed) {
+  const int64_t max_bytes = 4096;
+  absl::flat_hash_set<ObjectID> plasma;
+  SpillingMemoryStore spilling(
+      max_bytes, [&plasma](const RayObject &object, const ObjectID &object_id) {
+        plasma.insert(object_id);
+        return Status::OK();
+      });
+  auto store = spilling.store;
+  auto hot_id = ObjectID::FromRandom();
+  store->Put(MakeObject(data_, sizeof(data_)), hot_id);
+  for (int i = 0; i < 1000; i++) {
+    store->Put(MakeObject(data_, sizeof(data_)), ObjectID::FromRandom());
+    // An object that is read between spills is never the coldest.
+    ASSERT_NE(store->GetOrPromoteToPlasma(hot_id), nullptr);
+    spilling.RunSpills();
+  }
+  ASSERT_EQ(plasma.count(hot_id), 0);
+  ASSERT_FALSE(plasma.empty());
+  auto stats = store->GetMemoryStoreStatisticalData();
+  ASSERT_LE(stats.used_object_store_memory, max_bytes);
+  ASSERT_EQ(static_cast<size_t>(stats.num_in_plasma), plasma.size());
+  ASSERT_EQ(stats.num_in_plasma + stats.num_local_objects, 1001);
+}
+
+// The budget is shared by the shards, so a store under its budget never spills however
+// its objects are spread across the shards, and an over-budget store spills the objects
+// that were put first.
+TEST_F(MemoryStoreTest, TestNoSpillUnderBudget) {
+  const int num_objects = 100;
+  const int64_t object_size = MakeObject(data_, sizeof(data_)).GetSize();
+  absl::flat_hash_set<ObjectID> plasma;
+  SpillingMemoryStore spilling(
+      2 * num_objects * object_size,
+      [&plasma](const RayObject &object, const ObjectID &object_id) {
+        plasma.insert(object_id);
+        return Status::OK();
+      });
+  auto store = spilling.store;
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < num_objects; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    ASSERT_TRUE(store->Put(MakeObject(data_, sizeof(data_)), ids.back()));
+  }
+  // An object that is much larger than a shard's share of the budget.
+  std::vector<uint8_t> large_data(num_objects * object_size);
+  ASSERT_TRUE(store->Put(MakeObject(large_data.data(), large_data.size()),
+                         ObjectID::FromRandom()));
+  ASSERT_TRUE(spilling.spills.empty());
+  spilling.RunSpills();
+  ASSERT_TRUE(plasma.empty());
+
+  ASSERT_TRUE(store->Put(MakeObject(data_, sizeof(data_)), ObjectID::FromRandom()));
+  spilling.RunSpills();
+  ASSERT_EQ(plasma, absl::flat_hash_set<ObjectID>{ids[0]});
+  ASSERT_EQ(store->GetMemoryStoreStatisticalData().used_object_store_memory,
+            2 * num_objects * object_size);
+}
+
+// An object that is deleted while it is spilled leaves no marker behind, and its
+// plasma copy is released.
+TEST_F(MemoryStoreTest, TestDeleteDuringSpill) {
+  std::shared_ptr<CoreWorkerMemoryStore> store;
+  auto deleted_id = ObjectID::FromRandom();
+  SpillingMemoryStore spilling(
+      /*max_bytes=*/1, [&store, &deleted_id](const RayObject &object,
+                                              const ObjectID &object_id) {
+        if (object_id == deleted_id) {
+          store->Delete(std::vector<ObjectID>{object_id});
+        }
+        return Status::OK();
+      });
+  store = spilling.store;
+  auto kept_id = ObjectID::FromRandom();
+  store->Put(MakeObject(data_, sizeof(data_)), deleted_id);
+  store->Put(MakeObject(data_, sizeof(data_)), kept_id);
+  spilling.RunSpills();
+
+  bool in_plasma = false;
+  ASSERT_FALSE(store->Contains(deleted_id, &in_plasma));
+  ASSERT_TRUE(store->Contains(kept_id, &in_plasma));
+  ASSERT_TRUE(in_plasma);
+  ASSERT_EQ(spilling.released, absl::flat_hash_set<ObjectID>{deleted_id});
+}
+
+// Objects that plasma cannot take stay in memory, and are spilled by a later spill.
+TEST_F(MemoryStoreTest, TestSpillPlasmaFull) {
+  bool plasma_full = true;
+  absl::flat_hash_set<ObjectID> plasma;
+  SpillingMemoryStore spilling(
+      /*max_bytes=*/1,
+      [&plasma_full, &plasma](const RayObject &object, const ObjectID &object_id) {
+        if (plasma_full) {
+          return Status::ObjectStoreFull("full");
+        }
+        plasma.insert(object_id);
+        return Status::OK();
+      });
+  auto store = spilling.store;
+  auto id = ObjectID::FromRandom();
+  store->Put(MakeObject(data_, sizeof(data_)), id);
+  spilling.RunSpills();
+  ASSERT_NE(store->GetOrPromoteToPlasma(id), nullptr);
+  ASSERT_EQ(store->GetMemoryStoreStatisticalData().num_local_objects, 1);
+
+  plasma_full = false;
+  store->Put(MakeObject(data_, sizeof(data_)), ObjectID::FromRandom());
+  spilling.RunSpills();
+  ASSERT_EQ(plasma.count(id), 1);
+  ASSERT_EQ(store->GetMemoryStoreStatisticalData().num_in_plasma, 2);
+}
+
+/// Measure the throughput of the store as the number of threads that use it grows.
+/// Each thread puts its own objects, gets them and gets them asynchronously, and
+/// reads a set of objects that all threads share, like the arguments of the tasks
+/// of an actor with a high max_concurrency.
+TEST_F(MemoryStoreTest, DISABLED_TestConcurrentPutGetPerf) {
+  const int num_ops = 200000;
+  std::vector<ObjectID> shared_ids;
+  for (int i = 0; i < 100; i++) {
+    shared_ids.push_back(ObjectID::FromRandom());
+    store_->Put(MakeObject(data_, sizeof(data_)), shared_ids.back());
+  }
+  for (int num_threads : {1, 2, 4, 8}) {
+    std::vector<std::vector<ObjectID>> ids(num_threads);
+    for (auto &thread_ids : ids) {
+      for (int i = 0; i < num_ops / num_threads / 4; i++) {
+        thread_ids.push_back(ObjectID::FromRandom());
+      }
+    }
+    std::atomic<int> num_callbacks(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([this, &ids, &shared_ids, &num_callbacks, t]() {
+        std::vector<std::shared_ptr<RayObject>> results;
+        bool in_plasma = false;
+        for (size_t i = 0; i < ids[t].size(); i++) {
+          const auto &id = ids[t][i];
+          store_->Put(MakeObject(data_, sizeof(data_)), id);
+          RAY_CHECK_OK(store_->Get({id}, 1, -1, ctx_, /*remove_after_get=*/false,
+                                   &results));
+          store_->GetAsync(
+              id, [&num_callbacks](std::shared_ptr<RayObject>) { num_callbacks++; });
+          RAY_CHECK(store_->Contains(shared_ids[i % shared_ids.size()], &in_plasma));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    RAY_LOG(INFO) << num_threads << " threads: " << num_ops << " ops in " << elapsed
+                  << "ms, " << num_ops / std::max<int64_t>(elapsed, 1) << " ops/ms";
+    for (const auto &thread_ids : ids) {
+      store_->Delete(thread_ids);
+    }
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -18,6 +18,31 @@
 
 namespace ray {
 
+namespace {
+
+/// Whether a node holds the most bytes of the plasma arguments of a task, given the
+/// bytes of the arguments on each node. The raylet would run the task there, so only
+/// workers on that node are reused for the task. Any node qualifies if the locality
+/// of the arguments is not known.
+bool IsNodeNearArguments(const NodeID &node_id,
+                         const absl::flat_hash_map<NodeID, uint64_t> &bytes_by_node) {
+  if (bytes_by_node.empty()) {
+    return true;
+  }
+  auto node_it = bytes_by_node.find(node_id);
+  if (node_it == bytes_by_node.end()) {
+    return false;
+  }
+  for (const auto &entry : bytes_by_node) {
+    if (entry.second > node_it->second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
   RAY_LOG(DEBUG) << "Submit task " << task_spec.TaskId();
 
@@ -115,11 +140,11 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
 void CoreWorkerDirectTaskSubmitter::AddWorkerLeaseClient(
     const rpc::WorkerAddress &addr, std::shared_ptr<WorkerLeaseInterface> lease_client,
     const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
-    const SchedulingKey &scheduling_key) {
+    const SchedulingKey &scheduling_key, Language language) {
   client_cache_->GetOrConnect(addr.ToProto());
   int64_t expiration = current_time_ms() + lease_timeout_ms_;
   LeaseEntry new_lease_entry = LeaseEntry(std::move(lease_client), expiration, 0,
-                                          assigned_resources, scheduling_key);
+                                          assigned_resources, scheduling_key, language);
   worker_to_lease_entry_.emplace(addr, new_lease_entry);
 
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -141,8 +166,8 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   // Return the worker if there was an error executing the previous task,
   // the previous task is an actor creation task,
   // there are no more applicable queued tasks, or the lease is expired.
-  if (was_error || current_queue.empty() ||
-      current_time_ms() > lease_entry.lease_expiration_time) {
+  bool lease_expired = current_time_ms() > lease_entry.lease_expiration_time;
+  if (was_error || current_queue.empty() || lease_expired) {
     RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
 
     // Return the worker only if there are no tasks in flight
@@ -156,12 +181,16 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
         scheduling_key_entries_.erase(scheduling_key);
       }
 
-      auto status =
-          lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id, was_error);
-      if (!status.ok()) {
-        RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+      // A worker that ran out of tasks may still run the tasks of another scheduling
+      // key.
+      if (was_error || lease_expired || !ReuseIdleWorker(addr)) {
+        auto status = lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id,
+                                                             was_error);
+        if (!status.ok()) {
+          RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+        }
+        worker_to_lease_entry_.erase(addr);
       }
-      worker_to_lease_entry_.erase(addr);
     }
 
   } else {
@@ -194,6 +223,107 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   RequestNewWorkerIfNeeded(scheduling_key);
 }
 
+bool CoreWorkerDirectTaskSubmitter::ReuseIdleWorker(const rpc::WorkerAddress &addr) {
+  if (idle_worker_timeout_ms_ <= 0) {
+    return false;
+  }
+  const auto &lease_entry = worker_to_lease_entry_[addr];
+  for (const auto &entry : scheduling_key_entries_) {
+    if (lease_entry.CanRunTasksOf(entry.first, entry.second.task_queue) &&
+        entry.second.AllPipelinesToWorkersFull(max_tasks_in_flight_per_worker_) &&
+        IsNodeNearArguments(addr.raylet_id,
+                            GetArgumentBytesByNode(entry.second.task_queue.front()))) {
+      // Copy the key, since moving the worker may remove its entry.
+      const SchedulingKey scheduling_key = entry.first;
+      MoveWorker(addr, scheduling_key);
+      return true;
+    }
+  }
+
+  if (!idle_worker_timer_.has_value() ||
+      !std::get<2>(lease_entry.scheduling_key).IsNil()) {
+    return false;
+  }
+  RAY_LOG(DEBUG) << "Keeping idle worker " << addr.worker_id;
+  idle_workers_.push_back({addr, current_time_ms() + idle_worker_timeout_ms_});
+  if (!idle_worker_timer_armed_) {
+    idle_worker_timer_armed_ = true;
+    idle_worker_timer_->expires_after(
+        boost::asio::chrono::milliseconds(idle_worker_timeout_ms_));
+    idle_worker_timer_->async_wait(
+        [this](const boost::system::error_code &error) { ReturnIdleWorkers(error); });
+  }
+  return true;
+}
+
+bool CoreWorkerDirectTaskSubmitter::TakeIdleWorker(const SchedulingKey &scheduling_key) {
+  if (idle_workers_.empty()) {
+    return false;
+  }
+  const auto &task_queue = scheduling_key_entries_[scheduling_key].task_queue;
+  const auto bytes_by_node = GetArgumentBytesByNode(task_queue.front());
+  int64_t now = current_time_ms();
+  for (auto it = idle_workers_.begin(); it != idle_workers_.end(); it++) {
+    if (!IsNodeNearArguments(it->addr.raylet_id, bytes_by_node)) {
+      continue;
+    }
+    const auto &lease_entry = worker_to_lease_entry_[it->addr];
+    // Workers whose lease expired are returned by ReturnIdleWorkers.
+    if (now <= lease_entry.lease_expiration_time &&
+        lease_entry.CanRunTasksOf(scheduling_key, task_queue)) {
+      RAY_LOG(DEBUG) << "Reusing idle worker " << it->addr.worker_id;
+      const rpc::WorkerAddress addr = it->addr;
+      idle_workers_.erase(it);
+      MoveWorker(addr, scheduling_key);
+      return true;
+    }
+  }
+  return false;
+}
+
+void CoreWorkerDirectTaskSubmitter::MoveWorker(const rpc::WorkerAddress &addr,
+                                               const SchedulingKey &scheduling_key) {
+  auto &lease_entry = worker_to_lease_entry_[addr];
+  RAY_CHECK(lease_entry.tasks_in_flight == 0);
+  lease_entry.scheduling_key = scheduling_key;
+  RAY_CHECK(scheduling_key_entries_[scheduling_key].active_workers.emplace(addr).second);
+  OnWorkerIdle(addr, scheduling_key, /*was_error=*/false, lease_entry.assigned_resources);
+}
+
+void CoreWorkerDirectTaskSubmitter::ReturnIdleWorkers(
+    const boost::system::error_code &error) {
+  if (error == boost::asio::error::operation_aborted) {
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  idle_worker_timer_armed_ = false;
+  int64_t now = current_time_ms();
+  while (!idle_workers_.empty()) {
+    const auto &idle_worker = idle_workers_.front();
+    auto &lease_entry = worker_to_lease_entry_[idle_worker.addr];
+    if (now < idle_worker.deadline_ms && now <= lease_entry.lease_expiration_time) {
+      break;
+    }
+    RAY_LOG(DEBUG) << "Returning idle worker " << idle_worker.addr.worker_id;
+    auto status = lease_entry.lease_client->ReturnWorker(
+        idle_worker.addr.port, idle_worker.addr.worker_id, /*disconnect_worker=*/false);
+    if (!status.ok()) {
+      RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+    }
+    worker_to_lease_entry_.erase(idle_worker.addr);
+    idle_workers_.pop_front();
+  }
+
+  if (!idle_workers_.empty()) {
+    // Idle workers are kept for the same duration, so the first one is returned first.
+    idle_worker_timer_armed_ = true;
+    idle_worker_timer_->expires_after(
+        boost::asio::chrono::milliseconds(idle_workers_.front().deadline_ms - now));
+    idle_worker_timer_->async_wait(
+        [this](const boost::system::error_code &error) { ReturnIdleWorkers(error); });
+  }
+}
+
 void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
     const SchedulingKey &scheduling_key) {
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -252,6 +382,43 @@ CoreWorkerDirectTaskSubmitter::GetOrConnectLeaseClient(
   return lease_client;
 }
 
+absl::flat_hash_map<NodeID, uint64_t>
+CoreWorkerDirectTaskSubmitter::GetArgumentBytesByNode(
+    const TaskSpecification &task_spec) {
+  absl::flat_hash_map<NodeID, uint64_t> bytes_by_node;
+  if (!locality_data_provider_) {
+    return bytes_by_node;
+  }
+  for (const auto &object_id : task_spec.GetDependencyIds()) {
+    auto locality_data = locality_data_provider_->GetLocalityData(object_id);
+    if (!locality_data) {
+      continue;
+    }
+    for (const auto &node_id : locality_data->nodes_containing_object) {
+      bytes_by_node[node_id] += locality_data->object_size;
+    }
+  }
+  return bytes_by_node;
+}
+
+TaskSpecification CoreWorkerDirectTaskSubmitter::WithArgumentLocality(
+    const TaskSpecification &task_spec) {
+  const auto bytes_by_node = GetArgumentBytesByNode(task_spec);
+  if (bytes_by_node.empty()) {
+    return task_spec;
+  }
+  // Copying the TaskSpecification would share its message, so copy the message.
+  TaskSpecification lease_spec(task_spec.GetMessage());
+  auto argument_locality = lease_spec.GetMutableMessage().mutable_argument_locality();
+  argument_locality->Clear();
+  for (const auto &entry : bytes_by_node) {
+    auto locality = argument_locality->Add();
+    locality->set_node_id(entry.first.Binary());
+    locality->set_argument_bytes(entry.second);
+  }
+  return lease_spec;
+}
+
 void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     const SchedulingKey &scheduling_key, const rpc::Address *raylet_address) {
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -281,15 +448,21 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     return;
   }
 
+  if (TakeIdleWorker(scheduling_key)) {
+    // An idle worker can run the tasks, so we don't need a new worker.
+    return;
+  }
+
   auto lease_client = GetOrConnectLeaseClient(raylet_address);
-  TaskSpecification &resource_spec = task_queue.front();
+  TaskSpecification resource_spec = WithArgumentLocality(task_queue.front());
   TaskID task_id = resource_spec.TaskId();
+  Language language = resource_spec.GetLanguage();
   // Subtract 1 so we don't double count the task we are requesting for.
   int64_t queue_size = task_queue.size() - 1;
   lease_client->RequestWorkerLease(
       resource_spec,
-      [this, scheduling_key](const Status &status,
-                             const rpc::RequestWorkerLeaseReply &reply) {
+      [this, scheduling_key, language](const Status &status,
+                                       const rpc::RequestWorkerLeaseReply &reply) {
         absl::MutexLock lock(&mu_);
 
         auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -311,7 +484,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
             auto resources_copy = reply.resource_mapping();
 
             AddWorkerLeaseClient(addr, std::move(lease_client), resources_copy,
-                                 scheduling_key);
+                                 scheduling_key, language);
             RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
             OnWorkerIdle(addr, scheduling_key,
                          /*error=*/false, resources_copy);
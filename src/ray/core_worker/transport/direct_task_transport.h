@@ -22,6 +22,7 @@
 #include "ray/common/ray_object.h"
 #include "ray/core_worker/actor_manager.h"
 #include "ray/core_worker/context.h"
+#include "ray/core_worker/reference_count.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
 #include "ray/core_worker/task_manager.h"
 #include "ray/core_worker/transport/dependency_resolver.h"
@@ -45,6 +46,10 @@ typedef std::function<std::shared_ptr<WorkerLeaseInterface>(const std::string &i
 // direct actor creation task, and reconstruct the actor if it dies. Otherwise if
 // the actor creation task just reuses an existing worker, then raylet will not
 // be aware of the actor and is not able to manage it.
+//
+// A worker that runs out of tasks of its key may still run the tasks of another key
+// that need the same resources, which saves a lease request to the raylet at the cost
+// of the raylet not choosing the worker for the plasma dependencies of those tasks.
 using SchedulingKey = std::tuple<SchedulingClass, std::vector<ObjectID>, ActorID>;
 
 // This class is thread-safe.
@@ -59,7 +64,11 @@ class CoreWorkerDirectTaskSubmitter {
       int64_t lease_timeout_ms, std::shared_ptr<ActorCreatorInterface> actor_creator,
       uint32_t max_tasks_in_flight_per_worker =
           RayConfig::instance().max_tasks_in_flight_per_worker(),
-      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt)
+      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt,
+      std::shared_ptr<LocalityDataProviderInterface> locality_data_provider = nullptr,
+      absl::optional<boost::asio::steady_timer> idle_worker_timer = absl::nullopt,
+      int64_t idle_worker_timeout_ms =
+          RayConfig::instance().worker_lease_idle_reuse_milliseconds())
       : rpc_address_(rpc_address),
         local_lease_client_(lease_client),
         lease_client_factory_(lease_client_factory),
@@ -70,7 +79,10 @@ class CoreWorkerDirectTaskSubmitter {
         actor_creator_(std::move(actor_creator)),
         client_cache_(core_worker_client_pool),
         max_tasks_in_flight_per_worker_(max_tasks_in_flight_per_worker),
-        cancel_retry_timer_(std::move(cancel_timer)) {}
+        cancel_retry_timer_(std::move(cancel_timer)),
+        locality_data_provider_(std::move(locality_data_provider)),
+        idle_worker_timer_(std::move(idle_worker_timer)),
+        idle_worker_timeout_ms_(idle_worker_timeout_ms) {}
 
   /// Schedule a task for direct submission to a worker.
   ///
@@ -128,11 +140,56 @@ class CoreWorkerDirectTaskSubmitter {
   void CancelWorkerLeaseIfNeeded(const SchedulingKey &scheduling_key)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Move an idle worker that has no tasks in flight to another scheduling key whose
+  /// queued tasks it can run and that needs more workers, if the worker is on the node
+  /// that holds the most bytes of the plasma arguments of the next task. If there is
+  /// none and idle workers can be kept, keep the worker until a scheduling key needs
+  /// it. Idle workers are only reused if `idle_worker_timeout_ms` is positive.
+  ///
+  /// \param[in] addr The address of the worker, which is not an active worker of any
+  /// scheduling key.
+  /// \return Whether the worker was moved or kept. Otherwise, the caller should return
+  /// the worker to the raylet.
+  bool ReuseIdleWorker(const rpc::WorkerAddress &addr) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Move a kept idle worker to a scheduling key that needs more workers, instead of
+  /// requesting a new worker lease from the raylet. A worker is only taken if it is on
+  /// a node that holds the most bytes of the plasma arguments of the next task, since
+  /// the raylet would otherwise have been asked to run the task where its arguments
+  /// are.
+  ///
+  /// \param[in] scheduling_key The scheduling key that needs more workers.
+  /// \return Whether a worker was moved to the scheduling key.
+  bool TakeIdleWorker(const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Make a worker an active worker of a scheduling key and push it queued tasks.
+  void MoveWorker(const rpc::WorkerAddress &addr, const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Return the kept idle workers that were not reused in time.
+  void ReturnIdleWorkers(const boost::system::error_code &error) LOCKS_EXCLUDED(mu_);
+
+  /// Return the number of bytes of the plasma arguments of a task on each node that
+  /// holds some of them. This is empty if argument locality is not known.
+  ///
+  /// \param[in] task_spec The task, whose dependencies are resolved.
+  absl::flat_hash_map<NodeID, uint64_t> GetArgumentBytesByNode(
+      const TaskSpecification &task_spec);
+
+  /// Return the task to request a worker lease for, with the nodes that hold its
+  /// plasma arguments, so that the raylet can run it where its arguments are. The
+  /// queued task is not modified, so that the locality is not sent to the worker.
+  ///
+  /// \param[in] task_spec The task, whose dependencies are resolved.
+  /// \return A copy of the task with the argument locality.
+  TaskSpecification WithArgumentLocality(const TaskSpecification &task_spec);
+
   /// Set up client state for newly granted worker lease.
   void AddWorkerLeaseClient(
       const rpc::WorkerAddress &addr, std::shared_ptr<WorkerLeaseInterface> lease_client,
       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
-      const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      const SchedulingKey &scheduling_key, Language language)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   /// Push a task to a specific worker.
   void PushNormalTask(const rpc::WorkerAddress &addr,
@@ -193,12 +250,14 @@ class CoreWorkerDirectTaskSubmitter {
   /// (3) The number of tasks that are currently in flight to the worker
   /// (4) The resources assigned to the worker
   /// (5) The SchedulingKey assigned to tasks that will be sent to the worker
+  /// (6) The language of the worker
   struct LeaseEntry {
     std::shared_ptr<WorkerLeaseInterface> lease_client;
     int64_t lease_expiration_time;
     uint32_t tasks_in_flight;
     google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> assigned_resources;
     SchedulingKey scheduling_key;
+    Language language;
 
     LeaseEntry(
         std::shared_ptr<WorkerLeaseInterface> lease_client = nullptr,
@@ -206,17 +265,30 @@ class CoreWorkerDirectTaskSubmitter {
         google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> assigned_resources =
             google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry>(),
         SchedulingKey scheduling_key = std::make_tuple(0, std::vector<ObjectID>(),
-                                                       ActorID::Nil()))
+                                                       ActorID::Nil()),
+        Language language = Language::PYTHON)
         : lease_client(lease_client),
           lease_expiration_time(lease_expiration_time),
           tasks_in_flight(tasks_in_flight),
           assigned_resources(assigned_resources),
-          scheduling_key(scheduling_key) {}
+          scheduling_key(scheduling_key),
+          language(language) {}
 
     // Check whether the pipeline to the worker associated with a LeaseEntry is full.
     bool PipelineToWorkerFull(uint32_t max_tasks_in_flight_per_worker) const {
       return tasks_in_flight == max_tasks_in_flight_per_worker;
     }
+
+    // Check whether the worker can run the tasks queued with another SchedulingKey,
+    // because they need the same resources and language. Workers that were leased for
+    // an actor creation task are never reused.
+    bool CanRunTasksOf(const SchedulingKey &other_key,
+                       const std::deque<TaskSpecification> &task_queue) const {
+      return !task_queue.empty() && std::get<2>(scheduling_key).IsNil() &&
+             std::get<2>(other_key).IsNil() &&
+             std::get<0>(scheduling_key) == std::get<0>(other_key) &&
+             task_queue.front().GetLanguage() == language;
+    }
   };
 
   // Map from worker address to a LeaseEntry struct containing the lease's metadata.
@@ -270,6 +342,31 @@ class CoreWorkerDirectTaskSubmitter {
 
   // Retries cancelation requests if they were not successful.
   absl::optional<boost::asio::steady_timer> cancel_retry_timer_;
+
+  /// Provides the sizes and locations of the arguments of the tasks, or null if
+  /// the raylets should not be told where the arguments are.
+  std::shared_ptr<LocalityDataProviderInterface> locality_data_provider_;
+
+  /// An idle worker that is kept for the scheduling keys that need more workers.
+  struct IdleWorker {
+    rpc::WorkerAddress addr;
+    /// When the worker is returned to the raylet if it was not reused.
+    int64_t deadline_ms;
+  };
+
+  /// The kept idle workers, in the order they became idle. These are not active
+  /// workers of any scheduling key.
+  std::deque<IdleWorker> idle_workers_ GUARDED_BY(mu_);
+
+  /// Returns the kept idle workers that were not reused in time. Idle workers are only
+  /// kept if this is set.
+  absl::optional<boost::asio::steady_timer> idle_worker_timer_;
+
+  /// Whether the idle worker timer is waiting.
+  bool idle_worker_timer_armed_ GUARDED_BY(mu_) = false;
+
+  /// How long an idle worker is kept for the scheduling keys that need more workers.
+  const int64_t idle_worker_timeout_ms_;
 };
 
 };  // namespace ray
@@ -123,6 +123,8 @@ GcsNodeManager::GcsNodeManager(boost::asio::io_service &main_io_service,
           })),
       node_failure_detector_service_(node_failure_detector_io_service),
       heartbeat_timer_(main_io_service),
+      resource_view_(RayConfig::instance().resource_view_full_sync_period(),
+                     RayConfig::instance().light_heartbeat_enabled()),
       gcs_pub_sub_(gcs_pub_sub),
       gcs_table_storage_(gcs_table_storage) {
   SendBatchedHeartbeat();
@@ -202,7 +204,7 @@ void GcsNodeManager::HandleReportHeartbeat(const rpc::ReportHeartbeatRequest &re
       heartbeat_data->should_global_gc() || heartbeat_data->resources_total_size() > 0 ||
       heartbeat_data->resources_available_changed() ||
       heartbeat_data->resource_load_changed()) {
-    heartbeat_buffer_[node_id] = *heartbeat_data;
+    resource_view_.UpdateNode(node_id, *heartbeat_data);
   }
 
   // Note: To avoid heartbeats being delayed by main thread, make sure heartbeat is always
@@ -329,8 +331,9 @@ void GcsNodeManager::HandleGetAllAvailableResources(
   for (const auto &iter : GetClusterRealtimeResources()) {
     rpc::AvailableResources resource;
     resource.set_node_id(iter.first.Binary());
-    for (const auto &res : iter.second->GetResourceAmountMap()) {
-      (*resource.mutable_resources_available())[res.first] = res.second.ToDouble();
+    for (const auto &res : iter.second->GetResourceAmounts()) {
+      (*resource.mutable_resources_available())[ResourceSet::GetResourceName(
+          res.first)] = res.second.ToDouble();
     }
     reply->add_resources_list()->CopyFrom(resource);
   }
@@ -451,7 +454,7 @@ std::shared_ptr<rpc::GcsNodeInfo> GcsNodeManager::RemoveNode(
     cluster_resources_.erase(node_id);
     // Remove from cluster realtime resources.
     cluster_realtime_resources_.erase(node_id);
-    heartbeat_buffer_.erase(node_id);
+    resource_view_.RemoveNode(node_id);
     if (!is_intended) {
       // Broadcast a warning to all of the drivers indicating that the node
       // has been marked as dead.
@@ -551,16 +554,9 @@ void GcsNodeManager::AddDeadNodeToCache(std::shared_ptr<rpc::GcsNodeInfo> node)
 }
 
 void GcsNodeManager::SendBatchedHeartbeat() {
-  if (!heartbeat_buffer_.empty()) {
-    auto batch = std::make_shared<rpc::HeartbeatBatchTableData>();
-    std::unordered_map<ResourceSet, rpc::ResourceDemand> aggregate_load;
-    for (auto &heartbeat : heartbeat_buffer_) {
-      batch->add_batch()->Swap(&heartbeat.second);
-    }
-
+  if (auto batch = resource_view_.NextBatch()) {
     RAY_CHECK_OK(gcs_pub_sub_->Publish(HEARTBEAT_BATCH_CHANNEL, "",
                                        batch->SerializeAsString(), nullptr));
-    heartbeat_buffer_.clear();
   }
 
   auto heartbeat_period = boost::posix_time::milliseconds(
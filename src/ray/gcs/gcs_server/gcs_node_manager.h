@@ -18,6 +18,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "ray/common/id.h"
 #include "ray/gcs/accessor.h"
+#include "ray/gcs/gcs_server/gcs_resource_view.h"
 #include "ray/gcs/gcs_server/gcs_table_storage.h"
 #include "ray/gcs/pubsub/gcs_pub_sub.h"
 #include "ray/rpc/client_call.h"
@@ -251,7 +252,7 @@ class GcsNodeManager : public rpc::NodeInfoHandler {
   /// \param node The node which is dead.
   void AddDeadNodeToCache(std::shared_ptr<rpc::GcsNodeInfo> node);
 
-  /// Send any buffered heartbeats as a single publish.
+  /// Publish the resources that changed since the last publish as a single batch.
   void SendBatchedHeartbeat();
 
   /// The main event loop for node failure detector.
@@ -273,8 +274,8 @@ class GcsNodeManager : public rpc::NodeInfoHandler {
   absl::flat_hash_map<NodeID, rpc::ResourceMap> cluster_resources_;
   /// Newest heartbeat of all nodes.
   absl::flat_hash_map<NodeID, rpc::HeartbeatTableData> node_heartbeats_;
-  /// A buffer containing heartbeats received from node managers in the last tick.
-  absl::flat_hash_map<NodeID, rpc::HeartbeatTableData> heartbeat_buffer_;
+  /// The resources of the nodes that are published to the raylets.
+  GcsResourceView resource_view_;
   /// Listeners which monitors the addition of nodes.
   std::vector<std::function<void(std::shared_ptr<rpc::GcsNodeInfo>)>>
       node_added_listeners_;
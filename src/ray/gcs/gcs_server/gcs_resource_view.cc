@@ -0,0 +1,135 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_resource_view.h"
+
+namespace ray {
+namespace gcs {
+
+namespace {
+
+std::unordered_map<std::string, double> ToResourceMap(
+    const google::protobuf::Map<std::string, double> &resources) {
+  std::unordered_map<std::string, double> result;
+  for (const auto &resource : resources) {
+    if (resource.second > 0) {
+      result.emplace(resource.first, resource.second);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+GcsResourceView::GcsResourceView(int64_t full_sync_period, bool light_heartbeat_enabled)
+    : full_sync_period_(full_sync_period),
+      light_heartbeat_enabled_(light_heartbeat_enabled) {}
+
+void GcsResourceView::UpdateNode(const NodeID &node_id,
+                                 const rpc::HeartbeatTableData &heartbeat) {
+  auto &entry = nodes_[node_id];
+  // Light heartbeats only hold the resources that changed.
+  if (!light_heartbeat_enabled_ || heartbeat.resources_total_size() > 0) {
+    entry.latest.total = ToResourceMap(heartbeat.resources_total());
+  }
+  if (!light_heartbeat_enabled_ || heartbeat.resources_available_changed()) {
+    entry.latest.available = ToResourceMap(heartbeat.resources_available());
+  }
+  if (!light_heartbeat_enabled_ || heartbeat.resource_load_changed()) {
+    entry.latest.load = ToResourceMap(heartbeat.resource_load());
+  }
+  entry.should_global_gc |= heartbeat.should_global_gc();
+  updated_nodes_.insert(node_id);
+}
+
+void GcsResourceView::RemoveNode(const NodeID &node_id) {
+  nodes_.erase(node_id);
+  updated_nodes_.erase(node_id);
+}
+
+bool GcsResourceView::AddDelta(const ResourceMap &published, const ResourceMap &latest,
+                               google::protobuf::Map<std::string, double> *delta) {
+  for (const auto &resource : latest) {
+    auto it = published.find(resource.first);
+    if (it == published.end() || it->second != resource.second) {
+      (*delta)[resource.first] = resource.second;
+    }
+  }
+  for (const auto &resource : published) {
+    if (latest.count(resource.first) == 0) {
+      (*delta)[resource.first] = 0;
+    }
+  }
+  return !delta->empty();
+}
+
+std::shared_ptr<rpc::HeartbeatBatchTableData> GcsResourceView::NextBatch() {
+  num_periods_++;
+  bool full_snapshot = full_sync_period_ <= 1 || num_periods_ % full_sync_period_ == 0;
+  auto batch = std::make_shared<rpc::HeartbeatBatchTableData>();
+  auto add_node = [&batch](const NodeID &node_id, NodeEntry &entry) {
+    auto heartbeat = batch->add_batch();
+    heartbeat->set_client_id(node_id.Binary());
+    heartbeat->set_should_global_gc(entry.should_global_gc);
+    entry.should_global_gc = false;
+    return heartbeat;
+  };
+
+  if (full_snapshot) {
+    // An empty published view makes the delta hold all the resources.
+    const NodeResources none;
+    for (auto &node : nodes_) {
+      auto &entry = node.second;
+      auto heartbeat = add_node(node.first, entry);
+      AddDelta(none.total, entry.latest.total, heartbeat->mutable_resources_total());
+      AddDelta(none.available, entry.latest.available,
+               heartbeat->mutable_resources_available());
+      heartbeat->set_resources_available_changed(true);
+      AddDelta(none.load, entry.latest.load, heartbeat->mutable_resource_load());
+      heartbeat->set_resource_load_changed(true);
+      entry.published = entry.latest;
+    }
+  } else {
+    for (const auto &node_id : updated_nodes_) {
+      auto &entry = nodes_[node_id];
+      bool should_global_gc = entry.should_global_gc;
+      auto heartbeat = add_node(node_id, entry);
+      bool total_changed = AddDelta(entry.published.total, entry.latest.total,
+                                    heartbeat->mutable_resources_total());
+      heartbeat->set_resources_available_changed(
+          AddDelta(entry.published.available, entry.latest.available,
+                   heartbeat->mutable_resources_available()));
+      heartbeat->set_resource_load_changed(AddDelta(
+          entry.published.load, entry.latest.load, heartbeat->mutable_resource_load()));
+      if (!total_changed && !heartbeat->resources_available_changed() &&
+          !heartbeat->resource_load_changed() && !should_global_gc) {
+        // Nothing changed since the last published batch.
+        batch->mutable_batch()->RemoveLast();
+        continue;
+      }
+      entry.published = entry.latest;
+    }
+  }
+  updated_nodes_.clear();
+
+  if (batch->batch_size() == 0) {
+    return nullptr;
+  }
+  batch->set_version(++version_);
+  batch->set_full_snapshot(full_snapshot);
+  return batch;
+}
+
+}  // namespace gcs
+}  // namespace ray
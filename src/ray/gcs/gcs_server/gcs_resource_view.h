@@ -0,0 +1,103 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "ray/common/id.h"
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+namespace gcs {
+
+/// The resources of the nodes of the cluster, as reported by their heartbeats and
+/// published to the raylets in versioned batches.
+///
+/// Each batch only holds the nodes and resources that changed since the previous
+/// batch, so that the size of a batch grows with the number of changes rather than
+/// with the number of nodes. Since batches are broadcast, a raylet that missed one
+/// cannot ask for the changes it missed; instead, every `full_sync_period` batches
+/// hold all the resources of all nodes.
+class GcsResourceView {
+ public:
+  /// Create a GcsResourceView.
+  ///
+  /// \param full_sync_period Every this many batches hold all the resources.
+  /// \param light_heartbeat_enabled Whether heartbeats only hold the resources that
+  /// changed.
+  GcsResourceView(int64_t full_sync_period, bool light_heartbeat_enabled);
+
+  /// Update the resources of a node from its heartbeat.
+  ///
+  /// \param node_id The node that sent the heartbeat.
+  /// \param heartbeat The heartbeat.
+  void UpdateNode(const NodeID &node_id, const rpc::HeartbeatTableData &heartbeat);
+
+  /// Remove a node. Raylets learn about removed nodes from the node table, so this
+  /// is not published.
+  ///
+  /// \param node_id The node to remove.
+  void RemoveNode(const NodeID &node_id);
+
+  /// Build the next batch to publish, and consider it published.
+  ///
+  /// \return The batch, or nullptr if there is nothing to publish.
+  std::shared_ptr<rpc::HeartbeatBatchTableData> NextBatch();
+
+  /// The version of the last published batch, or 0 if none was published.
+  int64_t Version() const { return version_; }
+
+ private:
+  using ResourceMap = std::unordered_map<std::string, double>;
+
+  /// The resources of a node.
+  struct NodeResources {
+    ResourceMap available;
+    ResourceMap total;
+    ResourceMap load;
+  };
+
+  struct NodeEntry {
+    /// The resources from the latest heartbeats.
+    NodeResources latest;
+    /// The resources as of the last published batch.
+    NodeResources published;
+    /// Whether the node requested a global GC since the last published batch.
+    bool should_global_gc = false;
+  };
+
+  /// Add the resources that differ from the published ones to a heartbeat map, and
+  /// the published resources that were removed with a value of 0.
+  ///
+  /// \return Whether any resource was added.
+  static bool AddDelta(const ResourceMap &published, const ResourceMap &latest,
+                       google::protobuf::Map<std::string, double> *delta);
+
+  const int64_t full_sync_period_;
+  const bool light_heartbeat_enabled_;
+  /// The number of times NextBatch was called.
+  int64_t num_periods_ = 0;
+  int64_t version_ = 0;
+  absl::flat_hash_map<NodeID, NodeEntry> nodes_;
+  /// The nodes that sent a heartbeat since the last published batch.
+  absl::flat_hash_set<NodeID> updated_nodes_;
+};
+
+}  // namespace gcs
+}  // namespace ray
@@ -0,0 +1,238 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/gcs/gcs_server/gcs_resource_view.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+rpc::HeartbeatTableData GenHeartbeat(
+    const NodeID &node_id, const std::unordered_map<std::string, double> &available,
+    const std::unordered_map<std::string, double> &total) {
+  rpc::HeartbeatTableData heartbeat;
+  heartbeat.set_client_id(node_id.Binary());
+  for (const auto &resource : available) {
+    (*heartbeat.mutable_resources_available())[resource.first] = resource.second;
+  }
+  heartbeat.set_resources_available_changed(true);
+  for (const auto &resource : total) {
+    (*heartbeat.mutable_resources_total())[resource.first] = resource.second;
+  }
+  return heartbeat;
+}
+
+/// Apply a batch to the resources of the nodes, the way raylets do.
+void ApplyBatch(
+    const rpc::HeartbeatBatchTableData &batch,
+    std::unordered_map<std::string, std::unordered_map<std::string, double>> *available) {
+  for (const auto &heartbeat : batch.batch()) {
+    auto &node_available = (*available)[heartbeat.client_id()];
+    if (batch.full_snapshot()) {
+      node_available.clear();
+    }
+    for (const auto &resource : heartbeat.resources_available()) {
+      if (resource.second > 0) {
+        node_available[resource.first] = resource.second;
+      } else {
+        node_available.erase(resource.first);
+      }
+    }
+  }
+}
+
+TEST(GcsResourceViewTest, TestDeltaHoldsChanges) {
+  gcs::GcsResourceView view(/*full_sync_period=*/100,
+                            /*light_heartbeat_enabled=*/false);
+  auto node1 = NodeID::FromRandom();
+  auto node2 = NodeID::FromRandom();
+  view.UpdateNode(node1, GenHeartbeat(node1, {{"CPU", 4}, {"GPU", 1}},
+                                      {{"CPU", 4}, {"GPU", 1}}));
+  view.UpdateNode(node2, GenHeartbeat(node2, {{"CPU", 8}}, {{"CPU", 8}}));
+  auto batch = view.NextBatch();
+  ASSERT_EQ(batch->version(), 1);
+  ASSERT_FALSE(batch->full_snapshot());
+  ASSERT_EQ(batch->batch_size(), 2);
+
+  // Only the resources that changed are published.
+  view.UpdateNode(node1, GenHeartbeat(node1, {{"CPU", 2}}, {{"CPU", 4}, {"GPU", 1}}));
+  view.UpdateNode(node2, GenHeartbeat(node2, {{"CPU", 8}}, {{"CPU", 8}}));
+  batch = view.NextBatch();
+  ASSERT_EQ(batch->version(), 2);
+  ASSERT_EQ(batch->batch_size(), 1);
+  const auto &heartbeat = batch->batch(0);
+  ASSERT_EQ(heartbeat.client_id(), node1.Binary());
+  ASSERT_EQ(heartbeat.resources_total_size(), 0);
+  ASSERT_TRUE(heartbeat.resources_available_changed());
+  ASSERT_EQ(heartbeat.resources_available_size(), 2);
+  ASSERT_EQ(heartbeat.resources_available().at("CPU"), 2);
+  // Removed resources have a value of 0.
+  ASSERT_EQ(heartbeat.resources_available().at("GPU"), 0);
+  ASSERT_FALSE(heartbeat.resource_load_changed());
+
+  // Nothing is published when nothing changed.
+  view.UpdateNode(node2, GenHeartbeat(node2, {{"CPU", 8}}, {{"CPU", 8}}));
+  ASSERT_EQ(view.NextBatch(), nullptr);
+  ASSERT_EQ(view.Version(), 2);
+
+  // A global GC request is published even if the resources did not change.
+  auto gc_heartbeat = GenHeartbeat(node2, {{"CPU", 8}}, {{"CPU", 8}});
+  gc_heartbeat.set_should_global_gc(true);
+  view.UpdateNode(node2, gc_heartbeat);
+  batch = view.NextBatch();
+  ASSERT_EQ(batch->batch_size(), 1);
+  ASSERT_TRUE(batch->batch(0).should_global_gc());
+  ASSERT_EQ(batch->batch(0).resources_available_size(), 0);
+}
+
+TEST(GcsResourceViewTest, TestFullSnapshot) {
+  gcs::GcsResourceView view(/*full_sync_period=*/3,
+                            /*light_heartbeat_enabled=*/false);
+  std::vector<NodeID> nodes;
+  for (int i = 0; i < 10; i++) {
+    nodes.push_back(NodeID::FromRandom());
+    view.UpdateNode(nodes.back(), GenHeartbeat(nodes.back(), {{"CPU", 1}}, {{"CPU", 1}}));
+  }
+  std::unordered_map<std::string, std::unordered_map<std::string, double>> available;
+  ApplyBatch(*view.NextBatch(), &available);
+  ASSERT_EQ(available.size(), 10);
+
+  view.UpdateNode(nodes[0], GenHeartbeat(nodes[0], {}, {{"CPU", 1}}));
+  auto batch = view.NextBatch();
+  ASSERT_EQ(batch->batch_size(), 1);
+  // A subscriber that missed the batch is stale.
+  auto stale = available;
+  ApplyBatch(*batch, &available);
+  ASSERT_TRUE(available[nodes[0].Binary()].empty());
+  ASSERT_FALSE(stale[nodes[0].Binary()].empty());
+
+  // Every third batch holds all the nodes, even those that did not change.
+  batch = view.NextBatch();
+  ASSERT_EQ(batch->version(), 3);
+  ASSERT_TRUE(batch->full_snapshot());
+  ASSERT_EQ(batch->batch_size(), 10);
+  ApplyBatch(*batch, &stale);
+  ASSERT_EQ(stale, available);
+
+  view.RemoveNode(nodes[1]);
+  view.NextBatch();
+  view.NextBatch();
+  batch = view.NextBatch();
+  ASSERT_TRUE(batch->full_snapshot());
+  ASSERT_EQ(batch->batch_size(), 9);
+}
+
+TEST(GcsResourceViewTest, TestLightHeartbeat) {
+  gcs::GcsResourceView view(/*full_sync_period=*/100,
+                            /*light_heartbeat_enabled=*/true);
+  auto node_id = NodeID::FromRandom();
+  auto heartbeat = GenHeartbeat(node_id, {{"CPU", 4}}, {{"CPU", 4}});
+  (*heartbeat.mutable_resource_load())["CPU"] = 2;
+  heartbeat.set_resource_load_changed(true);
+  view.UpdateNode(node_id, heartbeat);
+  ASSERT_EQ(view.NextBatch()->batch_size(), 1);
+
+  // The resources that are not in a light heartbeat did not change.
+  rpc::HeartbeatTableData light_heartbeat;
+  light_heartbeat.set_client_id(node_id.Binary());
+  (*light_heartbeat.mutable_resource_load())["CPU"] = 3;
+  light_heartbeat.set_resource_load_changed(true);
+  view.UpdateNode(node_id, light_heartbeat);
+  auto batch = view.NextBatch();
+  ASSERT_EQ(batch->batch_size(), 1);
+  ASSERT_FALSE(batch->batch(0).resources_available_changed());
+  ASSERT_EQ(batch->batch(0).resources_total_size(), 0);
+  ASSERT_EQ(batch->batch(0).resource_load().at("CPU"), 3);
+}
+
+/// Measure the bytes that the raylets receive and the time they spend parsing them per
+/// heartbeat period, as the number of nodes grows. Each node has a few resources, and
+/// the available resources of 5% of the nodes change every period.
+TEST(GcsResourceViewTest, DISABLED_TestPublishCostPerf) {
+  const int num_periods = 20;
+  for (int num_nodes : {100, 500, 1000, 2000}) {
+    for (int64_t full_sync_period : {1, 10}) {
+      gcs::GcsResourceView view(full_sync_period, /*light_heartbeat_enabled=*/false);
+      std::vector<rpc::HeartbeatTableData> heartbeats;
+      for (int i = 0; i < num_nodes; i++) {
+        heartbeats.push_back(GenHeartbeat(NodeID::FromRandom(),
+                                          {{"CPU", 16},
+                                           {"GPU", 4},
+                                           {"memory", 100},
+                                           {"object_store_memory", 50},
+                                           {"node:" + std::to_string(i), 1}},
+                                          {{"CPU", 16},
+                                           {"GPU", 4},
+                                           {"memory", 100},
+                                           {"object_store_memory", 50},
+                                           {"node:" + std::to_string(i), 1}}));
+      }
+      for (const auto &heartbeat : heartbeats) {
+        view.UpdateNode(NodeID::FromBinary(heartbeat.client_id()), heartbeat);
+      }
+      view.NextBatch();
+
+      uint64_t bytes = 0;
+      int64_t publish_ns = 0;
+      int64_t parse_ns = 0;
+      for (int period = 0; period < num_periods; period++) {
+        for (int i = 0; i < num_nodes; i++) {
+          auto &heartbeat = heartbeats[i];
+          if ((i + period) % 20 == 0) {
+            auto &cpu = (*heartbeat.mutable_resources_available())["CPU"];
+            cpu = cpu == 16 ? 8 : 16;
+          }
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &heartbeat : heartbeats) {
+          view.UpdateNode(NodeID::FromBinary(heartbeat.client_id()), heartbeat);
+        }
+        auto batch = view.NextBatch();
+        std::string data = batch ? batch->SerializeAsString() : "";
+        auto published = std::chrono::steady_clock::now();
+        rpc::HeartbeatBatchTableData received;
+        received.ParseFromString(data);
+        auto parsed = std::chrono::steady_clock::now();
+        bytes += data.size();
+        publish_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          published - start)
+                          .count();
+        parse_ns +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(parsed - published)
+                .count();
+      }
+      // Every raylet receives and parses each batch.
+      RAY_LOG(INFO) << num_nodes << " nodes, full sync period " << full_sync_period
+                    << ": " << bytes / num_periods << " bytes per batch, "
+                    << bytes * num_nodes / num_periods / 1e6
+                    << " MB per period cluster-wide, GCS publish "
+                    << publish_ns / num_periods / 1000 << "us per period, raylet parse "
+                    << parse_ns / num_periods / 1000 << "us per period, cluster-wide "
+                    << parse_ns * num_nodes / num_periods / 1000000 << "ms per period";
+    }
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/chunk_sizer.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+/// Chunks are multiples of the page size, so that they are copied aligned.
+const uint64_t kPageSize = 4096;
+
+/// The weight of a new measurement in the moving averages.
+const double kNewMeasurementWeight = 0.5;
+
+double MovingAverage(double average, double measurement) {
+  if (average == 0) {
+    return measurement;
+  }
+  return (1 - kNewMeasurementWeight) * average + kNewMeasurementWeight * measurement;
+}
+
+}  // namespace
+
+ChunkSizer::ChunkSizer(uint64_t default_chunk_size, uint64_t min_chunk_size,
+                       uint64_t max_chunk_size, int64_t target_chunk_ms,
+                       uint64_t min_chunks)
+    : default_chunk_size_(default_chunk_size),
+      min_chunk_size_(std::max<uint64_t>(min_chunk_size, 1)),
+      max_chunk_size_(std::max(max_chunk_size, min_chunk_size_)),
+      target_chunk_ms_(target_chunk_ms),
+      min_chunks_(std::max<uint64_t>(min_chunks, 1)) {}
+
+uint64_t ChunkSizer::ChunkSize(uint64_t object_size, const NodeID &node_id) const {
+  double throughput = Throughput(node_id);
+  uint64_t chunk_size = throughput > 0
+                            ? static_cast<uint64_t>(throughput * target_chunk_ms_ / 1000)
+                            : default_chunk_size_;
+  chunk_size = std::min(chunk_size, (object_size + min_chunks_ - 1) / min_chunks_);
+  chunk_size = std::max(std::min(chunk_size, max_chunk_size_), min_chunk_size_);
+  return (chunk_size + kPageSize - 1) / kPageSize * kPageSize;
+}
+
+void ChunkSizer::TransferStarted(const ObjectID &object_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  transfers_[object_id];
+}
+
+void ChunkSizer::ChunkReceived(const ObjectID &object_id, const NodeID &node_id,
+                               uint64_t bytes, double end_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = transfers_.find(object_id);
+  if (it == transfers_.end()) {
+    return;
+  }
+  Transfer &transfer = it->second[node_id];
+  if (transfer.num_chunks == 0) {
+    transfer.first_chunk_bytes = bytes;
+    transfer.first_end_time = end_time;
+  }
+  transfer.num_chunks++;
+  transfer.bytes += bytes;
+  transfer.last_end_time = std::max(transfer.last_end_time, end_time);
+}
+
+void ChunkSizer::TransferFinished(const ObjectID &object_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = transfers_.find(object_id);
+  if (it == transfers_.end()) {
+    return;
+  }
+  for (const auto &entry : it->second) {
+    const Transfer &transfer = entry.second;
+    num_transfers_++;
+    num_chunks_ += transfer.num_chunks;
+    num_bytes_ += transfer.bytes;
+    recent_chunks_per_transfer_ =
+        MovingAverage(recent_chunks_per_transfer_, transfer.num_chunks);
+    // The rate is only known once chunks arrived one after the other.
+    double elapsed = transfer.last_end_time - transfer.first_end_time;
+    if (elapsed <= 0) {
+      continue;
+    }
+    double bytes_per_sec = (transfer.bytes - transfer.first_chunk_bytes) / elapsed;
+    RAY_LOG(DEBUG) << "Received " << transfer.num_chunks << " chunks of object "
+                   << object_id << " from " << entry.first << ", " << transfer.bytes
+                   << " bytes at " << bytes_per_sec / 1e6 << " MB/s";
+    recent_throughput_ = MovingAverage(recent_throughput_, bytes_per_sec);
+    throughput_[entry.first] = MovingAverage(throughput_[entry.first], bytes_per_sec);
+  }
+  transfers_.erase(it);
+}
+
+void ChunkSizer::UpdateThroughput(const NodeID &node_id, double bytes_per_sec) {
+  if (bytes_per_sec <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  throughput_[node_id] = MovingAverage(throughput_[node_id], bytes_per_sec);
+}
+
+double ChunkSizer::Throughput(const NodeID &node_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = throughput_.find(node_id);
+  return it == throughput_.end() ? 0 : it->second;
+}
+
+double ChunkSizer::RecentThroughput() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return recent_throughput_;
+}
+
+double ChunkSizer::RecentChunksPerTransfer() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return recent_chunks_per_transfer_;
+}
+
+size_t ChunkSizer::NumTransfers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return transfers_.size();
+}
+
+std::string ChunkSizer::DebugString() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::stringstream result;
+  result << "ChunkSizer:";
+  result << "\n- num transfers in progress: " << transfers_.size();
+  result << "\n- num finished transfers: " << num_transfers_;
+  result << "\n- num chunks received: " << num_chunks_;
+  result << "\n- num bytes received: " << num_bytes_;
+  result << "\n- recent chunks per transfer: " << recent_chunks_per_transfer_;
+  result << "\n- recent throughput: " << recent_throughput_ / 1e6 << " MB/s";
+  result << "\n- num nodes with known throughput: " << throughput_.size();
+  return result.str();
+}
+
+}  // namespace ray
@@ -0,0 +1,136 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "ray/common/id.h"
+
+namespace ray {
+
+/// Chooses the size of the chunks that objects are split into when they are sent to a
+/// node, and measures the rate at which objects are received from each node.
+///
+/// Each chunk is sent in its own request, so small chunks make the per-request overhead
+/// dominate the transfer of large objects over fast links, while large chunks make a
+/// small object wait for a single thread to send it whole. Chunks are sized so that
+/// sending one to a node takes about `target_chunk_ms` at the rate measured for the
+/// node, and so that objects are split into at least `min_chunks` chunks when they are
+/// large enough.
+///
+/// This class is thread-safe.
+class ChunkSizer {
+ public:
+  /// Create a chunk sizer.
+  ///
+  /// \param default_chunk_size The chunk size for nodes whose rate is not known yet.
+  /// \param min_chunk_size The minimum chunk size.
+  /// \param max_chunk_size The maximum chunk size.
+  /// \param target_chunk_ms How long sending a chunk should take, in milliseconds.
+  /// \param min_chunks The number of chunks objects are split into at least.
+  ChunkSizer(uint64_t default_chunk_size, uint64_t min_chunk_size,
+             uint64_t max_chunk_size, int64_t target_chunk_ms, uint64_t min_chunks);
+
+  /// Choose the chunk size to send an object to a node with.
+  ///
+  /// \param object_size The size of the object and its metadata.
+  /// \param node_id The node the object is sent to.
+  /// \return The chunk size in bytes, which is a multiple of the page size.
+  uint64_t ChunkSize(uint64_t object_size, const NodeID &node_id) const;
+
+  /// Record that chunks of an object are expected, because the object is pulled.
+  /// Chunks are only recorded between this and `TransferFinished`, so that chunks
+  /// that arrive late, or that are pushed without being pulled, are not tracked.
+  ///
+  /// \param object_id The object.
+  void TransferStarted(const ObjectID &object_id);
+
+  /// Record that a chunk of an object was received from a node. This does nothing if
+  /// the transfer of the object was not started.
+  ///
+  /// \param object_id The object.
+  /// \param node_id The node that sent the chunk.
+  /// \param bytes The size of the chunk.
+  /// \param end_time The time the chunk was received at, in seconds.
+  void ChunkReceived(const ObjectID &object_id, const NodeID &node_id, uint64_t bytes,
+                     double end_time);
+
+  /// Record that no more chunks of an object are expected, because the object was
+  /// received or is not needed anymore. This updates the rate of the nodes that sent
+  /// chunks of the object.
+  ///
+  /// \param object_id The object.
+  void TransferFinished(const ObjectID &object_id);
+
+  /// Update the rate at which objects are transferred to or from a node.
+  ///
+  /// \param node_id The node.
+  /// \param bytes_per_sec The measured rate in bytes per second.
+  void UpdateThroughput(const NodeID &node_id, double bytes_per_sec);
+
+  /// The rate at which objects are transferred to or from a node.
+  ///
+  /// \param node_id The node.
+  /// \return The rate in bytes per second, or 0 if it is not known.
+  double Throughput(const NodeID &node_id) const;
+
+  /// The average rate of the transfers that finished recently, in bytes per second.
+  double RecentThroughput() const;
+
+  /// The average number of chunks of the transfers that finished recently.
+  double RecentChunksPerTransfer() const;
+
+  /// The number of objects whose transfer was started and not finished yet.
+  size_t NumTransfers() const;
+
+  std::string DebugString() const;
+
+ private:
+  /// The chunks of an object received from a node.
+  struct Transfer {
+    uint64_t num_chunks = 0;
+    uint64_t bytes = 0;
+    /// The size of the first chunk, which is not counted in the rate since the time
+    /// it took to arrive is not known.
+    uint64_t first_chunk_bytes = 0;
+    double first_end_time = 0;
+    double last_end_time = 0;
+  };
+
+  const uint64_t default_chunk_size_;
+  const uint64_t min_chunk_size_;
+  const uint64_t max_chunk_size_;
+  const int64_t target_chunk_ms_;
+  const uint64_t min_chunks_;
+
+  /// Protects all the fields below.
+  mutable std::mutex mutex_;
+  /// The transfers in progress, by object and sending node.
+  std::unordered_map<ObjectID, std::unordered_map<NodeID, Transfer>> transfers_;
+  /// The moving average of the rate of each node, in bytes per second.
+  std::unordered_map<NodeID, double> throughput_;
+
+  /// Statistics of the finished transfers.
+  uint64_t num_transfers_ = 0;
+  uint64_t num_chunks_ = 0;
+  uint64_t num_bytes_ = 0;
+  double recent_throughput_ = 0;
+  double recent_chunks_per_transfer_ = 0;
+};
+
+}  // namespace ray
@@ -41,26 +41,35 @@ ObjectBufferPool::~ObjectBufferPool() {
   RAY_CHECK_OK(store_client_.Disconnect());
 }
 
-uint64_t ObjectBufferPool::GetNumChunks(uint64_t data_size) {
-  return (data_size + default_chunk_size_ - 1) / default_chunk_size_;
+uint64_t ObjectBufferPool::GetNumChunks(uint64_t data_size, uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
+  return (data_size + chunk_size - 1) / chunk_size;
 }
 
-uint64_t ObjectBufferPool::GetBufferLength(uint64_t chunk_index, uint64_t data_size) {
-  return (chunk_index + 1) * default_chunk_size_ > data_size
-             ? data_size % default_chunk_size_
-             : default_chunk_size_;
+uint64_t ObjectBufferPool::GetBufferLength(uint64_t chunk_index, uint64_t data_size,
+                                           uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
+  return (chunk_index + 1) * chunk_size > data_size ? data_size - chunk_index * chunk_size
+                                                    : chunk_size;
 }
 
-std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::GetChunk(
+std::pair<ObjectBufferPool::ChunkInfo, ray::Status> ObjectBufferPool::GetChunk(
     const ObjectID &object_id, uint64_t data_size, uint64_t metadata_size,
-    uint64_t chunk_index) {
+    uint64_t chunk_index, uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
   std::lock_guard<std::mutex> lock(pool_mutex_);
   if (get_buffer_state_.count(object_id) == 0) {
     plasma::ObjectBuffer object_buffer;
     RAY_CHECK_OK(store_client_.Get(&object_id, 1, 0, &object_buffer));
     if (object_buffer.data == nullptr) {
       RAY_LOG(ERROR) << "Failed to get object";
-      return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+      return std::pair<ObjectBufferPool::ChunkInfo, ray::Status>(
           errored_chunk_,
           ray::Status::IOError("Unable to obtain object chunk, object not local."));
     }
@@ -69,15 +78,23 @@ std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::Ge
     RAY_CHECK(data_size == static_cast<uint64_t>(object_buffer.data->size() +
                                                  object_buffer.metadata->size()));
     auto *data = const_cast<uint8_t *>(object_buffer.data->data());
-    uint64_t num_chunks = GetNumChunks(data_size);
-    get_buffer_state_.emplace(
-        std::piecewise_construct, std::forward_as_tuple(object_id),
-        std::forward_as_tuple(BuildChunks(object_id, data, data_size)));
-    RAY_CHECK(get_buffer_state_[object_id].chunk_info.size() == num_chunks);
+    get_buffer_state_.emplace(std::piecewise_construct, std::forward_as_tuple(object_id),
+                              std::forward_as_tuple(data, data_size));
   }
-  get_buffer_state_[object_id].references++;
-  return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
-      get_buffer_state_[object_id].chunk_info[chunk_index], ray::Status::OK());
+  GetBufferState &buffer_state = get_buffer_state_[object_id];
+  if (chunk_index >= GetNumChunks(buffer_state.data_size, chunk_size)) {
+    if (buffer_state.references == 0) {
+      RAY_CHECK_OK(store_client_.Release(object_id));
+      get_buffer_state_.erase(object_id);
+    }
+    return std::pair<ObjectBufferPool::ChunkInfo, ray::Status>(
+        errored_chunk_, ray::Status::Invalid("Chunk index out of range."));
+  }
+  buffer_state.references++;
+  return std::pair<ObjectBufferPool::ChunkInfo, ray::Status>(
+      ChunkInfo(chunk_index, buffer_state.data + chunk_index * chunk_size,
+                GetBufferLength(chunk_index, buffer_state.data_size, chunk_size)),
+      ray::Status::OK());
 }
 
 void ObjectBufferPool::ReleaseGetChunk(const ObjectID &object_id, uint64_t chunk_index) {
@@ -98,33 +115,62 @@ void ObjectBufferPool::AbortGet(const ObjectID &object_id) {
 
 std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::CreateChunk(
     const ObjectID &object_id, const rpc::Address &owner_address, uint64_t data_size,
-    uint64_t metadata_size, uint64_t chunk_index) {
+    uint64_t metadata_size, uint64_t chunk_index, uint64_t chunk_size) {
+  if (chunk_size == 0) {
+    chunk_size = default_chunk_size_;
+  }
   std::lock_guard<std::mutex> lock(pool_mutex_);
   if (create_buffer_state_.count(object_id) == 0) {
+    if (chunk_index >= GetNumChunks(data_size, chunk_size)) {
+      return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+          errored_chunk_, ray::Status::Invalid("Chunk index out of range."));
+    }
     int64_t object_size = data_size - metadata_size;
     // Try to create shared buffer.
     std::shared_ptr<Buffer> data;
     Status s = store_client_.Create(object_id, owner_address, object_size, NULL,
                                     metadata_size, &data);
     std::vector<boost::asio::mutable_buffer> buffer;
+    if (s.IsObjectExists()) {
+      return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(errored_chunk_,
+                                                                         s);
+    }
     if (!s.ok()) {
-      // Create failed. The object may already exist locally. If something else went
-      // wrong, another chunk will succeed in creating the buffer, and this
-      // chunk will eventually make it here via pull requests.
+      // Create failed. If something went wrong, another chunk will succeed in
+      // creating the buffer, and this chunk will eventually make it here via pull
+      // requests.
       return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
           errored_chunk_, ray::Status::IOError(s.message()));
     }
     // Read object into store.
     uint8_t *mutable_data = data->mutable_data();
-    uint64_t num_chunks = GetNumChunks(data_size);
+    uint64_t num_chunks = GetNumChunks(data_size, chunk_size);
     create_buffer_state_.emplace(
         std::piecewise_construct, std::forward_as_tuple(object_id),
-        std::forward_as_tuple(BuildChunks(object_id, mutable_data, data_size)));
+        std::forward_as_tuple(BuildChunks(object_id, mutable_data, data_size, chunk_size),
+                              chunk_size));
     RAY_LOG(DEBUG) << "Created object " << object_id
                    << " in plasma store, number of chunks: " << num_chunks
                    << ", chunk index: " << chunk_index;
     RAY_CHECK(create_buffer_state_[object_id].chunk_info.size() == num_chunks);
   }
+  if (create_buffer_state_[object_id].chunk_size != chunk_size) {
+    // The chunks were sent by another node, which split the object differently.
+    return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+        errored_chunk_, ray::Status::IOError(
+                            "Object is being received in chunks of " +
+                            std::to_string(create_buffer_state_[object_id].chunk_size) +
+                            " bytes, not " + std::to_string(chunk_size) + "."));
+  }
+  if (chunk_index >= create_buffer_state_[object_id].chunk_state.size()) {
+    return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+        errored_chunk_, ray::Status::Invalid("Chunk index out of range."));
+  }
+  if (create_buffer_state_[object_id].chunk_state[chunk_index] ==
+      CreateChunkState::SEALED) {
+    return std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status>(
+        errored_chunk_, ray::Status::ObjectExists("Chunk already received."));
+  }
   if (create_buffer_state_[object_id].chunk_state[chunk_index] !=
       CreateChunkState::AVAILABLE) {
     // There can be only one reference to this chunk at any given time.
@@ -137,6 +183,12 @@ std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> ObjectBufferPool::Cr
       create_buffer_state_[object_id].chunk_info[chunk_index], ray::Status::OK());
 }
 
+uint64_t ObjectBufferPool::GetCreateChunkSize(const ObjectID &object_id) const {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  return it == create_buffer_state_.end() ? 0 : it->second.chunk_size;
+}
+
 void ObjectBufferPool::AbortCreateChunk(const ObjectID &object_id,
                                         const uint64_t chunk_index) {
   std::lock_guard<std::mutex> lock(pool_mutex_);
@@ -180,18 +232,18 @@ void ObjectBufferPool::AbortCreate(const ObjectID &object_id) {
 }
 
 std::vector<ObjectBufferPool::ChunkInfo> ObjectBufferPool::BuildChunks(
-    const ObjectID &object_id, uint8_t *data, uint64_t data_size) {
+    const ObjectID &object_id, uint8_t *data, uint64_t data_size, uint64_t chunk_size) {
   uint64_t space_remaining = data_size;
   std::vector<ChunkInfo> chunks;
   int64_t position = 0;
   while (space_remaining) {
     position = data_size - space_remaining;
-    if (space_remaining < default_chunk_size_) {
+    if (space_remaining < chunk_size) {
       chunks.emplace_back(chunks.size(), data + position, space_remaining);
       space_remaining = 0;
     } else {
-      chunks.emplace_back(chunks.size(), data + position, default_chunk_size_);
-      space_remaining -= default_chunk_size_;
+      chunks.emplace_back(chunks.size(), data + position, chunk_size);
+      space_remaining -= chunk_size;
     }
   }
   return chunks;
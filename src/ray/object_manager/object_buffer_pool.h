@@ -57,18 +57,24 @@ class ObjectBufferPool {
   /// This object cannot be copied due to pool_mutex.
   RAY_DISALLOW_COPY_AND_ASSIGN(ObjectBufferPool);
 
+  /// The chunk size that objects are split into unless another size is given.
+  uint64_t DefaultChunkSize() const { return default_chunk_size_; }
+
   /// Computes the number of chunks needed to transfer an object and its metadata.
   ///
   /// \param data_size The size of the object + metadata.
+  /// \param chunk_size The size of the chunks, or 0 for the default chunk size.
   /// \return The number of chunks into which the object will be split.
-  uint64_t GetNumChunks(uint64_t data_size);
+  uint64_t GetNumChunks(uint64_t data_size, uint64_t chunk_size = 0);
 
   /// Computes the buffer length of a chunk of an object.
   ///
   /// \param chunk_index The chunk index for which to obtain the buffer length.
   /// \param data_size The size of the object + metadata.
+  /// \param chunk_size The size of the chunks, or 0 for the default chunk size.
   /// \return The buffer length of the chunk at chunk_index.
-  uint64_t GetBufferLength(uint64_t chunk_index, uint64_t data_size);
+  uint64_t GetBufferLength(uint64_t chunk_index, uint64_t data_size,
+                           uint64_t chunk_size = 0);
 
   /// Returns a chunk of an object at the given chunk_index. The object chunk serves
   /// as the data that is to be written to a connection as part of sending an object to
@@ -78,11 +84,15 @@ class ObjectBufferPool {
   /// \param data_size The sum of the object size and metadata size.
   /// \param metadata_size The size of the metadata.
   /// \param chunk_index The index of the chunk.
+  /// \param chunk_size The size of the chunks, or 0 for the default chunk size. The
+  /// same object may be read in chunks of different sizes at once.
   /// \return A pair consisting of a ChunkInfo and status of invoking this method.
   /// An IOError status is returned if the Get call on the plasma store fails.
-  std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> GetChunk(
-      const ObjectID &object_id, uint64_t data_size, uint64_t metadata_size,
-      uint64_t chunk_index);
+  std::pair<ObjectBufferPool::ChunkInfo, ray::Status> GetChunk(const ObjectID &object_id,
+                                                               uint64_t data_size,
+                                                               uint64_t metadata_size,
+                                                               uint64_t chunk_index,
+                                                               uint64_t chunk_size = 0);
 
   /// When a chunk is done being used as part of a get, this method releases the chunk.
   /// If all chunks of an object are released, the object buffer will be released.
@@ -104,13 +114,23 @@ class ObjectBufferPool {
   /// \param data_size The sum of the object size and metadata size.
   /// \param metadata_size The size of the metadata.
   /// \param chunk_index The index of the chunk.
+  /// \param chunk_size The size of the chunks, or 0 for the default chunk size. This
+  /// must be the same for all the chunks of an object.
   /// \return A pair consisting of ChunkInfo and status of invoking this method.
-  /// An IOError status is returned if object creation on the store client fails,
-  /// or if create is invoked consecutively on the same chunk
-  /// (with no intermediate AbortCreateChunk).
+  /// An ObjectExists status is returned if the object already exists in the store
+  /// or the chunk was already sealed. An IOError status is returned if object
+  /// creation on the store client fails otherwise, if create is invoked consecutively
+  /// on the same chunk (with no intermediate AbortCreateChunk), or if the object is
+  /// being created with another chunk size.
   std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> CreateChunk(
       const ObjectID &object_id, const rpc::Address &owner_address, uint64_t data_size,
-      uint64_t metadata_size, uint64_t chunk_index);
+      uint64_t metadata_size, uint64_t chunk_index, uint64_t chunk_size = 0);
+
+  /// Returns the size of the chunks that an object is being created with.
+  ///
+  /// \param object_id The ObjectID.
+  /// \return The chunk size, or 0 if the object is not being created.
+  uint64_t GetCreateChunkSize(const ObjectID &object_id) const;
 
   /// Abort the create operation associated with a chunk at chunk_index.
   /// This method will fail if it's invoked on a chunk_index on which
@@ -153,15 +173,17 @@ class ObjectBufferPool {
   /// Splits an object into ceil(data_size/chunk_size) chunks, which will
   /// either be read or written to in parallel.
   std::vector<ChunkInfo> BuildChunks(const ObjectID &object_id, uint8_t *data,
-                                     uint64_t data_size);
+                                     uint64_t data_size, uint64_t chunk_size);
 
   /// Holds the state of a get buffer.
   struct GetBufferState {
     GetBufferState() {}
-    GetBufferState(std::vector<ChunkInfo> chunk_info) : chunk_info(chunk_info) {}
-    /// A vector maintaining information about the chunks which comprise
-    /// an object.
-    std::vector<ChunkInfo> chunk_info;
+    GetBufferState(uint8_t *data, uint64_t data_size)
+        : data(data), data_size(data_size) {}
+    /// The object and its metadata. Chunks are computed from this on each get, since
+    /// the object may be read in chunks of different sizes.
+    uint8_t *data = nullptr;
+    uint64_t data_size = 0;
     /// The number of references that currently rely on this buffer.
     /// Once this reaches 0, the buffer is released and this object is erased
     /// from get_buffer_state_.
@@ -174,10 +196,11 @@ class ObjectBufferPool {
   /// Holds the state of a create buffer.
   struct CreateBufferState {
     CreateBufferState() {}
-    CreateBufferState(std::vector<ChunkInfo> chunk_info)
+    CreateBufferState(std::vector<ChunkInfo> chunk_info, uint64_t chunk_size)
         : chunk_info(chunk_info),
           chunk_state(chunk_info.size(), CreateChunkState::AVAILABLE),
-          num_seals_remaining(chunk_info.size()) {}
+          num_seals_remaining(chunk_info.size()),
+          chunk_size(chunk_size) {}
     /// A vector maintaining information about the chunks which comprise
     /// an object.
     std::vector<ChunkInfo> chunk_info;
@@ -186,6 +209,8 @@ class ObjectBufferPool {
     std::vector<CreateChunkState> chunk_state;
     /// The number of chunks left to seal before the buffer is sealed.
     uint64_t num_seals_remaining;
+    /// The size of the chunks the object is split into.
+    uint64_t chunk_size;
   };
 
   /// Returned when GetChunk or CreateChunk fails.
@@ -14,6 +14,7 @@
 
 #include "ray/object_manager/object_manager.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "ray/common/common_protocol.h"
@@ -57,6 +58,11 @@ ObjectManager::ObjectManager(asio::io_service &main_service, const NodeID &self_
       object_directory_(std::move(object_directory)),
       object_store_internal_(config),
       buffer_pool_(config_.store_socket_name, config_.object_chunk_size),
+      chunk_sizer_(config_.object_chunk_size,
+                   RayConfig::instance().object_manager_min_chunk_size(),
+                   RayConfig::instance().object_manager_max_chunk_size(),
+                   RayConfig::instance().object_manager_chunk_target_ms(),
+                   config_.rpc_service_threads_number),
       rpc_work_(rpc_service_),
       gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
       object_manager_server_("ObjectManager", config_.object_manager_port,
@@ -130,10 +136,12 @@ void ObjectManager::HandleObjectAdded(
   if (iter != unfulfilled_push_requests_.end()) {
     for (auto &pair : iter->second) {
       auto &client_id = pair.first;
-      main_service_->post([this, object_id, client_id]() { Push(object_id, client_id); });
+      auto chunks = pair.second.chunks;
+      main_service_->post(
+          [this, object_id, client_id, chunks]() { Push(object_id, client_id, chunks); });
       // When push timeout is set to -1, there will be an empty timer in pair.second.
-      if (pair.second != nullptr) {
-        pair.second->cancel();
+      if (pair.second.timer != nullptr) {
+        pair.second.timer->cancel();
       }
     }
     unfulfilled_push_requests_.erase(iter);
@@ -181,6 +189,7 @@ ray::Status ObjectManager::Pull(const ObjectID &object_id,
   }
 
   pull_requests_.emplace(object_id, PullRequest());
+  chunk_sizer_.TransferStarted(object_id);
   // Subscribe to object notifications. A notification will be received every
   // time the set of client IDs for the object changes. Notifications will also
   // be received if the list of locations is empty. The set of client IDs has
@@ -253,6 +262,11 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
     return;
   }
 
+  if (it->second.striped_pull != nullptr) {
+    TryStripedPull(object_id);
+    return;
+  }
+
   // Choose a random client to pull the object from.
   // Generate a random index.
   std::uniform_int_distribution<int> distribution(0, node_vector.size() - 1);
@@ -272,14 +286,24 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
     RAY_CHECK(node_id != self_node_id_);
   }
 
+  // If the object is on several nodes, only ask for its first chunk, to learn how
+  // large it is. The other chunks are then pulled from all the nodes, see
+  // `HandlePulledChunk`.
+  std::vector<uint64_t> chunk_indices;
+  it->second.probing = RayConfig::instance().object_manager_max_pull_sources() > 1 &&
+                       node_vector.size() > 1;
+  if (it->second.probing) {
+    chunk_indices.push_back(0);
+  }
+
   RAY_LOG(DEBUG) << "Sending pull request from " << self_node_id_ << " to " << node_id
                  << " of object " << object_id;
 
   auto rpc_client = GetRpcClient(node_id);
   if (rpc_client) {
     // Try pulling from the client.
-    rpc_service_.post([this, object_id, node_id, rpc_client]() {
-      SendPullRequest(object_id, node_id, rpc_client);
+    rpc_service_.post([this, object_id, node_id, rpc_client, chunk_indices]() {
+      SendPullRequest(object_id, node_id, rpc_client, chunk_indices);
     });
   } else {
     RAY_LOG(ERROR) << "Couldn't send pull request from " << self_node_id_ << " to "
@@ -290,29 +314,7 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
   // If there are more clients to try, try them in succession, with a timeout
   // in between each try.
   if (!it->second.client_locations.empty()) {
-    if (it->second.retry_timer == nullptr) {
-      // Set the timer if we haven't already.
-      it->second.retry_timer = std::unique_ptr<boost::asio::deadline_timer>(
-          new boost::asio::deadline_timer(*main_service_));
-    }
-
-    // Wait for a timeout. If we receive the object or a caller Cancels the
-    // Pull within the timeout, then nothing will happen. Otherwise, the timer
-    // will fire and the next client in the list will be tried.
-    boost::posix_time::milliseconds retry_timeout(config_.pull_timeout_ms);
-    it->second.retry_timer->expires_from_now(retry_timeout);
-    it->second.retry_timer->async_wait(
-        [this, object_id](const boost::system::error_code &error) {
-          if (!error) {
-            // Try the Pull from the next client.
-            TryPull(object_id);
-          } else {
-            // Check that the error was due to the timer being canceled.
-            RAY_CHECK(error == boost::asio::error::operation_aborted);
-          }
-        });
-    // Record that we set the timer until the next attempt.
-    it->second.timer_set = true;
+    SetPullRetryTimer(object_id);
   } else {
     // The timer is not reset since there are no more clients to try. Go back
     // to waiting for more notifications. Once we receive a new object location
@@ -321,12 +323,138 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
   }
 };
 
+void ObjectManager::SetPullRetryTimer(const ObjectID &object_id) {
+  auto &pull_request = pull_requests_[object_id];
+  if (pull_request.retry_timer == nullptr) {
+    // Set the timer if we haven't already.
+    pull_request.retry_timer = std::unique_ptr<boost::asio::deadline_timer>(
+        new boost::asio::deadline_timer(*main_service_));
+  }
+
+  // Wait for a timeout. If we receive the object or a caller Cancels the
+  // Pull within the timeout, then nothing will happen. Otherwise, the timer
+  // will fire and the next client in the list will be tried.
+  boost::posix_time::milliseconds retry_timeout(config_.pull_timeout_ms);
+  pull_request.retry_timer->expires_from_now(retry_timeout);
+  pull_request.retry_timer->async_wait(
+      [this, object_id](const boost::system::error_code &error) {
+        if (!error) {
+          // Try the Pull from the next client.
+          TryPull(object_id);
+        } else {
+          // Check that the error was due to the timer being canceled.
+          RAY_CHECK(error == boost::asio::error::operation_aborted);
+        }
+      });
+  // Record that we set the timer until the next attempt.
+  pull_request.timer_set = true;
+}
+
+void ObjectManager::TryStripedPull(const ObjectID &object_id) {
+  auto &pull_request = pull_requests_[object_id];
+  auto &striped_pull = *pull_request.striped_pull;
+  int64_t now_ms = current_time_ms();
+  for (const auto &node_id :
+       striped_pull.RemoveStalledSources(now_ms, config_.pull_timeout_ms)) {
+    RAY_LOG(WARNING) << "Stopped pulling object " << object_id << " from " << node_id
+                     << ", which did not send any chunk for " << config_.pull_timeout_ms
+                     << " ms.";
+  }
+  for (const auto &node_id : pull_request.client_locations) {
+    if (node_id != self_node_id_) {
+      striped_pull.AddSource(node_id, now_ms);
+    }
+  }
+  if (striped_pull.NumSources() == 0) {
+    // All the locations stalled. Start over, as if the object was not pulled yet.
+    RAY_LOG(WARNING) << "Restarting the pull of object " << object_id
+                     << ", since none of its locations sent chunks: "
+                     << striped_pull.DebugString();
+    pull_request.striped_pull.reset();
+    TryPull(object_id);
+    return;
+  }
+  PullChunks(object_id);
+  SetPullRetryTimer(object_id);
+}
+
+void ObjectManager::PullChunks(const ObjectID &object_id) {
+  auto &striped_pull = *pull_requests_[object_id].striped_pull;
+  for (const auto &entry : striped_pull.AssignChunks(current_time_ms())) {
+    const NodeID &node_id = entry.first;
+    const std::vector<uint64_t> &chunk_indices = entry.second;
+    auto rpc_client = GetRpcClient(node_id);
+    if (rpc_client) {
+      rpc_service_.post([this, object_id, node_id, rpc_client, chunk_indices]() {
+        SendPullRequest(object_id, node_id, rpc_client, chunk_indices);
+      });
+    } else {
+      RAY_LOG(ERROR) << "Couldn't send pull request from " << self_node_id_ << " to "
+                     << node_id << " of object " << object_id
+                     << " , setup rpc connection failed.";
+      // Its chunks are asked from the other nodes the next time a chunk is received.
+      striped_pull.RemoveSource(node_id);
+    }
+  }
+}
+
+void ObjectManager::HandlePulledChunk(const ObjectID &object_id, const NodeID &client_id,
+                                      uint64_t chunk_index, uint64_t data_size,
+                                      uint64_t chunk_size, bool success) {
+  auto it = pull_requests_.find(object_id);
+  if (it == pull_requests_.end()) {
+    return;
+  }
+  auto &pull_request = it->second;
+  int64_t now_ms = current_time_ms();
+  if (pull_request.striped_pull == nullptr) {
+    // If the first chunk was not written, the retry timer will ask for it again.
+    if (!pull_request.probing || !success) {
+      return;
+    }
+    pull_request.probing = false;
+    // The object is split into the chunks that the first one was sent with. If it is
+    // not being created anymore, it was received whole.
+    uint64_t object_chunk_size = buffer_pool_.GetCreateChunkSize(object_id);
+    if (object_chunk_size == 0) {
+      return;
+    }
+    uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size, object_chunk_size);
+    if (num_chunks <= 1) {
+      return;
+    }
+    pull_request.striped_pull.reset(new StripedPull(
+        num_chunks, object_chunk_size,
+        RayConfig::instance().object_manager_max_pull_sources(),
+        RayConfig::instance().object_manager_pull_chunks_per_source()));
+    pull_request.striped_pull->AddSource(client_id, now_ms);
+    for (const auto &node_id : pull_request.client_locations) {
+      if (node_id != self_node_id_) {
+        pull_request.striped_pull->AddSource(node_id, now_ms);
+      }
+    }
+    RAY_LOG(DEBUG) << "Pulling " << num_chunks << " chunks of object " << object_id
+                   << " from " << pull_request.striped_pull->NumSources() << " nodes";
+  }
+  pull_request.striped_pull->ChunkReceived(client_id, chunk_index, chunk_size, success,
+                                           now_ms);
+  PullChunks(object_id);
+}
+
 void ObjectManager::SendPullRequest(
     const ObjectID &object_id, const NodeID &client_id,
-    std::shared_ptr<rpc::ObjectManagerClient> rpc_client) {
+    std::shared_ptr<rpc::ObjectManagerClient> rpc_client,
+    const std::vector<uint64_t> &chunk_indices) {
   rpc::PullRequest pull_request;
   pull_request.set_object_id(object_id.Binary());
   pull_request.set_client_id(self_node_id_.Binary());
+  for (uint64_t chunk_index : chunk_indices) {
+    pull_request.add_chunk_indices(chunk_index);
+  }
+  // Chunks received from another node must not be sent again in other sizes.
+  pull_request.set_chunk_size(buffer_pool_.GetCreateChunkSize(object_id));
+  pull_request.set_receive_throughput(
+      static_cast<uint64_t>(chunk_sizer_.Throughput(client_id)));
 
   rpc_client->Pull(pull_request, [object_id, client_id](const Status &status,
                                                         const rpc::PullReply &reply) {
@@ -376,6 +504,7 @@ void ObjectManager::HandleSendFinished(const ObjectID &object_id, const NodeID &
 
 void ObjectManager::HandleReceiveFinished(const ObjectID &object_id,
                                           const NodeID &client_id, uint64_t chunk_index,
+                                          uint64_t data_size, uint64_t chunk_size,
                                           double start_time, double end_time,
                                           ray::Status status) {
   if (!status.ok()) {
@@ -393,17 +522,72 @@ void ObjectManager::HandleReceiveFinished(const ObjectID &object_id,
                                "\"," + std::to_string(chunk_index) + ",\"" +
                                status.ToString() + "\"]");
 
-  std::lock_guard<std::mutex> lock(profile_mutex_);
-  profile_events_.push_back(profile_event);
+  {
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    profile_events_.push_back(profile_event);
+  }
+
+  if (status.ok()) {
+    chunk_sizer_.ChunkReceived(object_id, client_id, chunk_size, end_time);
+  }
+  main_service_->post(
+      [this, object_id, client_id, chunk_index, data_size, chunk_size, status]() {
+        HandlePulledChunk(object_id, client_id, chunk_index, data_size, chunk_size,
+                          status.ok());
+      });
 }
 
-void ObjectManager::Push(const ObjectID &object_id, const NodeID &client_id) {
+namespace {
+
+/// Add the chunks of a push request to those of another request for the same object
+/// and node, so that a single push sends both.
+void MergeObjectChunks(const ObjectChunks &chunks, ObjectChunks *merged) {
+  if (merged->chunk_indices.empty()) {
+    return;
+  }
+  if (chunks.chunk_indices.empty() || chunks.chunk_size != merged->chunk_size) {
+    *merged = ObjectChunks();
+    return;
+  }
+  for (uint64_t chunk_index : chunks.chunk_indices) {
+    if (std::find(merged->chunk_indices.begin(), merged->chunk_indices.end(),
+                  chunk_index) == merged->chunk_indices.end()) {
+      merged->chunk_indices.push_back(chunk_index);
+    }
+  }
+}
+
+/// Whether a push sent all the chunks that another push would send.
+bool CoversObjectChunks(const ObjectChunks &pushed, const ObjectChunks &chunks) {
+  if (pushed.chunk_indices.empty()) {
+    return true;
+  }
+  if (chunks.chunk_indices.empty() || chunks.chunk_size != pushed.chunk_size) {
+    return false;
+  }
+  for (uint64_t chunk_index : chunks.chunk_indices) {
+    if (std::find(pushed.chunk_indices.begin(), pushed.chunk_indices.end(),
+                  chunk_index) == pushed.chunk_indices.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void ObjectManager::Push(const ObjectID &object_id, const NodeID &client_id,
+                         const ObjectChunks &chunks) {
   RAY_LOG(DEBUG) << "Push on " << self_node_id_ << " to " << client_id << " of object "
                  << object_id;
   if (local_objects_.count(object_id) == 0) {
-    // Avoid setting duplicated timer for the same object and client pair.
+    // Avoid setting duplicated timer for the same object and client pair, but push the
+    // chunks of both requests once the object is local.
     auto &clients = unfulfilled_push_requests_[object_id];
-    if (clients.count(client_id) == 0) {
+    auto push_it = clients.find(client_id);
+    if (push_it != clients.end()) {
+      MergeObjectChunks(chunks, &push_it->second.chunks);
+    } else {
       // If config_.push_timeout_ms < 0, we give an empty timer
       // and the task will be kept infinitely.
       auto timer = std::unique_ptr<boost::asio::deadline_timer>();
@@ -426,35 +610,53 @@ void ObjectManager::Push(const ObjectID &object_id, const NodeID &client_id) {
             });
       }
       if (config_.push_timeout_ms != 0) {
-        clients.emplace(client_id, std::move(timer));
+        clients.emplace(client_id, UnfulfilledPush{std::move(timer), chunks});
       }
     }
     return;
   }
 
-  // If we haven't pushed this object to this same object manager yet, then push
-  // it. If we have, but it was a long time ago, then push it. If we have and it
-  // was recent, then don't do it again.
+  // If we haven't pushed these chunks of this object to this same object manager yet,
+  // then push them. If we have, but it was a long time ago, then push them. If we have
+  // and it was recent, then don't do it again. If the object was evicted and recreated
+  // locally, it has no recent pushes.
   auto &recent_pushes = local_objects_[object_id].recent_pushes;
+  int64_t current_time = absl::GetCurrentTimeNanos() / 1000000;
   auto it = recent_pushes.find(client_id);
-  if (it == recent_pushes.end()) {
-    // We haven't pushed this specific object to this specific object manager
-    // yet (or if we have then the object must have been evicted and recreated
-    // locally).
-    recent_pushes[client_id] = absl::GetCurrentTimeNanos() / 1000000;
-  } else {
-    int64_t current_time = absl::GetCurrentTimeNanos() / 1000000;
-    if (current_time - it->second <=
-        RayConfig::instance().object_manager_repeated_push_delay_ms()) {
-      // We pushed this object to the object manager recently, so don't do it
-      // again.
-      RAY_LOG(DEBUG) << "Object " << object_id << " recently pushed to " << client_id;
-      return;
-    } else {
-      it->second = current_time;
-    }
+  if (it != recent_pushes.end() &&
+      current_time - it->second.time_ms <=
+          RayConfig::instance().object_manager_repeated_push_delay_ms() &&
+      CoversObjectChunks(it->second.chunks, chunks)) {
+    // We pushed these chunks to the object manager recently, so don't do it again.
+    RAY_LOG(DEBUG) << "Object " << object_id << " recently pushed to " << client_id;
+    return;
+  }
+  UniqueID push_id = UniqueID::FromRandom();
+  recent_pushes[client_id] = RecentPush{push_id, current_time, chunks};
+
+  SendObjectChunks(push_id, object_id, client_id, chunks.chunk_indices,
+                   chunks.chunk_size);
+}
+
+void ObjectManager::HandlePushChunkFailed(const UniqueID &push_id,
+                                          const ObjectID &object_id,
+                                          const NodeID &client_id) {
+  auto object_it = local_objects_.find(object_id);
+  if (object_it == local_objects_.end()) {
+    return;
   }
+  auto &recent_pushes = object_it->second.recent_pushes;
+  auto it = recent_pushes.find(client_id);
+  // A later push to the node is kept.
+  if (it != recent_pushes.end() && it->second.push_id == push_id) {
+    recent_pushes.erase(it);
+  }
+}
 
+void ObjectManager::SendObjectChunks(const UniqueID &push_id, const ObjectID &object_id,
+                                     const NodeID &client_id,
+                                     const std::vector<uint64_t> &chunk_indices,
+                                     uint64_t chunk_size) {
   auto rpc_client = GetRpcClient(client_id);
   if (rpc_client) {
     const object_manager::protocol::ObjectInfoT &object_info =
@@ -462,7 +664,24 @@ void ObjectManager::Push(const ObjectID &object_id, const NodeID &client_id) {
     uint64_t data_size =
         static_cast<uint64_t>(object_info.data_size + object_info.metadata_size);
     uint64_t metadata_size = static_cast<uint64_t>(object_info.metadata_size);
-    uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size);
+    if (chunk_size == 0) {
+      chunk_size = RayConfig::instance().object_manager_adaptive_chunk_size()
+                       ? chunk_sizer_.ChunkSize(data_size, client_id)
+                       : buffer_pool_.DefaultChunkSize();
+    }
+    uint64_t num_chunks = buffer_pool_.GetNumChunks(data_size, chunk_size);
+    std::vector<uint64_t> chunks_to_send;
+    if (chunk_indices.empty()) {
+      for (uint64_t chunk_index = 0; chunk_index < num_chunks; ++chunk_index) {
+        chunks_to_send.push_back(chunk_index);
+      }
+    } else {
+      for (uint64_t chunk_index : chunk_indices) {
+        if (chunk_index < num_chunks) {
+          chunks_to_send.push_back(chunk_index);
+        }
+      }
+    }
 
     rpc::Address owner_address;
     owner_address.set_raylet_id(object_info.owner_raylet_id);
@@ -471,18 +690,21 @@ void ObjectManager::Push(const ObjectID &object_id, const NodeID &client_id) {
     owner_address.set_worker_id(object_info.owner_worker_id);
 
     RAY_LOG(DEBUG) << "Sending object chunks of " << object_id << " to client "
-                   << client_id << ", number of chunks: " << num_chunks
+                   << client_id << ", number of chunks: " << chunks_to_send.size()
+                   << " of " << num_chunks << ", chunk size: " << chunk_size
                    << ", total data size: " << data_size;
 
-    UniqueID push_id = UniqueID::FromRandom();
-    for (uint64_t chunk_index = 0; chunk_index < num_chunks; ++chunk_index) {
+    for (uint64_t chunk_index : chunks_to_send) {
       rpc_service_.post([this, push_id, object_id, owner_address, client_id, data_size,
-                         metadata_size, chunk_index, rpc_client]() {
+                         metadata_size, chunk_index, chunk_size, rpc_client]() {
         auto st = SendObjectChunk(push_id, object_id, owner_address, client_id, data_size,
-                                  metadata_size, chunk_index, rpc_client);
+                                  metadata_size, chunk_index, chunk_size, rpc_client);
         if (!st.ok()) {
           RAY_LOG(WARNING) << "Send object " << object_id << " chunk failed due to "
                            << st.message() << ", chunk index " << chunk_index;
+          main_service_->post([this, push_id, object_id, client_id]() {
+            HandlePushChunkFailed(push_id, object_id, client_id);
+          });
         }
       });
     }
@@ -496,7 +718,8 @@ void ObjectManager::Push(const ObjectID &object_id, const NodeID &client_id) {
 ray::Status ObjectManager::SendObjectChunk(
     const UniqueID &push_id, const ObjectID &object_id, const rpc::Address &owner_address,
     const NodeID &client_id, uint64_t data_size, uint64_t metadata_size,
-    uint64_t chunk_index, std::shared_ptr<rpc::ObjectManagerClient> rpc_client) {
+    uint64_t chunk_index, uint64_t chunk_size,
+    std::shared_ptr<rpc::ObjectManagerClient> rpc_client) {
   double start_time = absl::GetCurrentTimeNanos() / 1e9;
   rpc::PushRequest push_request;
   // Set request header
@@ -507,10 +730,11 @@ ray::Status ObjectManager::SendObjectChunk(
   push_request.set_data_size(data_size);
   push_request.set_metadata_size(metadata_size);
   push_request.set_chunk_index(chunk_index);
+  push_request.set_chunk_size(chunk_size);
 
   // Get data
-  std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> chunk_status =
-      buffer_pool_.GetChunk(object_id, data_size, metadata_size, chunk_index);
+  std::pair<ObjectBufferPool::ChunkInfo, ray::Status> chunk_status =
+      buffer_pool_.GetChunk(object_id, data_size, metadata_size, chunk_index, chunk_size);
   ObjectBufferPool::ChunkInfo chunk_info = chunk_status.first;
 
   // Fail on status not okay. The object is local, and there is
@@ -522,22 +746,38 @@ ray::Status ObjectManager::SendObjectChunk(
     RAY_RETURN_NOT_OK(status);
   }
 
-  push_request.set_data(chunk_info.data, chunk_info.buffer_length);
-
   // record the time cost between send chunk and receive reply
-  rpc::ClientCallback<rpc::PushReply> callback = [this, start_time, object_id, client_id,
-                                                  chunk_index](
+  rpc::ClientCallback<rpc::PushReply> callback = [this, start_time, push_id, object_id,
+                                                  client_id, chunk_index](
                                                      const Status &status,
                                                      const rpc::PushReply &reply) {
-    // TODO: Just print warning here, should we try to resend this chunk?
+    // The receiver asks for the chunk again, which must not be taken for a repeated
+    // push.
     if (!status.ok()) {
       RAY_LOG(WARNING) << "Send object " << object_id << " chunk to client " << client_id
                        << " failed due to" << status.message()
                        << ", chunk index: " << chunk_index;
+      HandlePushChunkFailed(push_id, object_id, client_id);
     }
     double end_time = absl::GetCurrentTimeNanos() / 1e9;
     HandleSendFinished(object_id, client_id, chunk_index, start_time, end_time, status);
   };
+
+  if (RayConfig::instance().object_manager_zero_copy_push()) {
+    // Hand the chunk to gRPC without copying it. The chunk stays referenced until
+    // gRPC does not need it anymore, whether the push failed or succeeded.
+    auto request = rpc::EncodePushChunk(
+        push_request, chunk_info.data, chunk_info.buffer_length,
+        [this, object_id, chunk_index]() {
+          rpc_service_.post([this, object_id, chunk_index]() {
+            buffer_pool_.ReleaseGetChunk(object_id, chunk_index);
+          });
+        });
+    rpc_client->PushChunk(request, callback);
+    return Status::OK();
+  }
+
+  push_request.set_data(chunk_info.data, chunk_info.buffer_length);
   rpc_client->Push(push_request, callback);
 
   // Do this regardless of whether it failed or succeeded.
@@ -546,6 +786,8 @@ ray::Status ObjectManager::SendObjectChunk(
 }
 
 void ObjectManager::CancelPull(const ObjectID &object_id) {
+  // No more chunks of the object are expected, whether it was received or not.
+  chunk_sizer_.TransferFinished(object_id);
   auto it = pull_requests_.find(object_id);
   if (it == pull_requests_.end()) {
     return;
@@ -764,11 +1006,34 @@ void ObjectManager::HandlePush(const rpc::PushRequest &request, rpc::PushReply *
   const std::string &data = request.data();
 
   double start_time = absl::GetCurrentTimeNanos() / 1e9;
-  auto status = ReceiveObjectChunk(client_id, object_id, owner_address, data_size,
-                                   metadata_size, chunk_index, data);
+  auto status = ReceiveObjectChunk(
+      client_id, object_id, owner_address, data_size, metadata_size, chunk_index,
+      request.chunk_size(), data.size(),
+      [&data](uint8_t *out) { std::memcpy(out, data.data(), data.size()); });
+  double end_time = absl::GetCurrentTimeNanos() / 1e9;
+
+  HandleReceiveFinished(object_id, client_id, chunk_index, data_size, data.size(),
+                        start_time, end_time, status);
+  send_reply_callback(status, nullptr, nullptr);
+}
+
+void ObjectManager::HandlePushChunk(const rpc::PushChunk &chunk, rpc::PushReply *reply,
+                                    rpc::SendReplyCallback send_reply_callback) {
+  const rpc::PushRequest &request = chunk.Header();
+  ObjectID object_id = ObjectID::FromBinary(request.object_id());
+  NodeID client_id = NodeID::FromBinary(request.client_id());
+  uint64_t chunk_index = request.chunk_index();
+
+  double start_time = absl::GetCurrentTimeNanos() / 1e9;
+  // The chunk is copied from the buffers gRPC received it into straight into plasma.
+  auto status = ReceiveObjectChunk(
+      client_id, object_id, request.owner_address(), request.data_size(),
+      request.metadata_size(), chunk_index, request.chunk_size(), chunk.DataSize(),
+      [&chunk](uint8_t *out) { chunk.CopyData(out); });
   double end_time = absl::GetCurrentTimeNanos() / 1e9;
 
-  HandleReceiveFinished(object_id, client_id, chunk_index, start_time, end_time, status);
+  HandleReceiveFinished(object_id, client_id, chunk_index, request.data_size(),
+                        chunk.DataSize(), start_time, end_time, status);
   send_reply_callback(status, nullptr, nullptr);
 }
 
@@ -776,23 +1041,38 @@ ray::Status ObjectManager::ReceiveObjectChunk(const NodeID &client_id,
                                               const ObjectID &object_id,
                                               const rpc::Address &owner_address,
                                               uint64_t data_size, uint64_t metadata_size,
-                                              uint64_t chunk_index,
-                                              const std::string &data) {
+                                              uint64_t chunk_index, uint64_t chunk_size,
+                                              uint64_t received_size,
+                                              const std::function<void(uint8_t *)>
+                                                  &copy_chunk) {
   RAY_LOG(DEBUG) << "ReceiveObjectChunk on " << self_node_id_ << " from " << client_id
                  << " of object " << object_id << " chunk index: " << chunk_index
-                 << ", chunk data size: " << data.size()
+                 << ", chunk data size: " << received_size
                  << ", object size: " << data_size;
 
   std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> chunk_status =
       buffer_pool_.CreateChunk(object_id, owner_address, data_size, metadata_size,
-                               chunk_index);
+                               chunk_index, chunk_size);
   ray::Status status;
   ObjectBufferPool::ChunkInfo chunk_info = chunk_status.first;
-  if (chunk_status.second.ok()) {
+  if (chunk_status.second.ok() && received_size != chunk_info.buffer_length) {
+    buffer_pool_.AbortCreateChunk(object_id, chunk_index);
+    status = Status::Invalid("Chunk of " + std::to_string(received_size) +
+                             " bytes does not match the expected size " +
+                             std::to_string(chunk_info.buffer_length));
+    RAY_LOG(WARNING) << "ReceiveObjectChunk index " << chunk_index << " of object "
+                     << object_id << " failed: " << status.message();
+  } else if (chunk_status.second.ok()) {
     // Avoid handling this chunk if it's already being handled by another process.
-    std::memcpy(chunk_info.data, data.data(), chunk_info.buffer_length);
+    copy_chunk(chunk_info.data);
     buffer_pool_.SealChunk(object_id, chunk_index);
+  } else if (chunk_status.second.IsObjectExists()) {
+    // A duplicate of a chunk that was received from another node or by a retry, or a
+    // chunk of an object that is already local.
+    RAY_LOG(DEBUG) << "ReceiveObjectChunk index " << chunk_index << " of object "
+                   << object_id << " skipped: " << chunk_status.second.message();
   } else {
+    status = chunk_status.second;
     RAY_LOG(WARNING) << "ReceiveObjectChunk index " << chunk_index << " of object "
                      << object_id << " failed: " << chunk_status.second.message();
     // TODO(hme): If the object isn't local, create a pull request for this chunk.
@@ -818,7 +1098,18 @@ void ObjectManager::HandlePull(const rpc::PullRequest &request, rpc::PullReply *
     profile_events_.emplace_back(profile_event);
   }
 
-  main_service_->post([this, object_id, client_id]() { Push(object_id, client_id); });
+  // The requester measured how fast it receives objects from here, which is used to
+  // size the chunks sent to it.
+  chunk_sizer_.UpdateThroughput(client_id, request.receive_throughput());
+
+  // Chunks are asked for by a node that pulls the object from several nodes, or that
+  // already received some chunks.
+  ObjectChunks chunks;
+  chunks.chunk_indices.assign(request.chunk_indices().begin(),
+                              request.chunk_indices().end());
+  chunks.chunk_size = request.chunk_size();
+  main_service_->post(
+      [this, object_id, client_id, chunks]() { Push(object_id, client_id, chunks); });
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
@@ -916,10 +1207,16 @@ std::string ObjectManager::DebugString() const {
   result << "\n- num active wait requests: " << active_wait_requests_.size();
   result << "\n- num unfulfilled push requests: " << unfulfilled_push_requests_.size();
   result << "\n- num pull requests: " << pull_requests_.size();
+  size_t num_striped_pulls = 0;
+  for (const auto &entry : pull_requests_) {
+    num_striped_pulls += entry.second.striped_pull != nullptr;
+  }
+  result << "\n- num pull requests from several nodes: " << num_striped_pulls;
   result << "\n- num buffered profile events: " << profile_events_.size();
   result << "\n" << object_directory_->DebugString();
   result << "\n" << store_notification_->DebugString();
   result << "\n" << buffer_pool_.DebugString();
+  result << "\n" << chunk_sizer_.DebugString();
   return result.str();
 }
 
@@ -931,6 +1228,8 @@ void ObjectManager::RecordMetrics() const {
   stats::ObjectManagerPullRequests().Record(pull_requests_.size());
   stats::ObjectManagerUnfulfilledPushRequests().Record(unfulfilled_push_requests_.size());
   stats::ObjectManagerProfileEvents().Record(profile_events_.size());
+  stats::ObjectManagerReceiveThroughput().Record(chunk_sizer_.RecentThroughput());
+  stats::ObjectManagerChunksPerTransfer().Record(chunk_sizer_.RecentChunksPerTransfer());
 }
 
 }  // namespace ray
@@ -34,10 +34,12 @@
 #include "ray/common/status.h"
 #include "ray/object_manager/format/object_manager_generated.h"
 #include "ray/object_manager/notification/object_store_notification_manager_ipc.h"
+#include "ray/object_manager/chunk_sizer.h"
 #include "ray/object_manager/object_buffer_pool.h"
 #include "ray/object_manager/object_directory.h"
 #include "ray/object_manager/ownership_based_object_directory.h"
 #include "ray/object_manager/plasma/store_runner.h"
+#include "ray/object_manager/striped_pull.h"
 #include "ray/rpc/object_manager/object_manager_client.h"
 #include "ray/rpc/object_manager/object_manager_server.h"
 
@@ -71,12 +73,30 @@ struct ObjectManagerConfig {
   bool huge_pages;
 };
 
+/// The chunks of an object to send to a remote object manager.
+struct ObjectChunks {
+  /// The chunks to send, or empty to send all the chunks.
+  std::vector<uint64_t> chunk_indices;
+  /// The size of the chunks to split the object into, or 0 to choose it.
+  uint64_t chunk_size = 0;
+};
+
+/// A push of an object to a remote object manager.
+struct RecentPush {
+  /// The ID of the push.
+  UniqueID push_id;
+  /// The time when the object was pushed, in milliseconds.
+  int64_t time_ms;
+  /// The chunks that were pushed.
+  ObjectChunks chunks;
+};
+
 struct LocalObjectInfo {
   /// Information from the object store about the object.
   object_manager::protocol::ObjectInfoT object_info;
-  /// A map from the ID of a remote object manager to the timestamp of when
-  /// the object was last pushed to that object manager (if a push took place).
-  std::unordered_map<NodeID, int64_t> recent_pushes;
+  /// A map from the ID of a remote object manager to the last push of the object to
+  /// that object manager (if a push took place).
+  std::unordered_map<NodeID, RecentPush> recent_pushes;
 };
 
 class ObjectStoreRunner {
@@ -116,6 +136,14 @@ class ObjectManager : public ObjectManagerInterface,
   void HandlePush(const rpc::PushRequest &request, rpc::PushReply *reply,
                   rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle an object chunk pushed from remote object manager without copying it
+  ///
+  /// \param chunk The object chunk
+  /// \param reply Reply to the sender
+  /// \param send_reply_callback Callback of the request
+  void HandlePushChunk(const rpc::PushChunk &chunk, rpc::PushReply *reply,
+                       rpc::SendReplyCallback send_reply_callback) override;
+
   /// Handle pull request from remote object manager
   ///
   /// \param request Pull request
@@ -143,11 +171,12 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param data_size Data size
   /// \param metadata_size Metadata size
   /// \param chunk_index Chunk index of this object chunk, start with 0
+  /// \param chunk_size Size of the chunks the object is split into
   /// \param rpc_client Rpc client used to send message to remote object manager
   ray::Status SendObjectChunk(const UniqueID &push_id, const ObjectID &object_id,
                               const rpc::Address &owner_address, const NodeID &client_id,
                               uint64_t data_size, uint64_t metadata_size,
-                              uint64_t chunk_index,
+                              uint64_t chunk_index, uint64_t chunk_size,
                               std::shared_ptr<rpc::ObjectManagerClient> rpc_client);
 
   /// Receive object chunk from remote object manager, small object may contain one chunk
@@ -158,18 +187,23 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param data_size Data size
   /// \param metadata_size Metadata size
   /// \param chunk_index Chunk index
-  /// \param data Chunk data
+  /// \param chunk_size Size of the chunks the object is split into
+  /// \param received_size Size of the received chunk data
+  /// \param copy_chunk Copies the chunk data to the given buffer
   ray::Status ReceiveObjectChunk(const NodeID &client_id, const ObjectID &object_id,
                                  const rpc::Address &owner_address, uint64_t data_size,
                                  uint64_t metadata_size, uint64_t chunk_index,
-                                 const std::string &data);
+                                 uint64_t chunk_size, uint64_t received_size,
+                                 const std::function<void(uint8_t *)> &copy_chunk);
 
   /// Send pull request
   ///
   /// \param object_id Object id
   /// \param client_id Remote server client id
+  /// \param chunk_indices The chunks to pull, or empty to pull all the chunks
   void SendPullRequest(const ObjectID &object_id, const NodeID &client_id,
-                       std::shared_ptr<rpc::ObjectManagerClient> rpc_client);
+                       std::shared_ptr<rpc::ObjectManagerClient> rpc_client,
+                       const std::vector<uint64_t> &chunk_indices);
 
   /// Get the rpc client according to the client ID
   ///
@@ -220,8 +254,10 @@ class ObjectManager : public ObjectManagerInterface,
   ///
   /// \param object_id The object's object id.
   /// \param client_id The remote node's client id.
+  /// \param chunks The chunks to push. By default, all the chunks are pushed.
   /// \return Void.
-  void Push(const ObjectID &object_id, const NodeID &client_id);
+  void Push(const ObjectID &object_id, const NodeID &client_id,
+            const ObjectChunks &chunks = ObjectChunks());
 
   /// Pull an object from NodeID.
   ///
@@ -291,10 +327,17 @@ class ObjectManager : public ObjectManagerInterface,
   friend class TestObjectManager;
 
   struct PullRequest {
-    PullRequest() : retry_timer(nullptr), timer_set(false), client_locations() {}
+    PullRequest()
+        : retry_timer(nullptr), timer_set(false), client_locations(), probing(false) {}
     std::unique_ptr<boost::asio::deadline_timer> retry_timer;
     bool timer_set;
     std::vector<NodeID> client_locations;
+    /// Whether only the first chunk was asked for, to learn the size of the object
+    /// before pulling it from several nodes.
+    bool probing;
+    /// Which node each chunk is pulled from, if the object is pulled from several
+    /// nodes.
+    std::unique_ptr<StripedPull> striped_pull;
   };
 
   struct WaitState {
@@ -387,6 +430,8 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param object_id The ID of the object that was received.
   /// \param client_id The ID of the client that the chunk was received from.
   /// \param chunk_index The index of the chunk.
+  /// \param data_size The size of the object.
+  /// \param chunk_size The size of the chunk.
   /// \param start_time_us The time when the object manager began receiving the
   /// chunk.
   /// \param end_time_us The time when the object manager finished receiving the
@@ -394,12 +439,64 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param status The status of the receive (e.g., did it succeed or fail).
   /// \return Void.
   void HandleReceiveFinished(const ObjectID &object_id, const NodeID &client_id,
-                             uint64_t chunk_index, double start_time_us,
+                             uint64_t chunk_index, uint64_t data_size,
+                             uint64_t chunk_size, double start_time_us,
                              double end_time_us, ray::Status status);
 
   /// Handle Push task timeout.
   void HandlePushTaskTimeout(const ObjectID &object_id, const NodeID &client_id);
 
+  /// Send the chunks of a local object to a remote object manager.
+  ///
+  /// \param push_id The ID of the push.
+  /// \param object_id The object's object id.
+  /// \param client_id The remote node's client id.
+  /// \param chunk_indices The chunks to send, or empty to send all the chunks.
+  /// \param chunk_size The size of the chunks to split the object into, or 0 to choose
+  /// it.
+  void SendObjectChunks(const UniqueID &push_id, const ObjectID &object_id,
+                        const NodeID &client_id,
+                        const std::vector<uint64_t> &chunk_indices,
+                        uint64_t chunk_size);
+
+  /// Forget a push whose chunk failed to be sent, so that a retry of the chunk is not
+  /// suppressed as a repeated push. This runs on the main thread.
+  ///
+  /// \param push_id The ID of the push.
+  /// \param object_id The object's object id.
+  /// \param client_id The remote node's client id.
+  void HandlePushChunkFailed(const UniqueID &push_id, const ObjectID &object_id,
+                             const NodeID &client_id);
+
+  /// Retry a pull after a timeout, unless the object is received before.
+  ///
+  /// \param object_id The object's object id.
+  void SetPullRetryTimer(const ObjectID &object_id);
+
+  /// Update a pull from several nodes: stop pulling from nodes that stalled, start
+  /// pulling from new locations, and ask the nodes for the next chunks.
+  ///
+  /// \param object_id The object's object id.
+  void TryStripedPull(const ObjectID &object_id);
+
+  /// Ask the nodes that an object is pulled from for the chunks assigned to them.
+  ///
+  /// \param object_id The object's object id.
+  void PullChunks(const ObjectID &object_id);
+
+  /// Update the pull of an object when one of its chunks was received. This runs on
+  /// the main thread.
+  ///
+  /// \param object_id The object's object id.
+  /// \param client_id The node the chunk was received from.
+  /// \param chunk_index The index of the chunk.
+  /// \param data_size The size of the object.
+  /// \param chunk_size The size of the chunk.
+  /// \param success Whether the chunk was written to the local object store.
+  void HandlePulledChunk(const ObjectID &object_id, const NodeID &client_id,
+                         uint64_t chunk_index, uint64_t data_size, uint64_t chunk_size,
+                         bool success);
+
   NodeID self_node_id_;
   const ObjectManagerConfig config_;
   std::shared_ptr<ObjectDirectoryInterface> object_directory_;
@@ -410,6 +507,10 @@ class ObjectManager : public ObjectManagerInterface,
   std::shared_ptr<ObjectStoreNotificationManager> store_notification_;
   ObjectBufferPool buffer_pool_;
 
+  /// Chooses the size of the chunks of the objects sent to each node, and measures
+  /// the rate at which objects are received.
+  ChunkSizer chunk_sizer_;
+
   /// Weak reference to main service. We ensure this object is destroyed before
   /// main_service_ is stopped.
   boost::asio::io_service *main_service_;
@@ -436,10 +537,17 @@ class ObjectManager : public ObjectManagerInterface,
   /// A set of active wait requests.
   std::unordered_map<UniqueID, WaitState> active_wait_requests_;
 
+  /// A push request that waits for its object to be local.
+  struct UnfulfilledPush {
+    /// The timer after which the request fails, or null if it never does.
+    std::unique_ptr<boost::asio::deadline_timer> timer;
+    /// The chunks to push once the object is local.
+    ObjectChunks chunks;
+  };
+
   /// Maintains a map of push requests that have not been fulfilled due to an object not
   /// being local. Objects are removed from this map after push_timeout_ms have elapsed.
-  std::unordered_map<
-      ObjectID, std::unordered_map<NodeID, std::unique_ptr<boost::asio::deadline_timer>>>
+  std::unordered_map<ObjectID, std::unordered_map<NodeID, UnfulfilledPush>>
       unfulfilled_push_requests_;
 
   /// The objects that this object manager is currently trying to fetch from
@@ -0,0 +1,355 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/async_external_store.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+AsyncExternalStore::AsyncExternalStore()
+    : stopped_(false),
+      num_writing_segments_(0),
+      next_segment_id_(0),
+      pending_bytes_(0),
+      num_objects_put_(0),
+      num_objects_read_from_memory_(0),
+      num_objects_read_from_storage_(0),
+      num_segments_written_(0),
+      num_write_errors_(0),
+      bytes_put_(0),
+      bytes_written_(0),
+      num_puts_blocked_(0) {}
+
+AsyncExternalStore::~AsyncExternalStore() {
+  RAY_CHECK(workers_.empty()) << "Subclasses of AsyncExternalStore must call Stop() "
+                                 "in their destructor.";
+}
+
+void AsyncExternalStore::Start(const Options& options) {
+  RAY_CHECK(workers_.empty()) << "The external store was already started.";
+  RAY_CHECK(options.num_workers > 0 && options.segment_size > 0);
+  options_ = options;
+  for (int i = 0; i < options_.num_workers; i++) {
+    workers_.emplace_back(&AsyncExternalStore::RunWorker, this);
+  }
+}
+
+void AsyncExternalStore::Stop() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+    segment_sealed_.SignalAll();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  absl::MutexLock lock(&mutex_);
+  for (const auto& entry : segments_) {
+    if (entry.second->state == SegmentState::WRITTEN) {
+      DeleteSegment(entry.first);
+    }
+  }
+  segments_.clear();
+  objects_.clear();
+  open_segment_ = nullptr;
+  sealed_segments_.clear();
+  pending_bytes_ = 0;
+}
+
+Status AsyncExternalStore::Put(const std::vector<ObjectID>& ids,
+                               const std::vector<std::shared_ptr<Buffer>>& data) {
+  RAY_CHECK(ids.size() == data.size());
+  if (workers_.empty()) {
+    return Status::Invalid("The external store is not connected.");
+  }
+  absl::MutexLock lock(&mutex_);
+  for (size_t i = 0; i < ids.size(); i++) {
+    int64_t size = data[i]->size();
+    if (pending_bytes_ > 0 && pending_bytes_ + size > options_.max_pending_bytes) {
+      // Too much data is waiting to be written. Wait for the workers to catch
+      // up, so that the memory used by the external store stays bounded.
+      num_puts_blocked_++;
+      SealOpenSegment();
+      while (pending_bytes_ > 0 && pending_bytes_ + size > options_.max_pending_bytes) {
+        segment_written_.Wait(&mutex_);
+      }
+    }
+    // An object that is put again replaces the old copy.
+    ForgetObject(ids[i]);
+    if (open_segment_ && !open_segment_->data.empty() &&
+        static_cast<int64_t>(open_segment_->data.size()) + size > options_.segment_size) {
+      SealOpenSegment();
+    }
+    if (!open_segment_) {
+      open_segment_ = std::make_shared<Segment>();
+      open_segment_->id = next_segment_id_++;
+      open_segment_->state = SegmentState::OPEN;
+      open_segment_->data.reserve(std::max(options_.segment_size, size));
+      open_segment_->num_live_objects = 0;
+      segments_.emplace(open_segment_->id, open_segment_);
+    }
+    ObjectLocation location;
+    location.segment_id = open_segment_->id;
+    location.offset = open_segment_->data.size();
+    location.stored_size = size;
+    location.size = size;
+    location.compressed = false;
+    open_segment_->data.insert(open_segment_->data.end(), data[i]->data(),
+                               data[i]->data() + size);
+    open_segment_->object_ids.push_back(ids[i]);
+    open_segment_->object_offsets.push_back(location.offset);
+    open_segment_->num_live_objects++;
+    objects_.emplace(ids[i], location);
+    pending_bytes_ += size;
+    num_objects_put_++;
+    bytes_put_ += size;
+  }
+  if (open_segment_ &&
+      static_cast<int64_t>(open_segment_->data.size()) >= options_.segment_size) {
+    SealOpenSegment();
+  }
+  return Status::OK();
+}
+
+Status AsyncExternalStore::Get(const std::vector<ObjectID>& ids,
+                               std::vector<std::shared_ptr<Buffer>> buffers) {
+  RAY_CHECK(ids.size() == buffers.size());
+  // The objects that have to be read from storage, and where they are.
+  std::vector<std::pair<size_t, ObjectLocation>> reads;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (size_t i = 0; i < ids.size(); i++) {
+      auto it = objects_.find(ids[i]);
+      if (it == objects_.end()) {
+        return Status::KeyError("Object " + ids[i].Hex() +
+                                " is not in the external store.");
+      }
+      const auto& location = it->second;
+      if (buffers[i]->size() != location.size) {
+        return Status::Invalid("The buffer for object " + ids[i].Hex() + " has " +
+                               std::to_string(buffers[i]->size()) + " bytes, but the " +
+                               "object has " + std::to_string(location.size) + ".");
+      }
+      const auto& segment = segments_[location.segment_id];
+      if (segment->state != SegmentState::WRITTEN) {
+        std::memcpy(buffers[i]->mutable_data(), segment->data.data() + location.offset,
+                    location.size);
+        num_objects_read_from_memory_++;
+      } else {
+        reads.emplace_back(i, location);
+      }
+    }
+  }
+
+  // Segments are only deleted by Put() and Get(), so the segments that are
+  // read here stay in storage.
+  std::vector<uint8_t> compressed;
+  for (const auto& read : reads) {
+    const auto& location = read.second;
+    uint8_t* out = buffers[read.first]->mutable_data();
+    if (!location.compressed) {
+      RAY_RETURN_NOT_OK(
+          ReadSegment(location.segment_id, location.offset, location.stored_size, out));
+      continue;
+    }
+    compressed.resize(location.stored_size);
+    RAY_RETURN_NOT_OK(ReadSegment(location.segment_id, location.offset,
+                                  location.stored_size, compressed.data()));
+    uLongf size = location.size;
+    int result = uncompress(out, &size, compressed.data(), location.stored_size);
+    if (result != Z_OK || static_cast<int64_t>(size) != location.size) {
+      return Status::IOError("Failed to decompress object " + ids[read.first].Hex() +
+                             ", zlib error " + std::to_string(result) + ".");
+    }
+  }
+
+  absl::MutexLock lock(&mutex_);
+  num_objects_read_from_storage_ += reads.size();
+  // The objects are back in the plasma store, so they do not need to be kept.
+  for (const auto& object_id : ids) {
+    ForgetObject(object_id);
+  }
+  return Status::OK();
+}
+
+Status AsyncExternalStore::Flush() {
+  absl::MutexLock lock(&mutex_);
+  int64_t num_write_errors = num_write_errors_;
+  SealOpenSegment();
+  while (!sealed_segments_.empty() || num_writing_segments_ > 0) {
+    segment_written_.Wait(&mutex_);
+  }
+  if (num_write_errors_ > num_write_errors) {
+    return Status::IOError("Failed to write " +
+                           std::to_string(num_write_errors_ - num_write_errors) +
+                           " segments to the external store.");
+  }
+  return Status::OK();
+}
+
+void AsyncExternalStore::SealOpenSegment() {
+  if (!open_segment_) {
+    return;
+  }
+  open_segment_->state = SegmentState::SEALED;
+  sealed_segments_.push_back(std::move(open_segment_));
+  open_segment_ = nullptr;
+  segment_sealed_.Signal();
+}
+
+void AsyncExternalStore::RunWorker() {
+  while (true) {
+    std::shared_ptr<Segment> segment;
+    {
+      absl::MutexLock lock(&mutex_);
+      while (sealed_segments_.empty() && !stopped_) {
+        // Write the open segment if no segment was sealed for a while.
+        bool timed_out = segment_sealed_.WaitWithTimeout(
+            &mutex_, absl::Milliseconds(options_.linger_ms));
+        if (timed_out && sealed_segments_.empty()) {
+          SealOpenSegment();
+        }
+      }
+      if (stopped_) {
+        return;
+      }
+      segment = sealed_segments_.front();
+      sealed_segments_.pop_front();
+      num_writing_segments_++;
+    }
+
+    // Sealed segments are not modified, so they can be read without the lock.
+    std::vector<ObjectLocation> locations;
+    Status status = CompressAndWrite(*segment, &locations);
+
+    absl::MutexLock lock(&mutex_);
+    num_writing_segments_--;
+    pending_bytes_ -= segment->data.size();
+    if (status.ok()) {
+      segment->state = SegmentState::WRITTEN;
+      for (size_t i = 0; i < segment->object_ids.size(); i++) {
+        auto it = objects_.find(segment->object_ids[i]);
+        if (it != objects_.end() && it->second.segment_id == segment->id) {
+          it->second = locations[i];
+        }
+        bytes_written_ += locations[i].stored_size;
+      }
+      num_segments_written_++;
+      std::vector<uint8_t>().swap(segment->data);
+    } else {
+      // Keep the objects in memory, so that they are not lost.
+      RAY_LOG(ERROR) << "Failed to write segment " << segment->id
+                     << " to the external store: " << status.ToString();
+      segment->state = SegmentState::FAILED;
+      num_write_errors_++;
+    }
+    MaybeDeleteSegment(segment);
+    segment_written_.SignalAll();
+  }
+}
+
+Status AsyncExternalStore::CompressAndWrite(const Segment& segment,
+                                            std::vector<ObjectLocation>* locations) {
+  locations->clear();
+  int64_t segment_size = segment.data.size();
+  for (size_t i = 0; i < segment.object_ids.size(); i++) {
+    int64_t end = i + 1 < segment.object_offsets.size() ? segment.object_offsets[i + 1]
+                                                        : segment_size;
+    ObjectLocation location;
+    location.segment_id = segment.id;
+    location.offset = segment.object_offsets[i];
+    location.size = end - segment.object_offsets[i];
+    location.stored_size = location.size;
+    location.compressed = false;
+    locations->push_back(location);
+  }
+  if (!options_.compress) {
+    return WriteSegment(segment.id, segment.data.data(), segment_size);
+  }
+
+  std::vector<uint8_t> output;
+  for (auto& location : *locations) {
+    const uint8_t* input = segment.data.data() + location.offset;
+    int64_t start = output.size();
+    uLongf compressed_size = compressBound(location.size);
+    output.resize(start + compressed_size);
+    int result = compress2(output.data() + start, &compressed_size, input, location.size,
+                           Z_BEST_SPEED);
+    location.offset = start;
+    if (result == Z_OK && static_cast<int64_t>(compressed_size) < location.size) {
+      output.resize(start + compressed_size);
+      location.stored_size = compressed_size;
+      location.compressed = true;
+    } else {
+      // Store objects that do not compress as they are.
+      output.resize(start);
+      output.insert(output.end(), input, input + location.size);
+    }
+  }
+  return WriteSegment(segment.id, output.data(), output.size());
+}
+
+void AsyncExternalStore::ForgetObject(const ObjectID& object_id) {
+  auto it = objects_.find(object_id);
+  if (it == objects_.end()) {
+    return;
+  }
+  auto segment_it = segments_.find(it->second.segment_id);
+  objects_.erase(it);
+  RAY_CHECK(segment_it != segments_.end());
+  auto segment = segment_it->second;
+  segment->num_live_objects--;
+  MaybeDeleteSegment(segment);
+}
+
+void AsyncExternalStore::MaybeDeleteSegment(const std::shared_ptr<Segment>& segment) {
+  // Open segments are reused, and sealed segments are deleted by the worker
+  // that writes them.
+  if (segment->num_live_objects > 0 || segment->state == SegmentState::OPEN ||
+      segment->state == SegmentState::SEALED) {
+    return;
+  }
+  if (segment->state == SegmentState::WRITTEN) {
+    DeleteSegment(segment->id);
+  }
+  segments_.erase(segment->id);
+}
+
+std::string AsyncExternalStore::DebugString() const {
+  absl::MutexLock lock(&mutex_);
+  std::stringstream result;
+  result << "\n(external store) objects stored: " << objects_.size();
+  result << "\n(external store) segments stored: " << segments_.size();
+  result << "\n(external store) objects put: " << num_objects_put_
+         << ", bytes put: " << bytes_put_;
+  result << "\n(external store) segments written: " << num_segments_written_
+         << ", bytes written: " << bytes_written_;
+  result << "\n(external store) objects read from memory: "
+         << num_objects_read_from_memory_
+         << ", from storage: " << num_objects_read_from_storage_;
+  result << "\n(external store) bytes waiting to be written: " << pending_bytes_;
+  result << "\n(external store) puts blocked: " << num_puts_blocked_;
+  result << "\n(external store) write errors: " << num_write_errors_;
+  return result.str();
+}
+
+}  // namespace plasma
@@ -0,0 +1,207 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "ray/object_manager/plasma/external_store.h"
+
+namespace plasma {
+
+/// An external store that writes evicted objects in the background, so that
+/// eviction does not block the plasma store on storage I/O.
+///
+/// Put() only copies the objects into an in-memory segment. Many objects are
+/// packed into one segment, and full segments are handed to a pool of worker
+/// threads, which optionally compress the objects and write the segment to
+/// storage with WriteSegment(). Objects whose segment is not written yet are
+/// served from memory. Put() blocks only when the segments waiting to be
+/// written hold more than a configured number of bytes.
+///
+/// Subclasses implement the storage of segments, and must call Start() when
+/// they are connected and Stop() in their destructor. Put() and Get() must not
+/// be called concurrently, which the plasma store guarantees.
+class AsyncExternalStore : public ExternalStore {
+ public:
+  struct Options {
+    /// The number of threads that write segments.
+    int num_workers = 2;
+    /// Objects are packed into segments of about this many bytes. Larger
+    /// objects get a segment of their own.
+    int64_t segment_size = 16 * 1024 * 1024;
+    /// Put() blocks while this many bytes are waiting to be written.
+    int64_t max_pending_bytes = 256 * 1024 * 1024;
+    /// A segment that is not full is written once the workers have been idle
+    /// for this long.
+    int64_t linger_ms = 100;
+    /// Whether to compress objects with zlib before writing them.
+    bool compress = false;
+  };
+
+  AsyncExternalStore();
+
+  ~AsyncExternalStore() override;
+
+  Status Put(const std::vector<ObjectID>& ids,
+             const std::vector<std::shared_ptr<Buffer>>& data) override;
+
+  Status Get(const std::vector<ObjectID>& ids,
+             std::vector<std::shared_ptr<Buffer>> buffers) override;
+
+  /// Write all the objects that were put so far to storage and wait until
+  /// they are written.
+  ///
+  /// \return An error if a segment could not be written.
+  Status Flush();
+
+  std::string DebugString() const override;
+
+ protected:
+  /// Start the worker threads.
+  ///
+  /// \param options The options of the store.
+  void Start(const Options& options);
+
+  /// Stop the worker threads and delete all the segments, since the objects
+  /// are not needed anymore once the plasma store is gone. This must be called
+  /// by the destructor of the subclass, since the workers call its methods.
+  void Stop();
+
+  /// Write a segment to storage. This is called from the worker threads.
+  ///
+  /// \param segment_id The ID of the segment.
+  /// \param data The contents of the segment.
+  /// \param size The size of the segment in bytes.
+  /// \return The return status.
+  virtual Status WriteSegment(uint64_t segment_id, const uint8_t* data,
+                              int64_t size) = 0;
+
+  /// Read part of a segment that was written with WriteSegment().
+  ///
+  /// \param segment_id The ID of the segment.
+  /// \param offset The offset to read from.
+  /// \param size The number of bytes to read.
+  /// \param[out] out The bytes are written here.
+  /// \return The return status.
+  virtual Status ReadSegment(uint64_t segment_id, int64_t offset, int64_t size,
+                             uint8_t* out) = 0;
+
+  /// Delete a segment that does not hold any objects anymore.
+  ///
+  /// \param segment_id The ID of the segment.
+  virtual void DeleteSegment(uint64_t segment_id) = 0;
+
+ private:
+  /// Where the data of an object is.
+  struct ObjectLocation {
+    uint64_t segment_id;
+    /// The offset of the object in the segment.
+    int64_t offset;
+    /// The number of bytes the object takes in the segment.
+    int64_t stored_size;
+    /// The size of the object.
+    int64_t size;
+    /// Whether the object is compressed in the segment.
+    bool compressed;
+  };
+
+  enum class SegmentState {
+    /// Objects are being put into the segment.
+    OPEN,
+    /// The segment is waiting to be written, or being written.
+    SEALED,
+    /// The segment is in storage.
+    WRITTEN,
+    /// The segment could not be written, so its objects stay in memory.
+    FAILED,
+  };
+
+  struct Segment {
+    uint64_t id;
+    SegmentState state;
+    /// The uncompressed objects of the segment. This is released once the
+    /// segment is written.
+    std::vector<uint8_t> data;
+    /// The objects that were put into the segment, and their offsets in data.
+    std::vector<ObjectID> object_ids;
+    std::vector<int64_t> object_offsets;
+    /// The number of objects in the segment that were not read back or
+    /// replaced yet.
+    int64_t num_live_objects;
+  };
+
+  /// Hand the open segment to the workers.
+  void SealOpenSegment() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// The main loop of the worker threads.
+  void RunWorker();
+
+  /// Compress the objects of a segment and write it.
+  ///
+  /// \param segment The segment to write.
+  /// \param[out] locations The locations of the objects in the written
+  ///             segment, in the same order as segment.object_ids.
+  /// \return The return status.
+  Status CompressAndWrite(const Segment& segment, std::vector<ObjectLocation>* locations);
+
+  /// Forget an object that was read back or replaced, and delete its segment
+  /// if it was the last object in it.
+  void ForgetObject(const ObjectID& object_id) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Delete a segment if it holds no objects and no worker is using it.
+  void MaybeDeleteSegment(const std::shared_ptr<Segment>& segment)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  Options options_;
+  std::vector<std::thread> workers_;
+
+  mutable absl::Mutex mutex_;
+  /// Signaled when a segment is sealed, and when the store stops.
+  absl::CondVar segment_sealed_;
+  /// Signaled when a segment was written.
+  absl::CondVar segment_written_;
+  bool stopped_ GUARDED_BY(mutex_);
+  /// The locations of the objects that are in the store.
+  std::unordered_map<ObjectID, ObjectLocation> objects_ GUARDED_BY(mutex_);
+  /// The segments that hold objects.
+  std::unordered_map<uint64_t, std::shared_ptr<Segment>> segments_ GUARDED_BY(mutex_);
+  /// The segment that new objects are put into, or nullptr.
+  std::shared_ptr<Segment> open_segment_ GUARDED_BY(mutex_);
+  /// The sealed segments that no worker has picked up yet.
+  std::deque<std::shared_ptr<Segment>> sealed_segments_ GUARDED_BY(mutex_);
+  /// The number of segments that workers are writing.
+  int64_t num_writing_segments_ GUARDED_BY(mutex_);
+  uint64_t next_segment_id_ GUARDED_BY(mutex_);
+  /// The number of uncompressed bytes in segments that are not written yet.
+  int64_t pending_bytes_ GUARDED_BY(mutex_);
+
+  /// Statistics.
+  int64_t num_objects_put_ GUARDED_BY(mutex_);
+  int64_t num_objects_read_from_memory_ GUARDED_BY(mutex_);
+  int64_t num_objects_read_from_storage_ GUARDED_BY(mutex_);
+  int64_t num_segments_written_ GUARDED_BY(mutex_);
+  int64_t num_write_errors_ GUARDED_BY(mutex_);
+  int64_t bytes_put_ GUARDED_BY(mutex_);
+  int64_t bytes_written_ GUARDED_BY(mutex_);
+  int64_t num_puts_blocked_ GUARDED_BY(mutex_);
+};
+
+}  // namespace plasma
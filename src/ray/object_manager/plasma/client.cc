@@ -34,8 +34,10 @@
 #include "arrow/buffer.h"
 
 #include "ray/object_manager/plasma/connection.h"
+#include "ray/object_manager/plasma/numa.h"
 #include "ray/object_manager/plasma/plasma.h"
 #include "ray/object_manager/plasma/protocol.h"
+#include "ray/object_manager/plasma/release_ring.h"
 #include "ray/object_manager/plasma/shared_memory.h"
 
 #ifdef PLASMA_CUDA
@@ -158,6 +160,14 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
                 std::shared_ptr<Buffer>* data, int device_num = 0,
                 bool evict_if_full = true);
 
+  Status CreateBatch(const std::vector<ObjectID>& object_ids,
+                     const ray::rpc::Address& owner_address,
+                     const std::vector<int64_t>& data_sizes,
+                     const std::vector<const uint8_t*>& metadatas,
+                     const std::vector<int64_t>& metadata_sizes,
+                     std::vector<std::shared_ptr<Buffer>>* data,
+                     std::vector<Status>* results, bool evict_if_full = true);
+
   Status Get(const std::vector<ObjectID>& object_ids, int64_t timeout_ms,
              std::vector<ObjectBuffer>* object_buffers);
 
@@ -166,12 +176,16 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
 
   Status Release(const ObjectID& object_id);
 
+  Status ReleaseBatch(const std::vector<ObjectID>& object_ids);
+
   Status Contains(const ObjectID& object_id, bool* has_object);
 
   Status Abort(const ObjectID& object_id);
 
   Status Seal(const ObjectID& object_id);
 
+  Status SealBatch(const std::vector<ObjectID>& object_ids);
+
   Status Delete(const std::vector<ObjectID>& object_ids);
 
   Status Evict(int64_t num_bytes, int64_t& num_bytes_evicted);
@@ -201,6 +215,13 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
   /// \return The return status.
   Status MarkObjectUnused(const ObjectID& object_id);
 
+  /// This is a helper method for decrementing the number of instances of an
+  /// object that are in use by this client.
+  ///
+  /// \param object_id The object ID to decrement the count of.
+  /// \return True if the client is no longer using the object.
+  bool DecrementObjectCount(const ObjectID& object_id);
+
   /// Common helper for Get() variants
   Status GetBuffers(const ObjectID* object_ids, int64_t num_objects, int64_t timeout_ms,
                     const std::function<std::shared_ptr<Buffer>(
@@ -229,6 +250,9 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
   int64_t store_capacity_;
   /// A hash set to record the ids that users want to delete but still in use.
   std::unordered_set<ObjectID> deletion_cache_;
+  /// The ring through which releases are posted to the store, if the store
+  /// set one up for this client.
+  std::unique_ptr<ReleaseRing> release_ring_;
   /// A mutex which protects this class.
   std::recursive_mutex client_mutex_;
 
@@ -315,7 +339,7 @@ Status PlasmaClient::Impl::Create(const ObjectID& object_id, const ray::rpc::Add
   RAY_LOG(DEBUG) << "called plasma_create on conn " << store_conn_ << " with size "
                    << data_size << " and metadata size " << metadata_size;
   RAY_RETURN_NOT_OK(SendCreateRequest(store_conn_, object_id, owner_address, evict_if_full, data_size,
-                                  metadata_size, device_num));
+                                  metadata_size, device_num, GetCurrentNumaNode()));
   std::vector<uint8_t> buffer;
   RAY_RETURN_NOT_OK(PlasmaReceive(store_conn_, MessageType::PlasmaCreateReply, &buffer));
   ObjectID id;
@@ -375,6 +399,69 @@ Status PlasmaClient::Impl::Create(const ObjectID& object_id, const ray::rpc::Add
   return Status::OK();
 }
 
+Status PlasmaClient::Impl::CreateBatch(const std::vector<ObjectID>& object_ids,
+                                       const ray::rpc::Address& owner_address,
+                                       const std::vector<int64_t>& data_sizes,
+                                       const std::vector<const uint8_t*>& metadatas,
+                                       const std::vector<int64_t>& metadata_sizes,
+                                       std::vector<std::shared_ptr<Buffer>>* data,
+                                       std::vector<Status>* results,
+                                       bool evict_if_full) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+  RAY_CHECK(object_ids.size() == data_sizes.size());
+  RAY_CHECK(object_ids.size() == metadatas.size());
+  RAY_CHECK(object_ids.size() == metadata_sizes.size());
+
+  RAY_LOG(DEBUG) << "called plasma_create_batch on conn " << store_conn_ << " with "
+                 << object_ids.size() << " objects";
+  RAY_RETURN_NOT_OK(SendCreateBatchRequest(store_conn_, object_ids, owner_address,
+                                           evict_if_full, data_sizes, metadata_sizes,
+                                           GetCurrentNumaNode()));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaCreateBatchReply, &buffer));
+  std::vector<ObjectID> received_object_ids;
+  std::vector<PlasmaObject> objects;
+  std::vector<MEMFD_TYPE> store_fds;
+  std::vector<int64_t> mmap_sizes;
+  RAY_RETURN_NOT_OK(ReadCreateBatchReply(buffer.data(), buffer.size(),
+                                         &received_object_ids, &objects, results,
+                                         &store_fds, &mmap_sizes));
+  RAY_CHECK(received_object_ids.size() == object_ids.size());
+  RAY_CHECK(results->size() == object_ids.size());
+
+  // The store sends the file descriptors for all of the created objects right
+  // after the reply, so mmap them before looking at the individual objects.
+  for (size_t i = 0; i < store_fds.size(); i++) {
+    GetStoreFdAndMmap(store_fds[i], mmap_sizes[i]);
+  }
+
+  data->assign(object_ids.size(), nullptr);
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    RAY_DCHECK(received_object_ids[i] == object_ids[i]);
+    if (!(*results)[i].ok()) {
+      continue;
+    }
+    PlasmaObject* object = &objects[i];
+    RAY_CHECK(object->data_size == data_sizes[i]);
+    RAY_CHECK(object->metadata_size == metadata_sizes[i]);
+    // The metadata should come right after the data.
+    RAY_CHECK(object->metadata_offset == object->data_offset + data_sizes[i]);
+    (*data)[i] = std::make_shared<PlasmaMutableBuffer>(
+        shared_from_this(), LookupMmappedFile(object->store_fd) + object->data_offset,
+        data_sizes[i]);
+    if (metadatas[i] != NULL) {
+      // Copy the metadata to the buffer.
+      memcpy((*data)[i]->mutable_data() + object->data_size, metadatas[i],
+             metadata_sizes[i]);
+    }
+    // See Create() for why the count is incremented twice.
+    IncrementObjectCount(object_ids[i], object, false);
+    IncrementObjectCount(object_ids[i], object, false);
+  }
+  return Status::OK();
+}
+
 Status PlasmaClient::Impl::GetBuffers(
     const ObjectID* object_ids, int64_t num_objects, int64_t timeout_ms,
     const std::function<std::shared_ptr<Buffer>(
@@ -542,13 +629,7 @@ Status PlasmaClient::Impl::MarkObjectUnused(const ObjectID& object_id) {
   return Status::OK();
 }
 
-Status PlasmaClient::Impl::Release(const ObjectID& object_id) {
-  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
-
-  // If the client is already disconnected, ignore release requests.
-  if (!store_conn_) {
-    return Status::OK();
-  }
+bool PlasmaClient::Impl::DecrementObjectCount(const ObjectID& object_id) {
   auto object_entry = objects_in_use_.find(object_id);
   RAY_CHECK(object_entry != objects_in_use_.end());
 
@@ -566,11 +647,24 @@ Status PlasmaClient::Impl::Release(const ObjectID& object_id) {
 
   object_entry->second->count -= 1;
   RAY_CHECK(object_entry->second->count >= 0);
+  return object_entry->second->count == 0;
+}
+
+Status PlasmaClient::Impl::Release(const ObjectID& object_id) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+
+  // If the client is already disconnected, ignore release requests.
+  if (!store_conn_) {
+    return Status::OK();
+  }
   // Check if the client is no longer using this object.
-  if (object_entry->second->count == 0) {
-    // Tell the store that the client no longer needs the object.
+  if (DecrementObjectCount(object_id)) {
+    // Tell the store that the client no longer needs the object. Fall back to
+    // the socket if the ring is full.
     RAY_RETURN_NOT_OK(MarkObjectUnused(object_id));
-    RAY_RETURN_NOT_OK(SendReleaseRequest(store_conn_, object_id));
+    if (!release_ring_ || !release_ring_->Push(object_id)) {
+      RAY_RETURN_NOT_OK(SendReleaseRequest(store_conn_, object_id));
+    }
     auto iter = deletion_cache_.find(object_id);
     if (iter != deletion_cache_.end()) {
       deletion_cache_.erase(object_id);
@@ -580,6 +674,37 @@ Status PlasmaClient::Impl::Release(const ObjectID& object_id) {
   return Status::OK();
 }
 
+Status PlasmaClient::Impl::ReleaseBatch(const std::vector<ObjectID>& object_ids) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+
+  // If the client is already disconnected, ignore release requests.
+  if (!store_conn_) {
+    return Status::OK();
+  }
+  std::vector<ObjectID> unused_object_ids;
+  std::vector<ObjectID> object_ids_to_delete;
+  for (const auto& object_id : object_ids) {
+    if (DecrementObjectCount(object_id)) {
+      RAY_RETURN_NOT_OK(MarkObjectUnused(object_id));
+      if (!release_ring_ || !release_ring_->Push(object_id)) {
+        unused_object_ids.push_back(object_id);
+      }
+      if (deletion_cache_.erase(object_id) > 0) {
+        object_ids_to_delete.push_back(object_id);
+      }
+    }
+  }
+  // Tell the store that the client no longer needs the objects that did not
+  // fit in the ring, with a single message for all of them.
+  if (!unused_object_ids.empty()) {
+    RAY_RETURN_NOT_OK(SendReleaseBatchRequest(store_conn_, unused_object_ids));
+  }
+  if (!object_ids_to_delete.empty()) {
+    RAY_RETURN_NOT_OK(Delete(object_ids_to_delete));
+  }
+  return Status::OK();
+}
+
 // This method is used to query whether the plasma store contains an object.
 Status PlasmaClient::Impl::Contains(const ObjectID& object_id, bool* has_object) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
@@ -633,6 +758,43 @@ Status PlasmaClient::Impl::Seal(const ObjectID& object_id) {
   return Release(object_id);
 }
 
+Status PlasmaClient::Impl::SealBatch(const std::vector<ObjectID>& object_ids) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+
+  // Make sure this client has a reference to all of the objects before sending
+  // the request to Plasma.
+  for (const auto& object_id : object_ids) {
+    auto object_entry = objects_in_use_.find(object_id);
+    if (object_entry == objects_in_use_.end()) {
+      return Status::ObjectNotFound(
+          "SealBatch() called on an object without a reference to it");
+    }
+    if (object_entry->second->is_sealed) {
+      return Status::ObjectAlreadySealed(
+          "SealBatch() called on an already sealed object");
+    }
+  }
+  for (const auto& object_id : object_ids) {
+    objects_in_use_[object_id]->is_sealed = true;
+  }
+  /// Send the seal request to Plasma.
+  RAY_RETURN_NOT_OK(SendSealBatchRequest(store_conn_, object_ids));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaSealBatchReply, &buffer));
+  std::vector<ObjectID> sealed_ids;
+  std::vector<Status> results;
+  RAY_RETURN_NOT_OK(
+      ReadSealBatchReply(buffer.data(), buffer.size(), &sealed_ids, &results));
+  RAY_CHECK(sealed_ids == object_ids);
+  for (const auto& result : results) {
+    RAY_RETURN_NOT_OK(result);
+  }
+  // Release the extra instance of each object that was taken in Create(), see
+  // Seal().
+  return ReleaseBatch(object_ids);
+}
+
 Status PlasmaClient::Impl::Abort(const ObjectID& object_id) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
   auto object_entry = objects_in_use_.find(object_id);
@@ -725,11 +887,20 @@ Status PlasmaClient::Impl::Connect(const std::string& store_socket_name,
   ray::local_stream_socket socket(main_service_);
   RAY_RETURN_NOT_OK(ray::ConnectSocketRetry(socket, store_socket_name));
   store_conn_.reset(new StoreConn(std::move(socket)));
-  // Send a ConnectRequest to the store to get its memory capacity.
-  RAY_RETURN_NOT_OK(SendConnectRequest(store_conn_));
+  // Send a ConnectRequest to the store to get its memory capacity and,
+  // if the store supports it, a ring to post releases to.
+  RAY_RETURN_NOT_OK(SendConnectRequest(store_conn_, /*use_release_ring=*/true));
   std::vector<uint8_t> buffer;
   RAY_RETURN_NOT_OK(PlasmaReceive(store_conn_, MessageType::PlasmaConnectReply, &buffer));
-  RAY_RETURN_NOT_OK(ReadConnectReply(buffer.data(), buffer.size(), &store_capacity_));
+  uint32_t release_ring_capacity;
+  RAY_RETURN_NOT_OK(ReadConnectReply(buffer.data(), buffer.size(), &store_capacity_,
+                                     &release_ring_capacity));
+  if (release_ring_capacity > 0) {
+    MEMFD_TYPE fd;
+    RAY_RETURN_NOT_OK(store_conn_->RecvFd(&fd));
+    // If the ring cannot be mapped, releases are sent over the socket.
+    release_ring_ = ReleaseRing::Map(fd, release_ring_capacity);
+  }
   return Status::OK();
 }
 
@@ -752,6 +923,7 @@ Status PlasmaClient::Impl::Disconnect() {
   // Close the connections to Plasma. The Plasma store will release the objects
   // that were in use by us when handling the SIGPIPE.
   store_conn_.reset();
+  release_ring_.reset();
   return Status::OK();
 }
 
@@ -798,6 +970,17 @@ Status PlasmaClient::Create(const ObjectID& object_id, const ray::rpc::Address&
                        evict_if_full);
 }
 
+Status PlasmaClient::CreateBatch(const std::vector<ObjectID>& object_ids,
+                                 const ray::rpc::Address& owner_address,
+                                 const std::vector<int64_t>& data_sizes,
+                                 const std::vector<const uint8_t*>& metadatas,
+                                 const std::vector<int64_t>& metadata_sizes,
+                                 std::vector<std::shared_ptr<Buffer>>* data,
+                                 std::vector<Status>* results, bool evict_if_full) {
+  return impl_->CreateBatch(object_ids, owner_address, data_sizes, metadatas,
+                            metadata_sizes, data, results, evict_if_full);
+}
+
 Status PlasmaClient::Get(const std::vector<ObjectID>& object_ids, int64_t timeout_ms,
                          std::vector<ObjectBuffer>* object_buffers) {
   return impl_->Get(object_ids, timeout_ms, object_buffers);
@@ -812,6 +995,10 @@ Status PlasmaClient::Release(const ObjectID& object_id) {
   return impl_->Release(object_id);
 }
 
+Status PlasmaClient::ReleaseBatch(const std::vector<ObjectID>& object_ids) {
+  return impl_->ReleaseBatch(object_ids);
+}
+
 Status PlasmaClient::Contains(const ObjectID& object_id, bool* has_object) {
   return impl_->Contains(object_id, has_object);
 }
@@ -820,6 +1007,10 @@ Status PlasmaClient::Abort(const ObjectID& object_id) { return impl_->Abort(obje
 
 Status PlasmaClient::Seal(const ObjectID& object_id) { return impl_->Seal(object_id); }
 
+Status PlasmaClient::SealBatch(const std::vector<ObjectID>& object_ids) {
+  return impl_->SealBatch(object_ids);
+}
+
 Status PlasmaClient::Delete(const ObjectID& object_id) {
   return impl_->Delete(std::vector<ObjectID>{object_id});
 }
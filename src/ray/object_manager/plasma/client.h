@@ -98,12 +98,42 @@ class RAY_EXPORT PlasmaClient {
   /// \return The return status.
   ///
   /// The returned object must be released once it is done with.  It must also
-  /// be either sealed or aborted.
+  /// be either sealed or aborted. If the store has NUMA arenas enabled, it
+  /// places the object on the NUMA node of the calling thread.
   Status Create(const ObjectID& object_id, const ray::rpc::Address& owner_address,
                 int64_t data_size, const uint8_t* metadata, int64_t metadata_size,
                 std::shared_ptr<Buffer>* data, int device_num = 0,
                 bool evict_if_full = true);
 
+  /// Create a number of objects in the Plasma Store with a single round trip to
+  /// the store. The objects are created in host memory and share the same owner.
+  /// Each object is created independently, so some objects may be created even
+  /// if others fail.
+  ///
+  /// \param object_ids The IDs to use for the newly created objects.
+  /// \param owner_address The address of the objects' owner.
+  /// \param data_sizes The size in bytes of each object's data.
+  /// \param metadatas The metadata of each object, or NULL if the object has no
+  ///        metadata.
+  /// \param metadata_sizes The size in bytes of each object's metadata.
+  /// \param[out] data The buffers of the newly created objects. The buffer is
+  ///        nullptr for the objects that could not be created.
+  /// \param[out] results The result of creating each object.
+  /// \param evict_if_full Whether to evict other objects to make space for
+  ///        these objects.
+  /// \return The return status. This is only an error if the request to the
+  ///         store failed, the per-object errors are in results.
+  ///
+  /// Each created object must be released once it is done with. It must also
+  /// be either sealed or aborted.
+  Status CreateBatch(const std::vector<ObjectID>& object_ids,
+                     const ray::rpc::Address& owner_address,
+                     const std::vector<int64_t>& data_sizes,
+                     const std::vector<const uint8_t*>& metadatas,
+                     const std::vector<int64_t>& metadata_sizes,
+                     std::vector<std::shared_ptr<Buffer>>* data,
+                     std::vector<Status>* results, bool evict_if_full = true);
+
   /// Get some objects from the Plasma Store. This function will block until the
   /// objects have all been created and sealed in the Plasma Store or the
   /// timeout expires.
@@ -144,6 +174,13 @@ class RAY_EXPORT PlasmaClient {
   /// \return The return status.
   Status Release(const ObjectID& object_id);
 
+  /// Release a number of objects with a single message to the store. This is
+  /// equivalent to calling Release() on each of the objects.
+  ///
+  /// \param object_ids The IDs of the objects that are no longer needed.
+  /// \return The return status.
+  Status ReleaseBatch(const std::vector<ObjectID>& object_ids);
+
   /// Check if the object store contains a particular object and the object has
   /// been sealed. The result will be stored in has_object.
   ///
@@ -173,6 +210,13 @@ class RAY_EXPORT PlasmaClient {
   /// \return The return status.
   Status Seal(const ObjectID& object_id);
 
+  /// Seal a number of objects with a single round trip to the store. This is
+  /// equivalent to calling Seal() on each of the objects.
+  ///
+  /// \param object_ids The IDs of the objects to seal.
+  /// \return The return status.
+  Status SealBatch(const std::vector<ObjectID>& object_ids);
+
   /// Delete an object from the object store. This currently assumes that the
   /// object is present, has been sealed and not used by another client. Otherwise,
   /// it is a no operation.
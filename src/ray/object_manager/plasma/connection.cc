@@ -1,5 +1,7 @@
 #include "ray/object_manager/plasma/connection.h"
 
+#include <boost/asio/post.hpp>
+
 #include "ray/object_manager/format/object_manager_generated.h"
 #ifndef _WIN32
 #include "ray/object_manager/plasma/fling.h"
@@ -80,6 +82,10 @@ std::shared_ptr<Client> Client::Create(PlasmaStoreMessageHandler message_handler
   return self;
 }
 
+void Client::Post(std::function<void()> fn) {
+  boost::asio::post(socket_.get_executor(), std::move(fn));
+}
+
 Status Client::SendFd(MEMFD_TYPE fd) {
   // Only send the file descriptor if it hasn't been sent (see analogous
   // logic in GetStoreFd in client.cc).
@@ -4,6 +4,7 @@
 #include "ray/common/id.h"
 #include "ray/common/status.h"
 #include "ray/object_manager/plasma/compat.h"
+#include "ray/object_manager/plasma/release_ring.h"
 
 namespace plasma {
 
@@ -24,9 +25,22 @@ class Client : public ray::ClientConnection  {
 
   ray::Status SendFd(MEMFD_TYPE fd);
 
+  /// Run a function on the thread that handles this client's connection.
+  ///
+  /// \param fn The function to run.
+  void Post(std::function<void()> fn);
+
+  /// The executor of the thread that handles this client's connection.
+  ray::local_stream_socket::executor_type GetExecutor() {
+    return socket_.get_executor();
+  }
+
   /// Object ids that are used by this client.
   std::unordered_set<ray::ObjectID> object_ids;
 
+  /// The ring through which this client releases objects, if it has one.
+  std::unique_ptr<ReleaseRing> release_ring;
+
   std::string name = "anonymous_client";
 
  private:
@@ -31,6 +31,7 @@
 #include <string>
 #include <vector>
 
+#include "ray/object_manager/plasma/numa.h"
 #include "ray/object_manager/plasma/plasma.h"
 
 namespace plasma {
@@ -43,6 +44,7 @@ int fake_munmap(void*, int64_t);
 #define DIRECT_MMAP(s) fake_mmap(s)
 #define DIRECT_MUNMAP(a, s) fake_munmap(a, s)
 #define USE_DL_PREFIX
+#define MSPACES 1
 #define HAVE_MORECORE 0
 #define DEFAULT_MMAP_THRESHOLD MAX_SIZE_T
 #define DEFAULT_GRANULARITY ((size_t)128U * 1024U)
@@ -54,6 +56,7 @@ int fake_munmap(void*, int64_t);
 #undef DIRECT_MMAP
 #undef DIRECT_MUNMAP
 #undef USE_DL_PREFIX
+#undef MSPACES
 #undef HAVE_MORECORE
 #undef DEFAULT_GRANULARITY
 
@@ -127,6 +130,10 @@ void* fake_mmap(size_t size) {
   void* pointer;
   MEMFD_TYPE fd;
   create_and_mmap_buffer(size, &pointer, &fd);
+  if (mmap_numa_node >= 0) {
+    // The pages are not touched yet, so they will all be placed on the node.
+    PreferNumaNode(pointer, size, mmap_numa_node);
+  }
 
   // Increase dlmalloc's allocation granularity directly.
   mparams.granularity *= GRANULARITY_MULTIPLIER;
@@ -134,6 +141,7 @@ void* fake_mmap(size_t size) {
   MmapRecord& record = mmap_records[pointer];
   record.fd = fd;
   record.size = size;
+  record.numa_node = mmap_numa_node;
 
   // We lie to dlmalloc about where mapped memory actually lives.
   pointer = pointer_advance(pointer, kMmapRegionsGap);
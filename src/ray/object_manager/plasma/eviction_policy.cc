@@ -23,6 +23,45 @@
 
 namespace plasma {
 
+std::unique_ptr<ObjectCache> ObjectCache::Create(const std::string& type,
+                                                 const std::string& name, int64_t size) {
+  if (type == "lru") {
+    return std::unique_ptr<ObjectCache>(new LRUCache(name, size));
+  } else if (type == "2q") {
+    return std::unique_ptr<ObjectCache>(new TwoQueueCache(name, size));
+  } else if (type == "gdsf") {
+    return std::unique_ptr<ObjectCache>(new GreedyDualSizeCache(name, size));
+  }
+  RAY_LOG(FATAL) << "Unknown plasma eviction policy " << type
+                 << ", expected one of lru, 2q, gdsf";
+  return nullptr;
+}
+
+void ObjectCache::AdjustCapacity(int64_t delta) {
+  RAY_LOG(INFO) << "adjusting global lru capacity from " << Capacity() << " to "
+                  << (Capacity() + delta) << " (max " << OriginalCapacity() << ")";
+  capacity_ += delta;
+  RAY_CHECK(used_capacity_ >= 0) << DebugString();
+}
+
+int64_t ObjectCache::Capacity() const { return capacity_; }
+
+int64_t ObjectCache::OriginalCapacity() const { return original_capacity_; }
+
+int64_t ObjectCache::RemainingCapacity() const { return capacity_ - used_capacity_; }
+
+std::string ObjectCache::DebugString() const {
+  std::stringstream result;
+  result << "\n(" << name_ << ") capacity: " << Capacity();
+  result << "\n(" << name_
+         << ") used: " << 100. * (1. - (RemainingCapacity() / (double)OriginalCapacity()))
+         << "%";
+  result << "\n(" << name_ << ") num objects: " << NumObjects();
+  result << "\n(" << name_ << ") num evictions: " << num_evictions_total_;
+  result << "\n(" << name_ << ") bytes evicted: " << bytes_evicted_total_;
+  return result.str();
+}
+
 void LRUCache::Add(const ObjectID& key, int64_t size) {
   auto it = item_map_.find(key);
   RAY_CHECK(it == item_map_.end());
@@ -45,37 +84,12 @@ int64_t LRUCache::Remove(const ObjectID& key) {
   return size;
 }
 
-void LRUCache::AdjustCapacity(int64_t delta) {
-  RAY_LOG(INFO) << "adjusting global lru capacity from " << Capacity() << " to "
-                  << (Capacity() + delta) << " (max " << OriginalCapacity() << ")";
-  capacity_ += delta;
-  RAY_CHECK(used_capacity_ >= 0) << DebugString();
-}
-
-int64_t LRUCache::Capacity() const { return capacity_; }
-
-int64_t LRUCache::OriginalCapacity() const { return original_capacity_; }
-
-int64_t LRUCache::RemainingCapacity() const { return capacity_ - used_capacity_; }
-
 void LRUCache::Foreach(std::function<void(const ObjectID&)> f) {
   for (auto& pair : item_list_) {
     f(pair.first);
   }
 }
 
-std::string LRUCache::DebugString() const {
-  std::stringstream result;
-  result << "\n(" << name_ << ") capacity: " << Capacity();
-  result << "\n(" << name_
-         << ") used: " << 100. * (1. - (RemainingCapacity() / (double)OriginalCapacity()))
-         << "%";
-  result << "\n(" << name_ << ") num objects: " << item_map_.size();
-  result << "\n(" << name_ << ") num evictions: " << num_evictions_total_;
-  result << "\n(" << name_ << ") bytes evicted: " << bytes_evicted_total_;
-  return result.str();
-}
-
 int64_t LRUCache::ChooseObjectsToEvict(int64_t num_bytes_required,
                                        std::vector<ObjectID>* objects_to_evict) {
   int64_t bytes_evicted = 0;
@@ -84,29 +98,205 @@ int64_t LRUCache::ChooseObjectsToEvict(int64_t num_bytes_required,
     it--;
     objects_to_evict->push_back(it->first);
     bytes_evicted += it->second;
-    bytes_evicted_total_ += it->second;
-    num_evictions_total_ += 1;
+    RecordEviction(it->second);
+  }
+  return bytes_evicted;
+}
+
+int64_t AccessHistory::RecordAccess(const ObjectID& key) {
+  auto it = entry_map_.find(key);
+  if (it != entry_map_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return ++it->second->second;
+  }
+  entries_.emplace_front(key, 1);
+  entry_map_.emplace(key, entries_.begin());
+  if (entries_.size() > kAccessHistorySize) {
+    entry_map_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  return 1;
+}
+
+int64_t AccessHistory::NumAccesses(const ObjectID& key) const {
+  auto it = entry_map_.find(key);
+  return it == entry_map_.end() ? 0 : it->second->second;
+}
+
+bool AccessHistory::Forget(const ObjectID& key) {
+  auto it = entry_map_.find(key);
+  if (it == entry_map_.end()) {
+    return false;
+  }
+  entries_.erase(it->second);
+  entry_map_.erase(it);
+  return true;
+}
+
+void TwoQueueCache::Add(const ObjectID& key, int64_t size) {
+  RAY_CHECK(item_map_.find(key) == item_map_.end());
+  Item item;
+  item.frequent = history_.NumAccesses(key) > 1;
+  if (item.frequent) {
+    frequent_list_.emplace_front(key, size);
+    item.it = frequent_list_.begin();
+  } else {
+    new_list_.emplace_front(key, size);
+    item.it = new_list_.begin();
+    new_bytes_ += size;
+  }
+  item_map_.emplace(key, item);
+  used_capacity_ += size;
+}
+
+int64_t TwoQueueCache::Remove(const ObjectID& key) {
+  auto it = item_map_.find(key);
+  if (it == item_map_.end()) {
+    return -1;
+  }
+  int64_t size = it->second.it->second;
+  if (it->second.frequent) {
+    frequent_list_.erase(it->second.it);
+  } else {
+    new_list_.erase(it->second.it);
+    new_bytes_ -= size;
+  }
+  item_map_.erase(it);
+  used_capacity_ -= size;
+  RAY_CHECK(used_capacity_ >= 0) << DebugString();
+  // The object leaves the cache because a client uses it, because it is
+  // evicted, in which case it is used again if it is ever created again, or
+  // because it is deleted, in which case the access is forgotten eventually.
+  history_.RecordAccess(key);
+  return size;
+}
+
+int64_t TwoQueueCache::ChooseObjectsToEvict(int64_t num_bytes_required,
+                                            std::vector<ObjectID>* objects_to_evict) {
+  int64_t bytes_evicted = 0;
+  int64_t new_bytes = new_bytes_;
+  const int64_t new_bytes_target = static_cast<int64_t>(kNewFraction * capacity_);
+  auto new_it = new_list_.end();
+  auto frequent_it = frequent_list_.end();
+  while (bytes_evicted < num_bytes_required) {
+    bool has_new = new_it != new_list_.begin();
+    bool has_frequent = frequent_it != frequent_list_.begin();
+    if (!has_new && !has_frequent) {
+      break;
+    }
+    // Evict the oldest object used once while they take up more than their
+    // share of the capacity, and the least recently used frequent object after.
+    bool evict_new = has_new && (new_bytes > new_bytes_target || !has_frequent);
+    auto& it = evict_new ? new_it : frequent_it;
+    it--;
+    objects_to_evict->push_back(it->first);
+    bytes_evicted += it->second;
+    RecordEviction(it->second);
+    if (evict_new) {
+      new_bytes -= it->second;
+    }
   }
   return bytes_evicted;
 }
 
-EvictionPolicy::EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size)
-    : pinned_memory_bytes_(0), store_info_(store_info), cache_("global lru", max_size) {}
+void TwoQueueCache::Foreach(std::function<void(const ObjectID&)> f) {
+  for (auto& pair : new_list_) {
+    f(pair.first);
+  }
+  for (auto& pair : frequent_list_) {
+    f(pair.first);
+  }
+}
+
+std::string TwoQueueCache::DebugString() const {
+  std::stringstream result;
+  result << ObjectCache::DebugString();
+  result << "\n(" << name_ << ") objects used once: " << new_list_.size() << " ("
+         << new_bytes_ << " bytes)";
+  result << "\n(" << name_ << ") objects used more than once: " << frequent_list_.size()
+         << " (" << used_capacity_ - new_bytes_ << " bytes)";
+  return result.str();
+}
+
+void GreedyDualSizeCache::Add(const ObjectID& key, int64_t size) {
+  RAY_CHECK(item_map_.find(key) == item_map_.end());
+  int64_t num_accesses = std::max<int64_t>(history_.NumAccesses(key), 1);
+  Priority priority(
+      inflation_ + static_cast<double>(num_accesses) / std::max<int64_t>(size, 1),
+      next_sequence_number_++);
+  queue_.emplace(priority, Item{key, size});
+  item_map_.emplace(key, priority);
+  used_capacity_ += size;
+}
+
+int64_t GreedyDualSizeCache::Remove(const ObjectID& key) {
+  auto it = item_map_.find(key);
+  if (it == item_map_.end()) {
+    return -1;
+  }
+  auto queue_it = queue_.find(it->second);
+  int64_t size = queue_it->second.size;
+  queue_.erase(queue_it);
+  item_map_.erase(it);
+  used_capacity_ -= size;
+  RAY_CHECK(used_capacity_ >= 0) << DebugString();
+  history_.RecordAccess(key);
+  return size;
+}
+
+int64_t GreedyDualSizeCache::ChooseObjectsToEvict(
+    int64_t num_bytes_required, std::vector<ObjectID>* objects_to_evict) {
+  int64_t bytes_evicted = 0;
+  for (auto it = queue_.begin(); it != queue_.end() && bytes_evicted < num_bytes_required;
+       it++) {
+    objects_to_evict->push_back(it->second.key);
+    bytes_evicted += it->second.size;
+    RecordEviction(it->second.size);
+    // Objects added from now on are ranked above the evicted ones.
+    inflation_ = it->first.first;
+  }
+  return bytes_evicted;
+}
+
+void GreedyDualSizeCache::Foreach(std::function<void(const ObjectID&)> f) {
+  for (auto& entry : queue_) {
+    f(entry.second.key);
+  }
+}
+
+std::string GreedyDualSizeCache::DebugString() const {
+  std::stringstream result;
+  result << ObjectCache::DebugString();
+  result << "\n(" << name_ << ") inflation: " << inflation_;
+  return result.str();
+}
+
+EvictionPolicy::EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size,
+                               const std::string& cache_type)
+    : pinned_memory_bytes_(0),
+      store_info_(store_info),
+      cache_(ObjectCache::Create(cache_type, "global " + cache_type, max_size)),
+      num_hits_total_(0),
+      num_misses_total_(0),
+      num_refetches_total_(0),
+      bytes_refetched_total_(0) {}
 
 int64_t EvictionPolicy::ChooseObjectsToEvict(int64_t num_bytes_required,
                                              std::vector<ObjectID>* objects_to_evict) {
   int64_t bytes_evicted =
-      cache_.ChooseObjectsToEvict(num_bytes_required, objects_to_evict);
+      cache_->ChooseObjectsToEvict(num_bytes_required, objects_to_evict);
   // Update the LRU cache.
   for (auto& object_id : *objects_to_evict) {
-    cache_.Remove(object_id);
+    cache_->Remove(object_id);
   }
+  RecordObjectsEvicted(*objects_to_evict);
   return bytes_evicted;
 }
 
 void EvictionPolicy::ObjectCreated(const ObjectID& object_id, Client* client,
                                    bool is_create) {
-  cache_.Add(object_id, GetObjectSize(object_id));
+  RecordObjectCreated(object_id);
+  cache_->Add(object_id, GetObjectSize(object_id));
 }
 
 bool EvictionPolicy::SetClientQuota(Client* client, int64_t output_memory_quota) {
@@ -140,36 +330,71 @@ bool EvictionPolicy::RequireSpace(int64_t size, std::vector<ObjectID>* objects_t
 
 void EvictionPolicy::BeginObjectAccess(const ObjectID& object_id) {
   // If the object is in the LRU cache, remove it.
-  cache_.Remove(object_id);
+  cache_->Remove(object_id);
   pinned_memory_bytes_ += GetObjectSize(object_id);
 }
 
 void EvictionPolicy::EndObjectAccess(const ObjectID& object_id) {
   auto size = GetObjectSize(object_id);
   // Add the object to the LRU cache.
-  cache_.Add(object_id, size);
+  cache_->Add(object_id, size);
   pinned_memory_bytes_ -= size;
 }
 
 void EvictionPolicy::RemoveObject(const ObjectID& object_id) {
   // If the object is in the LRU cache, remove it.
-  cache_.Remove(object_id);
+  cache_->Remove(object_id);
 }
 
 void EvictionPolicy::RefreshObjects(const std::vector<ObjectID>& object_ids) {
   for (const auto& object_id : object_ids) {
-    int64_t size = cache_.Remove(object_id);
+    int64_t size = cache_->Remove(object_id);
     if (size != -1) {
-      cache_.Add(object_id, size);
+      cache_->Add(object_id, size);
     }
   }
 }
 
+void EvictionPolicy::ObjectRequested(const ObjectID& object_id, bool is_local) {
+  if (is_local) {
+    num_hits_total_++;
+  } else {
+    num_misses_total_++;
+  }
+}
+
+void EvictionPolicy::RecordObjectCreated(const ObjectID& object_id) {
+  if (evicted_objects_.Forget(object_id)) {
+    num_refetches_total_++;
+    bytes_refetched_total_ += GetObjectSize(object_id);
+  }
+}
+
+void EvictionPolicy::RecordObjectsEvicted(const std::vector<ObjectID>& object_ids) {
+  for (const auto& object_id : object_ids) {
+    evicted_objects_.RecordAccess(object_id);
+  }
+}
+
 int64_t EvictionPolicy::GetObjectSize(const ObjectID& object_id) const {
   auto entry = store_info_->objects[object_id].get();
   return entry->data_size + entry->metadata_size;
 }
 
-std::string EvictionPolicy::DebugString() const { return cache_.DebugString(); }
+std::string EvictionPolicy::StatsDebugString() const {
+  std::stringstream result;
+  int64_t num_requests = num_hits_total_ + num_misses_total_;
+  result << "\nnum hits: " << num_hits_total_;
+  result << "\nnum misses: " << num_misses_total_;
+  result << "\nhit rate: "
+         << (num_requests == 0 ? 0. : 100. * num_hits_total_ / num_requests) << "%";
+  result << "\nnum objects recreated after eviction: " << num_refetches_total_;
+  result << "\nbytes recreated after eviction: " << bytes_refetched_total_;
+  return result.str();
+}
+
+std::string EvictionPolicy::DebugString() const {
+  return cache_->DebugString() + StatsDebugString();
+}
 
 }  // namespace plasma
@@ -19,6 +19,8 @@
 
 #include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -39,9 +41,16 @@ class Client;
 //
 // It does not implement memory quotas; see quota_aware_policy for that.
 
-class LRUCache {
+/// The number of objects for which the frequency-aware caches remember how
+/// often they were accessed, including objects that are no longer cached.
+constexpr size_t kAccessHistorySize = 64 * 1024;
+
+/// A set of evictable objects that decides in which order they are evicted.
+/// Objects are added when they stop being used by any client and removed
+/// when they are used again or deleted.
+class ObjectCache {
  public:
-  LRUCache(const std::string& name, int64_t size)
+  ObjectCache(const std::string& name, int64_t size)
       : name_(name),
         original_capacity_(size),
         capacity_(size),
@@ -49,12 +58,32 @@ class LRUCache {
         num_evictions_total_(0),
         bytes_evicted_total_(0) {}
 
-  void Add(const ObjectID& key, int64_t size);
+  virtual ~ObjectCache() {}
 
-  int64_t Remove(const ObjectID& key);
+  /// Create a cache of the given type.
+  ///
+  /// \param type One of "lru", "2q" or "gdsf".
+  /// \param name The name of the cache, used for debugging purposes only.
+  /// \param size The capacity of the cache in bytes.
+  static std::unique_ptr<ObjectCache> Create(const std::string& type,
+                                             const std::string& name, int64_t size);
 
-  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
-                               std::vector<ObjectID>* objects_to_evict);
+  /// Add an object to the cache.
+  virtual void Add(const ObjectID& key, int64_t size) = 0;
+
+  /// Remove an object from the cache.
+  ///
+  /// \return The size of the object, or -1 if it was not in the cache.
+  virtual int64_t Remove(const ObjectID& key) = 0;
+
+  /// Choose objects to evict, without removing them from the cache. The caller
+  /// is expected to evict and Remove() the chosen objects.
+  ///
+  /// \return The total size of the chosen objects.
+  virtual int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                                       std::vector<ObjectID>* objects_to_evict) = 0;
+
+  virtual void Foreach(std::function<void(const ObjectID&)>) = 0;
 
   int64_t OriginalCapacity() const;
 
@@ -64,18 +93,16 @@ class LRUCache {
 
   void AdjustCapacity(int64_t delta);
 
-  void Foreach(std::function<void(const ObjectID&)>);
+  virtual std::string DebugString() const;
 
-  std::string DebugString() const;
+ protected:
+  virtual size_t NumObjects() const = 0;
 
- private:
-  /// A doubly-linked list containing the items in the cache and
-  /// their sizes in LRU order.
-  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
-  ItemList item_list_;
-  /// A hash table mapping the object ID of an object in the cache to its
-  /// location in the doubly linked list item_list_.
-  std::unordered_map<ObjectID, ItemList::iterator> item_map_;
+  /// Record that an object was chosen for eviction.
+  void RecordEviction(int64_t size) {
+    bytes_evicted_total_ += size;
+    num_evictions_total_ += 1;
+  }
 
   /// The name of this cache, used for debugging purposes only.
   const std::string name_;
@@ -91,6 +118,144 @@ class LRUCache {
   int64_t bytes_evicted_total_;
 };
 
+/// Evicts the least recently used object first.
+class LRUCache : public ObjectCache {
+ public:
+  LRUCache(const std::string& name, int64_t size) : ObjectCache(name, size) {}
+
+  void Add(const ObjectID& key, int64_t size) override;
+
+  int64_t Remove(const ObjectID& key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID>* objects_to_evict) override;
+
+  void Foreach(std::function<void(const ObjectID&)>) override;
+
+ protected:
+  size_t NumObjects() const override { return item_map_.size(); }
+
+ private:
+  /// A doubly-linked list containing the items in the cache and
+  /// their sizes in LRU order.
+  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
+  ItemList item_list_;
+  /// A hash table mapping the object ID of an object in the cache to its
+  /// location in the doubly linked list item_list_.
+  std::unordered_map<ObjectID, ItemList::iterator> item_map_;
+};
+
+/// Counts how many times each object was accessed. Only the kAccessHistorySize
+/// most recently accessed objects are remembered, so that the history of
+/// objects that were evicted or deleted does not grow without bound.
+class AccessHistory {
+ public:
+  /// Record an access to an object.
+  ///
+  /// \return The number of accesses to the object, including this one.
+  int64_t RecordAccess(const ObjectID& key);
+
+  /// Return the number of recorded accesses to an object.
+  int64_t NumAccesses(const ObjectID& key) const;
+
+  /// Forget the accesses to an object.
+  ///
+  /// \return True if any access to the object was recorded.
+  bool Forget(const ObjectID& key);
+
+ private:
+  typedef std::list<std::pair<ObjectID, int64_t>> EntryList;
+  /// The access counts, most recently accessed first.
+  EntryList entries_;
+  std::unordered_map<ObjectID, EntryList::iterator> entry_map_;
+};
+
+/// A 2Q cache. Objects that have been used at most once are kept in a FIFO
+/// queue that is evicted first as long as it holds more than kNewFraction of
+/// the capacity. Objects that have been used again, even after being evicted
+/// and recreated, are kept in an LRU queue. A scan over many objects then only
+/// evicts other objects that were used once.
+///
+/// An object is used each time it is removed from the cache, which happens
+/// when a client gets it.
+class TwoQueueCache : public ObjectCache {
+ public:
+  /// The share of the capacity above which objects used once are evicted first.
+  static constexpr double kNewFraction = 0.25;
+
+  TwoQueueCache(const std::string& name, int64_t size) : ObjectCache(name, size) {}
+
+  void Add(const ObjectID& key, int64_t size) override;
+
+  int64_t Remove(const ObjectID& key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID>* objects_to_evict) override;
+
+  void Foreach(std::function<void(const ObjectID&)>) override;
+
+  std::string DebugString() const override;
+
+ protected:
+  size_t NumObjects() const override { return item_map_.size(); }
+
+ private:
+  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
+  struct Item {
+    /// Whether the object is in the queue of frequently used objects.
+    bool frequent;
+    ItemList::iterator it;
+  };
+  /// The objects that have been used at most once, newest first.
+  ItemList new_list_;
+  /// The objects that have been used more than once, most recently used first.
+  ItemList frequent_list_;
+  std::unordered_map<ObjectID, Item> item_map_;
+  /// The number of bytes in new_list_.
+  int64_t new_bytes_ = 0;
+  AccessHistory history_;
+};
+
+/// A GreedyDual-Size-Frequency cache. Each object has priority
+/// L + (number of uses) / size, where L is the priority of the last evicted
+/// object, and the object with the lowest priority is evicted first. Large
+/// objects that are used once are evicted before small objects that are used
+/// often, and L ages objects that are not used anymore.
+class GreedyDualSizeCache : public ObjectCache {
+ public:
+  GreedyDualSizeCache(const std::string& name, int64_t size) : ObjectCache(name, size) {}
+
+  void Add(const ObjectID& key, int64_t size) override;
+
+  int64_t Remove(const ObjectID& key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID>* objects_to_evict) override;
+
+  void Foreach(std::function<void(const ObjectID&)>) override;
+
+  std::string DebugString() const override;
+
+ protected:
+  size_t NumObjects() const override { return item_map_.size(); }
+
+ private:
+  /// The priority of an object, and a sequence number that breaks ties in
+  /// insertion order.
+  typedef std::pair<double, uint64_t> Priority;
+  struct Item {
+    ObjectID key;
+    int64_t size;
+  };
+  /// The objects in the cache, lowest priority first.
+  std::map<Priority, Item> queue_;
+  std::unordered_map<ObjectID, Priority> item_map_;
+  /// The inflation value L.
+  double inflation_ = 0;
+  uint64_t next_sequence_number_ = 0;
+  AccessHistory history_;
+};
+
 /// The eviction policy.
 class EvictionPolicy {
  public:
@@ -99,7 +264,10 @@ class EvictionPolicy {
   /// \param store_info Information about the Plasma store that is exposed
   ///        to the eviction policy.
   /// \param max_size Max size in bytes total of objects to store.
-  explicit EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size);
+  /// \param cache_type The type of cache that decides which objects to evict,
+  ///        see ObjectCache::Create.
+  explicit EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size,
+                          const std::string& cache_type = "lru");
 
   /// Destroy an eviction policy.
   virtual ~EvictionPolicy() {}
@@ -192,6 +360,14 @@ class EvictionPolicy {
 
   virtual void RefreshObjects(const std::vector<ObjectID>& object_ids);
 
+  /// This method will be called whenever a client gets an object, to keep track
+  /// of the hit rate of the store.
+  ///
+  /// \param object_id The ID of the object.
+  /// \param is_local Whether the object is in memory. If not, it has to be
+  ///        fetched or restored.
+  void ObjectRequested(const ObjectID& object_id, bool is_local);
+
   /// Returns debugging information for this eviction policy.
   virtual std::string DebugString() const;
 
@@ -204,8 +380,30 @@ class EvictionPolicy {
 
   /// Pointer to the plasma store info.
   PlasmaStoreInfo* store_info_;
-  /// Datastructure for the LRU cache.
-  LRUCache cache_;
+  /// The cache of evictable objects.
+  std::unique_ptr<ObjectCache> cache_;
+
+  /// Record that an object was created, to count the objects that are
+  /// created again after being evicted.
+  void RecordObjectCreated(const ObjectID& object_id);
+
+  /// Record that objects were chosen for eviction.
+  void RecordObjectsEvicted(const std::vector<ObjectID>& object_ids);
+
+  /// Returns the hit, miss and refetch counters.
+  std::string StatsDebugString() const;
+
+ private:
+  /// The number of gets of objects that were in memory.
+  int64_t num_hits_total_;
+  /// The number of gets of objects that were not in memory.
+  int64_t num_misses_total_;
+  /// The number of objects that were created again after being evicted.
+  int64_t num_refetches_total_;
+  /// The number of bytes of objects that were created again after being evicted.
+  int64_t bytes_refetched_total_;
+  /// The objects that were recently evicted.
+  AccessHistory evicted_objects_;
 };
 
 }  // namespace plasma
@@ -72,6 +72,9 @@ class ExternalStore {
   /// \return The return status.
   virtual Status Get(const std::vector<ObjectID>& ids,
                      std::vector<std::shared_ptr<Buffer>> buffers) = 0;
+
+  /// Returns debugging information about the external store.
+  virtual std::string DebugString() const { return ""; }
 };
 
 class ExternalStores {
@@ -0,0 +1,156 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/local_disk_external_store.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+
+constexpr char kEndpointPrefix[] = "local-disk://";
+
+Status ParseInt(const std::string& key, const std::string& value, int64_t* result) {
+  try {
+    size_t end;
+    *result = std::stoll(value, &end);
+    if (end == value.size() && *result > 0) {
+      return Status::OK();
+    }
+  } catch (const std::exception&) {
+  }
+  return Status::Invalid("Invalid value for local-disk option " + key + ": " + value);
+}
+
+}  // namespace
+
+LocalDiskExternalStore::~LocalDiskExternalStore() { Stop(); }
+
+Status LocalDiskExternalStore::Connect(const std::string& endpoint) {
+  if (endpoint.compare(0, sizeof(kEndpointPrefix) - 1, kEndpointPrefix) != 0) {
+    return Status::Invalid("Malformed local-disk endpoint " + endpoint);
+  }
+  std::string path = endpoint.substr(sizeof(kEndpointPrefix) - 1);
+  Options options;
+  auto query = path.find('?');
+  if (query != std::string::npos) {
+    RAY_RETURN_NOT_OK(ParseOptions(path.substr(query + 1), &options));
+    path = path.substr(0, query);
+  }
+  if (path.empty()) {
+    return Status::Invalid("No directory in local-disk endpoint " + endpoint);
+  }
+  directory_ = path;
+  std::random_device random;
+  std::stringstream prefix;
+  prefix << "plasma-spill-" << std::hex << random() << random() << "-";
+  file_prefix_ = prefix.str();
+
+  // Check that the directory is writable, rather than failing on the first
+  // eviction.
+  std::string probe_path = directory_ + "/" + file_prefix_ + "probe";
+  if (!std::ofstream(probe_path)) {
+    return Status::IOError("Cannot create files in " + directory_);
+  }
+  std::remove(probe_path.c_str());
+
+  RAY_LOG(INFO) << "Writing evicted objects to " << directory_ << " with "
+                << options.num_workers << " threads, compression "
+                << (options.compress ? "enabled" : "disabled");
+  Start(options);
+  return Status::OK();
+}
+
+Status LocalDiskExternalStore::ParseOptions(const std::string& query, Options* options) {
+  std::stringstream stream(query);
+  std::string option;
+  while (std::getline(stream, option, '&')) {
+    if (option.empty()) {
+      continue;
+    }
+    auto equals = option.find('=');
+    if (equals == std::string::npos) {
+      return Status::Invalid("Malformed local-disk option " + option);
+    }
+    std::string key = option.substr(0, equals);
+    std::string value = option.substr(equals + 1);
+    int64_t number;
+    if (key == "num_workers") {
+      RAY_RETURN_NOT_OK(ParseInt(key, value, &number));
+      options->num_workers = static_cast<int>(number);
+    } else if (key == "segment_size") {
+      RAY_RETURN_NOT_OK(ParseInt(key, value, &options->segment_size));
+    } else if (key == "max_pending_bytes") {
+      RAY_RETURN_NOT_OK(ParseInt(key, value, &options->max_pending_bytes));
+    } else if (key == "linger_ms") {
+      RAY_RETURN_NOT_OK(ParseInt(key, value, &options->linger_ms));
+    } else if (key == "compression") {
+      if (value != "zlib" && value != "none") {
+        return Status::Invalid("Unsupported compression " + value);
+      }
+      options->compress = value == "zlib";
+    } else {
+      return Status::Invalid("Unknown local-disk option " + key);
+    }
+  }
+  return Status::OK();
+}
+
+std::string LocalDiskExternalStore::SegmentPath(uint64_t segment_id) const {
+  return directory_ + "/" + file_prefix_ + std::to_string(segment_id);
+}
+
+Status LocalDiskExternalStore::WriteSegment(uint64_t segment_id, const uint8_t* data,
+                                            int64_t size) {
+  std::string path = SegmentPath(segment_id);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(data), size);
+  file.close();
+  if (!file) {
+    std::remove(path.c_str());
+    return Status::IOError("Failed to write " + std::to_string(size) + " bytes to " +
+                           path);
+  }
+  return Status::OK();
+}
+
+Status LocalDiskExternalStore::ReadSegment(uint64_t segment_id, int64_t offset,
+                                           int64_t size, uint8_t* out) {
+  std::string path = SegmentPath(segment_id);
+  std::ifstream file(path, std::ios::binary);
+  file.seekg(offset);
+  file.read(reinterpret_cast<char*>(out), size);
+  if (!file || file.gcount() != size) {
+    return Status::IOError("Failed to read " + std::to_string(size) + " bytes at " +
+                           std::to_string(offset) + " from " + path);
+  }
+  return Status::OK();
+}
+
+void LocalDiskExternalStore::DeleteSegment(uint64_t segment_id) {
+  std::string path = SegmentPath(segment_id);
+  if (std::remove(path.c_str()) != 0) {
+    RAY_LOG(WARNING) << "Failed to delete " << path;
+  }
+}
+
+REGISTER_EXTERNAL_STORE("local-disk", LocalDiskExternalStore);
+
+}  // namespace plasma
@@ -0,0 +1,67 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "ray/object_manager/plasma/async_external_store.h"
+
+namespace plasma {
+
+/// An external store that writes each segment to a file in a local directory.
+///
+/// The endpoint has the form
+///   local-disk://<directory>[?<option>=<value>[&<option>=<value>...]]
+/// where the directory must exist, and the options are
+///   - num_workers: the number of threads that write segments.
+///   - segment_size: the size in bytes of the segments objects are packed into.
+///   - max_pending_bytes: the number of bytes that may wait to be written.
+///   - linger_ms: how long a segment that is not full may wait to be written.
+///   - compression: "zlib" or "none".
+/// For example, local-disk:///mnt/spill?num_workers=4&compression=zlib.
+class LocalDiskExternalStore : public AsyncExternalStore {
+ public:
+  LocalDiskExternalStore() = default;
+
+  ~LocalDiskExternalStore() override;
+
+  Status Connect(const std::string& endpoint) override;
+
+ protected:
+  Status WriteSegment(uint64_t segment_id, const uint8_t* data, int64_t size) override;
+
+  Status ReadSegment(uint64_t segment_id, int64_t offset, int64_t size,
+                     uint8_t* out) override;
+
+  void DeleteSegment(uint64_t segment_id) override;
+
+ private:
+  /// Parse the options in the query part of an endpoint.
+  ///
+  /// \param query The query, e.g. "num_workers=4&compression=zlib".
+  /// \param[out] options The parsed options are written here.
+  /// \return The return status.
+  static Status ParseOptions(const std::string& query, Options* options);
+
+  std::string SegmentPath(uint64_t segment_id) const;
+
+  /// The directory the segment files are in.
+  std::string directory_;
+  /// The prefix of the segment file names. This is unique for each store, so
+  /// that several stores can share a directory.
+  std::string file_prefix_;
+};
+
+}  // namespace plasma
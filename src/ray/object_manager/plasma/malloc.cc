@@ -26,6 +26,8 @@ namespace plasma {
 
 std::unordered_map<void*, MmapRecord> mmap_records;
 
+int mmap_numa_node = -1;
+
 static void* pointer_advance(void* p, ptrdiff_t n) { return (unsigned char*)p + n; }
 
 static ptrdiff_t pointer_distance(void const* pfrom, void const* pto) {
@@ -47,6 +49,15 @@ void GetMallocMapinfo(void* addr, MEMFD_TYPE* fd, int64_t* map_size, ptrdiff_t*
   *offset = 0;
 }
 
+int GetMallocNumaNode(void* addr) {
+  for (const auto& entry : mmap_records) {
+    if (addr >= entry.first && addr < pointer_advance(entry.first, entry.second.size)) {
+      return entry.second.numa_node;
+    }
+  }
+  return -1;
+}
+
 int64_t GetMmapSize(MEMFD_TYPE fd) {
   for (const auto& entry : mmap_records) {
     if (entry.second.fd == fd) {
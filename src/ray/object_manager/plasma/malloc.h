@@ -39,9 +39,18 @@ void GetMallocMapinfo(void* addr, MEMFD_TYPE* fd, int64_t* map_length, ptrdiff_t
 /// \return The size of the corresponding memory-mapped file.
 int64_t GetMmapSize(MEMFD_TYPE fd);
 
+/// Get the NUMA node that the memory-mapped file containing an address was
+/// placed on.
+///
+/// \param addr The address to look up.
+/// \return The node, or -1 if the file was not placed on a particular node.
+int GetMallocNumaNode(void* addr);
+
 struct MmapRecord {
   MEMFD_TYPE fd;
   int64_t size;
+  /// The NUMA node that the file was placed on, or -1.
+  int numa_node;
 };
 
 /// Hashtable that contains one entry per segment that we got from the OS
@@ -49,4 +58,8 @@ struct MmapRecord {
 /// and size.
 extern std::unordered_map<void*, MmapRecord> mmap_records;
 
+/// The NUMA node to place the files that dlmalloc maps next on, or -1 to use
+/// the default memory policy.
+extern int mmap_numa_node;
+
 }  // namespace plasma
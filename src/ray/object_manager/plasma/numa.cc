@@ -0,0 +1,124 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/numa.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+
+#ifdef __linux__
+/// From linux/mempolicy.h. We call mbind directly so that we do not depend on
+/// libnuma.
+constexpr int kMpolPreferred = 1;
+#endif
+
+bool ParseNonNegative(const std::string &value, int *result) {
+  if (value.empty() || value.size() > 9 ||
+      !std::all_of(value.begin(), value.end(), ::isdigit)) {
+    return false;
+  }
+  *result = std::stoi(value);
+  return true;
+}
+
+}  // namespace
+
+std::vector<int> ParseNumaNodeList(const std::string &list) {
+  std::vector<int> nodes;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first, last;
+    if (dash == std::string::npos) {
+      if (!ParseNonNegative(range, &first)) {
+        return {};
+      }
+      last = first;
+    } else if (!ParseNonNegative(range.substr(0, dash), &first) ||
+               !ParseNonNegative(range.substr(dash + 1), &last) || last < first) {
+      return {};
+    }
+    for (int node = first; node <= last; node++) {
+      nodes.push_back(node);
+    }
+  }
+  return nodes;
+}
+
+int NumNumaNodes() {
+  static const int num_nodes = []() {
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string list;
+    if (!file || !std::getline(file, list)) {
+      return 1;
+    }
+    auto nodes = ParseNumaNodeList(list);
+    if (nodes.empty()) {
+      RAY_LOG(WARNING) << "Failed to parse the list of NUMA nodes: " << list;
+      return 1;
+    }
+    return *std::max_element(nodes.begin(), nodes.end()) + 1;
+  }();
+  return num_nodes;
+}
+
+int GetCurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned int cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return -1;
+}
+
+bool PreferNumaNode(void *addr, size_t length, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int kBitsPerWord = sizeof(unsigned long) * CHAR_BIT;
+  std::vector<unsigned long> node_mask(node / kBitsPerWord + 1, 0);
+  node_mask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+  // The kernel ignores the last bit of the mask, so pass one more than its size.
+  unsigned long max_node = node_mask.size() * kBitsPerWord + 1;
+  if (syscall(SYS_mbind, addr, length, kMpolPreferred, node_mask.data(), max_node, 0) ==
+      0) {
+    return true;
+  }
+  RAY_LOG(WARNING) << "Failed to place " << length << " bytes on NUMA node " << node
+                   << ": " << std::strerror(errno);
+#endif
+  return false;
+}
+
+}  // namespace plasma
@@ -0,0 +1,51 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace plasma {
+
+/// Parse a list of NUMA nodes in the format of
+/// /sys/devices/system/node/online, e.g. "0-3,6".
+///
+/// \param list The list to parse.
+/// \return The nodes in the list, or an empty vector if it is malformed.
+std::vector<int> ParseNumaNodeList(const std::string &list);
+
+/// Get the number of NUMA nodes of this host. Node IDs are in the range
+/// [0, NumNumaNodes()).
+///
+/// \return The number of nodes, or 1 if the topology is not known.
+int NumNumaNodes();
+
+/// Get the NUMA node of the CPU that the calling thread is running on.
+///
+/// \return The node, or -1 if it is not known.
+int GetCurrentNumaNode();
+
+/// Make the kernel place the pages of a memory range on the given NUMA node
+/// when they are first touched. If the node runs out of memory, the pages are
+/// placed on other nodes instead of failing.
+///
+/// \param addr The start of the range. This must be page-aligned.
+/// \param length The length of the range in bytes.
+/// \param node The node to place the pages on.
+/// \return True if the memory policy was set.
+bool PreferNumaNode(void *addr, size_t length, int node);
+
+}  // namespace plasma
@@ -15,9 +15,13 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <sstream>
+
 #include "ray/util/logging.h"
 
 #include "ray/object_manager/plasma/malloc.h"
+#include "ray/object_manager/plasma/numa.h"
+#include "ray/object_manager/plasma/plasma.h"
 #include "ray/object_manager/plasma/plasma_allocator.h"
 
 namespace plasma {
@@ -25,12 +29,92 @@ namespace plasma {
 extern "C" {
 void* dlmemalign(size_t alignment, size_t bytes);
 void dlfree(void* mem);
+void* create_mspace(size_t capacity, int locked);
+void* mspace_memalign(void* msp, size_t alignment, size_t bytes);
+void mspace_free(void* msp, void* mem);
 }
 
 int64_t PlasmaAllocator::footprint_limit_ = 0;
 int64_t PlasmaAllocator::allocated_ = 0;
+std::unique_ptr<SlabAllocator> PlasmaAllocator::slab_allocator_;
+std::vector<PlasmaAllocator::NumaArena> PlasmaAllocator::numa_arenas_;
+
+void* PlasmaAllocator::Memalign(size_t alignment, size_t bytes, int numa_node) {
+  if (slab_allocator_ && slab_allocator_->Handles(bytes) &&
+      alignment <= static_cast<size_t>(kBlockSize)) {
+    void* mem = slab_allocator_->Allocate(bytes);
+    if (mem != nullptr) {
+      return mem;
+    }
+    // There is no room for a new slab of this size class, but the object itself
+    // may still fit, so fall back to dlmalloc.
+  }
+  if (!numa_arenas_.empty()) {
+    return NumaMemalign(alignment, bytes, numa_node);
+  }
+  return DlMemalign(alignment, bytes);
+}
+
+void PlasmaAllocator::Free(void* mem, size_t bytes) {
+  if (slab_allocator_ && slab_allocator_->Free(mem, bytes)) {
+    return;
+  }
+  if (!numa_arenas_.empty()) {
+    int numa_node = GetMallocNumaNode(mem);
+    if (numa_node >= 0) {
+      auto& arena = numa_arenas_[numa_node];
+      mspace_free(arena.mspace, mem);
+      arena.allocated -= bytes;
+      allocated_ -= bytes;
+      return;
+    }
+    // The memory is a slab, which comes from the default arena.
+  }
+  DlFree(mem, bytes);
+}
+
+void* PlasmaAllocator::NumaMemalign(size_t alignment, size_t bytes, int numa_node) {
+  if (allocated_ + static_cast<int64_t>(bytes) > footprint_limit_) {
+    return nullptr;
+  }
+  int num_arenas = static_cast<int>(numa_arenas_.size());
+  if (numa_node < 0 || numa_node >= num_arenas) {
+    numa_node = GetCurrentNumaNode();
+    if (numa_node < 0 || numa_node >= num_arenas) {
+      numa_node = 0;
+    }
+  }
+  int64_t arena_limit = footprint_limit_ / num_arenas;
+  int arena_index = numa_node;
+  if (numa_arenas_[arena_index].allocated + static_cast<int64_t>(bytes) > arena_limit) {
+    // Remote memory is better than evicting objects, so use the arena with the
+    // most free space instead.
+    for (int i = 0; i < num_arenas; i++) {
+      if (numa_arenas_[i].allocated < numa_arenas_[arena_index].allocated) {
+        arena_index = i;
+      }
+    }
+    if (numa_arenas_[arena_index].allocated + static_cast<int64_t>(bytes) >
+        arena_limit) {
+      return nullptr;
+    }
+  }
+  auto& arena = numa_arenas_[arena_index];
+  // New memory that dlmalloc maps for this arena is placed on its node.
+  mmap_numa_node = arena_index;
+  void* mem = mspace_memalign(arena.mspace, alignment, bytes);
+  mmap_numa_node = -1;
+  RAY_CHECK(mem);
+  arena.allocated += bytes;
+  arena.num_allocations++;
+  if (arena_index != numa_node) {
+    arena.num_fallback_allocations++;
+  }
+  allocated_ += bytes;
+  return mem;
+}
 
-void* PlasmaAllocator::Memalign(size_t alignment, size_t bytes) {
+void* PlasmaAllocator::DlMemalign(size_t alignment, size_t bytes) {
   if (allocated_ + static_cast<int64_t>(bytes) > footprint_limit_) {
     return nullptr;
   }
@@ -40,11 +124,44 @@ void* PlasmaAllocator::Memalign(size_t alignment, size_t bytes) {
   return mem;
 }
 
-void PlasmaAllocator::Free(void* mem, size_t bytes) {
+void PlasmaAllocator::DlFree(void* mem, size_t bytes) {
   dlfree(mem);
   allocated_ -= bytes;
 }
 
+void PlasmaAllocator::EnableSlabAllocator(size_t min_block_size, size_t max_block_size,
+                                          size_t min_slab_size) {
+  RAY_CHECK(allocated_ == 0) << "The slab allocator must be enabled before any "
+                                "allocation is made.";
+  slab_allocator_.reset(new SlabAllocator(kBlockSize, min_block_size, max_block_size,
+                                          min_slab_size, &PlasmaAllocator::DlMemalign,
+                                          &PlasmaAllocator::DlFree));
+  RAY_LOG(INFO) << "Serving plasma objects of up to " << max_block_size
+                << " bytes from the slab allocator.";
+}
+
+void PlasmaAllocator::EnableNumaArenas(int num_nodes) {
+  RAY_CHECK(allocated_ == 0) << "NUMA arenas must be enabled before any allocation "
+                                "is made.";
+  RAY_CHECK(num_nodes > 0);
+  for (int node = 0; node < num_nodes; node++) {
+    NumaArena arena;
+    // Creating the arena maps its first segment.
+    mmap_numa_node = node;
+    arena.mspace = create_mspace(0, 0);
+    mmap_numa_node = -1;
+    RAY_CHECK(arena.mspace != nullptr) << "Failed to create the arena of NUMA node "
+                                       << node;
+    arena.allocated = 0;
+    arena.num_allocations = 0;
+    arena.num_fallback_allocations = 0;
+    numa_arenas_.push_back(arena);
+  }
+  RAY_LOG(INFO) << "Placing plasma objects on " << num_nodes << " NUMA nodes.";
+}
+
+int PlasmaAllocator::NumNumaArenas() { return static_cast<int>(numa_arenas_.size()); }
+
 void PlasmaAllocator::SetFootprintLimit(size_t bytes) {
   footprint_limit_ = static_cast<int64_t>(bytes);
 }
@@ -53,4 +170,26 @@ int64_t PlasmaAllocator::GetFootprintLimit() { return footprint_limit_; }
 
 int64_t PlasmaAllocator::Allocated() { return allocated_; }
 
+std::string PlasmaAllocator::DebugString() {
+  std::stringstream result;
+  result << "\n(allocator) footprint limit: " << footprint_limit_;
+  result << "\n(allocator) allocated: " << allocated_;
+  if (slab_allocator_) {
+    result << slab_allocator_->DebugString();
+  }
+  for (size_t node = 0; node < numa_arenas_.size(); node++) {
+    const auto& arena = numa_arenas_[node];
+    int64_t mapped = 0;
+    for (const auto& entry : mmap_records) {
+      if (entry.second.numa_node == static_cast<int>(node)) {
+        mapped += entry.second.size;
+      }
+    }
+    result << "\n(allocator) numa node " << node << ": allocated " << arena.allocated
+           << ", mapped " << mapped << ", allocations " << arena.num_allocations
+           << ", fallback allocations " << arena.num_fallback_allocations;
+  }
+  return result.str();
+}
+
 }  // namespace plasma
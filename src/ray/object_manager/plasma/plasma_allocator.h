@@ -19,6 +19,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ray/object_manager/plasma/slab_allocator.h"
 
 namespace plasma {
 
@@ -29,8 +34,10 @@ class PlasmaAllocator {
   ///
   /// \param alignment Memory alignment.
   /// \param bytes Number of bytes.
+  /// \param numa_node The NUMA node to place the memory on if NUMA arenas are
+  ///        enabled, or -1 to use the node of the calling thread.
   /// \return Pointer to allocated memory.
-  static void* Memalign(size_t alignment, size_t bytes);
+  static void* Memalign(size_t alignment, size_t bytes, int numa_node = -1);
 
   /// Frees the memory space pointed to by mem, which must have been returned by
   /// a previous call to Memalign()
@@ -49,13 +56,68 @@ class PlasmaAllocator {
   /// \return Plasma memory footprint limit in bytes.
   static int64_t GetFootprintLimit();
 
-  /// Get the number of bytes allocated by Plasma so far.
+  /// Get the number of bytes allocated by Plasma so far. This includes the
+  /// slabs reserved by the slab allocator, whether their blocks are in use or not.
   /// \return Number of bytes allocated by Plasma so far.
   static int64_t Allocated();
 
+  /// Serve small allocations from per-size-class slabs carved out of the
+  /// shared memory region instead of going through dlmalloc for each object.
+  /// Must be called before any allocation is made.
+  ///
+  /// \param min_block_size Size of the smallest size class.
+  /// \param max_block_size Allocations larger than this go to dlmalloc.
+  /// \param min_slab_size Minimum number of bytes reserved at once for a
+  ///        size class.
+  static void EnableSlabAllocator(size_t min_block_size, size_t max_block_size,
+                                  size_t min_slab_size);
+
+  /// Allocate objects from one dlmalloc arena per NUMA node, whose memory is
+  /// placed on that node, instead of from a single arena. Each arena may use an
+  /// equal share of the footprint limit. Must be called after plasma_config is
+  /// set and before any allocation is made.
+  ///
+  /// \param num_nodes The number of NUMA nodes.
+  static void EnableNumaArenas(int num_nodes);
+
+  /// Get the number of NUMA arenas.
+  ///
+  /// \return The number of arenas, or 0 if NUMA arenas are not enabled.
+  static int NumNumaArenas();
+
+  /// Returns debugging information about the allocator.
+  static std::string DebugString();
+
  private:
+  /// Allocate memory directly from dlmalloc, subject to the footprint limit.
+  static void* DlMemalign(size_t alignment, size_t bytes);
+
+  /// Free memory allocated by DlMemalign().
+  static void DlFree(void* mem, size_t bytes);
+
+  /// A dlmalloc arena whose memory is placed on one NUMA node.
+  struct NumaArena {
+    /// The dlmalloc mspace of the arena.
+    void* mspace;
+    /// Number of bytes currently allocated from the arena.
+    int64_t allocated;
+    /// Number of allocations made from the arena so far.
+    int64_t num_allocations;
+    /// Number of allocations made from the arena so far that were meant for
+    /// another node, whose arena was full.
+    int64_t num_fallback_allocations;
+  };
+
+  /// Allocate memory from the arena of a NUMA node, or from the arena with the
+  /// most free space if that arena is full.
+  static void* NumaMemalign(size_t alignment, size_t bytes, int numa_node);
+
   static int64_t allocated_;
   static int64_t footprint_limit_;
+  /// The allocator for small objects, if enabled.
+  static std::unique_ptr<SlabAllocator> slab_allocator_;
+  /// The arena of each NUMA node, if enabled.
+  static std::vector<NumaArena> numa_arenas_;
 };
 
 }  // namespace plasma
@@ -193,7 +193,8 @@ Status ReadGetDebugStringReply(uint8_t* data, size_t size, std::string* debug_st
 
 Status SendCreateRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id,
                          const ray::rpc::Address& owner_address, bool evict_if_full,
-                         int64_t data_size, int64_t metadata_size, int device_num) {
+                         int64_t data_size, int64_t metadata_size, int device_num,
+                         int numa_node) {
   flatbuffers::FlatBufferBuilder fbb;
   auto message =
       fb::CreatePlasmaCreateRequest(fbb, fbb.CreateString(object_id.Binary()),
@@ -201,7 +202,8 @@ Status SendCreateRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID
                                     fbb.CreateString(owner_address.ip_address()),
                                     owner_address.port(),
                                     fbb.CreateString(owner_address.worker_id()),
-                                    evict_if_full, data_size, metadata_size, device_num);
+                                    evict_if_full, data_size, metadata_size, device_num,
+                                    numa_node);
   return PlasmaSend(store_conn, MessageType::PlasmaCreateRequest, &fbb, message);
 }
 
@@ -209,7 +211,7 @@ Status ReadCreateRequest(uint8_t* data, size_t size, ObjectID* object_id,
                          NodeID* owner_raylet_id, std::string* owner_ip_address,
                          int* owner_port, WorkerID* owner_worker_id, bool* evict_if_full,
                          int64_t* data_size, int64_t* metadata_size,
-                         int* device_num) {
+                         int* device_num, int* numa_node) {
   RAY_DCHECK(data);
   auto message = flatbuffers::GetRoot<fb::PlasmaCreateRequest>(data);
   RAY_DCHECK(VerifyFlatbuffer(message, data, size));
@@ -222,6 +224,7 @@ Status ReadCreateRequest(uint8_t* data, size_t size, ObjectID* object_id,
   *owner_port = message->owner_port();
   *owner_worker_id = WorkerID::FromBinary(message->owner_worker_id()->str());
   *device_num = message->device_num();
+  *numa_node = message->numa_node();
   return Status::OK();
 }
 
@@ -284,6 +287,122 @@ Status ReadCreateReply(uint8_t* data, size_t size, ObjectID* object_id,
   return PlasmaErrorStatus(message->error());
 }
 
+Status SendCreateBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                              const std::vector<ObjectID>& object_ids,
+                              const ray::rpc::Address& owner_address, bool evict_if_full,
+                              const std::vector<int64_t>& data_sizes,
+                              const std::vector<int64_t>& metadata_sizes, int numa_node) {
+  RAY_DCHECK(object_ids.size() == data_sizes.size());
+  RAY_DCHECK(object_ids.size() == metadata_sizes.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<uint64_t> data_sizes_as_uint(data_sizes.begin(), data_sizes.end());
+  std::vector<uint64_t> metadata_sizes_as_uint(metadata_sizes.begin(),
+                                               metadata_sizes.end());
+  auto message = fb::CreatePlasmaCreateBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()),
+      fbb.CreateString(owner_address.raylet_id()),
+      fbb.CreateString(owner_address.ip_address()), owner_address.port(),
+      fbb.CreateString(owner_address.worker_id()), evict_if_full,
+      fbb.CreateVector(arrow::util::MakeNonNull(data_sizes_as_uint.data()),
+                       data_sizes_as_uint.size()),
+      fbb.CreateVector(arrow::util::MakeNonNull(metadata_sizes_as_uint.data()),
+                       metadata_sizes_as_uint.size()),
+      numa_node);
+  return PlasmaSend(store_conn, MessageType::PlasmaCreateBatchRequest, &fbb, message);
+}
+
+Status ReadCreateBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                              NodeID* owner_raylet_id, std::string* owner_ip_address,
+                              int* owner_port, WorkerID* owner_worker_id,
+                              bool* evict_if_full, std::vector<int64_t>* data_sizes,
+                              std::vector<int64_t>* metadata_sizes, int* numa_node) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaCreateBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String& id) { return ObjectID::FromBinary(id.str()); });
+  RAY_CHECK(message->data_sizes()->size() == object_ids->size());
+  RAY_CHECK(message->metadata_sizes()->size() == object_ids->size());
+  data_sizes->clear();
+  metadata_sizes->clear();
+  for (uoffset_t i = 0; i < object_ids->size(); i++) {
+    data_sizes->push_back(message->data_sizes()->Get(i));
+    metadata_sizes->push_back(message->metadata_sizes()->Get(i));
+  }
+  *owner_raylet_id = NodeID::FromBinary(message->owner_raylet_id()->str());
+  *owner_ip_address = message->owner_ip_address()->str();
+  *owner_port = message->owner_port();
+  *owner_worker_id = WorkerID::FromBinary(message->owner_worker_id()->str());
+  *evict_if_full = message->evict_if_full();
+  *numa_node = message->numa_node();
+  return Status::OK();
+}
+
+Status SendCreateBatchReply(const std::shared_ptr<Client> &client,
+                            const std::vector<ObjectID>& object_ids,
+                            const std::vector<PlasmaObject>& objects,
+                            const std::vector<PlasmaError>& errors,
+                            const std::vector<MEMFD_TYPE>& store_fds,
+                            const std::vector<int64_t>& mmap_sizes) {
+  RAY_DCHECK(object_ids.size() == objects.size());
+  RAY_DCHECK(object_ids.size() == errors.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<PlasmaObjectSpec> object_specs;
+  object_specs.reserve(objects.size());
+  for (const auto& object : objects) {
+    object_specs.push_back(PlasmaObjectSpec(FD2INT(object.store_fd), object.data_offset,
+                                            object.data_size, object.metadata_offset,
+                                            object.metadata_size, object.device_num));
+  }
+  std::vector<int> store_fds_as_int;
+  for (MEMFD_TYPE store_fd : store_fds) {
+    store_fds_as_int.push_back(FD2INT(store_fd));
+  }
+  auto message = fb::CreatePlasmaCreateBatchReply(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()),
+      fbb.CreateVectorOfStructs(arrow::util::MakeNonNull(object_specs.data()),
+                                object_specs.size()),
+      fbb.CreateVector(
+          arrow::util::MakeNonNull(reinterpret_cast<const int32_t*>(errors.data())),
+          errors.size()),
+      fbb.CreateVector(arrow::util::MakeNonNull(store_fds_as_int.data()), store_fds_as_int.size()),
+      fbb.CreateVector(arrow::util::MakeNonNull(mmap_sizes.data()), mmap_sizes.size()));
+  return PlasmaSend(client, MessageType::PlasmaCreateBatchReply, &fbb, message);
+}
+
+Status ReadCreateBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                            std::vector<PlasmaObject>* objects,
+                            std::vector<Status>* results,
+                            std::vector<MEMFD_TYPE>* store_fds,
+                            std::vector<int64_t>* mmap_sizes) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaCreateBatchReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String& id) { return ObjectID::FromBinary(id.str()); });
+  ConvertToVector(message->plasma_objects(), objects, [](const PlasmaObjectSpec& spec) {
+    PlasmaObject object = {};
+    object.store_fd = INT2FD(spec.segment_index());
+    object.data_offset = spec.data_offset();
+    object.data_size = spec.data_size();
+    object.metadata_offset = spec.metadata_offset();
+    object.metadata_size = spec.metadata_size();
+    object.device_num = spec.device_num();
+    return object;
+  });
+  results->clear();
+  for (uoffset_t i = 0; i < message->errors()->size(); i++) {
+    results->push_back(
+        PlasmaErrorStatus(static_cast<PlasmaError>(message->errors()->data()[i])));
+  }
+  RAY_CHECK(message->store_fds()->size() == message->mmap_sizes()->size());
+  for (uoffset_t i = 0; i < message->store_fds()->size(); i++) {
+    store_fds->push_back(INT2FD(message->store_fds()->Get(i)));
+    mmap_sizes->push_back(message->mmap_sizes()->Get(i));
+  }
+  return Status::OK();
+}
+
 Status SendAbortRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id) {
   flatbuffers::FlatBufferBuilder fbb;
   auto message = fb::CreatePlasmaAbortRequest(fbb, fbb.CreateString(object_id.Binary()));
@@ -343,6 +462,51 @@ Status ReadSealReply(uint8_t* data, size_t size, ObjectID* object_id) {
   return PlasmaErrorStatus(message->error());
 }
 
+Status SendSealBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            const std::vector<ObjectID>& object_ids) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaSealBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaSealBatchRequest, &fbb, message);
+}
+
+Status ReadSealBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaSealBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String& id) { return ObjectID::FromBinary(id.str()); });
+  return Status::OK();
+}
+
+Status SendSealBatchReply(const std::shared_ptr<Client> &client,
+                          const std::vector<ObjectID>& object_ids,
+                          const std::vector<PlasmaError>& errors) {
+  RAY_DCHECK(object_ids.size() == errors.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaSealBatchReply(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()),
+      fbb.CreateVector(
+          arrow::util::MakeNonNull(reinterpret_cast<const int32_t*>(errors.data())),
+          errors.size()));
+  return PlasmaSend(client, MessageType::PlasmaSealBatchReply, &fbb, message);
+}
+
+Status ReadSealBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                          std::vector<Status>* results) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaSealBatchReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String& id) { return ObjectID::FromBinary(id.str()); });
+  results->clear();
+  for (uoffset_t i = 0; i < message->errors()->size(); i++) {
+    results->push_back(
+        PlasmaErrorStatus(static_cast<PlasmaError>(message->errors()->data()[i])));
+  }
+  return Status::OK();
+}
+
 // Release messages.
 
 Status SendReleaseRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id) {
@@ -375,6 +539,24 @@ Status ReadReleaseReply(uint8_t* data, size_t size, ObjectID* object_id) {
   return PlasmaErrorStatus(message->error());
 }
 
+Status SendReleaseBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                               const std::vector<ObjectID>& object_ids) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaReleaseBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaReleaseBatchRequest, &fbb, message);
+}
+
+Status ReadReleaseBatchRequest(uint8_t* data, size_t size,
+                               std::vector<ObjectID>* object_ids) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaReleaseBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  ConvertToVector(message->object_ids(), object_ids,
+                  [](const flatbuffers::String& id) { return ObjectID::FromBinary(id.str()); });
+  return Status::OK();
+}
+
 // Delete objects messages.
 
 Status SendDeleteRequest(const std::shared_ptr<StoreConn> &store_conn, const std::vector<ObjectID>& object_ids) {
@@ -465,25 +647,36 @@ Status ReadContainsReply(uint8_t* data, size_t size, ObjectID* object_id,
 
 // Connect messages.
 
-Status SendConnectRequest(const std::shared_ptr<StoreConn> &store_conn) {
+Status SendConnectRequest(const std::shared_ptr<StoreConn> &store_conn,
+                          bool use_release_ring) {
   flatbuffers::FlatBufferBuilder fbb;
-  auto message = fb::CreatePlasmaConnectRequest(fbb);
+  auto message = fb::CreatePlasmaConnectRequest(fbb, use_release_ring);
   return PlasmaSend(store_conn, MessageType::PlasmaConnectRequest, &fbb, message);
 }
 
-Status ReadConnectRequest(uint8_t* data) { return Status::OK(); }
+Status ReadConnectRequest(uint8_t* data, size_t size, bool* use_release_ring) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaConnectRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *use_release_ring = message->use_release_ring();
+  return Status::OK();
+}
 
-Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity) {
+Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity,
+                        uint32_t release_ring_capacity) {
   flatbuffers::FlatBufferBuilder fbb;
-  auto message = fb::CreatePlasmaConnectReply(fbb, memory_capacity);
+  auto message =
+      fb::CreatePlasmaConnectReply(fbb, memory_capacity, release_ring_capacity);
   return PlasmaSend(client, MessageType::PlasmaConnectReply, &fbb, message);
 }
 
-Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity) {
+Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity,
+                        uint32_t* release_ring_capacity) {
   RAY_DCHECK(data);
   auto message = flatbuffers::GetRoot<fb::PlasmaConnectReply>(data);
   RAY_DCHECK(VerifyFlatbuffer(message, data, size));
   *memory_capacity = message->memory_capacity();
+  *release_ring_capacity = message->release_ring_capacity();
   return Status::OK();
 }
 
@@ -82,13 +82,14 @@ Status ReadGetDebugStringReply(uint8_t* data, size_t size, std::string* debug_st
 
 Status SendCreateRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id,
                          const ray::rpc::Address &owner_address, bool evict_if_full,
-                         int64_t data_size, int64_t metadata_size, int device_num);
+                         int64_t data_size, int64_t metadata_size, int device_num,
+                         int numa_node);
 
 Status ReadCreateRequest(uint8_t* data, size_t size, ObjectID* object_id,
                          NodeID* owner_raylet_id, std::string* owner_ip_address,
                          int* owner_port, WorkerID* owner_worker_id, bool* evict_if_full,
                          int64_t* data_size, int64_t* metadata_size,
-                         int* device_num);
+                         int* device_num, int* numa_node);
 
 Status SendCreateReply(const std::shared_ptr<Client> &client, ObjectID object_id, PlasmaObject* object,
                        PlasmaError error, int64_t mmap_size);
@@ -96,6 +97,31 @@ Status SendCreateReply(const std::shared_ptr<Client> &client, ObjectID object_id
 Status ReadCreateReply(uint8_t* data, size_t size, ObjectID* object_id,
                        PlasmaObject* object, MEMFD_TYPE* store_fd, int64_t* mmap_size);
 
+Status SendCreateBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                              const std::vector<ObjectID>& object_ids,
+                              const ray::rpc::Address &owner_address, bool evict_if_full,
+                              const std::vector<int64_t>& data_sizes,
+                              const std::vector<int64_t>& metadata_sizes, int numa_node);
+
+Status ReadCreateBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                              NodeID* owner_raylet_id, std::string* owner_ip_address,
+                              int* owner_port, WorkerID* owner_worker_id,
+                              bool* evict_if_full, std::vector<int64_t>* data_sizes,
+                              std::vector<int64_t>* metadata_sizes, int* numa_node);
+
+Status SendCreateBatchReply(const std::shared_ptr<Client> &client,
+                            const std::vector<ObjectID>& object_ids,
+                            const std::vector<PlasmaObject>& objects,
+                            const std::vector<PlasmaError>& errors,
+                            const std::vector<MEMFD_TYPE>& store_fds,
+                            const std::vector<int64_t>& mmap_sizes);
+
+Status ReadCreateBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                            std::vector<PlasmaObject>* objects,
+                            std::vector<Status>* results,
+                            std::vector<MEMFD_TYPE>* store_fds,
+                            std::vector<int64_t>* mmap_sizes);
+
 Status SendAbortRequest(const std::shared_ptr<StoreConn> &store_conn, ObjectID object_id);
 
 Status ReadAbortRequest(uint8_t* data, size_t size, ObjectID* object_id);
@@ -114,6 +140,18 @@ Status SendSealReply(const std::shared_ptr<Client> &client, ObjectID object_id,
 
 Status ReadSealReply(uint8_t* data, size_t size, ObjectID* object_id);
 
+Status SendSealBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            const std::vector<ObjectID>& object_ids);
+
+Status ReadSealBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids);
+
+Status SendSealBatchReply(const std::shared_ptr<Client> &client,
+                          const std::vector<ObjectID>& object_ids,
+                          const std::vector<PlasmaError>& errors);
+
+Status ReadSealBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                          std::vector<Status>* results);
+
 /* Plasma Get message functions. */
 
 Status SendGetRequest(const std::shared_ptr<StoreConn> &store_conn, const ObjectID* object_ids, int64_t num_objects,
@@ -141,6 +179,12 @@ Status SendReleaseReply(const std::shared_ptr<Client> &client, ObjectID object_i
 
 Status ReadReleaseReply(uint8_t* data, size_t size, ObjectID* object_id);
 
+Status SendReleaseBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                               const std::vector<ObjectID>& object_ids);
+
+Status ReadReleaseBatchRequest(uint8_t* data, size_t size,
+                               std::vector<ObjectID>* object_ids);
+
 /* Plasma Delete objects message functions. */
 
 Status SendDeleteRequest(const std::shared_ptr<StoreConn> &store_conn, const std::vector<ObjectID>& object_ids);
@@ -166,13 +210,16 @@ Status ReadContainsReply(uint8_t* data, size_t size, ObjectID* object_id,
 
 /* Plasma Connect message functions. */
 
-Status SendConnectRequest(const std::shared_ptr<StoreConn> &store_conn);
+Status SendConnectRequest(const std::shared_ptr<StoreConn> &store_conn,
+                          bool use_release_ring);
 
-Status ReadConnectRequest(uint8_t* data, size_t size);
+Status ReadConnectRequest(uint8_t* data, size_t size, bool* use_release_ring);
 
-Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity);
+Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity,
+                        uint32_t release_ring_capacity);
 
-Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity);
+Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity,
+                        uint32_t* release_ring_capacity);
 
 /* Plasma Evict message functions (no reply so far). */
 
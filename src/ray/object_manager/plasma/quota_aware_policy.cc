@@ -26,8 +26,9 @@
 
 namespace plasma {
 
-QuotaAwarePolicy::QuotaAwarePolicy(PlasmaStoreInfo* store_info, int64_t max_size)
-    : EvictionPolicy(store_info, max_size) {}
+QuotaAwarePolicy::QuotaAwarePolicy(PlasmaStoreInfo* store_info, int64_t max_size,
+                                   const std::string& cache_type)
+    : EvictionPolicy(store_info, max_size, cache_type) {}
 
 bool QuotaAwarePolicy::HasQuota(Client* client, bool is_create) {
   if (!is_create) {
@@ -39,6 +40,7 @@ bool QuotaAwarePolicy::HasQuota(Client* client, bool is_create) {
 void QuotaAwarePolicy::ObjectCreated(const ObjectID& object_id, Client* client,
                                      bool is_create) {
   if (HasQuota(client, is_create)) {
+    RecordObjectCreated(object_id);
     per_client_cache_[client]->Add(object_id, GetObjectSize(object_id));
     owned_by_client_[object_id] = client;
   } else {
@@ -52,14 +54,14 @@ bool QuotaAwarePolicy::SetClientQuota(Client* client, int64_t output_memory_quot
     return false;
   }
 
-  if (cache_.Capacity() - output_memory_quota <
-      cache_.OriginalCapacity() * kGlobalLruReserveFraction) {
+  if (cache_->Capacity() - output_memory_quota <
+      cache_->OriginalCapacity() * kGlobalLruReserveFraction) {
     RAY_LOG(WARNING) << "Not enough memory to set client quota: " << DebugString();
     return false;
   }
 
   // those objects will be lazily evicted on the next call
-  cache_.AdjustCapacity(-output_memory_quota);
+  cache_->AdjustCapacity(-output_memory_quota);
   per_client_cache_[client] =
       std::unique_ptr<LRUCache>(new LRUCache(client->name, output_memory_quota));
   return true;
@@ -99,6 +101,7 @@ bool QuotaAwarePolicy::EnforcePerClientQuota(Client* client, int64_t size, bool
       owned_by_client_.erase(object_id);
       client_cache->Remove(object_id);
     }
+    RecordObjectsEvicted(*objects_to_evict);
   }
   return true;
 }
@@ -146,13 +149,13 @@ void QuotaAwarePolicy::ClientDisconnected(Client* client) {
     return;
   }
   // return capacity back to global LRU
-  cache_.AdjustCapacity(per_client_cache_[client]->Capacity());
+  cache_->AdjustCapacity(per_client_cache_[client]->Capacity());
   // clean up any entries used to track this client's quota usage
   per_client_cache_[client]->Foreach([this](const ObjectID& obj) {
     if (!shared_for_read_.count(obj)) {
       // only add it to the global LRU if we have it in pinned mode
       // otherwise, EndObjectAccess will add it later
-      cache_.Add(obj, GetObjectSize(obj));
+      cache_->Add(obj, GetObjectSize(obj));
     }
     owned_by_client_.erase(obj);
     shared_for_read_.erase(obj);
@@ -168,7 +171,8 @@ std::string QuotaAwarePolicy::DebugString() const {
   result << "\nallocated bytes: " << PlasmaAllocator::Allocated();
   result << "\nallocation limit: " << PlasmaAllocator::GetFootprintLimit();
   result << "\npinned bytes: " << pinned_memory_bytes_;
-  result << cache_.DebugString();
+  result << StatsDebugString();
+  result << cache_->DebugString();
   for (const auto& pair : per_client_cache_) {
     result << pair.second->DebugString();
   }
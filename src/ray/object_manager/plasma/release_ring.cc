@@ -0,0 +1,147 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/release_ring.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+
+uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+int64_t ReleaseRing::MmapSize(uint32_t capacity) {
+  return sizeof(Header) + static_cast<int64_t>(capacity) * ObjectID::kLength;
+}
+
+ReleaseRing::ReleaseRing(MEMFD_TYPE fd, uint8_t *pointer, uint32_t capacity)
+    : fd_(fd), pointer_(pointer), capacity_(capacity) {
+  RAY_CHECK(header()->head.is_lock_free() && header()->tail.is_lock_free());
+}
+
+std::unique_ptr<ReleaseRing> ReleaseRing::Create(const std::string &directory,
+                                                 uint32_t capacity) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  capacity = RoundUpToPowerOfTwo(capacity);
+  int64_t size = MmapSize(capacity);
+  // Create a temporary file and immediately unlink it so we do not leave traces
+  // in the system, as in create_and_mmap_buffer.
+  std::string file_template = directory + "/plasma_ringXXXXXX";
+  std::vector<char> file_name(file_template.begin(), file_template.end());
+  file_name.push_back('\0');
+  int fd = mkstemp(&file_name[0]);
+  if (fd < 0) {
+    RAY_LOG(ERROR) << "Failed to create release ring file " << &file_name[0] << ": "
+                   << std::strerror(errno);
+    return nullptr;
+  }
+  if (unlink(&file_name[0]) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    RAY_LOG(ERROR) << "Failed to set up release ring file " << &file_name[0] << ": "
+                   << std::strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  void *pointer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (pointer == MAP_FAILED) {
+    RAY_LOG(ERROR) << "Failed to mmap release ring: " << std::strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  // The file is zero-filled, so the ring starts out empty.
+  return std::unique_ptr<ReleaseRing>(
+      new ReleaseRing(fd, static_cast<uint8_t *>(pointer), capacity));
+#endif
+}
+
+std::unique_ptr<ReleaseRing> ReleaseRing::Map(MEMFD_TYPE fd, uint32_t capacity) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  RAY_CHECK(capacity > 0 && (capacity & (capacity - 1)) == 0) << capacity;
+  void *pointer =
+      mmap(NULL, MmapSize(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (pointer == MAP_FAILED) {
+    RAY_LOG(ERROR) << "Failed to mmap release ring: " << std::strerror(errno);
+    return nullptr;
+  }
+  return std::unique_ptr<ReleaseRing>(
+      new ReleaseRing(INVALID_FD, static_cast<uint8_t *>(pointer), capacity));
+#endif
+}
+
+ReleaseRing::~ReleaseRing() {
+#ifndef _WIN32
+  if (munmap(pointer_, MmapSize(capacity_)) != 0) {
+    RAY_LOG(ERROR) << "munmap of release ring failed, errno = " << errno;
+  }
+  if (fd_ != INVALID_FD) {
+    close(fd_);
+  }
+#endif
+}
+
+bool ReleaseRing::Push(const ObjectID &object_id) {
+  uint64_t tail = header()->tail.load(std::memory_order_relaxed);
+  uint64_t head = header()->head.load(std::memory_order_acquire);
+  if (tail - head >= capacity_) {
+    return false;
+  }
+  std::memcpy(Entry(tail), object_id.Data(), ObjectID::kLength);
+  // Publish the entry to the consumer.
+  header()->tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+size_t ReleaseRing::Drain(std::vector<ObjectID> *object_ids) {
+  uint64_t head = header()->head.load(std::memory_order_relaxed);
+  uint64_t tail = header()->tail.load(std::memory_order_acquire);
+  if (tail - head > capacity_) {
+    // The producer is not supposed to be able to do this. Drop the contents of
+    // the ring rather than reading garbage.
+    RAY_LOG(ERROR) << "Release ring is corrupted, head " << head << ", tail " << tail;
+    header()->head.store(tail, std::memory_order_release);
+    return 0;
+  }
+  size_t count = tail - head;
+  for (; head != tail; head++) {
+    object_ids->push_back(ObjectID::FromBinary(
+        std::string(reinterpret_cast<const char *>(Entry(head)), ObjectID::kLength)));
+  }
+  // Hand the entries back to the producer.
+  header()->head.store(tail, std::memory_order_release);
+  return count;
+}
+
+}  // namespace plasma
@@ -0,0 +1,112 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ray/common/id.h"
+#include "ray/object_manager/plasma/compat.h"
+#include "ray/util/macros.h"
+
+namespace plasma {
+
+using ray::ObjectID;
+
+/// A single-producer single-consumer ring of object IDs in shared memory. The
+/// store creates one ring per client at connect time and passes its file
+/// descriptor to the client. The client then posts the IDs of the objects it
+/// releases to the ring instead of sending a release message over the socket,
+/// and the store drains the ring in bulk.
+///
+/// The ring only holds the head and tail counters and the entries. The
+/// capacity is kept in process-local memory on both sides, so that a
+/// misbehaving client cannot make the store read out of bounds.
+///
+/// Push() must only be called by one thread at a time, and so must Drain().
+class ReleaseRing {
+ public:
+  /// Create a new ring backed by an unlinked temporary file. This is called by
+  /// the store.
+  ///
+  /// \param directory The directory to create the backing file in.
+  /// \param capacity The maximum number of entries in the ring. This is rounded
+  ///        up to a power of two.
+  /// \return The ring, or nullptr if the backing memory could not be created.
+  static std::unique_ptr<ReleaseRing> Create(const std::string &directory,
+                                             uint32_t capacity);
+
+  /// Map a ring that was created by the store. This is called by the client.
+  ///
+  /// \param fd The file descriptor received from the store. The ring takes
+  ///        ownership of it.
+  /// \param capacity The capacity of the ring, as reported by the store.
+  /// \return The ring, or nullptr if the memory could not be mapped.
+  static std::unique_ptr<ReleaseRing> Map(MEMFD_TYPE fd, uint32_t capacity);
+
+  /// Size in bytes of the shared memory of a ring with the given capacity.
+  static int64_t MmapSize(uint32_t capacity);
+
+  ~ReleaseRing();
+
+  /// Post an object ID to the ring.
+  ///
+  /// \param object_id The ID of the released object.
+  /// \return True if the ID was posted, false if the ring is full.
+  bool Push(const ObjectID &object_id);
+
+  /// Pop all the object IDs that are currently in the ring.
+  ///
+  /// \param[out] object_ids The popped IDs are appended here, in the order in
+  ///             which they were pushed.
+  /// \return The number of popped IDs.
+  size_t Drain(std::vector<ObjectID> *object_ids);
+
+  /// The file descriptor of the backing memory. Only valid in the store.
+  MEMFD_TYPE fd() const { return fd_; }
+
+  uint32_t capacity() const { return capacity_; }
+
+ private:
+  struct Header {
+    /// Index of the next entry to be popped. Only written by the consumer.
+    alignas(64) std::atomic<uint64_t> head;
+    /// Index of the next entry to be pushed. Only written by the producer.
+    alignas(64) std::atomic<uint64_t> tail;
+  };
+
+  ReleaseRing(MEMFD_TYPE fd, uint8_t *pointer, uint32_t capacity);
+
+  uint8_t *Entry(uint64_t index) {
+    return pointer_ + sizeof(Header) + (index & (capacity_ - 1)) * ObjectID::kLength;
+  }
+
+  Header *header() { return reinterpret_cast<Header *>(pointer_); }
+
+  /// The file descriptor of the backing memory, or INVALID_FD in the client,
+  /// which closes it right after mapping.
+  MEMFD_TYPE fd_;
+  /// The start of the mapped memory.
+  uint8_t *pointer_;
+  /// The maximum number of entries. This is a power of two.
+  const uint32_t capacity_;
+
+  RAY_DISALLOW_COPY_AND_ASSIGN(ReleaseRing);
+};
+
+}  // namespace plasma
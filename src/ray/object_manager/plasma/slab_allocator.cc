@@ -0,0 +1,203 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/slab_allocator.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+
+size_t RoundUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+SlabAllocator::SlabAllocator(size_t alignment, size_t min_block_size,
+                             size_t max_block_size, size_t min_slab_size,
+                             SlabMemalignFn slab_memalign, SlabFreeFn slab_free)
+    : alignment_(alignment),
+      max_block_size_(RoundUp(max_block_size, alignment)),
+      slab_memalign_(std::move(slab_memalign)),
+      slab_free_(std::move(slab_free)),
+      reserved_bytes_(0),
+      requested_bytes_(0) {
+  RAY_CHECK(alignment_ > 0 && (alignment_ & (alignment_ - 1)) == 0);
+  RAY_CHECK(min_block_size > 0 && min_block_size <= max_block_size);
+  // Build the size classes. Between two consecutive powers of two base and
+  // 2 * base there are kClassesPerDoubling evenly spaced classes.
+  size_t base = RoundUp(min_block_size, alignment_);
+  while (size_classes_.empty() || size_classes_.back().block_size < max_block_size_) {
+    for (int i = 0; i < kClassesPerDoubling; i++) {
+      size_t block_size = std::min(
+          RoundUp(base + base * i / kClassesPerDoubling, alignment_), max_block_size_);
+      if (!size_classes_.empty() && size_classes_.back().block_size >= block_size) {
+        continue;
+      }
+      SizeClass size_class;
+      size_class.block_size = block_size;
+      size_class.slab_size =
+          RoundUp(std::max(min_slab_size, block_size * kMinBlocksPerSlab), block_size);
+      size_classes_.push_back(std::move(size_class));
+      if (block_size == max_block_size_) {
+        break;
+      }
+    }
+    base *= 2;
+  }
+}
+
+SlabAllocator::~SlabAllocator() {
+  for (auto &entry : slabs_) {
+    slab_free_(entry.second->base, entry.second->size);
+  }
+}
+
+size_t SlabAllocator::SizeClassFor(size_t bytes) const {
+  auto it = std::lower_bound(
+      size_classes_.begin(), size_classes_.end(), bytes,
+      [](const SizeClass &size_class, size_t b) { return size_class.block_size < b; });
+  RAY_CHECK(it != size_classes_.end());
+  return it - size_classes_.begin();
+}
+
+size_t SlabAllocator::SlabSizeFor(size_t bytes) const {
+  return size_classes_[SizeClassFor(bytes)].slab_size;
+}
+
+SlabAllocator::Slab *SlabAllocator::AllocateSlab(size_t size_class) {
+  auto &cls = size_classes_[size_class];
+  void *mem = slab_memalign_(alignment_, cls.slab_size);
+  if (mem == nullptr) {
+    return nullptr;
+  }
+  std::unique_ptr<Slab> slab(new Slab());
+  slab->base = static_cast<uint8_t *>(mem);
+  slab->size = cls.slab_size;
+  slab->size_class = size_class;
+  slab->num_blocks = static_cast<uint32_t>(cls.slab_size / cls.block_size);
+  // Hand out the blocks in increasing address order.
+  slab->free_blocks.reserve(slab->num_blocks);
+  for (uint32_t i = slab->num_blocks; i > 0; i--) {
+    slab->free_blocks.push_back(i - 1);
+  }
+  Slab *result = slab.get();
+  slabs_.emplace(reinterpret_cast<uintptr_t>(mem), std::move(slab));
+  cls.partial_slabs.insert(result);
+  cls.num_slabs++;
+  reserved_bytes_ += cls.slab_size;
+  RAY_LOG(DEBUG) << "Allocated slab of " << cls.slab_size << " bytes for size class "
+                 << cls.block_size;
+  return result;
+}
+
+void SlabAllocator::FreeSlab(Slab *slab) {
+  auto &cls = size_classes_[slab->size_class];
+  RAY_CHECK(slab->free_blocks.size() == slab->num_blocks);
+  cls.partial_slabs.erase(slab);
+  cls.num_slabs--;
+  reserved_bytes_ -= slab->size;
+  slab_free_(slab->base, slab->size);
+  slabs_.erase(reinterpret_cast<uintptr_t>(slab->base));
+}
+
+void *SlabAllocator::Allocate(size_t bytes) {
+  RAY_CHECK(Handles(bytes)) << bytes;
+  size_t size_class = SizeClassFor(bytes);
+  auto &cls = size_classes_[size_class];
+  Slab *slab = nullptr;
+  if (cls.partial_slabs.empty()) {
+    slab = AllocateSlab(size_class);
+    if (slab == nullptr) {
+      return nullptr;
+    }
+  } else {
+    slab = *cls.partial_slabs.begin();
+  }
+  uint32_t block = slab->free_blocks.back();
+  slab->free_blocks.pop_back();
+  if (slab->free_blocks.empty()) {
+    cls.partial_slabs.erase(slab);
+  }
+  cls.blocks_in_use++;
+  cls.requested_bytes += bytes;
+  cls.num_allocations_total++;
+  requested_bytes_ += bytes;
+  return slab->base + static_cast<size_t>(block) * cls.block_size;
+}
+
+bool SlabAllocator::Free(void *mem, size_t bytes) {
+  auto address = reinterpret_cast<uintptr_t>(mem);
+  // Find the slab with the largest start address that is <= mem.
+  auto it = slabs_.upper_bound(address);
+  if (it == slabs_.begin()) {
+    return false;
+  }
+  --it;
+  Slab *slab = it->second.get();
+  if (address >= it->first + slab->size) {
+    return false;
+  }
+  auto &cls = size_classes_[slab->size_class];
+  size_t offset = address - it->first;
+  RAY_CHECK(offset % cls.block_size == 0)
+      << "Freeing a pointer that is not the start of a block";
+  slab->free_blocks.push_back(static_cast<uint32_t>(offset / cls.block_size));
+  cls.blocks_in_use--;
+  cls.requested_bytes -= bytes;
+  requested_bytes_ -= bytes;
+  cls.partial_slabs.erase(slab);
+  if (slab->free_blocks.size() == slab->num_blocks && !cls.partial_slabs.empty()) {
+    // The slab is empty and there is another slab with free space in this size
+    // class, so give the memory back.
+    FreeSlab(slab);
+  } else {
+    cls.partial_slabs.insert(slab);
+  }
+  return true;
+}
+
+double SlabAllocator::Fragmentation() const {
+  if (reserved_bytes_ == 0) {
+    return 0;
+  }
+  return 1. - static_cast<double>(requested_bytes_) / reserved_bytes_;
+}
+
+std::string SlabAllocator::DebugString() const {
+  std::stringstream result;
+  result << "\n(slab) reserved bytes: " << reserved_bytes_;
+  result << "\n(slab) requested bytes: " << requested_bytes_;
+  result << "\n(slab) fragmentation: " << 100. * Fragmentation() << "%";
+  for (const auto &cls : size_classes_) {
+    if (cls.num_slabs == 0 && cls.num_allocations_total == 0) {
+      continue;
+    }
+    int64_t total_blocks = cls.num_slabs * (cls.slab_size / cls.block_size);
+    result << "\n(slab) size class " << cls.block_size << ": slabs " << cls.num_slabs
+           << ", blocks in use " << cls.blocks_in_use << "/" << total_blocks
+           << ", occupancy "
+           << (total_blocks == 0 ? 0. : 100. * cls.blocks_in_use / total_blocks) << "%"
+           << ", allocations " << cls.num_allocations_total;
+  }
+  return result.str();
+}
+
+}  // namespace plasma
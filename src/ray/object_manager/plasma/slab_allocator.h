@@ -0,0 +1,158 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace plasma {
+
+/// A size-class allocator for small objects. Memory is obtained from a backing
+/// allocator in large slabs, and each slab is carved into fixed-size blocks of
+/// a single size class. Allocating or freeing a small object then only touches
+/// the free list of its size class instead of the global allocator state.
+///
+/// Size classes are spaced geometrically with kClassesPerDoubling classes
+/// between consecutive powers of two, which bounds internal fragmentation.
+/// A slab is returned to the backing allocator as soon as all of its blocks are
+/// free, unless it is the last slab with free space of its size class.
+///
+/// This class is not thread-safe.
+class SlabAllocator {
+ public:
+  /// Allocate a slab of the given size with the given alignment. Returns
+  /// nullptr if the backing allocator is out of memory.
+  using SlabMemalignFn = std::function<void *(size_t alignment, size_t bytes)>;
+  /// Return a slab to the backing allocator.
+  using SlabFreeFn = std::function<void(void *mem, size_t bytes)>;
+
+  /// Number of size classes between two consecutive powers of two.
+  static constexpr int kClassesPerDoubling = 4;
+
+  /// Create a slab allocator.
+  ///
+  /// \param alignment Alignment of every block. Must be a power of two.
+  /// \param min_block_size Size of the smallest size class.
+  /// \param max_block_size Size of the largest size class. Requests larger than
+  ///        this are not served by the slab allocator.
+  /// \param min_slab_size Minimum size of a slab. Slabs of the larger size
+  ///        classes are sized to hold at least kMinBlocksPerSlab blocks.
+  /// \param slab_memalign Function used to allocate slabs.
+  /// \param slab_free Function used to free slabs.
+  SlabAllocator(size_t alignment, size_t min_block_size, size_t max_block_size,
+                size_t min_slab_size, SlabMemalignFn slab_memalign,
+                SlabFreeFn slab_free);
+
+  ~SlabAllocator();
+
+  /// Whether a request of the given size is served by this allocator.
+  bool Handles(size_t bytes) const { return bytes > 0 && bytes <= max_block_size_; }
+
+  /// Allocate a block large enough to hold the given number of bytes.
+  ///
+  /// \param bytes Number of bytes requested. Handles(bytes) must be true.
+  /// \return Pointer to the block, or nullptr if a new slab was needed and the
+  ///         backing allocator could not provide one.
+  void *Allocate(size_t bytes);
+
+  /// Free a block previously returned by Allocate().
+  ///
+  /// \param mem Pointer to the block.
+  /// \param bytes Number of bytes that were requested for this block.
+  /// \return True if the block belonged to this allocator, false otherwise (in
+  ///         which case nothing is done).
+  bool Free(void *mem, size_t bytes);
+
+  /// Size of the slab that would be allocated for a request of the given size.
+  size_t SlabSizeFor(size_t bytes) const;
+
+  /// Total number of bytes held in slabs, whether in use or not.
+  int64_t ReservedBytes() const { return reserved_bytes_; }
+
+  /// Total number of bytes requested by the blocks currently in use.
+  int64_t RequestedBytes() const { return requested_bytes_; }
+
+  /// The fraction of reserved slab memory that is not holding object data, due
+  /// to both free blocks and internal fragmentation of the used blocks.
+  double Fragmentation() const;
+
+  /// Returns debugging information with the per-size-class occupancy.
+  std::string DebugString() const;
+
+ private:
+  struct Slab {
+    /// Start of the slab.
+    uint8_t *base;
+    /// Size of the slab in bytes.
+    size_t size;
+    /// Index of the size class this slab belongs to.
+    size_t size_class;
+    /// Indices of the free blocks in this slab.
+    std::vector<uint32_t> free_blocks;
+    /// Total number of blocks in this slab.
+    uint32_t num_blocks;
+  };
+
+  struct SizeClass {
+    /// Size of each block of this class.
+    size_t block_size;
+    /// Size of each slab of this class.
+    size_t slab_size;
+    /// The slabs of this class that have at least one free block.
+    std::unordered_set<Slab *> partial_slabs;
+    /// Number of slabs of this class.
+    int64_t num_slabs = 0;
+    /// Number of blocks of this class that are in use.
+    int64_t blocks_in_use = 0;
+    /// Number of bytes requested by the blocks of this class that are in use.
+    int64_t requested_bytes = 0;
+    /// Total number of allocations served by this class.
+    int64_t num_allocations_total = 0;
+  };
+
+  /// Minimum number of blocks in each slab.
+  static constexpr size_t kMinBlocksPerSlab = 8;
+
+  /// Return the index of the smallest size class that fits the given size.
+  size_t SizeClassFor(size_t bytes) const;
+
+  /// Allocate a new slab for the given size class and make it available for
+  /// allocation. Returns nullptr if the backing allocator is out of memory.
+  Slab *AllocateSlab(size_t size_class);
+
+  /// Return an empty slab to the backing allocator.
+  void FreeSlab(Slab *slab);
+
+  const size_t alignment_;
+  const size_t max_block_size_;
+  const SlabMemalignFn slab_memalign_;
+  const SlabFreeFn slab_free_;
+  std::vector<SizeClass> size_classes_;
+  /// All slabs, keyed by their start address. Used to map a block back to its
+  /// slab on free.
+  std::map<uintptr_t, std::unique_ptr<Slab>> slabs_;
+  /// Total number of bytes held in slabs.
+  int64_t reserved_bytes_;
+  /// Total number of bytes requested by the blocks in use.
+  int64_t requested_bytes_;
+};
+
+}  // namespace plasma
@@ -44,6 +44,7 @@
 
 #include <boost/bind.hpp>
 
+#include "ray/common/ray_config.h"
 #include "ray/object_manager/format/object_manager_generated.h"
 #include "ray/object_manager/plasma/common.h"
 #include "ray/object_manager/plasma/malloc.h"
@@ -64,7 +65,7 @@ namespace fb = plasma::flatbuf;
 namespace plasma {
 
 struct GetRequest {
-  GetRequest(boost::asio::io_service& io_context, const std::shared_ptr<Client> &client, const std::vector<ObjectID>& object_ids);
+  GetRequest(const std::shared_ptr<Client> &client, const std::vector<ObjectID>& object_ids);
   /// The client that called get.
   std::shared_ptr<Client> client;
   /// The object IDs involved in this request. This is used in the reply.
@@ -77,6 +78,8 @@ struct GetRequest {
   /// The number of object requests in this wait request that are already
   /// satisfied.
   int64_t num_satisfied;
+  /// Whether this request has returned to the client or was removed.
+  bool removed;
 
   void AsyncWait(int64_t timeout_ms,
                  std::function<void(const boost::system::error_code&)> on_timeout) {
@@ -89,16 +92,18 @@ struct GetRequest {
 
  private:
   /// The timer that will time out and cause this wait to return to
-  /// the client if it hasn't already returned.
+  /// the client if it hasn't already returned. It runs on the client's thread, so it
+  /// must only be armed or cancelled from there.
   boost::asio::steady_timer timer_;
 };
 
-GetRequest::GetRequest(boost::asio::io_service& io_context, const std::shared_ptr<Client> &client, const std::vector<ObjectID>& object_ids)
+GetRequest::GetRequest(const std::shared_ptr<Client> &client, const std::vector<ObjectID>& object_ids)
     : client(client),
       object_ids(object_ids.begin(), object_ids.end()),
       objects(object_ids.size()),
       num_satisfied(0),
-      timer_(io_context) {
+      removed(false),
+      timer_(client->GetExecutor()) {
   std::unordered_set<ObjectID> unique_ids(object_ids.begin(), object_ids.end());
   num_objects_to_wait_for = unique_ids.size();
 }
@@ -110,7 +115,9 @@ PlasmaStore::PlasmaStore(boost::asio::io_service &main_service, std::string dire
       socket_name_(socket_name),
       acceptor_(main_service, ParseUrlEndpoint(socket_name)),
       socket_(main_service),
-      eviction_policy_(&store_info_, PlasmaAllocator::GetFootprintLimit()),
+      eviction_policy_(&store_info_, PlasmaAllocator::GetFootprintLimit(),
+                       RayConfig::instance().plasma_eviction_policy()),
+      release_ring_timer_(main_service),
       external_store_(external_store) {
   store_info_.directory = directory;
   store_info_.hugepages_enabled = hugepages_enabled;
@@ -125,12 +132,25 @@ PlasmaStore::PlasmaStore(boost::asio::io_service &main_service, std::string dire
 PlasmaStore::~PlasmaStore() {}
 
 void PlasmaStore::Start() {
+  uint32_t num_threads = RayConfig::instance().plasma_store_num_threads();
+  if (num_threads > 0) {
+    io_service_pool_.reset(new ray::IOServicePool(num_threads));
+    io_service_pool_->Run();
+  }
   // Start listening for clients.
   DoAccept();
+  if (RayConfig::instance().plasma_release_ring_capacity() > 0) {
+    ScheduleReleaseRingDrain();
+  }
 }
 
 void PlasmaStore::Stop() {
   acceptor_.close();
+  release_ring_timer_.cancel();
+  if (io_service_pool_) {
+    io_service_pool_->Stop();
+    io_service_pool_.reset();
+  }
 }
 
 const PlasmaStoreInfo* PlasmaStore::GetPlasmaStoreInfo() { return &store_info_; }
@@ -159,7 +179,7 @@ void PlasmaStore::AddToClientObjectIds(const ObjectID& object_id, ObjectTableEnt
 // Allocate memory
 uint8_t* PlasmaStore::AllocateMemory(size_t size, bool evict_if_full, MEMFD_TYPE* fd,
                                      int64_t* map_size, ptrdiff_t* offset, const std::shared_ptr<Client> &client,
-                                     bool is_create) {
+                                     bool is_create, int numa_node) {
   // First free up space from the client's LRU queue if quota enforcement is on.
   if (evict_if_full) {
     std::vector<ObjectID> client_objects_to_evict;
@@ -181,13 +201,17 @@ uint8_t* PlasmaStore::AllocateMemory(size_t size, bool evict_if_full, MEMFD_TYPE
     // plasma_client.cc). Note that even though this pointer is 64-byte aligned,
     // it is not guaranteed that the corresponding pointer in the client will be
     // 64-byte aligned, but in practice it often will be.
-    pointer = reinterpret_cast<uint8_t*>(PlasmaAllocator::Memalign(kBlockSize, size));
+    pointer = reinterpret_cast<uint8_t*>(
+        PlasmaAllocator::Memalign(kBlockSize, size, numa_node));
     if (pointer || !evict_if_full) {
       // If we manage to allocate the memory, return the pointer. If we cannot
       // allocate the space, but we are also not allowed to evict anything to
       // make more space, return an error to the client.
       break;
     }
+    // Objects that clients have released through their rings may not have
+    // been processed yet. Release them so that they can be evicted.
+    DrainReleaseRings();
     // Tell the eviction policy how much space we need to create this object.
     std::vector<ObjectID> objects_to_evict;
     bool success = eviction_policy_.RequireSpace(size, &objects_to_evict);
@@ -232,7 +256,7 @@ PlasmaError PlasmaStore::CreateObject(const ObjectID& object_id,
                                       int owner_port, const WorkerID& owner_worker_id,
                                       bool evict_if_full, int64_t data_size,
                                       int64_t metadata_size, int device_num,
-                                      const std::shared_ptr<Client> &client,
+                                      int numa_node, const std::shared_ptr<Client> &client,
                                       PlasmaObject* result) {
   RAY_LOG(DEBUG) << "creating object " << object_id.Hex();
 
@@ -251,7 +275,8 @@ PlasmaError PlasmaStore::CreateObject(const ObjectID& object_id,
 
   if (device_num == 0) {
     pointer =
-        AllocateMemory(total_size, evict_if_full, &fd, &map_size, &offset, client, true);
+        AllocateMemory(total_size, evict_if_full, &fd, &map_size, &offset, client, true,
+                       numa_node);
     if (!pointer) {
       RAY_LOG(ERROR) << "Not enough memory to create the object " << object_id.Hex()
                        << ", data_size=" << data_size
@@ -329,7 +354,7 @@ void PlasmaObject_init(PlasmaObject* object, ObjectTableEntry* entry) {
   object->device_num = entry->device_num;
 }
 
-void PlasmaStore::RemoveGetRequest(GetRequest* get_request) {
+void PlasmaStore::RemoveGetRequest(const std::shared_ptr<GetRequest>& get_request) {
   // Remove the get request from each of the relevant object_get_requests hash
   // tables if it is present there. It should only be present there if the get
   // request timed out or if it was issued by a client that has disconnected.
@@ -348,15 +373,17 @@ void PlasmaStore::RemoveGetRequest(GetRequest* get_request) {
       }
     }
   }
-  // Remove the get request.
-  get_request->CancelTimer();
-  delete get_request;
+  // Remove the get request. The request may be removed from another client's thread,
+  // so the timer is cancelled on its own client's thread; if it fires first, its
+  // handler sees that the request was removed.
+  get_request->removed = true;
+  get_request->client->Post([get_request]() { get_request->CancelTimer(); });
 }
 
 void PlasmaStore::RemoveGetRequestsForClient(const std::shared_ptr<Client> &client) {
-  std::unordered_set<GetRequest*> get_requests_to_remove;
+  std::unordered_set<std::shared_ptr<GetRequest>> get_requests_to_remove;
   for (auto const& pair : object_get_requests_) {
-    for (GetRequest* get_request : pair.second) {
+    for (const auto& get_request : pair.second) {
       if (get_request->client == client) {
         get_requests_to_remove.insert(get_request);
       }
@@ -366,12 +393,12 @@ void PlasmaStore::RemoveGetRequestsForClient(const std::shared_ptr<Client> &clie
   // It shouldn't be possible for a given client to be in the middle of multiple get
   // requests.
   RAY_CHECK(get_requests_to_remove.size() <= 1);
-  for (GetRequest* get_request : get_requests_to_remove) {
+  for (const auto& get_request : get_requests_to_remove) {
     RemoveGetRequest(get_request);
   }
 }
 
-void PlasmaStore::ReturnFromGet(GetRequest* get_req) {
+void PlasmaStore::ReturnFromGet(const std::shared_ptr<GetRequest>& get_req) {
   // Figure out how many file descriptors we need to send.
   std::unordered_set<MEMFD_TYPE> fds_to_send;
   std::vector<MEMFD_TYPE> store_fds;
@@ -385,22 +412,26 @@ void PlasmaStore::ReturnFromGet(GetRequest* get_req) {
       mmap_sizes.push_back(GetMmapSize(fd));
     }
   }
-  // Send the get reply to the client.
-  Status s = SendGetReply(get_req->client, &get_req->object_ids[0], get_req->objects,
-                          get_req->object_ids.size(), store_fds, mmap_sizes);
-  // If we successfully sent the get reply message to the client, then also send
-  // the file descriptors.
-  if (s.ok()) {
-    // Send all of the file descriptors for the present objects.
-    for (MEMFD_TYPE store_fd : store_fds) {
-      Status send_fd_status = get_req->client->SendFd(store_fd);
-      if (!send_fd_status.ok()) {
-        RAY_LOG(ERROR) << "Failed to send mmap results to client on fd " << get_req->client;
+  // Send the get reply to the client. The request is not modified after it is
+  // removed below, so it can be read without holding the lock.
+  SendToClient(get_req->client, [get_req, store_fds, mmap_sizes]() {
+    Status s = SendGetReply(get_req->client, &get_req->object_ids[0], get_req->objects,
+                            get_req->object_ids.size(), store_fds, mmap_sizes);
+    // If we successfully sent the get reply message to the client, then also send
+    // the file descriptors.
+    if (s.ok()) {
+      // Send all of the file descriptors for the present objects.
+      for (MEMFD_TYPE store_fd : store_fds) {
+        Status send_fd_status = get_req->client->SendFd(store_fd);
+        if (!send_fd_status.ok()) {
+          RAY_LOG(ERROR) << "Failed to send mmap results to client on fd "
+                         << get_req->client;
+        }
       }
+    } else {
+      RAY_LOG(ERROR) << "Failed to send Get reply to client on fd " << get_req->client;
     }
-  } else {
-    RAY_LOG(ERROR) << "Failed to send Get reply to client on fd " << get_req->client;
-  }
+  });
 
   // Remove the get request from each of the relevant object_get_requests hash
   // tables if it is present there. It should only be present there if the get
@@ -456,13 +487,15 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
                                     const std::vector<ObjectID>& object_ids,
                                     int64_t timeout_ms) {
   // Create a get request for this object.
-  auto get_req = new GetRequest(io_context_, client, object_ids);
+  auto get_req = std::make_shared<GetRequest>(client, object_ids);
   std::vector<ObjectID> evicted_ids;
   std::vector<ObjectTableEntry*> evicted_entries;
   for (auto object_id : object_ids) {
     // Check if this object is already present locally. If so, record that the
     // object is being used and mark it as accounted for.
     auto entry = GetObjectTableEntry(&store_info_, object_id);
+    eviction_policy_.ObjectRequested(
+        object_id, entry && entry->state == ObjectState::PLASMA_SEALED);
     if (entry && entry->state == ObjectState::PLASMA_SEALED) {
       // Update the get request to take into account the present object.
       PlasmaObject_init(&get_req->objects[object_id], entry);
@@ -476,7 +509,8 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
 
       entry->pointer =
           AllocateMemory(entry->data_size + entry->metadata_size, /*evict=*/true,
-                         &entry->fd, &entry->map_size, &entry->offset, client, false);
+                         &entry->fd, &entry->map_size, &entry->offset, client, false,
+                         /*numa_node=*/-1);
       if (entry->pointer) {
         entry->state = ObjectState::PLASMA_CREATED;
         entry->create_time = std::time(nullptr);
@@ -504,8 +538,9 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
     std::vector<std::shared_ptr<Buffer>> buffers;
     for (size_t i = 0; i < evicted_ids.size(); ++i) {
       RAY_CHECK(evicted_entries[i]->pointer != nullptr);
-      buffers.emplace_back(new arrow::MutableBuffer(evicted_entries[i]->pointer,
-                                                    evicted_entries[i]->data_size));
+      buffers.emplace_back(new arrow::MutableBuffer(
+          evicted_entries[i]->pointer,
+          evicted_entries[i]->data_size + evicted_entries[i]->metadata_size));
     }
     if (external_store_->Get(evicted_ids, buffers).ok()) {
       for (size_t i = 0; i < evicted_ids.size(); ++i) {
@@ -534,8 +569,13 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
     // that a timeout of -1 is used to indicate that no timer should be set.
     get_req->AsyncWait(timeout_ms, [this, get_req](const boost::system::error_code& ec) {
       if (ec != boost::asio::error::operation_aborted) {
-        // Timer was not cancelled, take necessary action.
-        ReturnFromGet(get_req);
+        absl::MutexLock lock(&mutex_);
+        // Timer was not cancelled, take necessary action. In the multi-threaded
+        // mode, the request may have returned on another thread after the
+        // timer fired.
+        if (!get_req->removed) {
+          ReturnFromGet(get_req);
+        }
       }
     });
   }
@@ -786,6 +826,47 @@ void PlasmaStore::DisconnectClient(const std::shared_ptr<Client> &client) {
     // Remove notification for this client from global map.
     notification_clients_.erase(client);
   }
+
+  release_ring_clients_.erase(client);
+  client->release_ring.reset();
+}
+
+void PlasmaStore::SendToClient(const std::shared_ptr<Client> &client,
+                               std::function<void()> send) {
+  // Even in the single-threaded mode, this is posted rather than run inline, since
+  // callers hold mutex_ and the write may block.
+  client->Post(std::move(send));
+}
+
+void PlasmaStore::DrainReleaseRing(const std::shared_ptr<Client> &client) {
+  std::vector<ObjectID> object_ids;
+  if (client->release_ring->Drain(&object_ids) == 0) {
+    return;
+  }
+  for (const auto& object_id : object_ids) {
+    ReleaseObject(object_id, client);
+  }
+}
+
+void PlasmaStore::DrainReleaseRings() {
+  for (const auto& client : release_ring_clients_) {
+    DrainReleaseRing(client);
+  }
+}
+
+void PlasmaStore::ScheduleReleaseRingDrain() {
+  release_ring_timer_.expires_from_now(std::chrono::milliseconds(
+      RayConfig::instance().plasma_release_ring_drain_interval_ms()));
+  release_ring_timer_.async_wait([this](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      return;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      DrainReleaseRings();
+    }
+    ScheduleReleaseRingDrain();
+  });
 }
 
 /// Send notifications about sealed objects to the subscribers. This is called
@@ -816,16 +897,19 @@ void PlasmaStore::SendNotifications(
     boost::asio::const_buffer(size, sizeof(*size)),
     boost::asio::const_buffer(data, fbb.GetSize()),
   };
-  client->WriteBufferAsync(buffers, [this, client, size, data](const Status& s) {
-    if (!s.ok()) {
-      RAY_LOG(WARNING) << "Failed to send notification to client on fd " << client;
-      if (s.IsIOError()) {
-        client->Close();
-        notification_clients_.erase(client);
+  SendToClient(client, [this, client, size, data, buffers]() {
+    client->WriteBufferAsync(buffers, [this, client, size, data](const Status& s) {
+      if (!s.ok()) {
+        RAY_LOG(WARNING) << "Failed to send notification to client on fd " << client;
+        if (s.IsIOError()) {
+          client->Close();
+          absl::MutexLock lock(&mutex_);
+          notification_clients_.erase(client);
+        }
       }
-    }
-    delete size;
-    delete[] data;
+      delete size;
+      delete[] data;
+    });
   });
 }
 
@@ -881,7 +965,15 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
   ObjectID object_id;
   PlasmaObject object = {};
 
-  // Process the different types of requests.
+  // Process the releases the client posted before this message, so that they
+  // are ordered before it.
+  if (client->release_ring) {
+    absl::MutexLock lock(&mutex_);
+    DrainReleaseRing(client);
+  }
+
+  // Process the different types of requests. The store state is only accessed
+  // while holding mutex_, and replies are sent after releasing it.
   switch (type) {
     case fb::MessageType::PlasmaCreateRequest: {
       NodeID owner_raylet_id;
@@ -892,52 +984,121 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
       int64_t data_size;
       int64_t metadata_size;
       int device_num;
+      int numa_node;
       RAY_RETURN_NOT_OK(ReadCreateRequest(
         input, input_size, &object_id, &owner_raylet_id, &owner_ip_address, &owner_port,
-        &owner_worker_id, &evict_if_full, &data_size, &metadata_size, &device_num));
-      PlasmaError error_code = CreateObject(object_id, owner_raylet_id, owner_ip_address,
-                                            owner_port, owner_worker_id, evict_if_full,
-                                            data_size, metadata_size, device_num, client,
-                                            &object);
+        &owner_worker_id, &evict_if_full, &data_size, &metadata_size, &device_num,
+        &numa_node));
+      PlasmaError error_code;
       int64_t mmap_size = 0;
-      if (error_code == PlasmaError::OK && device_num == 0) {
-        mmap_size = GetMmapSize(object.store_fd);
+      {
+        absl::MutexLock lock(&mutex_);
+        error_code = CreateObject(object_id, owner_raylet_id, owner_ip_address,
+                                  owner_port, owner_worker_id, evict_if_full, data_size,
+                                  metadata_size, device_num, numa_node, client, &object);
+        if (error_code == PlasmaError::OK && device_num == 0) {
+          mmap_size = GetMmapSize(object.store_fd);
+        }
       }
       RAY_RETURN_NOT_OK(SendCreateReply(client, object_id, &object, error_code, mmap_size));
       if (error_code == PlasmaError::OK && device_num == 0) {
         RAY_RETURN_NOT_OK(client->SendFd(object.store_fd));
       }
     } break;
+    case fb::MessageType::PlasmaCreateBatchRequest: {
+      std::vector<ObjectID> object_ids;
+      NodeID owner_raylet_id;
+      std::string owner_ip_address;
+      int owner_port;
+      WorkerID owner_worker_id;
+      bool evict_if_full;
+      std::vector<int64_t> data_sizes;
+      std::vector<int64_t> metadata_sizes;
+      int numa_node;
+      RAY_RETURN_NOT_OK(ReadCreateBatchRequest(
+          input, input_size, &object_ids, &owner_raylet_id, &owner_ip_address,
+          &owner_port, &owner_worker_id, &evict_if_full, &data_sizes, &metadata_sizes,
+          &numa_node));
+      std::vector<PlasmaObject> objects(object_ids.size());
+      std::vector<PlasmaError> error_codes;
+      error_codes.reserve(object_ids.size());
+      // Figure out which file descriptors we need to send, as in ReturnFromGet.
+      std::unordered_set<MEMFD_TYPE> fds_to_send;
+      std::vector<MEMFD_TYPE> store_fds;
+      std::vector<int64_t> mmap_sizes;
+      {
+        absl::MutexLock lock(&mutex_);
+        for (size_t i = 0; i < object_ids.size(); i++) {
+          PlasmaError error_code = CreateObject(
+              object_ids[i], owner_raylet_id, owner_ip_address, owner_port,
+              owner_worker_id, evict_if_full, data_sizes[i], metadata_sizes[i],
+              /*device_num=*/0, numa_node, client, &objects[i]);
+          error_codes.push_back(error_code);
+          MEMFD_TYPE fd = objects[i].store_fd;
+          if (error_code == PlasmaError::OK && fds_to_send.count(fd) == 0) {
+            fds_to_send.insert(fd);
+            store_fds.push_back(fd);
+            mmap_sizes.push_back(GetMmapSize(fd));
+          }
+        }
+      }
+      RAY_RETURN_NOT_OK(SendCreateBatchReply(client, object_ids, objects, error_codes,
+                                             store_fds, mmap_sizes));
+      for (MEMFD_TYPE store_fd : store_fds) {
+        RAY_RETURN_NOT_OK(client->SendFd(store_fd));
+      }
+    } break;
     case fb::MessageType::PlasmaAbortRequest: {
       RAY_RETURN_NOT_OK(ReadAbortRequest(input, input_size, &object_id));
-      RAY_CHECK(AbortObject(object_id, client) == 1) << "To abort an object, the only "
-                                                          "client currently using it "
-                                                          "must be the creator.";
+      {
+        absl::MutexLock lock(&mutex_);
+        RAY_CHECK(AbortObject(object_id, client) == 1) << "To abort an object, the only "
+                                                            "client currently using it "
+                                                            "must be the creator.";
+      }
       RAY_RETURN_NOT_OK(SendAbortReply(client, object_id));
     } break;
     case fb::MessageType::PlasmaGetRequest: {
       std::vector<ObjectID> object_ids_to_get;
       int64_t timeout_ms;
       RAY_RETURN_NOT_OK(ReadGetRequest(input, input_size, object_ids_to_get, &timeout_ms));
+      absl::MutexLock lock(&mutex_);
       ProcessGetRequest(client, object_ids_to_get, timeout_ms);
     } break;
     case fb::MessageType::PlasmaReleaseRequest: {
       RAY_RETURN_NOT_OK(ReadReleaseRequest(input, input_size, &object_id));
+      absl::MutexLock lock(&mutex_);
       ReleaseObject(object_id, client);
     } break;
+    case fb::MessageType::PlasmaReleaseBatchRequest: {
+      std::vector<ObjectID> object_ids;
+      RAY_RETURN_NOT_OK(ReadReleaseBatchRequest(input, input_size, &object_ids));
+      absl::MutexLock lock(&mutex_);
+      for (const auto& object_id : object_ids) {
+        ReleaseObject(object_id, client);
+      }
+    } break;
     case fb::MessageType::PlasmaDeleteRequest: {
       std::vector<ObjectID> object_ids;
       std::vector<PlasmaError> error_codes;
       RAY_RETURN_NOT_OK(ReadDeleteRequest(input, input_size, &object_ids));
       error_codes.reserve(object_ids.size());
-      for (auto& object_id : object_ids) {
-        error_codes.push_back(DeleteObject(object_id));
+      {
+        absl::MutexLock lock(&mutex_);
+        for (auto& object_id : object_ids) {
+          error_codes.push_back(DeleteObject(object_id));
+        }
       }
       RAY_RETURN_NOT_OK(SendDeleteReply(client, object_ids, error_codes));
     } break;
     case fb::MessageType::PlasmaContainsRequest: {
       RAY_RETURN_NOT_OK(ReadContainsRequest(input, input_size, &object_id));
-      if (ContainsObject(object_id) == ObjectStatus::OBJECT_FOUND) {
+      ObjectStatus status;
+      {
+        absl::MutexLock lock(&mutex_);
+        status = ContainsObject(object_id);
+      }
+      if (status == ObjectStatus::OBJECT_FOUND) {
         RAY_RETURN_NOT_OK(SendContainsReply(client, object_id, 1));
       } else {
         RAY_RETURN_NOT_OK(SendContainsReply(client, object_id, 0));
@@ -945,48 +1106,98 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
     } break;
     case fb::MessageType::PlasmaSealRequest: {
       RAY_RETURN_NOT_OK(ReadSealRequest(input, input_size, &object_id));
-      SealObjects({object_id});
+      {
+        absl::MutexLock lock(&mutex_);
+        SealObjects({object_id});
+      }
       RAY_RETURN_NOT_OK(SendSealReply(client, object_id, PlasmaError::OK));
     } break;
+    case fb::MessageType::PlasmaSealBatchRequest: {
+      std::vector<ObjectID> object_ids;
+      RAY_RETURN_NOT_OK(ReadSealBatchRequest(input, input_size, &object_ids));
+      {
+        absl::MutexLock lock(&mutex_);
+        SealObjects(object_ids);
+      }
+      RAY_RETURN_NOT_OK(SendSealBatchReply(
+          client, object_ids, std::vector<PlasmaError>(object_ids.size(), PlasmaError::OK)));
+    } break;
     case fb::MessageType::PlasmaEvictRequest: {
       // This code path should only be used for testing.
       int64_t num_bytes;
       RAY_RETURN_NOT_OK(ReadEvictRequest(input, input_size, &num_bytes));
       std::vector<ObjectID> objects_to_evict;
-      int64_t num_bytes_evicted =
-          eviction_policy_.ChooseObjectsToEvict(num_bytes, &objects_to_evict);
-      EvictObjects(objects_to_evict);
+      int64_t num_bytes_evicted;
+      {
+        absl::MutexLock lock(&mutex_);
+        num_bytes_evicted =
+            eviction_policy_.ChooseObjectsToEvict(num_bytes, &objects_to_evict);
+        EvictObjects(objects_to_evict);
+      }
       RAY_RETURN_NOT_OK(SendEvictReply(client, num_bytes_evicted));
     } break;
     case fb::MessageType::PlasmaRefreshLRURequest: {
       std::vector<ObjectID> object_ids;
       RAY_RETURN_NOT_OK(ReadRefreshLRURequest(input, input_size, &object_ids));
-      eviction_policy_.RefreshObjects(object_ids);
+      {
+        absl::MutexLock lock(&mutex_);
+        eviction_policy_.RefreshObjects(object_ids);
+      }
       RAY_RETURN_NOT_OK(SendRefreshLRUReply(client));
     } break;
-    case fb::MessageType::PlasmaSubscribeRequest:
+    case fb::MessageType::PlasmaSubscribeRequest: {
+      absl::MutexLock lock(&mutex_);
       SubscribeToUpdates(client);
-      break;
+    } break;
     case fb::MessageType::PlasmaConnectRequest: {
-      RAY_RETURN_NOT_OK(SendConnectReply(client, PlasmaAllocator::GetFootprintLimit()));
+      bool use_release_ring;
+      RAY_RETURN_NOT_OK(ReadConnectRequest(input, input_size, &use_release_ring));
+      uint32_t capacity = RayConfig::instance().plasma_release_ring_capacity();
+      // The ring is backed by a regular file, which cannot be created on a
+      // hugetlbfs mount.
+      if (use_release_ring && capacity > 0 && !store_info_.hugepages_enabled &&
+          !client->release_ring) {
+        client->release_ring = ReleaseRing::Create(store_info_.directory, capacity);
+      }
+      RAY_RETURN_NOT_OK(SendConnectReply(
+          client, PlasmaAllocator::GetFootprintLimit(),
+          client->release_ring ? client->release_ring->capacity() : 0));
+      if (client->release_ring) {
+        RAY_RETURN_NOT_OK(client->SendFd(client->release_ring->fd()));
+        absl::MutexLock lock(&mutex_);
+        release_ring_clients_.insert(client);
+      }
     } break;
-    case fb::MessageType::PlasmaDisconnectClient:
+    case fb::MessageType::PlasmaDisconnectClient: {
       RAY_LOG(DEBUG) << "Disconnecting client on fd " << client;
+      absl::MutexLock lock(&mutex_);
       DisconnectClient(client);
       return Status::Disconnected("The Plasma Store client is disconnected.");
-      break;
+    } break;
     case fb::MessageType::PlasmaSetOptionsRequest: {
       std::string client_name;
       int64_t output_memory_quota;
       RAY_RETURN_NOT_OK(
           ReadSetOptionsRequest(input, input_size, &client_name, &output_memory_quota));
-      client->name = client_name;
-      bool success = eviction_policy_.SetClientQuota(client.get(), output_memory_quota);
+      bool success;
+      {
+        absl::MutexLock lock(&mutex_);
+        client->name = client_name;
+        success = eviction_policy_.SetClientQuota(client.get(), output_memory_quota);
+      }
       RAY_RETURN_NOT_OK(SendSetOptionsReply(client, success ? PlasmaError::OK
                                                             : PlasmaError::OutOfMemory));
     } break;
     case fb::MessageType::PlasmaGetDebugStringRequest: {
-      RAY_RETURN_NOT_OK(SendGetDebugStringReply(client, eviction_policy_.DebugString()));
+      std::string debug_string;
+      {
+        absl::MutexLock lock(&mutex_);
+        debug_string = eviction_policy_.DebugString() + PlasmaAllocator::DebugString();
+        if (external_store_) {
+          debug_string += external_store_->DebugString();
+        }
+      }
+      RAY_RETURN_NOT_OK(SendGetDebugStringReply(client, debug_string));
     } break;
     default:
       // This code should be unreachable.
@@ -996,6 +1207,10 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
 }
 
 void PlasmaStore::DoAccept() {
+  if (io_service_pool_) {
+    // Accept the next client on one of the connection threads.
+    socket_ = ray::local_stream_socket(*io_service_pool_->Get());
+  }
   acceptor_.async_accept(socket_, boost::bind(&PlasmaStore::ConnectClient, this,
                                               boost::asio::placeholders::error));
 }
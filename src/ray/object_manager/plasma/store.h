@@ -24,6 +24,9 @@
 #include <unordered_set>
 #include <vector>
 
+#include <boost/asio/steady_timer.hpp>
+
+#include "absl/synchronization/mutex.h"
 #include "ray/common/status.h"
 #include "ray/object_manager/format/object_manager_generated.h"
 #include "ray/object_manager/notification/object_store_notification_manager.h"
@@ -33,6 +36,7 @@
 #include "ray/object_manager/plasma/plasma.h"
 #include "ray/object_manager/plasma/protocol.h"
 #include "ray/object_manager/plasma/quota_aware_policy.h"
+#include "ray/util/io_service_pool.h"
 
 namespace plasma {
 
@@ -84,6 +88,8 @@ class PlasmaStore {
   ///        device_num = 0 corresponds to the host,
   ///        device_num = 1 corresponds to GPU0,
   ///        device_num = 2 corresponds to GPU1, etc.
+  /// \param numa_node The NUMA node of the creating client, or -1 if it is
+  ///        not known.
   /// \param client The client that created the object.
   /// \param result The object that has been created.
   /// \return One of the following error codes:
@@ -98,7 +104,8 @@ class PlasmaStore {
                            const std::string& owner_ip_address, int owner_port,
                            const WorkerID& owner_worker_id, bool evict_if_full,
                            int64_t data_size, int64_t metadata_size, int device_num,
-                           const std::shared_ptr<Client> &client, PlasmaObject* result);
+                           int numa_node, const std::shared_ptr<Client> &client,
+                           PlasmaObject* result);
 
   /// Abort a created but unsealed object. If the client is not the
   /// creator, then the abort will fail.
@@ -179,6 +186,7 @@ class PlasmaStore {
 
   void SetNotificationListener(
       const std::shared_ptr<ray::ObjectStoreNotificationManager> &notification_listener) {
+    absl::MutexLock lock(&mutex_);
     notification_listener_ = notification_listener;
     if (notification_listener_) {
       // Push notifications to the new subscriber about existing sealed objects.
@@ -205,14 +213,14 @@ class PlasmaStore {
   /// Remove a GetRequest and clean up the relevant data structures.
   ///
   /// \param get_request The GetRequest to remove.
-  void RemoveGetRequest(GetRequest* get_request);
+  void RemoveGetRequest(const std::shared_ptr<GetRequest>& get_request);
 
   /// Remove all of the GetRequests for a given client.
   ///
   /// \param client The client whose GetRequests should be removed.
   void RemoveGetRequestsForClient(const std::shared_ptr<Client> &client);
 
-  void ReturnFromGet(GetRequest* get_req);
+  void ReturnFromGet(const std::shared_ptr<GetRequest>& get_req);
 
   void UpdateObjectGetRequests(const ObjectID& object_id);
 
@@ -221,8 +229,21 @@ class PlasmaStore {
 
   void EraseFromObjectTable(const ObjectID& object_id);
 
+  /// Release all the objects that a client has posted to its release ring.
+  ///
+  /// \param client The client whose ring should be drained.
+  void DrainReleaseRing(const std::shared_ptr<Client> &client);
+
+  /// Drain the release rings of all clients.
+  void DrainReleaseRings();
+
+  /// Drain the release rings of all clients periodically, so that released
+  /// objects become evictable even if their clients go quiet.
+  void ScheduleReleaseRingDrain();
+
   uint8_t* AllocateMemory(size_t size, bool evict_if_full, MEMFD_TYPE* fd, int64_t* map_size,
-                          ptrdiff_t* offset, const std::shared_ptr<Client> &client, bool is_create);
+                          ptrdiff_t* offset, const std::shared_ptr<Client> &client, bool is_create,
+                          int numa_node);
 #ifdef PLASMA_CUDA
   Status AllocateCudaMemory(int device_num, int64_t size, uint8_t** out_pointer,
                             std::shared_ptr<CudaIpcMemHandle>* out_ipc_handle);
@@ -233,6 +254,16 @@ class PlasmaStore {
   // Start listening for clients.
   void DoAccept();
 
+  /// Write messages to a client. This is posted to the thread of the client's
+  /// connection, so that messages sent to a client from other threads, such as the
+  /// reply to a get request that is satisfied by another client's seal, are not
+  /// interleaved with its own replies, and so that they are not written while
+  /// holding mutex_.
+  ///
+  /// \param client The client to write to.
+  /// \param send The function that writes the messages.
+  void SendToClient(const std::shared_ptr<Client> &client, std::function<void()> send);
+
   // A reference to the asio io context.
   boost::asio::io_service& io_context_;
   /// The name of the socket this object store listens on.
@@ -241,6 +272,13 @@ class PlasmaStore {
   boost::asio::basic_socket_acceptor<ray::local_stream_protocol> acceptor_;
   /// The socket to listen on for new clients.
   ray::local_stream_socket socket_;
+  /// The threads that handle client connections in the multi-threaded mode,
+  /// or nullptr if everything runs on io_context_.
+  std::unique_ptr<ray::IOServicePool> io_service_pool_;
+  /// Protects all of the state below, as well as the objects used by each
+  /// client. The socket I/O, decoding of requests and encoding of replies
+  /// happen outside of it.
+  absl::Mutex mutex_;
 
   /// The plasma store information, including the object tables, that is exposed
   /// to the eviction policy.
@@ -249,12 +287,18 @@ class PlasmaStore {
   QuotaAwarePolicy eviction_policy_;
   /// A hash table mapping object IDs to a vector of the get requests that are
   /// waiting for the object to arrive.
-  std::unordered_map<ObjectID, std::vector<GetRequest*>> object_get_requests_;
+  std::unordered_map<ObjectID, std::vector<std::shared_ptr<GetRequest>>>
+      object_get_requests_;
   /// The registered client for receiving notifications.
   std::unordered_set<std::shared_ptr<Client>> notification_clients_;
 
   std::unordered_set<ObjectID> deletion_cache_;
 
+  /// The clients that release objects through a release ring.
+  std::unordered_set<std::shared_ptr<Client>> release_ring_clients_;
+  /// Timer for draining the release rings.
+  boost::asio::steady_timer release_ring_timer_;
+
   /// Manages worker threads for handling asynchronous/multi-threaded requests
   /// for reading/writing data to/from external store.
   std::shared_ptr<ExternalStore> external_store_;
@@ -7,6 +7,10 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
+
+#include "ray/common/ray_config.h"
+#include "ray/object_manager/plasma/numa.h"
 #include "ray/object_manager/plasma/plasma_allocator.h"
 
 namespace plasma {
@@ -30,6 +34,11 @@ PlasmaStoreRunner::PlasmaStoreRunner(std::string socket_name, int64_t system_mem
   RAY_LOG(INFO) << "Allowing the Plasma store to use up to "
                   << static_cast<double>(system_memory) / 1000000000
                   << "GB of memory.";
+  if (RayConfig::instance().plasma_slab_allocator_enabled()) {
+    PlasmaAllocator::EnableSlabAllocator(
+        kBlockSize, RayConfig::instance().plasma_slab_max_object_size(),
+        RayConfig::instance().plasma_slab_min_slab_size());
+  }
   if (hugepages_enabled && plasma_directory.empty()) {
     RAY_LOG(FATAL) << "if you want to use hugepages, please specify path to huge pages "
                         "filesystem with -d";
@@ -97,17 +106,30 @@ void PlasmaStoreRunner::Start() {
                                 socket_name_, external_store));
     plasma_config = store_->GetPlasmaStoreInfo();
 
+    if (RayConfig::instance().plasma_numa_arenas_enabled()) {
+      int num_nodes = NumNumaNodes();
+      if (num_nodes > 1) {
+        PlasmaAllocator::EnableNumaArenas(num_nodes);
+      } else {
+        RAY_LOG(INFO) << "Not using NUMA arenas because this host has a single "
+                         "NUMA node.";
+      }
+    }
+
     // We are using a single memory-mapped file by mallocing and freeing a single
     // large amount of space up front. According to the documentation,
     // dlmalloc might need up to 128*sizeof(size_t) bytes for internal
-    // bookkeeping.
-    void* pointer = PlasmaAllocator::Memalign(
-        kBlockSize, PlasmaAllocator::GetFootprintLimit() - 256 * sizeof(size_t));
-    RAY_CHECK(pointer != nullptr);
-    // This will unmap the file, but the next one created will be as large
-    // as this one (this is an implementation detail of dlmalloc).
-    PlasmaAllocator::Free(
-        pointer, PlasmaAllocator::GetFootprintLimit() - 256 * sizeof(size_t));
+    // bookkeeping. With NUMA arenas, each arena gets its own file.
+    int num_arenas = std::max(PlasmaAllocator::NumNumaArenas(), 1);
+    int64_t arena_size = PlasmaAllocator::GetFootprintLimit() / num_arenas;
+    for (int node = 0; node < num_arenas; node++) {
+      void* pointer =
+          PlasmaAllocator::Memalign(kBlockSize, arena_size - 256 * sizeof(size_t), node);
+      RAY_CHECK(pointer != nullptr);
+      // This will unmap the file, but the next one created will be as large
+      // as this one (this is an implementation detail of dlmalloc).
+      PlasmaAllocator::Free(pointer, arena_size - 256 * sizeof(size_t));
+    }
 
     store_->Start();
   }
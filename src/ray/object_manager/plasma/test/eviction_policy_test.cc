@@ -0,0 +1,142 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/eviction_policy.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+/// Simulate a client getting an object: the object leaves the cache while it is
+/// in use and is added back when it is released.
+void UseObject(ObjectCache *cache, const ObjectID &object_id) {
+  int64_t size = cache->Remove(object_id);
+  ASSERT_NE(size, -1);
+  cache->Add(object_id, size);
+}
+
+/// Evict objects the way EvictionPolicy does and return them.
+std::vector<ObjectID> Evict(ObjectCache *cache, int64_t num_bytes) {
+  std::vector<ObjectID> objects_to_evict;
+  cache->ChooseObjectsToEvict(num_bytes, &objects_to_evict);
+  for (const auto &object_id : objects_to_evict) {
+    cache->Remove(object_id);
+  }
+  return objects_to_evict;
+}
+
+bool Contains(const std::vector<ObjectID> &object_ids, const ObjectID &object_id) {
+  return std::find(object_ids.begin(), object_ids.end(), object_id) != object_ids.end();
+}
+
+TEST(EvictionPolicyTest, TestLRU) {
+  auto cache = ObjectCache::Create("lru", "test", 1000);
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 4; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    cache->Add(object_ids.back(), 100);
+  }
+  ASSERT_EQ(cache->RemainingCapacity(), 600);
+  UseObject(cache.get(), object_ids[0]);
+  auto evicted = Evict(cache.get(), 150);
+  ASSERT_EQ(evicted, std::vector<ObjectID>({object_ids[1], object_ids[2]}));
+  ASSERT_EQ(cache->RemainingCapacity(), 800);
+  ASSERT_EQ(cache->Remove(object_ids[1]), -1);
+}
+
+TEST(EvictionPolicyTest, Test2QScanResistance) {
+  auto cache = ObjectCache::Create("2q", "test", 1000);
+  // Small objects that are used repeatedly.
+  std::vector<ObjectID> hot_ids;
+  for (int i = 0; i < 4; i++) {
+    hot_ids.push_back(ObjectID::FromRandom());
+    cache->Add(hot_ids.back(), 50);
+    UseObject(cache.get(), hot_ids.back());
+    UseObject(cache.get(), hot_ids.back());
+  }
+  // A scan over large objects that are used once. With LRU, the hot objects
+  // would be evicted first.
+  std::vector<ObjectID> scan_ids;
+  for (int i = 0; i < 4; i++) {
+    scan_ids.push_back(ObjectID::FromRandom());
+    cache->Add(scan_ids.back(), 200);
+    UseObject(cache.get(), scan_ids.back());
+  }
+  auto evicted = Evict(cache.get(), 400);
+  ASSERT_EQ(evicted, std::vector<ObjectID>({scan_ids[0], scan_ids[1]}));
+  evicted = Evict(cache.get(), 200);
+  ASSERT_EQ(evicted, std::vector<ObjectID>({scan_ids[2]}));
+  // Once the objects used once are within their share of the capacity, the
+  // least recently used of the other objects is evicted.
+  evicted = Evict(cache.get(), 50);
+  ASSERT_EQ(evicted, std::vector<ObjectID>({hot_ids[0]}));
+}
+
+TEST(EvictionPolicyTest, Test2QRecreatedObject) {
+  auto cache = ObjectCache::Create("2q", "test", 1000);
+  ObjectID object_id = ObjectID::FromRandom();
+  cache->Add(object_id, 100);
+  UseObject(cache.get(), object_id);
+  ASSERT_EQ(Evict(cache.get(), 100), std::vector<ObjectID>({object_id}));
+  // An object that is created again after being evicted is protected from
+  // objects that are used once.
+  cache->Add(object_id, 100);
+  std::vector<ObjectID> other_ids;
+  for (int i = 0; i < 3; i++) {
+    other_ids.push_back(ObjectID::FromRandom());
+    cache->Add(other_ids.back(), 100);
+  }
+  ASSERT_EQ(Evict(cache.get(), 100), std::vector<ObjectID>({other_ids[0]}));
+}
+
+TEST(EvictionPolicyTest, TestGreedyDualSize) {
+  auto cache = ObjectCache::Create("gdsf", "test", 10000);
+  ObjectID small_id = ObjectID::FromRandom();
+  ObjectID large_id = ObjectID::FromRandom();
+  ObjectID frequent_id = ObjectID::FromRandom();
+  cache->Add(small_id, 100);
+  cache->Add(large_id, 5000);
+  cache->Add(frequent_id, 1000);
+  // Large objects are evicted first, even if they were used more recently.
+  ASSERT_EQ(Evict(cache.get(), 1), std::vector<ObjectID>({large_id}));
+  // Frequently used objects are evicted after objects of the same size.
+  for (int i = 0; i < 20; i++) {
+    UseObject(cache.get(), frequent_id);
+  }
+  ObjectID new_id = ObjectID::FromRandom();
+  cache->Add(new_id, 1000);
+  auto evicted = Evict(cache.get(), 1000);
+  ASSERT_EQ(evicted, std::vector<ObjectID>({new_id}));
+  // Objects that are not used anymore age, and are eventually evicted before
+  // new objects of the same size.
+  int num_rounds = 0;
+  bool frequent_evicted = false;
+  while (!frequent_evicted) {
+    ASSERT_LT(num_rounds, 100);
+    cache->Add(ObjectID::FromRandom(), 1000);
+    frequent_evicted = Contains(Evict(cache.get(), 1000), frequent_id);
+    num_rounds++;
+  }
+  ASSERT_GT(num_rounds, 1);
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/local_disk_external_store.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+class LocalDiskExternalStoreTest : public ::testing::TestWithParam<bool> {
+ public:
+  void SetUp() override {
+    store_.reset(new LocalDiskExternalStore());
+    // Use small segments so that the tests write several of them.
+    std::string endpoint = "local-disk://" + ::testing::TempDir() +
+                           "?segment_size=4096&linger_ms=10&compression=" +
+                           (GetParam() ? "zlib" : "none");
+    ASSERT_TRUE(store_->Connect(endpoint).ok());
+  }
+
+  /// Put objects of the given sizes and return their IDs. Every other object
+  /// is compressible.
+  std::vector<ObjectID> PutObjects(const std::vector<int64_t> &sizes) {
+    std::vector<ObjectID> ids;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    for (size_t i = 0; i < sizes.size(); i++) {
+      ids.push_back(ObjectID::FromRandom());
+      std::vector<uint8_t> data(sizes[i]);
+      for (int64_t j = 0; j < sizes[i]; j++) {
+        data[j] = i % 2 == 0 ? static_cast<uint8_t>(j % 7) : static_cast<uint8_t>(rand());
+      }
+      contents_[ids.back()] = data;
+      buffers.push_back(
+          std::make_shared<Buffer>(contents_[ids.back()].data(), sizes[i]));
+    }
+    RAY_CHECK_OK(store_->Put(ids, buffers));
+    return ids;
+  }
+
+  /// Get objects and check their contents.
+  void CheckObjects(const std::vector<ObjectID> &ids) {
+    std::vector<std::vector<uint8_t>> data;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    for (const auto &id : ids) {
+      data.emplace_back(contents_[id].size());
+      buffers.push_back(std::make_shared<arrow::MutableBuffer>(data.back().data(),
+                                                               data.back().size()));
+    }
+    ASSERT_TRUE(store_->Get(ids, buffers).ok());
+    for (size_t i = 0; i < ids.size(); i++) {
+      ASSERT_EQ(data[i], contents_[ids[i]]);
+    }
+  }
+
+ protected:
+  std::unique_ptr<LocalDiskExternalStore> store_;
+  std::unordered_map<ObjectID, std::vector<uint8_t>> contents_;
+};
+
+TEST_P(LocalDiskExternalStoreTest, TestPutGet) {
+  // Many small objects that share segments, and objects that are larger than
+  // a segment.
+  std::vector<int64_t> sizes;
+  for (int i = 0; i < 100; i++) {
+    sizes.push_back(100 + i);
+  }
+  sizes.push_back(10000);
+  sizes.push_back(0);
+  sizes.push_back(20000);
+  auto ids = PutObjects(sizes);
+  // Read some objects before they are written.
+  CheckObjects({ids[0], ids[99], ids[100]});
+  ASSERT_TRUE(store_->Flush().ok());
+  CheckObjects(std::vector<ObjectID>(ids.begin() + 1, ids.begin() + 99));
+  CheckObjects({ids[101], ids[102]});
+  // Objects that were read back are not kept.
+  std::vector<uint8_t> data(100);
+  ASSERT_TRUE(store_
+                  ->Get({ids[0]}, {std::make_shared<arrow::MutableBuffer>(
+                                      data.data(), data.size())})
+                  .IsKeyError());
+}
+
+TEST_P(LocalDiskExternalStoreTest, TestPutAgain) {
+  auto ids = PutObjects({1000, 1000});
+  ASSERT_TRUE(store_->Flush().ok());
+  CheckObjects({ids[0]});
+  // Put an object that is still in the store again, with different contents.
+  contents_[ids[1]] = std::vector<uint8_t>(500, 1);
+  RAY_CHECK_OK(store_->Put(
+      {ids[1], ids[0]},
+      {std::make_shared<Buffer>(contents_[ids[1]].data(), 500),
+       std::make_shared<Buffer>(contents_[ids[0]].data(), contents_[ids[0]].size())}));
+  ASSERT_TRUE(store_->Flush().ok());
+  CheckObjects(ids);
+}
+
+INSTANTIATE_TEST_CASE_P(Compression, LocalDiskExternalStoreTest,
+                        ::testing::Values(false, true));
+
+TEST(LocalDiskExternalStoreOptionsTest, TestInvalidEndpoints) {
+  LocalDiskExternalStore store;
+  ASSERT_TRUE(store.Connect("local-disk://").IsInvalid());
+  ASSERT_TRUE(store.Connect("local-disk:///tmp?num_workers=0").IsInvalid());
+  ASSERT_TRUE(store.Connect("local-disk:///tmp?compression=lz4").IsInvalid());
+  ASSERT_TRUE(store.Connect("local-disk:///tmp?unknown=1").IsInvalid());
+  ASSERT_TRUE(store.Connect("local-disk:///nonexistent/directory").IsIOError());
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,46 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/numa.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+TEST(NumaTest, TestParseNodeList) {
+  ASSERT_EQ(ParseNumaNodeList("0"), std::vector<int>({0}));
+  ASSERT_EQ(ParseNumaNodeList("0-1\n"), std::vector<int>({0, 1}));
+  ASSERT_EQ(ParseNumaNodeList("0-2,4,6-7"), std::vector<int>({0, 1, 2, 4, 6, 7}));
+  ASSERT_TRUE(ParseNumaNodeList("").empty());
+  ASSERT_TRUE(ParseNumaNodeList("1-0").empty());
+  ASSERT_TRUE(ParseNumaNodeList("0,a").empty());
+  ASSERT_TRUE(ParseNumaNodeList("-1").empty());
+}
+
+TEST(NumaTest, TestCurrentNode) {
+  int num_nodes = NumNumaNodes();
+  ASSERT_GE(num_nodes, 1);
+  int node = GetCurrentNumaNode();
+  ASSERT_GE(node, -1);
+  ASSERT_LT(node, num_nodes);
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
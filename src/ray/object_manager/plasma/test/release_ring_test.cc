@@ -0,0 +1,94 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/release_ring.h"
+
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+class ReleaseRingTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    store_ring_ = ReleaseRing::Create("/tmp", 100);
+    ASSERT_NE(store_ring_, nullptr);
+    // The client maps the ring through its own file descriptor.
+    client_ring_ = ReleaseRing::Map(dup(store_ring_->fd()), store_ring_->capacity());
+    ASSERT_NE(client_ring_, nullptr);
+  }
+
+ protected:
+  std::unique_ptr<ReleaseRing> store_ring_;
+  std::unique_ptr<ReleaseRing> client_ring_;
+};
+
+TEST_F(ReleaseRingTest, TestPushAndDrain) {
+  ASSERT_EQ(store_ring_->capacity(), 128);
+  std::vector<ObjectID> drained;
+  ASSERT_EQ(store_ring_->Drain(&drained), 0);
+
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 10; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    ASSERT_TRUE(client_ring_->Push(object_ids.back()));
+  }
+  ASSERT_EQ(store_ring_->Drain(&drained), 10);
+  ASSERT_EQ(drained, object_ids);
+  ASSERT_EQ(store_ring_->Drain(&drained), 0);
+}
+
+TEST_F(ReleaseRingTest, TestFull) {
+  ObjectID object_id = ObjectID::FromRandom();
+  for (uint32_t i = 0; i < store_ring_->capacity(); i++) {
+    ASSERT_TRUE(client_ring_->Push(object_id));
+  }
+  ASSERT_FALSE(client_ring_->Push(object_id));
+  std::vector<ObjectID> drained;
+  ASSERT_EQ(store_ring_->Drain(&drained), store_ring_->capacity());
+  // Draining makes room for new entries, which wrap around the end of the ring.
+  ASSERT_TRUE(client_ring_->Push(object_id));
+}
+
+TEST_F(ReleaseRingTest, TestConcurrentProducer) {
+  const int num_objects = 10000;
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < num_objects; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+  }
+  std::thread producer([this, &object_ids]() {
+    for (const auto &object_id : object_ids) {
+      while (!client_ring_->Push(object_id)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  std::vector<ObjectID> drained;
+  while (drained.size() < object_ids.size()) {
+    store_ring_->Drain(&drained);
+  }
+  producer.join();
+  ASSERT_EQ(drained, object_ids);
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/slab_allocator.h"
+
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+class SlabAllocatorTest : public ::testing::Test {
+ public:
+  SlabAllocatorTest() : limit_(64 * 1024 * 1024), allocated_(0) {}
+
+  std::unique_ptr<SlabAllocator> MakeAllocator(size_t min_block_size,
+                                               size_t max_block_size,
+                                               size_t min_slab_size) {
+    return std::unique_ptr<SlabAllocator>(new SlabAllocator(
+        64, min_block_size, max_block_size, min_slab_size,
+        [this](size_t alignment, size_t bytes) -> void * {
+          if (allocated_ + static_cast<int64_t>(bytes) > limit_) {
+            return nullptr;
+          }
+          void *mem = nullptr;
+          if (posix_memalign(&mem, alignment, bytes) != 0) {
+            return nullptr;
+          }
+          allocated_ += bytes;
+          slabs_[mem] = bytes;
+          return mem;
+        },
+        [this](void *mem, size_t bytes) {
+          ASSERT_EQ(slabs_[mem], bytes);
+          slabs_.erase(mem);
+          allocated_ -= bytes;
+          free(mem);
+        }));
+  }
+
+ protected:
+  int64_t limit_;
+  int64_t allocated_;
+  std::unordered_map<void *, size_t> slabs_;
+};
+
+TEST_F(SlabAllocatorTest, TestSizeClasses) {
+  auto allocator = MakeAllocator(64, 1024 * 1024, 1024 * 1024);
+  ASSERT_FALSE(allocator->Handles(0));
+  ASSERT_TRUE(allocator->Handles(1));
+  ASSERT_TRUE(allocator->Handles(1024 * 1024));
+  ASSERT_FALSE(allocator->Handles(1024 * 1024 + 1));
+  // Small classes share the minimum slab size, large classes hold at least 8 blocks.
+  ASSERT_EQ(allocator->SlabSizeFor(100), 1024 * 1024);
+  ASSERT_EQ(allocator->SlabSizeFor(1024 * 1024), 8 * 1024 * 1024);
+
+  // Every allocation is aligned and the internal fragmentation of a block is
+  // bounded by the spacing of the size classes.
+  for (size_t bytes : {1, 63, 64, 65, 1000, 4097, 100 * 1000, 700 * 1000}) {
+    void *mem = allocator->Allocate(bytes);
+    ASSERT_NE(mem, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(mem) % 64, 0);
+    ASSERT_TRUE(allocator->Free(mem, bytes));
+  }
+}
+
+TEST_F(SlabAllocatorTest, TestAllocateAndFree) {
+  auto allocator = MakeAllocator(64, 1024 * 1024, 1024 * 1024);
+  std::vector<void *> blocks;
+  for (int i = 0; i < 100; i++) {
+    void *mem = allocator->Allocate(100 * 1000);
+    ASSERT_NE(mem, nullptr);
+    for (void *other : blocks) {
+      ASSERT_NE(mem, other);
+    }
+    blocks.push_back(mem);
+  }
+  ASSERT_EQ(allocator->RequestedBytes(), 100 * 100 * 1000);
+  ASSERT_EQ(allocator->ReservedBytes(), allocated_);
+  ASSERT_GT(allocator->Fragmentation(), 0);
+
+  // Pointers that were not handed out by the allocator are not freed.
+  int unrelated;
+  ASSERT_FALSE(allocator->Free(&unrelated, sizeof(unrelated)));
+
+  for (void *mem : blocks) {
+    ASSERT_TRUE(allocator->Free(mem, 100 * 1000));
+  }
+  ASSERT_EQ(allocator->RequestedBytes(), 0);
+  // Empty slabs are given back, except for one per size class.
+  ASSERT_EQ(slabs_.size(), 1);
+  ASSERT_EQ(allocator->ReservedBytes(), allocated_);
+  allocator.reset();
+  ASSERT_EQ(allocated_, 0);
+}
+
+TEST_F(SlabAllocatorTest, TestOutOfMemory) {
+  limit_ = 2 * 1024 * 1024;
+  auto allocator = MakeAllocator(64, 256 * 1024, 1024 * 1024);
+  std::vector<void *> blocks;
+  void *mem;
+  while ((mem = allocator->Allocate(256 * 1024)) != nullptr) {
+    blocks.push_back(mem);
+  }
+  // The backing allocator ran out of memory after a single 2MB slab.
+  ASSERT_EQ(blocks.size(), 8);
+  ASSERT_EQ(allocator->Allocate(1000), nullptr);
+  // Freeing a block makes space for a new allocation of the same class.
+  ASSERT_TRUE(allocator->Free(blocks.back(), 256 * 1024));
+  blocks.pop_back();
+  ASSERT_NE(allocator->Allocate(250 * 1024), nullptr);
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,172 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+#include "ray/object_manager/plasma/client.h"
+#include "ray/object_manager/plasma/store_runner.h"
+
+namespace plasma {
+
+/// Tests of a store that serves its clients from a pool of threads. The store is
+/// shared by the tests, since its allocator is global.
+class PlasmaStoreThreadsTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() {
+    RayConfig::instance().initialize({{"plasma_store_num_threads", "4"}});
+    socket_name_ = "/tmp/plasma_store_test_" + std::to_string(getpid());
+    plasma_store_runner.reset(new PlasmaStoreRunner(socket_name_, 64 << 20,
+                                                    /*hugepages_enabled=*/false,
+                                                    /*plasma_directory=*/"",
+                                                    /*external_store_endpoint=*/""));
+    store_thread_ = std::thread([]() { plasma_store_runner->Start(); });
+  }
+
+  static void TearDownTestSuite() {
+    plasma_store_runner->Stop();
+    store_thread_.join();
+    plasma_store_runner.reset();
+    RayConfig::instance().initialize({{"plasma_store_num_threads", "0"}});
+  }
+
+ protected:
+  /// Run a function on each of several threads, each with its own client.
+  void RunClients(int num_clients,
+                  const std::function<void(int, PlasmaClient &)> &client_fn) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_clients; i++) {
+      threads.emplace_back([i, &client_fn]() {
+        PlasmaClient client;
+        RAY_CHECK_OK(client.Connect(socket_name_));
+        client_fn(i, client);
+        RAY_CHECK_OK(client.Disconnect());
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  /// Create and seal an object whose bytes are all `value`.
+  static void PutObject(PlasmaClient &client, const ObjectID &object_id, uint8_t value) {
+    std::shared_ptr<Buffer> data;
+    RAY_CHECK_OK(client.Create(object_id, ray::rpc::Address(), kObjectSize, nullptr, 0,
+                               &data));
+    std::fill(data->mutable_data(), data->mutable_data() + kObjectSize, value);
+    RAY_CHECK_OK(client.Seal(object_id));
+    RAY_CHECK_OK(client.Release(object_id));
+  }
+
+  static constexpr int64_t kObjectSize = 1024;
+  static std::string socket_name_;
+  static std::thread store_thread_;
+};
+
+constexpr int64_t PlasmaStoreThreadsTest::kObjectSize;
+std::string PlasmaStoreThreadsTest::socket_name_;
+std::thread PlasmaStoreThreadsTest::store_thread_;
+
+// Every client gets the objects that the next client creates, so most gets wait for
+// a seal that is processed on another thread of the store.
+TEST_F(PlasmaStoreThreadsTest, TestConcurrentCreateSealGetRelease) {
+  const int num_clients = 8;
+  const int num_objects = 50;
+  std::vector<std::vector<ObjectID>> ids(num_clients);
+  for (auto &client_ids : ids) {
+    for (int i = 0; i < num_objects; i++) {
+      client_ids.push_back(ObjectID::FromRandom());
+    }
+  }
+  std::atomic<int> num_checked(0);
+  RunClients(num_clients, [&ids, &num_checked](int i, PlasmaClient &client) {
+    const auto &to_get = ids[(i + 1) % ids.size()];
+    std::thread getter([&ids, &to_get, &num_checked, i]() {
+      PlasmaClient get_client;
+      RAY_CHECK_OK(get_client.Connect(socket_name_));
+      for (const auto &object_id : to_get) {
+        std::vector<ObjectBuffer> buffers;
+        RAY_CHECK_OK(get_client.Get({object_id}, /*timeout_ms=*/-1, &buffers));
+        RAY_CHECK(buffers[0].data != nullptr);
+        RAY_CHECK(buffers[0].data->size() == kObjectSize);
+        const uint8_t expected = (i + 1) % ids.size();
+        for (int64_t j = 0; j < kObjectSize; j++) {
+          RAY_CHECK(buffers[0].data->data()[j] == expected);
+        }
+        num_checked++;
+      }
+      RAY_CHECK_OK(get_client.Disconnect());
+    });
+    for (const auto &object_id : ids[i]) {
+      PutObject(client, object_id, static_cast<uint8_t>(i));
+    }
+    getter.join();
+  });
+  ASSERT_EQ(num_checked, num_clients * num_objects);
+
+  PlasmaClient client;
+  RAY_CHECK_OK(client.Connect(socket_name_));
+  for (const auto &client_ids : ids) {
+    for (const auto &object_id : client_ids) {
+      bool has_object = false;
+      RAY_CHECK_OK(client.Contains(object_id, &has_object));
+      ASSERT_TRUE(has_object);
+    }
+  }
+  RAY_CHECK_OK(client.Disconnect());
+}
+
+// Gets time out on their clients' threads while other clients create objects, and a
+// get that times out still returns the objects that were sealed meanwhile.
+TEST_F(PlasmaStoreThreadsTest, TestGetTimeouts) {
+  const int num_clients = 8;
+  std::vector<ObjectID> sealed_ids;
+  for (int i = 0; i < num_clients; i++) {
+    sealed_ids.push_back(ObjectID::FromRandom());
+  }
+  RunClients(num_clients, [&sealed_ids](int i, PlasmaClient &client) {
+    auto missing_id = ObjectID::FromRandom();
+    std::thread putter([&sealed_ids, i]() {
+      PlasmaClient put_client;
+      RAY_CHECK_OK(put_client.Connect(socket_name_));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      PutObject(put_client, sealed_ids[i], static_cast<uint8_t>(i));
+      RAY_CHECK_OK(put_client.Disconnect());
+    });
+    for (int j = 0; j < 20; j++) {
+      std::vector<ObjectBuffer> buffers;
+      RAY_CHECK_OK(client.Get({missing_id}, /*timeout_ms=*/1, &buffers));
+      RAY_CHECK(buffers[0].data == nullptr);
+    }
+    std::vector<ObjectBuffer> buffers;
+    RAY_CHECK_OK(
+        client.Get({sealed_ids[i], missing_id}, /*timeout_ms=*/1000, &buffers));
+    RAY_CHECK(buffers[0].data != nullptr);
+    RAY_CHECK(buffers[0].data->data()[0] == i);
+    RAY_CHECK(buffers[1].data == nullptr);
+    putter.join();
+  });
+}
+
+}  // namespace plasma
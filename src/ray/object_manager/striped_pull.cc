@@ -0,0 +1,244 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/striped_pull.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace ray {
+
+StripedPull::StripedPull(uint64_t num_chunks, uint64_t chunk_size, size_t max_sources,
+                         size_t chunks_per_source)
+    : chunk_size_(chunk_size),
+      max_sources_(max_sources),
+      chunks_per_source_(std::max<size_t>(chunks_per_source, 1)),
+      chunks_(num_chunks) {
+  for (uint64_t i = 0; i < num_chunks; i++) {
+    unassigned_.push_back(i);
+  }
+}
+
+bool StripedPull::AddSource(const NodeID &source, int64_t now_ms) {
+  if (sources_.count(source) != 0 || removed_sources_.count(source) != 0 ||
+      sources_.size() >= max_sources_) {
+    return false;
+  }
+  sources_[source].last_progress_ms = now_ms;
+  return true;
+}
+
+void StripedPull::RemoveSource(const NodeID &source) {
+  auto it = sources_.find(source);
+  if (it == sources_.end()) {
+    return;
+  }
+  // Ask for the pending chunks of the source first, since they are overdue.
+  for (auto chunk = it->second.pending.rbegin(); chunk != it->second.pending.rend();
+       chunk++) {
+    chunks_[*chunk].source = NodeID::Nil();
+    unassigned_.push_front(*chunk);
+  }
+  sources_.erase(it);
+  removed_sources_.insert(source);
+}
+
+std::vector<NodeID> StripedPull::RemoveStalledSources(int64_t now_ms,
+                                                      int64_t timeout_ms) {
+  std::vector<NodeID> stalled;
+  for (const auto &entry : sources_) {
+    if (!entry.second.pending.empty() &&
+        now_ms - entry.second.last_progress_ms > timeout_ms) {
+      stalled.push_back(entry.first);
+    }
+  }
+  for (const auto &source : stalled) {
+    RemoveSource(source);
+  }
+  return stalled;
+}
+
+void StripedPull::ChunkReceived(const NodeID &source, uint64_t chunk_index,
+                                uint64_t bytes, bool success, int64_t now_ms) {
+  if (chunk_index >= chunks_.size()) {
+    return;
+  }
+  auto it = sources_.find(source);
+  if (it != sources_.end()) {
+    auto &pending = it->second.pending;
+    auto position = std::find(pending.begin(), pending.end(), chunk_index);
+    if (position != pending.end()) {
+      pending.erase(position);
+    }
+    it->second.last_progress_ms = now_ms;
+    if (success) {
+      it->second.bytes_received += bytes;
+      it->second.last_receive_ms = now_ms;
+    }
+  }
+
+  Chunk &chunk = chunks_[chunk_index];
+  if (chunk.received) {
+    if (success) {
+      num_duplicates_++;
+    }
+    return;
+  }
+  if (success) {
+    chunk.received = true;
+    num_received_++;
+    if (!chunk.source.IsNil() && chunk.source != source) {
+      // The chunk was taken over by another source, which does not need to deliver
+      // it anymore.
+      auto owner = sources_.find(chunk.source);
+      if (owner != sources_.end()) {
+        auto &pending = owner->second.pending;
+        auto position = std::find(pending.begin(), pending.end(), chunk_index);
+        if (position != pending.end()) {
+          pending.erase(position);
+        }
+      }
+    }
+  } else if (chunk.source == source) {
+    chunk.source = NodeID::Nil();
+    unassigned_.push_front(chunk_index);
+  }
+}
+
+std::unordered_map<NodeID, std::vector<uint64_t>> StripedPull::AssignChunks(
+    int64_t now_ms) {
+  std::unordered_map<NodeID, std::vector<uint64_t>> assignments;
+  // Serve the fastest sources first.
+  std::vector<NodeID> source_ids;
+  for (const auto &entry : sources_) {
+    source_ids.push_back(entry.first);
+  }
+  std::sort(source_ids.begin(), source_ids.end(),
+            [this](const NodeID &a, const NodeID &b) {
+              return Rate(sources_.at(a)) > Rate(sources_.at(b));
+            });
+
+  for (const auto &source_id : source_ids) {
+    auto &source = sources_[source_id];
+    while (source.pending.size() < chunks_per_source_ && !unassigned_.empty()) {
+      uint64_t chunk_index = unassigned_.front();
+      unassigned_.pop_front();
+      if (chunks_[chunk_index].received) {
+        continue;
+      }
+      Assign(chunk_index, source_id, now_ms, &assignments);
+    }
+  }
+
+  if (unassigned_.empty()) {
+    for (const auto &source_id : source_ids) {
+      if (sources_[source_id].pending.empty()) {
+        TakeOverChunk(source_id, now_ms, &assignments);
+      }
+    }
+  }
+  return assignments;
+}
+
+double StripedPull::SourceRate(const NodeID &source) const {
+  auto it = sources_.find(source);
+  return it == sources_.end() ? 0 : Rate(it->second);
+}
+
+double StripedPull::Rate(const Source &source) const {
+  if (source.bytes_received == 0 || source.start_ms < 0) {
+    return 0;
+  }
+  int64_t elapsed_ms = std::max<int64_t>(source.last_receive_ms - source.start_ms, 1);
+  return source.bytes_received * 1000.0 / elapsed_ms;
+}
+
+double StripedPull::ExpectedFinishMs(const Source &source) const {
+  double rate = Rate(source);
+  if (rate == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return source.pending.size() * chunk_size_ * 1000.0 / rate;
+}
+
+void StripedPull::Assign(uint64_t chunk_index, const NodeID &source_id, int64_t now_ms,
+                         std::unordered_map<NodeID, std::vector<uint64_t>> *assignments) {
+  auto &source = sources_[source_id];
+  if (source.pending.empty()) {
+    // The source was idle, so it could not have made progress until now.
+    source.last_progress_ms = now_ms;
+  }
+  if (source.start_ms < 0) {
+    source.start_ms = now_ms;
+  }
+  chunks_[chunk_index].source = source_id;
+  source.pending.push_back(chunk_index);
+  (*assignments)[source_id].push_back(chunk_index);
+}
+
+bool StripedPull::TakeOverChunk(
+    const NodeID &idle_source, int64_t now_ms,
+    std::unordered_map<NodeID, std::vector<uint64_t>> *assignments) {
+  double idle_rate = Rate(sources_[idle_source]);
+  if (idle_rate == 0) {
+    // We cannot tell whether the source would be faster.
+    return false;
+  }
+  double idle_finish_ms = chunk_size_ * 1000.0 / idle_rate;
+
+  Source *slowest = nullptr;
+  double slowest_finish_ms = idle_finish_ms;
+  for (auto &entry : sources_) {
+    if (entry.first == idle_source || entry.second.pending.empty()) {
+      continue;
+    }
+    double finish_ms = ExpectedFinishMs(entry.second);
+    if (finish_ms > slowest_finish_ms) {
+      slowest = &entry.second;
+      slowest_finish_ms = finish_ms;
+    }
+  }
+  if (slowest == nullptr) {
+    return false;
+  }
+  // Take the chunk that the slowest source would deliver last.
+  auto &pending = slowest->pending;
+  for (auto chunk = pending.rbegin(); chunk != pending.rend(); chunk++) {
+    if (!chunks_[*chunk].reassigned) {
+      uint64_t chunk_index = *chunk;
+      pending.erase(std::next(chunk).base());
+      chunks_[chunk_index].reassigned = true;
+      num_reassigned_++;
+      Assign(chunk_index, idle_source, now_ms, assignments);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string StripedPull::DebugString() const {
+  std::stringstream result;
+  result << num_received_ << "/" << chunks_.size() << " chunks received from "
+         << sources_.size() << " sources, " << num_reassigned_ << " reassigned, "
+         << num_duplicates_ << " duplicates";
+  for (const auto &entry : sources_) {
+    result << "\n- " << entry.first << ": " << entry.second.bytes_received
+           << " bytes at " << Rate(entry.second) / 1e6 << " MB/s, "
+           << entry.second.pending.size() << " pending";
+  }
+  return result.str();
+}
+
+}  // namespace ray
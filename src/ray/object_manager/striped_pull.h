@@ -0,0 +1,149 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ray/common/id.h"
+
+namespace ray {
+
+/// Decides which node each chunk of an object is pulled from, when the object is pulled
+/// from several nodes at once. This only does the bookkeeping; the object manager sends
+/// the pull requests.
+///
+/// Each source has a window of chunks that it was asked for and did not deliver yet,
+/// and it is asked for the next chunk whenever it delivers one, so faster sources serve
+/// more chunks. Once every chunk was asked for, a source that has delivered all its
+/// chunks takes over the last chunk of the source that is expected to finish last, if
+/// it would get that chunk sooner. A chunk is taken over at most once, so at most one
+/// duplicate of each chunk is transferred.
+class StripedPull {
+ public:
+  /// Create the bookkeeping for an object.
+  ///
+  /// \param num_chunks The number of chunks of the object.
+  /// \param chunk_size The size of a chunk in bytes.
+  /// \param max_sources The maximum number of sources to pull from.
+  /// \param chunks_per_source The number of chunks that a source may be asked for
+  /// before it delivers them.
+  StripedPull(uint64_t num_chunks, uint64_t chunk_size, size_t max_sources,
+              size_t chunks_per_source);
+
+  /// Add a node to pull chunks from. This does nothing if the node is or was a source,
+  /// or if there are already max_sources sources.
+  ///
+  /// \param source The node.
+  /// \param now_ms The current time in milliseconds.
+  /// \return Whether the node was added.
+  bool AddSource(const NodeID &source, int64_t now_ms);
+
+  /// Stop pulling from a node. The chunks it was asked for are asked from the other
+  /// sources.
+  ///
+  /// \param source The node.
+  void RemoveSource(const NodeID &source);
+
+  /// Stop pulling from the sources that did not deliver a chunk for a while.
+  ///
+  /// \param now_ms The current time in milliseconds.
+  /// \param timeout_ms How long a source that was asked for chunks may not deliver any.
+  /// \return The sources that were removed.
+  std::vector<NodeID> RemoveStalledSources(int64_t now_ms, int64_t timeout_ms);
+
+  /// Record that a chunk was received.
+  ///
+  /// \param source The node the chunk was received from.
+  /// \param chunk_index The index of the chunk.
+  /// \param bytes The size of the chunk in bytes.
+  /// \param success Whether the chunk was written. If not, it is asked for again.
+  /// \param now_ms The current time in milliseconds.
+  void ChunkReceived(const NodeID &source, uint64_t chunk_index, uint64_t bytes,
+                     bool success, int64_t now_ms);
+
+  /// Decide which chunks to ask the sources for next.
+  ///
+  /// \param now_ms The current time in milliseconds.
+  /// \return The chunks to ask each source for.
+  std::unordered_map<NodeID, std::vector<uint64_t>> AssignChunks(int64_t now_ms);
+
+  /// Whether all the chunks were received.
+  bool Done() const { return num_received_ == chunks_.size(); }
+
+  size_t NumSources() const { return sources_.size(); }
+
+  /// The rate at which a source delivered chunks, in bytes per second, or 0 if it did
+  /// not deliver any chunk yet.
+  double SourceRate(const NodeID &source) const;
+
+  std::string DebugString() const;
+
+ private:
+  struct Chunk {
+    /// The source the chunk was asked from, or nil if it was not asked for.
+    NodeID source;
+    bool received = false;
+    /// Whether the chunk was taken over from another source.
+    bool reassigned = false;
+  };
+
+  struct Source {
+    /// The chunks the source was asked for and did not deliver, oldest first.
+    std::deque<uint64_t> pending;
+    /// When the source was first asked for a chunk, or -1.
+    int64_t start_ms = -1;
+    /// When the source last delivered a chunk, or was asked for chunks when it had
+    /// none pending.
+    int64_t last_progress_ms = 0;
+    uint64_t bytes_received = 0;
+    int64_t last_receive_ms = -1;
+  };
+
+  double Rate(const Source &source) const;
+
+  /// The expected time in milliseconds until a source delivers its pending chunks.
+  double ExpectedFinishMs(const Source &source) const;
+
+  /// Assign a chunk to a source.
+  void Assign(uint64_t chunk_index, const NodeID &source_id, int64_t now_ms,
+              std::unordered_map<NodeID, std::vector<uint64_t>> *assignments);
+
+  /// Find a pending chunk of another source for an idle source to take over.
+  ///
+  /// \return Whether a chunk was taken over.
+  bool TakeOverChunk(const NodeID &idle_source, int64_t now_ms,
+                     std::unordered_map<NodeID, std::vector<uint64_t>> *assignments);
+
+  const uint64_t chunk_size_;
+  const size_t max_sources_;
+  const size_t chunks_per_source_;
+  std::vector<Chunk> chunks_;
+  /// The chunks that are not assigned to a source, in order.
+  std::deque<uint64_t> unassigned_;
+  std::unordered_map<NodeID, Source> sources_;
+  /// The sources that were removed, which are not pulled from again.
+  std::unordered_set<NodeID> removed_sources_;
+  size_t num_received_ = 0;
+  /// Statistics.
+  size_t num_reassigned_ = 0;
+  size_t num_duplicates_ = 0;
+};
+
+}  // namespace ray
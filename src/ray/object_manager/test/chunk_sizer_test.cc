@@ -0,0 +1,110 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/chunk_sizer.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+const uint64_t kMB = 1024 * 1024;
+
+class ChunkSizerTest : public ::testing::Test {
+ public:
+  ChunkSizerTest() : sizer_(kMB, 64 * 1024, 64 * kMB, 10, 4) {}
+
+  /// Receive an object from a node in chunks that arrive at the given rate.
+  void ReceiveObject(const NodeID &node_id, uint64_t num_chunks, uint64_t chunk_size,
+                     double bytes_per_sec) {
+    ObjectID object_id = ObjectID::FromRandom();
+    sizer_.TransferStarted(object_id);
+    for (uint64_t i = 0; i < num_chunks; i++) {
+      sizer_.ChunkReceived(object_id, node_id, chunk_size,
+                           100 + i * chunk_size / bytes_per_sec);
+    }
+    sizer_.TransferFinished(object_id);
+  }
+
+ protected:
+  ChunkSizer sizer_;
+};
+
+TEST_F(ChunkSizerTest, TestUnknownNode) {
+  NodeID node_id = NodeID::FromRandom();
+  // Large objects use the default chunk size.
+  ASSERT_EQ(sizer_.ChunkSize(1024 * kMB, node_id), kMB);
+  // Smaller objects are split into at least 4 chunks, of at least the minimum size.
+  ASSERT_EQ(sizer_.ChunkSize(2 * kMB, node_id), kMB / 2);
+  ASSERT_EQ(sizer_.ChunkSize(100, node_id), 64 * 1024);
+  // Chunks are whole pages.
+  ASSERT_EQ(sizer_.ChunkSize(4 * kMB + 4, node_id) % 4096, 0);
+}
+
+TEST_F(ChunkSizerTest, TestChunkSizeFollowsThroughput) {
+  NodeID fast = NodeID::FromRandom();
+  NodeID slow = NodeID::FromRandom();
+  ReceiveObject(fast, 20, kMB, 1000.0 * kMB);
+  ReceiveObject(slow, 20, kMB, 10.0 * kMB);
+  ASSERT_NEAR(sizer_.Throughput(fast), 1000.0 * kMB, kMB);
+  ASSERT_NEAR(sizer_.Throughput(slow), 10.0 * kMB, kMB);
+  // 10ms worth of data, within the bounds.
+  ASSERT_NEAR(sizer_.ChunkSize(10240 * kMB, fast), 10 * kMB, 4096);
+  ASSERT_EQ(sizer_.ChunkSize(10240 * kMB, slow), 104 * 1024);
+  ASSERT_EQ(sizer_.ChunkSize(2 * kMB, fast), kMB / 2);
+  ASSERT_NEAR(sizer_.RecentChunksPerTransfer(), 20, 1e-9);
+}
+
+TEST_F(ChunkSizerTest, TestSingleChunkTransfer) {
+  NodeID node_id = NodeID::FromRandom();
+  // The rate is not known from a single chunk.
+  ReceiveObject(node_id, 1, kMB, 10.0 * kMB);
+  ASSERT_EQ(sizer_.Throughput(node_id), 0);
+  // But it can be reported by the node.
+  sizer_.UpdateThroughput(node_id, 10.0 * kMB);
+  ASSERT_EQ(sizer_.Throughput(node_id), 10.0 * kMB);
+}
+
+TEST_F(ChunkSizerTest, TestChunksOutsideTransfer) {
+  NodeID node_id = NodeID::FromRandom();
+  ObjectID object_id = ObjectID::FromRandom();
+  // Chunks of an object that is not pulled, such as a push of an object that is
+  // already local, are not tracked.
+  sizer_.ChunkReceived(object_id, node_id, kMB, 100);
+  ASSERT_EQ(sizer_.NumTransfers(), 0);
+
+  sizer_.TransferStarted(object_id);
+  sizer_.ChunkReceived(object_id, node_id, kMB, 100);
+  sizer_.ChunkReceived(object_id, node_id, kMB, 100.1);
+  ASSERT_EQ(sizer_.NumTransfers(), 1);
+  sizer_.TransferFinished(object_id);
+  ASSERT_EQ(sizer_.NumTransfers(), 0);
+  ASSERT_NEAR(sizer_.Throughput(node_id), 10.0 * kMB, 1);
+
+  // Late and duplicate chunks that arrive after the transfer finished are ignored
+  // and do not change the rate.
+  for (int i = 0; i < 10; i++) {
+    sizer_.ChunkReceived(object_id, node_id, kMB, 200 + i);
+  }
+  ASSERT_EQ(sizer_.NumTransfers(), 0);
+  sizer_.TransferFinished(object_id);
+  ASSERT_NEAR(sizer_.Throughput(node_id), 10.0 * kMB, 1);
+  ASSERT_NEAR(sizer_.RecentChunksPerTransfer(), 2, 1e-9);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/striped_pull.h"
+
+#include <deque>
+#include <set>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+const uint64_t kChunkSize = 1000;
+
+/// Simulate pulling an object from sources that deliver one chunk every given number of
+/// milliseconds, and return how long it took.
+int64_t SimulatePull(
+    uint64_t num_chunks, const std::vector<int64_t> &ms_per_chunk,
+    std::unordered_map<NodeID, uint64_t> *chunks_per_source = nullptr) {
+  StripedPull pull(num_chunks, kChunkSize, ms_per_chunk.size(), 2);
+  std::vector<NodeID> sources;
+  // The chunks each source was asked for, in order.
+  std::unordered_map<NodeID, std::deque<uint64_t>> requests;
+  std::unordered_map<NodeID, int64_t> next_delivery_ms;
+  for (size_t i = 0; i < ms_per_chunk.size(); i++) {
+    sources.push_back(NodeID::FromRandom());
+    EXPECT_TRUE(pull.AddSource(sources.back(), 0));
+  }
+  int64_t now_ms = 0;
+  while (!pull.Done()) {
+    for (const auto &entry : pull.AssignChunks(now_ms)) {
+      auto &queue = requests[entry.first];
+      if (queue.empty()) {
+        next_delivery_ms[entry.first] = now_ms;
+      }
+      queue.insert(queue.end(), entry.second.begin(), entry.second.end());
+    }
+    now_ms++;
+    for (size_t i = 0; i < sources.size(); i++) {
+      auto &queue = requests[sources[i]];
+      if (!queue.empty() && now_ms - next_delivery_ms[sources[i]] >= ms_per_chunk[i]) {
+        pull.ChunkReceived(sources[i], queue.front(), kChunkSize, true, now_ms);
+        if (chunks_per_source != nullptr) {
+          (*chunks_per_source)[sources[i]]++;
+        }
+        queue.pop_front();
+        next_delivery_ms[sources[i]] = now_ms;
+      }
+    }
+    EXPECT_LT(now_ms, 100000);
+  }
+  return now_ms;
+}
+
+TEST(StripedPullTest, TestScalesWithSources) {
+  int64_t one_source_ms = SimulatePull(100, {10});
+  int64_t four_sources_ms = SimulatePull(100, {10, 10, 10, 10});
+  ASSERT_LE(four_sources_ms, one_source_ms / 3);
+}
+
+TEST(StripedPullTest, TestFasterSourcesServeMoreChunks) {
+  std::unordered_map<NodeID, uint64_t> chunks_per_source;
+  int64_t duration_ms = SimulatePull(100, {5, 20}, &chunks_per_source);
+  std::vector<uint64_t> counts;
+  for (const auto &entry : chunks_per_source) {
+    counts.push_back(entry.second);
+  }
+  ASSERT_EQ(counts.size(), 2);
+  ASSERT_GT(std::max(counts[0], counts[1]), 3 * std::min(counts[0], counts[1]));
+  // Close to the 400ms that the two sources would take together.
+  ASSERT_LT(duration_ms, 500);
+}
+
+TEST(StripedPullTest, TestStragglerTakenOver) {
+  StripedPull pull(4, kChunkSize, 2, 2);
+  NodeID fast = NodeID::FromRandom();
+  NodeID slow = NodeID::FromRandom();
+  ASSERT_TRUE(pull.AddSource(fast, 0));
+  ASSERT_TRUE(pull.AddSource(slow, 0));
+  auto assignments = pull.AssignChunks(0);
+  ASSERT_EQ(assignments[fast].size() + assignments[slow].size(), 4);
+  // The fast source delivers its chunks, the slow one delivers one of two.
+  for (auto chunk : assignments[fast]) {
+    pull.ChunkReceived(fast, chunk, kChunkSize, true, 10);
+  }
+  pull.ChunkReceived(slow, assignments[slow][0], kChunkSize, true, 100);
+  // The fast source takes over the remaining chunk of the slow one.
+  auto takeover = pull.AssignChunks(100);
+  ASSERT_EQ(takeover.size(), 1);
+  ASSERT_EQ(takeover[fast], std::vector<uint64_t>({assignments[slow][1]}));
+  pull.ChunkReceived(fast, assignments[slow][1], kChunkSize, true, 105);
+  ASSERT_TRUE(pull.Done());
+  // The slow source delivers the chunk too, which is a duplicate.
+  pull.ChunkReceived(slow, assignments[slow][1], kChunkSize, true, 200);
+  ASSERT_TRUE(pull.Done());
+  ASSERT_TRUE(pull.AssignChunks(200).empty());
+}
+
+TEST(StripedPullTest, TestStalledSourceRemoved) {
+  StripedPull pull(4, kChunkSize, 2, 2);
+  NodeID good = NodeID::FromRandom();
+  NodeID stalled = NodeID::FromRandom();
+  ASSERT_TRUE(pull.AddSource(good, 0));
+  ASSERT_TRUE(pull.AddSource(stalled, 0));
+  auto assignments = pull.AssignChunks(0);
+  for (auto chunk : assignments[good]) {
+    pull.ChunkReceived(good, chunk, kChunkSize, true, 500);
+  }
+  ASSERT_TRUE(pull.RemoveStalledSources(500, 1000).empty());
+  auto removed = pull.RemoveStalledSources(1500, 1000);
+  ASSERT_EQ(removed, std::vector<NodeID>({stalled}));
+  ASSERT_EQ(pull.NumSources(), 1);
+  ASSERT_FALSE(pull.AddSource(stalled, 1500));
+  // The chunks of the stalled source are asked from the other one.
+  auto reassigned = pull.AssignChunks(1500);
+  std::set<uint64_t> expected(assignments[stalled].begin(), assignments[stalled].end());
+  ASSERT_EQ(std::set<uint64_t>(reassigned[good].begin(), reassigned[good].end()),
+            expected);
+}
+
+TEST(StripedPullTest, TestFailedChunkAskedAgain) {
+  StripedPull pull(2, kChunkSize, 1, 1);
+  NodeID source = NodeID::FromRandom();
+  ASSERT_TRUE(pull.AddSource(source, 0));
+  ASSERT_FALSE(pull.AddSource(NodeID::FromRandom(), 0));
+  ASSERT_EQ(pull.AssignChunks(0)[source], std::vector<uint64_t>({0}));
+  pull.ChunkReceived(source, 0, kChunkSize, false, 10);
+  ASSERT_EQ(pull.AssignChunks(10)[source], std::vector<uint64_t>({0}));
+  pull.ChunkReceived(source, 0, kChunkSize, true, 20);
+  ASSERT_EQ(pull.AssignChunks(20)[source], std::vector<uint64_t>({1}));
+  pull.ChunkReceived(source, 1, kChunkSize, true, 30);
+  ASSERT_TRUE(pull.Done());
+  ASSERT_EQ(pull.SourceRate(source), 2 * kChunkSize * 1000.0 / 30);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -86,6 +86,22 @@ std::vector<ray::rpc::ObjectReference> FlatbufferToObjectReference(
   return refs;
 }
 
+/// Apply the resources that changed to a resource set. Removed resources have a value
+/// of 0.
+ray::ResourceSet ApplyResourceDelta(
+    const ray::ResourceSet &resources,
+    const google::protobuf::Map<std::string, double> &delta) {
+  auto resource_map = resources.GetResourceMap();
+  for (const auto &resource : delta) {
+    if (resource.second > 0) {
+      resource_map[resource.first] = resource.second;
+    } else {
+      resource_map.erase(resource.first);
+    }
+  }
+  return ray::ResourceSet(resource_map);
+}
+
 }  // namespace
 
 namespace ray {
@@ -202,6 +218,8 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
         std::shared_ptr<ClusterResourceScheduler>(new ClusterResourceScheduler(
             self_node_id_.Binary(),
             local_resources.GetTotalResources().GetResourceMap()));
+    new_resource_scheduler_->SetPlacementScorer(
+        PlacementScorer::Create(RayConfig::instance().scheduler_placement_strategy()));
     std::function<bool(const Task &)> fulfills_dependencies_func =
         [this](const Task &task) {
           bool args_ready = task_dependency_manager_.SubscribeGetDependencies(
@@ -861,7 +879,8 @@ void NodeManager::TryLocalInfeasibleTaskScheduling() {
 }
 
 void NodeManager::HeartbeatAdded(const NodeID &client_id,
-                                 const HeartbeatTableData &heartbeat_data) {
+                                 const HeartbeatTableData &heartbeat_data,
+                                 bool is_delta) {
   // Locate the client id in remote client table and update available resources based on
   // the received heartbeat information.
   auto it = cluster_resource_map_.find(client_id);
@@ -878,24 +897,22 @@ void NodeManager::HeartbeatAdded(const NodeID &client_id,
 
   SchedulingResources &remote_resources = it->second;
 
-  // If light heartbeat enabled, we update remote resources only when related resources
-  // map in heartbeat is not empty.
-  if (light_heartbeat_enabled_) {
+  // If the heartbeat is a delta, it only holds the resources that changed.
+  if (is_delta) {
     if (heartbeat_data.resources_total_size() > 0) {
-      ResourceSet remote_total(MapFromProtobuf(heartbeat_data.resources_total()));
-      remote_resources.SetTotalResources(std::move(remote_total));
+      remote_resources.SetTotalResources(ApplyResourceDelta(
+          remote_resources.GetTotalResources(), heartbeat_data.resources_total()));
     }
-    if (heartbeat_data.resource_load_changed()) {
-      ResourceSet remote_available(MapFromProtobuf(heartbeat_data.resources_available()));
-      remote_resources.SetAvailableResources(std::move(remote_available));
+    if (heartbeat_data.resources_available_changed()) {
+      remote_resources.SetAvailableResources(
+          ApplyResourceDelta(remote_resources.GetAvailableResources(),
+                             heartbeat_data.resources_available()));
     }
     if (heartbeat_data.resource_load_changed()) {
-      ResourceSet remote_load(MapFromProtobuf(heartbeat_data.resource_load()));
-      // Extract the load information and save it locally.
-      remote_resources.SetLoadResources(std::move(remote_load));
+      remote_resources.SetLoadResources(ApplyResourceDelta(
+          remote_resources.GetLoadResources(), heartbeat_data.resource_load()));
     }
   } else {
-    // If light heartbeat disabled, we update remote resources every time.
     ResourceSet remote_total(MapFromProtobuf(heartbeat_data.resources_total()));
     remote_resources.SetTotalResources(std::move(remote_total));
     ResourceSet remote_available(MapFromProtobuf(heartbeat_data.resources_available()));
@@ -938,6 +955,14 @@ void NodeManager::HeartbeatAdded(const NodeID &client_id,
 }
 
 void NodeManager::HeartbeatBatchAdded(const HeartbeatBatchTableData &heartbeat_batch) {
+  if (!heartbeat_batch.full_snapshot() && resource_view_version_ > 0 &&
+      heartbeat_batch.version() != resource_view_version_ + 1) {
+    // The changes of the batches in between are lost, so the resources of some nodes
+    // may be stale until the next full snapshot.
+    RAY_LOG(DEBUG) << "Missed resource view versions " << resource_view_version_ + 1
+                   << " to " << heartbeat_batch.version() - 1;
+  }
+  resource_view_version_ = heartbeat_batch.version();
   // Update load information provided by each heartbeat.
   for (const auto &heartbeat_data : heartbeat_batch.batch()) {
     const NodeID &client_id = NodeID::FromBinary(heartbeat_data.client_id());
@@ -945,7 +970,7 @@ void NodeManager::HeartbeatBatchAdded(const HeartbeatBatchTableData &heartbeat_b
       // Skip heartbeats from self.
       continue;
     }
-    HeartbeatAdded(client_id, heartbeat_data);
+    HeartbeatAdded(client_id, heartbeat_data, !heartbeat_batch.full_snapshot());
   }
 }
 
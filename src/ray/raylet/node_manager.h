@@ -25,11 +25,11 @@
 #include "ray/common/client_connection.h"
 #include "ray/common/task/task_common.h"
 #include "ray/common/task/scheduling_resources.h"
+#include "ray/common/task/scheduling_ids.h"
 #include "ray/object_manager/object_manager.h"
 #include "ray/raylet/actor_registration.h"
 #include "ray/raylet/agent_manager.h"
 #include "ray/raylet/local_object_manager.h"
-#include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 #include "ray/raylet/scheduling/cluster_task_manager.h"
 #include "ray/raylet/scheduling_policy.h"
@@ -229,8 +229,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   ///
   /// \param id The ID of the node manager that sent the heartbeat.
   /// \param data The heartbeat data including load information.
+  /// \param is_delta Whether the heartbeat only holds the resources that changed.
   /// \return Void.
-  void HeartbeatAdded(const NodeID &id, const HeartbeatTableData &data);
+  void HeartbeatAdded(const NodeID &id, const HeartbeatTableData &data, bool is_delta);
   /// Handler for a heartbeat batch notification from the GCS
   ///
   /// \param heartbeat_batch The batch of heartbeat data.
@@ -713,6 +714,8 @@ class NodeManager : public rpc::NodeManagerServiceHandler {
   /// Cache which stores resources in last heartbeat used to check if they are changed.
   /// Used by light heartbeat.
   SchedulingResources last_heartbeat_resources_;
+  /// The version of the last heartbeat batch received from the GCS.
+  int64_t resource_view_version_ = 0;
   /// The time that the last debug string was logged to the console.
   uint64_t last_debug_dump_at_ms_;
   /// The number of heartbeats that we should wait before sending the
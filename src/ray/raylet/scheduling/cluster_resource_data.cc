@@ -325,6 +325,20 @@ bool TaskRequest::IsEmpty() const {
   return true;
 }
 
+bool TaskRequest::HasOnlyHardConstraints() const {
+  for (size_t i = 0; i < this->predefined_resources.size(); i++) {
+    if (this->predefined_resources[i].soft) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < this->custom_resources.size(); i++) {
+    if (this->custom_resources[i].soft) {
+      return false;
+    }
+  }
+  return this->placement_hints.empty();
+}
+
 std::string TaskRequest::DebugString() const {
   std::stringstream buffer;
   buffer << " {";
@@ -20,9 +20,9 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "ray/common/task/scheduling_ids.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/raylet/scheduling/fixed_point.h"
-#include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/util/logging.h"
 
 /// List of predefined resources.
@@ -81,6 +81,9 @@ class TaskRequest {
   absl::flat_hash_set<int64_t> placement_hints;
   /// Check whether the request contains no resources.
   bool IsEmpty() const;
+  /// Check whether the request has no soft constraints, i.e., no soft resource
+  /// demands and no placement hints.
+  bool HasOnlyHardConstraints() const;
   /// Returns human-readable string for this task request.
   std::string DebugString() const;
 };
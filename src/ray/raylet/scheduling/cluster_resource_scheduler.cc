@@ -68,11 +68,13 @@ void ClusterResourceScheduler::AddOrUpdateNode(int64_t node_id,
   if (it == nodes_.end()) {
     // This node is new, so add it to the map.
     nodes_.emplace(node_id, node_resources);
+    UpdateNodeIndex(node_id, node_resources);
   } else {
     // This node exists, so update its resources.
     NodeResources &resources = it->second;
     SetPredefinedResources(node_resources, &resources);
     SetCustomResources(node_resources.custom_resources, &resources.custom_resources);
+    UpdateNodeIndex(node_id, resources);
   }
 }
 
@@ -84,6 +86,8 @@ bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
   } else {
     it->second.custom_resources.clear();
     nodes_.erase(it);
+    node_index_.RemoveNode(node_id);
+    dense_nodes_.RemoveNode(node_id);
     string_to_int_map_.Remove(node_id);
     return true;
   }
@@ -98,6 +102,45 @@ bool ClusterResourceScheduler::RemoveNode(const std::string &node_id_string) {
   return RemoveNode(node_id);
 }
 
+namespace {
+
+/// Return a node as a placement candidate for a task request.
+PlacementCandidate ToPlacementCandidate(const TaskRequest &task_req,
+                                        const NodeResources &resources) {
+  PlacementCandidate candidate{1, 1};
+  bool first = true;
+  auto add_resource = [&candidate, &first](FixedPoint demand,
+                                           const ResourceCapacity &capacity) {
+    if (demand <= 0) {
+      return;
+    }
+    double free_slots = capacity.available.Double() / demand.Double();
+    double total_slots = capacity.total.Double() / demand.Double();
+    if (first || free_slots < candidate.free_slots) {
+      candidate.free_slots = free_slots;
+    }
+    if (first || total_slots < candidate.total_slots) {
+      candidate.total_slots = total_slots;
+    }
+    first = false;
+  };
+  size_t num_predefined =
+      std::min<size_t>(PredefinedResources_MAX, task_req.predefined_resources.size());
+  for (size_t i = 0; i < num_predefined; i++) {
+    add_resource(task_req.predefined_resources[i].demand,
+                 resources.predefined_resources[i]);
+  }
+  for (const auto &custom_resource : task_req.custom_resources) {
+    auto it = resources.custom_resources.find(custom_resource.id);
+    if (it != resources.custom_resources.end()) {
+      add_resource(custom_resource.demand, it->second);
+    }
+  }
+  return candidate;
+}
+
+}  // namespace
+
 int64_t ClusterResourceScheduler::IsSchedulable(const TaskRequest &task_req,
                                                 int64_t node_id,
                                                 const NodeResources &resources) {
@@ -120,7 +163,17 @@ int64_t ClusterResourceScheduler::IsSchedulable(const TaskRequest &task_req,
     }
   }
 
-  // Now check custom resources.
+  // Now check custom resources and placement hints.
+  int64_t other_violations = CustomAndPlacementViolations(task_req, node_id, resources);
+  if (other_violations == -1) {
+    return -1;
+  }
+  return violations + other_violations;
+}
+
+int64_t ClusterResourceScheduler::CustomAndPlacementViolations(
+    const TaskRequest &task_req, int64_t node_id, const NodeResources &resources) const {
+  int64_t violations = 0;
   for (const auto &task_req_custom_resource : task_req.custom_resources) {
     auto it = resources.custom_resources.find(task_req_custom_resource.id);
 
@@ -188,7 +241,10 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
   }
 
   // Check whether local node is schedulable. We return immediately
-  // the local node only if there are zero violations.
+  // the local node only if there are zero violations. If the request has placement
+  // hints, this is only the case if the local node is one of them, so the hinted nodes
+  // are always tried before the others, and the local node first among them. The
+  // legacy SchedulingPolicy places tasks the same way.
   auto it = nodes_.find(local_node_id_);
   if (it != nodes_.end()) {
     if (IsSchedulable(task_req, it->first, it->second) == 0) {
@@ -207,19 +263,70 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
     }
   }
 
-  for (const auto &node : nodes_) {
+  if (!task_req.placement_hints.empty()) {
+    TaskRequest unhinted_req = task_req;
+    unhinted_req.placement_hints.clear();
+    if (unhinted_req.HasOnlyHardConstraints()) {
+      // No node in the placement hints can schedule the request, and all the other
+      // nodes violate them once, so look for a node as if there were no hints.
+      best_node = GetBestSchedulableNode(unhinted_req, actor_creation, total_violations);
+      *total_violations = best_node == -1 ? 0 : 1;
+      return best_node;
+    }
+  }
+
+  if (task_req.HasOnlyHardConstraints() && placement_scorer_ == nullptr) {
+    // Any node that satisfies the request has zero violations, so just find one.
+    best_node = node_index_.FindNode(task_req, [this, &task_req](int64_t node_id) {
+      auto it = nodes_.find(node_id);
+      return it != nodes_.end() && IsSchedulable(task_req, node_id, it->second) == 0;
+    });
+    return best_node;
+  }
+
+  if (task_req.HasOnlyHardConstraints()) {
+    // Let the scorer choose among the first nodes found from a random start.
+    std::vector<int64_t> candidate_nodes;
+    std::vector<PlacementCandidate> candidates;
+    size_t num_candidates = placement_scorer_->NumCandidates();
+    node_index_.FindNode(
+        task_req,
+        [&](int64_t node_id) {
+          auto it = nodes_.find(node_id);
+          if (it != nodes_.end() && IsSchedulable(task_req, node_id, it->second) == 0) {
+            candidate_nodes.push_back(node_id);
+            candidates.push_back(ToPlacementCandidate(task_req, it->second));
+          }
+          return candidates.size() >= num_candidates;
+        },
+        std::rand());
+    int64_t picked = placement_scorer_->Pick(candidates);
+    return picked == -1 ? -1 : candidate_nodes[picked];
+  }
+
+  // Check the predefined resources of all the nodes at once, and then the rest of the
+  // request only on the nodes that may have fewer violations than the best one.
+  std::vector<int64_t> predefined_violations;
+  dense_nodes_.PredefinedViolations(DenseTaskRequest(task_req), &predefined_violations);
+  for (size_t i = 0; i < predefined_violations.size(); i++) {
+    if (predefined_violations[i] == -1 || predefined_violations[i] >= min_violations) {
+      continue;
+    }
+    int64_t node_id = dense_nodes_.NodeId(i);
+    auto node = nodes_.find(node_id);
+    RAY_CHECK(node != nodes_.end());
     // Return -1 if node not schedulable. otherwise return the number
     // of soft constraint violations.
-    int64_t violations;
-
-    if ((violations = IsSchedulable(task_req, node.first, node.second)) == -1) {
+    int64_t violations = CustomAndPlacementViolations(task_req, node_id, node->second);
+    if (violations == -1) {
       continue;
     }
+    violations += predefined_violations[i];
 
     // Update the node with the smallest number of soft constraints violated.
     if (min_violations > violations) {
       min_violations = violations;
-      best_node = node.first;
+      best_node = node_id;
     }
     if (violations == 0) {
       *total_violations = 0;
@@ -246,6 +353,62 @@ std::string ClusterResourceScheduler::GetBestSchedulableNode(
   return string_to_int_map_.Get(node_id);
 }
 
+std::vector<std::pair<int64_t, int64_t>> ClusterResourceScheduler::ScheduleTaskBatch(
+    const TaskRequest &task_req, bool actor_creation, int64_t num_tasks) {
+  std::vector<std::pair<int64_t, int64_t>> placements;
+  // Empty actor creation requests are placed on random nodes.
+  bool random_placement = actor_creation && task_req.IsEmpty();
+  int64_t remaining = num_tasks;
+  while (remaining > 0) {
+    int64_t violations;
+    int64_t node_id = GetBestSchedulableNode(task_req, actor_creation, &violations);
+    if (node_id == -1) {
+      break;
+    }
+    int64_t count = 1;
+    if (node_id == local_node_id_) {
+      if (!random_placement) {
+        count = remaining;
+      }
+    } else {
+      SubtractNodeAvailableResources(node_id, task_req);
+      if (!random_placement && violations == 0 && placement_scorer_ == nullptr) {
+        // The node would be picked again as long as it has no violations.
+        const NodeResources &resources = nodes_.find(node_id)->second;
+        while (count < remaining && IsSchedulable(task_req, node_id, resources) == 0) {
+          SubtractNodeAvailableResources(node_id, task_req);
+          count++;
+        }
+      }
+    }
+    if (!placements.empty() && placements.back().first == node_id) {
+      placements.back().second += count;
+    } else {
+      placements.emplace_back(node_id, count);
+    }
+    remaining -= count;
+  }
+  return placements;
+}
+
+std::vector<std::pair<std::string, int64_t>> ClusterResourceScheduler::ScheduleTaskBatch(
+    const std::unordered_map<std::string, double> &task_resources, bool actor_creation,
+    int64_t num_tasks, const std::vector<std::string> &placement_hints) {
+  TaskRequest task_request = ResourceMapToTaskRequest(string_to_int_map_, task_resources);
+  for (const auto &node_id_string : placement_hints) {
+    int64_t node_id = string_to_int_map_.Get(node_id_string);
+    if (node_id != -1) {
+      task_request.placement_hints.insert(node_id);
+    }
+  }
+  std::vector<std::pair<std::string, int64_t>> placements;
+  auto node_placements = ScheduleTaskBatch(task_request, actor_creation, num_tasks);
+  for (const auto &placement : node_placements) {
+    placements.emplace_back(string_to_int_map_.Get(placement.first), placement.second);
+  }
+  return placements;
+}
+
 bool ClusterResourceScheduler::SubtractNodeAvailableResources(
     int64_t node_id, const TaskRequest &task_req) {
   auto it = nodes_.find(node_id);
@@ -274,6 +437,7 @@ bool ClusterResourceScheduler::SubtractNodeAvailableResources(
           std::max(FixedPoint(0), it->second.available - task_req_custom_resource.demand);
     }
   }
+  UpdateNodeIndex(node_id, resources);
   return true;
 }
 
@@ -306,6 +470,7 @@ bool ClusterResourceScheduler::AddNodeAvailableResources(int64_t node_id,
           it->second.available + task_req_custom_resource.demand, it->second.total);
     }
   }
+  UpdateNodeIndex(node_id, resources);
   return true;
 }
 
@@ -385,6 +550,7 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &client_
       it->second.custom_resources.emplace(resource_id, resource_capacity);
     }
   }
+  UpdateNodeIndex(client_id, it->second);
 }
 
 void ClusterResourceScheduler::DeleteResource(const std::string &client_id_string,
@@ -415,6 +581,7 @@ void ClusterResourceScheduler::DeleteResource(const std::string &client_id_strin
       it->second.custom_resources.erase(itr);
     }
   }
+  UpdateNodeIndex(client_id, it->second);
 }
 
 std::string ClusterResourceScheduler::DebugString(void) const {
@@ -659,6 +826,7 @@ void ClusterResourceScheduler::UpdateLocalAvailableResourcesFromResourceInstance
       }
     }
   }
+  UpdateNodeIndex(local_node_id_, it_local_node->second);
 }
 
 void ClusterResourceScheduler::FreeTaskResourceInstances(
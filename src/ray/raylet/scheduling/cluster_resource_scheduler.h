@@ -20,10 +20,13 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "ray/common/task/scheduling_ids.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "ray/raylet/scheduling/dense_resource_table.h"
 #include "ray/raylet/scheduling/fixed_point.h"
-#include "ray/raylet/scheduling/scheduling_ids.h"
+#include "ray/raylet/scheduling/node_capacity_index.h"
+#include "ray/raylet/scheduling/placement_scorer.h"
 #include "ray/util/logging.h"
 
 #include "src/ray/protobuf/gcs.pb.h"
@@ -42,6 +45,15 @@ class ClusterResourceScheduler {
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   absl::flat_hash_map<int64_t, NodeResources> nodes_;
+  /// Index of nodes_ by available capacity. This must be updated whenever the
+  /// resources of a node change.
+  NodeCapacityIndex node_index_;
+  /// Available predefined resources of nodes_, used to check requests against all
+  /// nodes at once. This must be updated whenever the resources of a node change.
+  DenseResourceTable dense_nodes_;
+  /// Chooses among the nodes that can schedule a request with only hard constraints.
+  /// If null, the first node found is used.
+  std::shared_ptr<PlacementScorer> placement_scorer_;
   /// Identifier of local node.
   int64_t local_node_id_;
   /// Resources of local node.
@@ -77,6 +89,23 @@ class ClusterResourceScheduler {
   bool AllocateTaskResources(int64_t node_id, const TaskRequest &task_req,
                              std::shared_ptr<TaskResourceInstances> task_allocation);
 
+  /// Update the indexes of a node after its resources changed.
+  ///
+  /// \param node_id: ID of the node.
+  /// \param resources: The resources of the node.
+  void UpdateNodeIndex(int64_t node_id, const NodeResources &resources) {
+    node_index_.AddOrUpdateNode(node_id, resources);
+    dense_nodes_.AddOrUpdateNode(node_id, resources);
+  }
+
+  /// Check whether a node can satisfy the custom resource demands and the placement
+  /// hints of a request. The predefined resource demands are not checked.
+  ///
+  /// \return: -1 if a hard constraint is violated, and else the number of soft
+  ///     constraint violations.
+  int64_t CustomAndPlacementViolations(const TaskRequest &task_req, int64_t node_id,
+                                       const NodeResources &resources) const;
+
  public:
   ClusterResourceScheduler(void){};
 
@@ -142,6 +171,11 @@ class ClusterResourceScheduler {
   ///  soft constraints. Among these nodes, it returns a node which violates
   ///  the least number of soft constraints.
   ///
+  ///  If the request has only hard constraints, the nodes are looked up by
+  ///  available capacity rather than checked one by one. With a placement
+  ///  scorer, the scorer chooses among some of the nodes without violations
+  ///  other than the local node.
+  ///
   ///  Finally, if no such node exists, return -1.
   ///
   ///  \param task_request: Task to be scheduled.
@@ -166,6 +200,39 @@ class ClusterResourceScheduler {
       const std::unordered_map<std::string, double> &task_request, bool actor_creation,
       int64_t *violations);
 
+  /// Place tasks that all have the same resource request, as scheduling them one by
+  /// one with GetBestSchedulableNode and allocating the resources of the tasks placed
+  /// on remote nodes would. Unless there is a placement scorer, once a node without
+  /// violations is found, it gets tasks until it cannot satisfy one more, so that
+  /// placing many tasks takes one search per node used rather than one per task.
+  ///
+  /// The resources of the tasks placed on remote nodes are allocated. The ones of the
+  /// tasks placed on the local node are allocated when they are dispatched, so the
+  /// local node gets all the remaining tasks once it can schedule one.
+  ///
+  ///  \param task_request: Resource request of each task.
+  ///  \param actor_creation: True if the tasks are actor creation tasks.
+  ///  \param num_tasks: Number of tasks to place.
+  ///
+  ///  \return The nodes the tasks are placed on, with the number of tasks placed on
+  ///          each, in the order the tasks should be assigned. Fewer than num_tasks
+  ///          are placed if no node can schedule the remaining ones.
+  std::vector<std::pair<int64_t, int64_t>> ScheduleTaskBatch(
+      const TaskRequest &task_request, bool actor_creation, int64_t num_tasks);
+
+  /// Similar to the above, but with the IDs of the nodes in string format, and the
+  /// nodes the tasks should preferably run on as the placement hints of the request.
+  std::vector<std::pair<std::string, int64_t>> ScheduleTaskBatch(
+      const std::unordered_map<std::string, double> &task_request, bool actor_creation,
+      int64_t num_tasks, const std::vector<std::string> &placement_hints = {});
+
+  /// Set how to choose among the nodes that can schedule a request.
+  ///
+  /// \param placement_scorer: The scorer, or null to use the first node found.
+  void SetPlacementScorer(std::shared_ptr<PlacementScorer> placement_scorer) {
+    placement_scorer_ = std::move(placement_scorer);
+  }
+
   /// Decrease the available resources of a node when a task request is
   /// scheduled on the given node.
   ///
@@ -14,12 +14,14 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <chrono>
+#include <map>
 #include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ray/common/task/scheduling_ids.h"
 #include "ray/common/task/scheduling_resources.h"
-#include "ray/raylet/scheduling/scheduling_ids.h"
 
 #ifdef UNORDERED_VS_ABSL_MAPS_EVALUATION
 #include <chrono>
@@ -1057,6 +1059,382 @@ TEST_F(ClusterResourceSchedulerTest, HeartbeatTest) {
   }
 }
 
+/// Return a random request for nodes built by initCluster.
+TaskRequest randomTaskRequest(int num_nodes, bool with_soft_demands) {
+  TaskRequest task_req;
+  vector<FixedPoint> pred_demands;
+  vector<bool> pred_soft;
+  for (int k = 0; k < PredefinedResources_MAX; k++) {
+    pred_demands.push_back(rand() % 3 == 0 ? FixedPoint(0) : FixedPoint(rand() % 10));
+    pred_soft.push_back(with_soft_demands && rand() % 2 == 0);
+  }
+  vector<int64_t> cust_ids;
+  vector<FixedPoint> cust_demands;
+  vector<bool> cust_soft;
+  if (rand() % 2 == 0) {
+    cust_ids.push_back(rand() % num_nodes);
+    cust_demands.push_back(FixedPoint(rand() % 10 + 0.5));
+    cust_soft.push_back(with_soft_demands && rand() % 2 == 0);
+  }
+  initTaskRequest(task_req, pred_demands, pred_soft, cust_ids, cust_demands, cust_soft,
+                  EmptyIntVector);
+  return task_req;
+}
+
+/// Return a node with the resources of the nodes of a large cluster.
+NodeResources randomNodeResources(int num_nodes) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities;
+  for (int k = 0; k < PredefinedResources_MAX; k++) {
+    pred_capacities.push_back(rand() % 10);
+  }
+  vector<int64_t> cust_ids{rand() % num_nodes, rand() % num_nodes};
+  vector<FixedPoint> cust_capacities{rand() % 10, rand() % 10};
+  initNodeResources(node_resources, pred_capacities, cust_ids, cust_capacities);
+  return node_resources;
+}
+
+/// Return whether any node of the cluster can schedule a request, by checking each.
+bool anyNodeSchedulable(ClusterResourceScheduler &cluster_resources,
+                        const TaskRequest &task_req, int num_nodes) {
+  for (int i = 0; i < num_nodes; i++) {
+    NodeResources resources;
+    if (cluster_resources.GetNodeResources(i, &resources) &&
+        cluster_resources.IsSchedulable(task_req, i, resources) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST_F(ClusterResourceSchedulerTest, SchedulingIndexedSearchTest) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities{0};
+  initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler cluster_resources(0, node_resources);
+  int num_nodes = 200;
+  initCluster(cluster_resources, num_nodes);
+
+  for (int i = 0; i < 2000; i++) {
+    TaskRequest task_req = randomTaskRequest(num_nodes, false);
+    int64_t violations;
+    int64_t node_id =
+        cluster_resources.GetBestSchedulableNode(task_req, false, &violations);
+    ASSERT_EQ(node_id != -1, anyNodeSchedulable(cluster_resources, task_req, num_nodes));
+    if (node_id != -1) {
+      NodeResources resources;
+      ASSERT_TRUE(cluster_resources.GetNodeResources(node_id, &resources));
+      ASSERT_EQ(cluster_resources.IsSchedulable(task_req, node_id, resources), 0);
+      ASSERT_EQ(violations, 0);
+    }
+
+    // Change the available resources of the nodes as the tasks run and finish.
+    int other_node = rand() % num_nodes;
+    switch (rand() % 4) {
+    case 0:
+      if (node_id != -1) {
+        cluster_resources.SubtractNodeAvailableResources(node_id, task_req);
+      }
+      break;
+    case 1:
+      cluster_resources.AddNodeAvailableResources(other_node, task_req);
+      break;
+    case 2:
+      if (rand() % 10 == 0) {
+        cluster_resources.RemoveNode(other_node);
+      }
+      break;
+    default:
+      cluster_resources.SubtractNodeAvailableResources(other_node, task_req);
+    }
+  }
+}
+
+/// Benchmark of scheduling decisions on a large cluster. This is disabled as it only
+/// reports timings.
+TEST_F(ClusterResourceSchedulerTest, DISABLED_SchedulingPerfTest) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities{0};
+  initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler cluster_resources(0, node_resources);
+  int num_nodes = 10000;
+  // Unlike initCluster, give every node the same number of resources.
+  for (int i = 0; i < num_nodes; i++) {
+    cluster_resources.AddOrUpdateNode(i, randomNodeResources(num_nodes));
+  }
+  int num_requests = 10000;
+  vector<TaskRequest> task_reqs;
+  for (int i = 0; i < num_requests; i++) {
+    task_reqs.push_back(randomTaskRequest(num_nodes, false));
+  }
+
+  // A placement hint that matches no node makes the scheduler check every node.
+  vector<TaskRequest> hinted_task_reqs = task_reqs;
+  for (auto &task_req : hinted_task_reqs) {
+    task_req.placement_hints.insert(-1);
+  }
+
+  auto time_requests = [&cluster_resources](const vector<TaskRequest> &task_reqs,
+                                            int *scheduled) {
+    int64_t violations;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &task_req : task_reqs) {
+      if (cluster_resources.GetBestSchedulableNode(task_req, false, &violations) !=
+          -1) {
+        (*scheduled)++;
+      }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+               .count();
+  };
+  int scheduled = 0;
+  int scanned = 0;
+  auto indexed_ns = time_requests(task_reqs, &scheduled);
+  auto scan_ns = time_requests(hinted_task_reqs, &scanned);
+  ASSERT_EQ(scheduled, scanned);
+  RAY_LOG(INFO) << num_requests << " requests on " << num_nodes << " nodes, "
+                << scheduled << " schedulable: indexed search "
+                << indexed_ns / num_requests << "ns per request, linear search "
+                << scan_ns / num_requests << "ns per request";
+}
+
+TEST_F(ClusterResourceSchedulerTest, SchedulingSoftConstraintsTest) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities{0};
+  initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler cluster_resources(0, node_resources);
+  int num_nodes = 200;
+  initCluster(cluster_resources, num_nodes);
+
+  for (int i = 0; i < 2000; i++) {
+    TaskRequest task_req = randomTaskRequest(num_nodes, true);
+    // The node with the fewest violations, found by checking each node.
+    int64_t min_violations = -1;
+    for (int node_id = 0; node_id < num_nodes; node_id++) {
+      NodeResources resources;
+      if (!cluster_resources.GetNodeResources(node_id, &resources)) {
+        continue;
+      }
+      int64_t violations = cluster_resources.IsSchedulable(task_req, node_id, resources);
+      if (violations != -1 && (min_violations == -1 || violations < min_violations)) {
+        min_violations = violations;
+      }
+    }
+
+    int64_t violations;
+    int64_t node_id =
+        cluster_resources.GetBestSchedulableNode(task_req, false, &violations);
+    if (min_violations == -1) {
+      ASSERT_EQ(node_id, -1);
+      continue;
+    }
+    ASSERT_NE(node_id, -1);
+    ASSERT_EQ(violations, min_violations);
+    NodeResources resources;
+    ASSERT_TRUE(cluster_resources.GetNodeResources(node_id, &resources));
+    ASSERT_EQ(cluster_resources.IsSchedulable(task_req, node_id, resources),
+              min_violations);
+
+    if (rand() % 2 == 0) {
+      cluster_resources.SubtractNodeAvailableResources(node_id, task_req);
+    } else if (rand() % 10 == 0) {
+      cluster_resources.RemoveNode(rand() % num_nodes);
+    }
+  }
+}
+
+/// Benchmark of scheduling requests with soft demands, which check the predefined
+/// resources of all the nodes at once, against checking each node with IsSchedulable.
+/// This is disabled as it only reports timings.
+TEST_F(ClusterResourceSchedulerTest, DISABLED_SchedulingDenseResourcesPerfTest) {
+  NodeResources local_resources;
+  vector<FixedPoint> pred_capacities{0};
+  initNodeResources(local_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler cluster_resources(0, local_resources);
+  int num_nodes = 10000;
+  vector<NodeResources> nodes;
+  for (int i = 0; i < num_nodes; i++) {
+    nodes.push_back(randomNodeResources(num_nodes));
+    cluster_resources.AddOrUpdateNode(i + 1, nodes.back());
+  }
+  int num_requests = 10000;
+  vector<TaskRequest> task_reqs;
+  for (int i = 0; i < num_requests; i++) {
+    task_reqs.push_back(randomTaskRequest(num_nodes, true));
+  }
+
+  int64_t dense_total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &task_req : task_reqs) {
+    int64_t violations;
+    if (cluster_resources.GetBestSchedulableNode(task_req, false, &violations) != -1) {
+      dense_total += violations;
+    }
+  }
+  auto dense_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+  int64_t scalar_total = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto &task_req : task_reqs) {
+    int64_t min_violations = -1;
+    for (int i = 0; i < num_nodes; i++) {
+      int64_t violations = cluster_resources.IsSchedulable(task_req, i + 1, nodes[i]);
+      if (violations != -1 && (min_violations == -1 || violations < min_violations)) {
+        min_violations = violations;
+        if (violations == 0) {
+          break;
+        }
+      }
+    }
+    scalar_total += std::max<int64_t>(min_violations, 0);
+  }
+  auto scalar_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  ASSERT_EQ(dense_total, scalar_total);
+  RAY_LOG(INFO) << num_requests << " requests with soft demands on " << num_nodes
+                << " nodes: dense check " << dense_ns / num_requests
+                << "ns per request, per node check " << scalar_ns / num_requests
+                << "ns per request";
+}
+
+TEST_F(ClusterResourceSchedulerTest, ScheduleTaskBatchTest) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities{1};
+  initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler cluster_resources(0, node_resources);
+  for (int i = 1; i <= 3; i++) {
+    NodeResources node_resources;
+    vector<FixedPoint> pred_capacities{2 * i + 1};
+    initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                      EmptyFixedPointVector);
+    cluster_resources.AddOrUpdateNode(i, node_resources);
+  }
+
+  // Remote nodes get as many tasks as they can run.
+  TaskRequest task_req;
+  vector<FixedPoint> pred_demands{2};
+  vector<bool> pred_soft{false};
+  initTaskRequest(task_req, pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  auto placements = cluster_resources.ScheduleTaskBatch(task_req, false, 10);
+  std::map<int64_t, int64_t> tasks_per_node;
+  for (const auto &placement : placements) {
+    tasks_per_node[placement.first] += placement.second;
+  }
+  ASSERT_EQ(placements.size(), 3);
+  ASSERT_EQ(tasks_per_node, (std::map<int64_t, int64_t>{{1, 1}, {2, 2}, {3, 3}}));
+  int64_t violations;
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, false, &violations), -1);
+  ASSERT_TRUE(cluster_resources.ScheduleTaskBatch(task_req, false, 10).empty());
+
+  // The local node gets all the tasks, as their resources are allocated later.
+  TaskRequest small_task_req;
+  vector<FixedPoint> small_pred_demands{1};
+  initTaskRequest(small_task_req, small_pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  placements = cluster_resources.ScheduleTaskBatch(small_task_req, false, 10);
+  ASSERT_EQ(placements, (vector<std::pair<int64_t, int64_t>>{{0, 10}}));
+}
+
+TEST_F(ClusterResourceSchedulerTest, ScheduleTaskBatchMatchesOneByOneTest) {
+  for (int i = 0; i < 20; i++) {
+    TaskRequest task_req = randomTaskRequest(50, i % 2 == 0);
+    NodeResources node_resources;
+    vector<FixedPoint> pred_capacities{0};
+    initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                      EmptyFixedPointVector);
+    ClusterResourceScheduler batch(0, node_resources);
+    ClusterResourceScheduler one_by_one(0, node_resources);
+    int seed = rand();
+    srand(seed);
+    initCluster(batch, 50);
+    srand(seed);
+    initCluster(one_by_one, 50);
+
+    std::map<int64_t, int64_t> batch_tasks;
+    for (const auto &placement : batch.ScheduleTaskBatch(task_req, false, 100)) {
+      batch_tasks[placement.first] += placement.second;
+    }
+    std::map<int64_t, int64_t> one_by_one_tasks;
+    for (int task = 0; task < 100; task++) {
+      int64_t violations;
+      int64_t node_id = one_by_one.GetBestSchedulableNode(task_req, false, &violations);
+      if (node_id == -1) {
+        break;
+      }
+      if (node_id == 0) {
+        // The local node would be picked for all the remaining tasks.
+        one_by_one_tasks[node_id] += 100 - task;
+        break;
+      }
+      one_by_one.SubtractNodeAvailableResources(node_id, task_req);
+      one_by_one_tasks[node_id]++;
+    }
+    ASSERT_EQ(batch_tasks, one_by_one_tasks);
+  }
+}
+
+TEST_F(ClusterResourceSchedulerTest, PlacementHintsTest) {
+  ClusterResourceScheduler cluster_resources("local", {{"CPU", 4}});
+  cluster_resources.AddOrUpdateNode("remote1", {{"CPU", 4}}, {{"CPU", 4}});
+  cluster_resources.AddOrUpdateNode("remote2", {{"CPU", 4}}, {{"CPU", 4}});
+
+  // The tasks run on the hinted node while it has room, even though the local node
+  // could run them, and then on the local node.
+  auto placements = cluster_resources.ScheduleTaskBatch({{"CPU", 1}}, false, 6,
+                                                        {"remote2", "unknown"});
+  ASSERT_EQ(placements,
+            (vector<std::pair<std::string, int64_t>>{{"remote2", 4}, {"local", 2}}));
+
+  // Once the hinted node is full, the request is placed as if there were no hints.
+  cluster_resources.AddOrUpdateNode("local", {{"CPU", 4}}, {{"CPU", 0}});
+  placements = cluster_resources.ScheduleTaskBatch({{"CPU", 1}}, false, 2, {"remote2"});
+  ASSERT_EQ(placements, (vector<std::pair<std::string, int64_t>>{{"remote1", 2}}));
+  ASSERT_TRUE(
+      cluster_resources.ScheduleTaskBatch({{"CPU", 8}}, false, 1, {"remote2"}).empty());
+}
+
+TEST_F(ClusterResourceSchedulerTest, PlacementScorerTest) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities{0};
+  initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler cluster_resources(0, node_resources);
+  cluster_resources.SetPlacementScorer(PlacementScorer::Create("least_loaded", 0));
+  for (int i = 1; i <= 3; i++) {
+    NodeResources node_resources;
+    vector<FixedPoint> pred_capacities{8};
+    initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                      EmptyFixedPointVector);
+    node_resources.predefined_resources[CPU].available = 2 * i;
+    cluster_resources.AddOrUpdateNode(i, node_resources);
+  }
+
+  TaskRequest task_req;
+  vector<FixedPoint> pred_demands{1};
+  vector<bool> pred_soft{false};
+  initTaskRequest(task_req, pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  int64_t violations;
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, false, &violations), 3);
+
+  // The tasks of a batch are spread over the nodes instead of filling each node.
+  std::map<int64_t, int64_t> tasks_per_node;
+  for (const auto &placement : cluster_resources.ScheduleTaskBatch(task_req, false, 6)) {
+    tasks_per_node[placement.first] += placement.second;
+  }
+  ASSERT_EQ(tasks_per_node, (std::map<int64_t, int64_t>{{2, 2}, {3, 4}}));
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -1,5 +1,6 @@
 #include <google/protobuf/map.h>
 
+#include "ray/common/ray_config.h"
 #include "ray/raylet/scheduling/cluster_task_manager.h"
 #include "ray/util/logging.h"
 
@@ -22,48 +23,68 @@ bool ClusterTaskManager::SchedulePendingTasks() {
   for (auto shapes_it = tasks_to_schedule_.begin();
        shapes_it != tasks_to_schedule_.end();) {
     auto &work_queue = shapes_it->second;
-    for (auto work_it = work_queue.begin(); work_it != work_queue.end();) {
-      // Check every task in task_to_schedule queue to see
-      // whether it can be scheduled. This avoids head-of-line
-      // blocking where a task which cannot be scheduled because
-      // there are not enough available resources blocks other
-      // tasks from being scheduled.
-      Work work = *work_it;
-      Task task = std::get<0>(work);
-      auto request_resources =
-          task.GetTaskSpecification().GetRequiredResources().GetResourceMap();
-      int64_t _unused;
+    while (!work_queue.empty()) {
+      // All the tasks in this queue have the same resource request, so place them
+      // all at once instead of looking for a node for each of them. Only the tasks
+      // that create actors or the ones that do not are placed together, since empty
+      // actor creation requests are placed differently, and only the ones whose
+      // arguments are on the same nodes.
+      const auto &spec = std::get<0>(work_queue.front()).GetTaskSpecification();
+      bool actor_creation = spec.IsActorCreationTask();
+      uint64_t min_locality_bytes =
+          RayConfig::instance().locality_aware_scheduling_min_bytes();
+      auto preferred_nodes = spec.GetPreferredNodes(min_locality_bytes);
+      size_t num_tasks = 1;
+      while (num_tasks < work_queue.size()) {
+        const auto &next_spec = std::get<0>(work_queue[num_tasks]).GetTaskSpecification();
+        if (next_spec.IsActorCreationTask() != actor_creation ||
+            next_spec.GetPreferredNodes(min_locality_bytes) != preferred_nodes) {
+          break;
+        }
+        num_tasks++;
+      }
+      std::vector<std::string> placement_hints;
+      for (const auto &node_id : preferred_nodes) {
+        placement_hints.push_back(node_id.Binary());
+      }
+      auto request_resources = spec.GetRequiredResources().GetResourceMap();
       // TODO (Alex): We should distinguish between infeasible tasks and a fully
       // utilized cluster.
-      std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
-          request_resources, task.GetTaskSpecification().IsActorCreationTask(), &_unused);
-      if (node_id_string.empty()) {
-        // There is no node that has available resources to run the request.
-        // Move on to the next shape.
-        break;
-      } else {
+      auto placements = cluster_resource_scheduler_->ScheduleTaskBatch(
+          request_resources, actor_creation, num_tasks, placement_hints);
+      size_t num_placed = 0;
+      for (const auto &placement : placements) {
+        const std::string &node_id_string = placement.first;
+        num_placed += placement.second;
         if (node_id_string == self_node_id_.Binary()) {
-          // Warning: WaitForTaskArgsRequests must execute (do not let it short
-          // circuit if did_schedule is true).
-          bool task_scheduled = WaitForTaskArgsRequests(work);
-          did_schedule = task_scheduled || did_schedule;
+          for (int64_t i = 0; i < placement.second; i++) {
+            // Warning: WaitForTaskArgsRequests must execute (do not let it short
+            // circuit if did_schedule is true).
+            bool task_scheduled = WaitForTaskArgsRequests(work_queue.front());
+            did_schedule = task_scheduled || did_schedule;
+            work_queue.pop_front();
+          }
         } else {
-          // Should spill over to a different node.
-          cluster_resource_scheduler_->AllocateRemoteTaskResources(node_id_string,
-                                                                   request_resources);
-
+          // Should spill over to a different node. The resources of the tasks were
+          // allocated on that node when they were placed.
           NodeID node_id = NodeID::FromBinary(node_id_string);
           auto node_info_opt = get_node_info_(node_id);
-          // gcs_client_->Nodes().Get(node_id);
           RAY_CHECK(node_info_opt)
               << "Spilling back to a node manager, but no GCS info found for node "
               << node_id;
-          auto reply = std::get<1>(work);
-          auto callback = std::get<2>(work);
-          Spillback(node_id, node_info_opt->node_manager_address(),
-                    node_info_opt->node_manager_port(), reply, callback);
+          for (int64_t i = 0; i < placement.second; i++) {
+            const Work &work = work_queue.front();
+            Spillback(node_id, node_info_opt->node_manager_address(),
+                      node_info_opt->node_manager_port(), std::get<1>(work),
+                      std::get<2>(work));
+            work_queue.pop_front();
+          }
         }
-        work_it = work_queue.erase(work_it);
+      }
+      if (num_placed < num_tasks) {
+        // There is no node that has available resources to run the request.
+        // Move on to the next shape.
+        break;
       }
     }
     if (work_queue.empty()) {
@@ -21,12 +21,12 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/id.h"
+#include "ray/common/task/scheduling_ids.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/common/task/task.h"
 #include "ray/common/task/task_util.h"
 #include "ray/common/test_util.h"
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
-#include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/raylet/test/util.h"
 
 #ifdef UNORDERED_VS_ABSL_MAPS_EVALUATION
@@ -413,6 +413,44 @@ TEST_F(ClusterTaskManagerTest, HeartbeatTest) {
   }
 }
 
+TEST_F(ClusterTaskManagerTest, SpillbackBatchTest) {
+  /*
+    Test that the tasks of a scheduling class are spread over the nodes that can
+    run them, without looking up each node once per task.
+   */
+  NodeID remote_node_id = NodeID::FromRandom();
+  single_node_resource_scheduler_->AddOrUpdateNode(
+      remote_node_id.Binary(), {{ray::kCPU_ResourceLabel, 20}},
+      {{ray::kCPU_ResourceLabel, 20}});
+  rpc::GcsNodeInfo node_info;
+  node_info.set_node_manager_address("127.0.0.1");
+  node_info.set_node_manager_port(1234);
+  node_info_ = node_info;
+
+  int num_callbacks = 0;
+  int *num_callbacks_ptr = &num_callbacks;
+  auto callback = [num_callbacks_ptr]() {
+    (*num_callbacks_ptr) = *num_callbacks_ptr + 1;
+  };
+  // Only the remote node can run these tasks, and it can run two of them.
+  std::vector<rpc::RequestWorkerLeaseReply> replies(3);
+  for (auto &reply : replies) {
+    Task task = CreateTask({{ray::kCPU_ResourceLabel, 9}});
+    task_manager_.QueueTask(task, &reply, callback);
+  }
+  task_manager_.SchedulePendingTasks();
+
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(node_info_calls_, 1);
+  ASSERT_EQ(replies[0].retry_at_raylet_address().raylet_id(), remote_node_id.Binary());
+  ASSERT_EQ(replies[1].retry_at_raylet_address().raylet_id(), remote_node_id.Binary());
+  ASSERT_EQ(replies[2].retry_at_raylet_address().raylet_id(), "");
+
+  // The last task is still queued.
+  task_manager_.SchedulePendingTasks();
+  ASSERT_EQ(num_callbacks, 2);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
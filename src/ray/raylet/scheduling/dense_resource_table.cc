@@ -0,0 +1,102 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ray/raylet/scheduling/dense_resource_table.h"
+
+namespace ray {
+
+namespace {
+
+/// Added to the violations of a node for each hard demand it cannot satisfy. This is
+/// larger than any number of soft violations, so that all the demands can be counted
+/// without branches.
+const int64_t kHardViolation = int64_t(1) << 32;
+
+}  // namespace
+
+DenseTaskRequest::DenseTaskRequest(const TaskRequest &task_req) {
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    if (i < task_req.predefined_resources.size()) {
+      demands[i] = task_req.predefined_resources[i].demand;
+      soft[i] = task_req.predefined_resources[i].soft;
+    } else {
+      demands[i] = 0;
+      soft[i] = false;
+    }
+  }
+}
+
+void DenseResourceTable::AddOrUpdateNode(int64_t node_id,
+                                         const NodeResources &resources) {
+  auto it = positions_.find(node_id);
+  size_t position;
+  if (it == positions_.end()) {
+    position = node_ids_.size();
+    positions_.emplace(node_id, position);
+    node_ids_.push_back(node_id);
+    for (auto &available : available_) {
+      available.emplace_back(0);
+    }
+  } else {
+    position = it->second;
+  }
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    available_[i][position] = i < resources.predefined_resources.size()
+                                  ? resources.predefined_resources[i].available
+                                  : FixedPoint(0);
+  }
+}
+
+void DenseResourceTable::RemoveNode(int64_t node_id) {
+  auto it = positions_.find(node_id);
+  if (it == positions_.end()) {
+    return;
+  }
+  // Move the last node to the position of the removed one.
+  size_t position = it->second;
+  size_t last = node_ids_.size() - 1;
+  positions_.erase(it);
+  if (position != last) {
+    node_ids_[position] = node_ids_[last];
+    positions_[node_ids_[position]] = position;
+    for (auto &available : available_) {
+      available[position] = available[last];
+    }
+  }
+  node_ids_.pop_back();
+  for (auto &available : available_) {
+    available.pop_back();
+  }
+}
+
+void DenseResourceTable::PredefinedViolations(const DenseTaskRequest &task_req,
+                                              std::vector<int64_t> *violations) const {
+  size_t num_nodes = node_ids_.size();
+  violations->assign(num_nodes, 0);
+  int64_t *counts = violations->data();
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    const FixedPoint demand = task_req.demands[i];
+    const int64_t weight = task_req.soft[i] ? 1 : kHardViolation;
+    const FixedPoint *available = available_[i].data();
+    for (size_t node = 0; node < num_nodes; node++) {
+      counts[node] += (demand > available[node]) * weight;
+    }
+  }
+  for (size_t node = 0; node < num_nodes; node++) {
+    counts[node] = counts[node] >= kHardViolation ? -1 : counts[node];
+  }
+}
+
+}  // namespace ray
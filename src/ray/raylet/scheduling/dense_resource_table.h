@@ -0,0 +1,81 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "ray/raylet/scheduling/fixed_point.h"
+
+namespace ray {
+
+/// The predefined resource demands of a task request, with one lane per resource.
+struct DenseTaskRequest {
+  explicit DenseTaskRequest(const TaskRequest &task_req);
+
+  /// Demand of each predefined resource.
+  std::array<FixedPoint, PredefinedResources_MAX> demands;
+  /// Whether the demand of each predefined resource is soft.
+  std::array<bool, PredefinedResources_MAX> soft;
+};
+
+/// The available capacities of the predefined resources of the nodes of the cluster,
+/// stored with one contiguous vector per resource.
+///
+/// This allows checking the predefined demands of a request against every node with
+/// branch free loops over the nodes, which the compiler can vectorize, instead of
+/// checking the nodes one by one.
+class DenseResourceTable {
+ public:
+  /// Add a node, or update the capacities of a node that was added before.
+  ///
+  /// \param node_id: ID of the node.
+  /// \param resources: Up to date resources of the node.
+  void AddOrUpdateNode(int64_t node_id, const NodeResources &resources);
+
+  /// Remove a node. This does nothing if the node was not added. This changes the
+  /// position of the last node.
+  ///
+  /// \param node_id: ID of the node.
+  void RemoveNode(int64_t node_id);
+
+  /// Check the predefined demands of a request against every node.
+  ///
+  /// \param task_req: The demands of the request.
+  /// \param violations: Set to one entry per node, in the order of NodeId(). The entry
+  ///     is -1 if a hard demand exceeds the available capacity of the node, and else
+  ///     the number of soft demands that do.
+  void PredefinedViolations(const DenseTaskRequest &task_req,
+                            std::vector<int64_t> *violations) const;
+
+  /// Return the number of nodes in the table.
+  size_t NumNodes() const { return node_ids_.size(); }
+
+  /// Return the ID of the node at a position of the table.
+  int64_t NodeId(size_t position) const { return node_ids_[position]; }
+
+ private:
+  /// The position of each node.
+  absl::flat_hash_map<int64_t, size_t> positions_;
+  /// The node at each position.
+  std::vector<int64_t> node_ids_;
+  /// The available capacity of each predefined resource, indexed by position.
+  std::array<std::vector<FixedPoint>, PredefinedResources_MAX> available_;
+};
+
+}  // namespace ray
@@ -55,13 +55,6 @@ FixedPoint FixedPoint::operator=(double const d) {
   return *this;
 }
 
-bool FixedPoint::operator<(FixedPoint const &ru1) const { return (i_ < ru1.i_); };
-bool FixedPoint::operator>(FixedPoint const &ru1) const { return (i_ > ru1.i_); };
-bool FixedPoint::operator<=(FixedPoint const &ru1) const { return (i_ <= ru1.i_); };
-bool FixedPoint::operator>=(FixedPoint const &ru1) const { return (i_ >= ru1.i_); };
-bool FixedPoint::operator==(FixedPoint const &ru1) const { return (i_ == ru1.i_); };
-bool FixedPoint::operator!=(FixedPoint const &ru1) const { return (i_ != ru1.i_); };
-
 std::ostream &operator<<(std::ostream &out, FixedPoint const &ru1) {
   out << ru1.i_;
   return out;
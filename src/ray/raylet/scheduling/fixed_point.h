@@ -30,12 +30,14 @@ class FixedPoint {
 
   FixedPoint operator=(double const d);
 
-  bool operator<(FixedPoint const &ru1) const;
-  bool operator>(FixedPoint const &ru1) const;
-  bool operator<=(FixedPoint const &ru1) const;
-  bool operator>=(FixedPoint const &ru1) const;
-  bool operator==(FixedPoint const &ru1) const;
-  bool operator!=(FixedPoint const &ru1) const;
+  // The comparisons are inline so that loops comparing vectors of FixedPoint can be
+  // vectorized.
+  bool operator<(FixedPoint const &ru1) const { return (i_ < ru1.i_); }
+  bool operator>(FixedPoint const &ru1) const { return (i_ > ru1.i_); }
+  bool operator<=(FixedPoint const &ru1) const { return (i_ <= ru1.i_); }
+  bool operator>=(FixedPoint const &ru1) const { return (i_ >= ru1.i_); }
+  bool operator==(FixedPoint const &ru1) const { return (i_ == ru1.i_); }
+  bool operator!=(FixedPoint const &ru1) const { return (i_ != ru1.i_); }
 
   double Double() const;
 
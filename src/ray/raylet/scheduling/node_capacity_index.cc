@@ -0,0 +1,181 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_capacity_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ray {
+
+int NodeCapacityIndex::Bucket(FixedPoint capacity) {
+  if (capacity <= 0) {
+    return 0;
+  }
+  int exponent = static_cast<int>(std::floor(std::log2(capacity.Double())));
+  return std::min(std::max(exponent - kMinExponent + 1, 1), kNumBuckets - 1);
+}
+
+void NodeCapacityIndex::SetBit(Bitmap *bitmap, size_t slot, bool value) {
+  size_t word = slot / 64;
+  if (word >= bitmap->size()) {
+    if (!value) {
+      return;
+    }
+    bitmap->resize(word + 1, 0);
+  }
+  if (value) {
+    (*bitmap)[word] |= uint64_t(1) << (slot % 64);
+  } else {
+    (*bitmap)[word] &= ~(uint64_t(1) << (slot % 64));
+  }
+}
+
+void NodeCapacityIndex::MoveNode(ResourceIndex *index, size_t slot, int old_bucket,
+                                 int new_bucket) {
+  // The node is in the bitmaps of the buckets up to its own.
+  for (int bucket = old_bucket + 1; bucket <= new_bucket; bucket++) {
+    SetBit(&index->at_least[bucket], slot, true);
+  }
+  for (int bucket = new_bucket + 1; bucket <= old_bucket; bucket++) {
+    SetBit(&index->at_least[bucket], slot, false);
+  }
+}
+
+void NodeCapacityIndex::AddOrUpdateNode(int64_t node_id, const NodeResources &resources) {
+  auto it = slots_.find(node_id);
+  size_t slot;
+  if (it == slots_.end()) {
+    if (free_slots_.empty()) {
+      slot = entries_.size();
+      entries_.emplace_back();
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    slots_.emplace(node_id, slot);
+    entries_[slot].node_id = node_id;
+    entries_[slot].predefined_buckets.assign(PredefinedResources_MAX, kNoBucket);
+    SetBit(&used_slots_, slot, true);
+  } else {
+    slot = it->second;
+  }
+  NodeEntry &entry = entries_[slot];
+
+  predefined_.resize(PredefinedResources_MAX);
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    int bucket = i < resources.predefined_resources.size()
+                     ? Bucket(resources.predefined_resources[i].available)
+                     : kNoBucket;
+    MoveNode(&predefined_[i], slot, entry.predefined_buckets[i], bucket);
+    entry.predefined_buckets[i] = bucket;
+  }
+
+  // Remove the node from the resources it does not have anymore.
+  for (auto bucket = entry.custom_buckets.begin();
+       bucket != entry.custom_buckets.end();) {
+    if (resources.custom_resources.count(bucket->first) == 0) {
+      MoveNode(&custom_[bucket->first], slot, bucket->second, kNoBucket);
+      entry.custom_buckets.erase(bucket++);
+    } else {
+      bucket++;
+    }
+  }
+  for (const auto &resource : resources.custom_resources) {
+    auto bucket = entry.custom_buckets.emplace(resource.first, kNoBucket).first;
+    int new_bucket = Bucket(resource.second.available);
+    MoveNode(&custom_[resource.first], slot, bucket->second, new_bucket);
+    bucket->second = new_bucket;
+  }
+}
+
+void NodeCapacityIndex::RemoveNode(int64_t node_id) {
+  auto it = slots_.find(node_id);
+  if (it == slots_.end()) {
+    return;
+  }
+  size_t slot = it->second;
+  NodeEntry &entry = entries_[slot];
+  for (size_t i = 0; i < entry.predefined_buckets.size(); i++) {
+    MoveNode(&predefined_[i], slot, entry.predefined_buckets[i], kNoBucket);
+  }
+  for (const auto &bucket : entry.custom_buckets) {
+    MoveNode(&custom_[bucket.first], slot, bucket.second, kNoBucket);
+  }
+  entry.custom_buckets.clear();
+  SetBit(&used_slots_, slot, false);
+  free_slots_.push_back(slot);
+  slots_.erase(it);
+}
+
+int64_t NodeCapacityIndex::FindNode(const TaskRequest &task_req,
+                                    const std::function<bool(int64_t)> &accept,
+                                    uint64_t start) const {
+  // The bitmaps of the nodes that may satisfy each hard demand.
+  std::vector<const Bitmap *> bitmaps = {&used_slots_};
+  for (size_t i = 0; i < task_req.predefined_resources.size() && i < predefined_.size();
+       i++) {
+    const auto &request = task_req.predefined_resources[i];
+    if (!request.soft && request.demand > 0) {
+      bitmaps.push_back(&predefined_[i].at_least[Bucket(request.demand)]);
+    }
+  }
+  for (const auto &request : task_req.custom_resources) {
+    if (request.soft) {
+      continue;
+    }
+    auto it = custom_.find(request.id);
+    if (it == custom_.end()) {
+      // No node has the resource.
+      return -1;
+    }
+    bitmaps.push_back(&it->second.at_least[Bucket(request.demand)]);
+  }
+
+  size_t num_words = used_slots_.size();
+  for (const auto bitmap : bitmaps) {
+    num_words = std::min(num_words, bitmap->size());
+  }
+  if (num_words == 0) {
+    return -1;
+  }
+  // Visit the slots from the start slot to the end, and then from the beginning to the
+  // start slot. The word of the start slot is visited twice, once for each part.
+  size_t start_slot = start % (num_words * 64);
+  uint64_t after_start = ~uint64_t(0) << (start_slot % 64);
+  for (size_t i = 0; i <= num_words; i++) {
+    size_t word = (start_slot / 64 + i) % num_words;
+    uint64_t candidates = ~uint64_t(0);
+    if (i == 0) {
+      candidates = after_start;
+    } else if (i == num_words) {
+      candidates = ~after_start;
+    }
+    for (const auto bitmap : bitmaps) {
+      candidates &= (*bitmap)[word];
+    }
+    for (size_t bit = 0; candidates != 0; bit++, candidates >>= 1) {
+      if ((candidates & 1) == 0) {
+        continue;
+      }
+      int64_t node_id = entries_[word * 64 + bit].node_id;
+      if (accept(node_id)) {
+        return node_id;
+      }
+    }
+  }
+  return -1;
+}
+
+}  // namespace ray
@@ -0,0 +1,104 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "ray/raylet/scheduling/fixed_point.h"
+
+namespace ray {
+
+/// Index of the nodes of the cluster by the available capacity of their resources,
+/// used to find a node that can schedule a request without checking every node.
+///
+/// The available capacity of each resource of a node is bucketed by powers of two.
+/// For each resource and bucket, a bitmap holds the nodes whose capacity is in that
+/// bucket or a higher one. The nodes that may satisfy the hard demands of a request
+/// are then the AND of one bitmap per demanded resource. A node in the same bucket as
+/// a demand may still have less than the demand, so candidates must be checked.
+class NodeCapacityIndex {
+ public:
+  /// Add a node, or update the capacities of a node that was added before.
+  ///
+  /// \param node_id: ID of the node.
+  /// \param resources: Up to date resources of the node.
+  void AddOrUpdateNode(int64_t node_id, const NodeResources &resources);
+
+  /// Remove a node. This does nothing if the node was not added.
+  ///
+  /// \param node_id: ID of the node.
+  void RemoveNode(int64_t node_id);
+
+  /// Find a node that may satisfy the hard demands of a task request. Soft demands
+  /// and placement hints are ignored.
+  ///
+  /// \param task_req: Task request to be scheduled.
+  /// \param accept: Called with each candidate node until it returns true.
+  /// \param start: Where to start looking for candidates. Nodes are visited in the
+  ///     same order for the same start, and in a different order for other starts.
+  /// \return The node that was accepted, or -1 if none was.
+  int64_t FindNode(const TaskRequest &task_req,
+                   const std::function<bool(int64_t)> &accept,
+                   uint64_t start = 0) const;
+
+  /// Return the number of nodes in the index.
+  size_t NumNodes() const { return slots_.size(); }
+
+ private:
+  using Bitmap = std::vector<uint64_t>;
+
+  /// Buckets of a resource capacity. Bucket 0 holds capacities of 0, and bucket b > 0
+  /// holds capacities in [2^(b - 1 + kMinExponent), 2^(b + kMinExponent)), except for
+  /// the first and last ones, which also hold smaller and larger capacities.
+  static const int kNumBuckets = 64;
+  static const int kMinExponent = -14;
+  /// The bucket of a resource that a node does not have.
+  static const int kNoBucket = -1;
+
+  /// Return the bucket of a capacity.
+  static int Bucket(FixedPoint capacity);
+
+  /// The bitmaps of a resource, indexed by bucket.
+  struct ResourceIndex {
+    std::vector<Bitmap> at_least = std::vector<Bitmap>(kNumBuckets);
+  };
+
+  /// The buckets of the resources of a node.
+  struct NodeEntry {
+    int64_t node_id;
+    std::vector<int> predefined_buckets;
+    absl::flat_hash_map<int64_t, int> custom_buckets;
+  };
+
+  /// Move a node from a bucket of a resource to another.
+  void MoveNode(ResourceIndex *index, size_t slot, int old_bucket, int new_bucket);
+
+  static void SetBit(Bitmap *bitmap, size_t slot, bool value);
+
+  /// Each node has a slot, which is its bit in the bitmaps.
+  absl::flat_hash_map<int64_t, size_t> slots_;
+  std::vector<NodeEntry> entries_;
+  /// Slots of removed nodes, which are reused by the next nodes that are added.
+  std::vector<size_t> free_slots_;
+  /// The slots that hold a node.
+  Bitmap used_slots_;
+  std::vector<ResourceIndex> predefined_;
+  absl::flat_hash_map<int64_t, ResourceIndex> custom_;
+};
+
+}  // namespace ray
@@ -0,0 +1,148 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ray/raylet/scheduling/placement_scorer.h"
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+class RandomScorer : public PlacementScorer {
+ public:
+  explicit RandomScorer(uint64_t seed) : PlacementScorer(seed) {}
+
+  int64_t Pick(const std::vector<PlacementCandidate> &candidates) override {
+    return PickUniform(candidates.size());
+  }
+
+  size_t NumCandidates() const override { return 8; }
+};
+
+/// Weights the nodes by the number of tasks they can still run, so that a node with
+/// 12 times as many free cores as another gets 12 times as many tasks. If every node
+/// is full, the nodes are weighted by their total capacity instead.
+class CapacityWeightedScorer : public PlacementScorer {
+ public:
+  explicit CapacityWeightedScorer(uint64_t seed) : PlacementScorer(seed) {}
+
+  int64_t Pick(const std::vector<PlacementCandidate> &candidates) override {
+    std::vector<double> weights;
+    double total_weight = 0;
+    for (const auto &candidate : candidates) {
+      weights.push_back(std::max(candidate.free_slots, 0.0));
+      total_weight += weights.back();
+    }
+    if (total_weight <= 0) {
+      weights.clear();
+      for (const auto &candidate : candidates) {
+        weights.push_back(std::max(candidate.total_slots, 0.0));
+        total_weight += weights.back();
+      }
+    }
+    if (total_weight <= 0) {
+      return PickUniform(candidates.size());
+    }
+    std::discrete_distribution<int64_t> distribution(weights.begin(), weights.end());
+    return distribution(gen_);
+  }
+
+  size_t NumCandidates() const override { return 16; }
+};
+
+/// Picks the least loaded of two random nodes, which spreads the load almost as well
+/// as picking the least loaded node, without having to know the load of every node.
+/// The nodes are sampled in proportion to their total capacity, so that large nodes
+/// are compared as often as they should get tasks.
+class PowerOfTwoScorer : public PlacementScorer {
+ public:
+  explicit PowerOfTwoScorer(uint64_t seed) : PlacementScorer(seed) {}
+
+  int64_t Pick(const std::vector<PlacementCandidate> &candidates) override {
+    if (candidates.empty()) {
+      return -1;
+    }
+    std::vector<double> weights;
+    double total_weight = 0;
+    for (const auto &candidate : candidates) {
+      weights.push_back(std::max(candidate.total_slots, 0.0));
+      total_weight += weights.back();
+    }
+    int64_t first;
+    int64_t second;
+    if (total_weight > 0) {
+      std::discrete_distribution<int64_t> distribution(weights.begin(), weights.end());
+      first = distribution(gen_);
+      second = distribution(gen_);
+    } else {
+      first = PickUniform(candidates.size());
+      second = PickUniform(candidates.size());
+    }
+    return candidates[second].Load() < candidates[first].Load() ? second : first;
+  }
+
+  size_t NumCandidates() const override { return 8; }
+};
+
+class LeastLoadedScorer : public PlacementScorer {
+ public:
+  explicit LeastLoadedScorer(uint64_t seed) : PlacementScorer(seed) {}
+
+  int64_t Pick(const std::vector<PlacementCandidate> &candidates) override {
+    int64_t best = -1;
+    for (size_t i = 0; i < candidates.size(); i++) {
+      if (best == -1 || candidates[i].Load() < candidates[best].Load()) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  size_t NumCandidates() const override { return 16; }
+};
+
+}  // namespace
+
+std::unique_ptr<PlacementScorer> PlacementScorer::Create(const std::string &type,
+                                                         uint64_t seed) {
+  if (type.empty()) {
+    return nullptr;
+  } else if (type == "random") {
+    return std::unique_ptr<PlacementScorer>(new RandomScorer(seed));
+  } else if (type == "capacity_weighted") {
+    return std::unique_ptr<PlacementScorer>(new CapacityWeightedScorer(seed));
+  } else if (type == "power_of_two") {
+    return std::unique_ptr<PlacementScorer>(new PowerOfTwoScorer(seed));
+  } else if (type == "least_loaded") {
+    return std::unique_ptr<PlacementScorer>(new LeastLoadedScorer(seed));
+  }
+  RAY_LOG(FATAL) << "Unknown placement strategy " << type
+                 << ", expected one of random, capacity_weighted, power_of_two, "
+                 << "least_loaded";
+  return nullptr;
+}
+
+int64_t PlacementScorer::PickUniform(size_t num_candidates) {
+  if (num_candidates == 0) {
+    return -1;
+  }
+  std::uniform_int_distribution<int64_t> distribution(0, num_candidates - 1);
+  return distribution(gen_);
+}
+
+}  // namespace ray
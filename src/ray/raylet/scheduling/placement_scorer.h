@@ -0,0 +1,72 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ray {
+
+/// A node that can run a task, as seen by a PlacementScorer. The capacities are
+/// measured in tasks like the one being placed.
+struct PlacementCandidate {
+  /// The number of such tasks that the node can still run, which is negative if more
+  /// tasks were placed on the node than it can run.
+  double free_slots;
+  /// The number of such tasks that the node can run when it is idle.
+  double total_slots;
+
+  /// The fraction of the capacity of the node that is used. This can be more than 1.
+  double Load() const { return total_slots > 0 ? 1 - free_slots / total_slots : 1; }
+};
+
+/// Chooses the node to place a task on among the nodes that can run it.
+class PlacementScorer {
+ public:
+  virtual ~PlacementScorer() {}
+
+  /// Create a scorer of the given type.
+  ///
+  /// \param type One of "random" (uniformly at random), "capacity_weighted" (at random,
+  ///     weighted by free capacity), "power_of_two" (the least loaded of two random
+  ///     nodes) or "least_loaded". An empty type returns nullptr, which lets the
+  ///     schedulers use their default choice.
+  /// \param seed The seed of the random number generator.
+  static std::unique_ptr<PlacementScorer> Create(const std::string &type,
+                                                 uint64_t seed = std::random_device()());
+
+  /// Choose a node.
+  ///
+  /// \param candidates The nodes that can run the task.
+  /// \return The index of the chosen candidate, or -1 if there are none.
+  virtual int64_t Pick(const std::vector<PlacementCandidate> &candidates) = 0;
+
+  /// The number of candidates that the scorer needs to make a good choice. Schedulers
+  /// that cannot list every node cheaply may pass fewer candidates than exist.
+  virtual size_t NumCandidates() const = 0;
+
+ protected:
+  explicit PlacementScorer(uint64_t seed) : gen_(seed) {}
+
+  /// Return a candidate chosen uniformly at random.
+  int64_t PickUniform(size_t num_candidates);
+
+  std::mt19937_64 gen_;
+};
+
+}  // namespace ray
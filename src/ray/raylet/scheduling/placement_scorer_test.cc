@@ -0,0 +1,152 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "ray/raylet/scheduling/placement_scorer.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+const std::vector<std::string> kPlacementStrategies = {
+    "random", "capacity_weighted", "power_of_two", "least_loaded"};
+
+/// A task of a trace, which needs one core.
+struct TraceTask {
+  double arrival_time;
+  double duration;
+};
+
+/// Replay a trace of tasks on a cluster. Each task is placed when it arrives, on the
+/// node chosen by the scorer among all the nodes. Each node runs one task per core at
+/// a time, in the order the tasks were placed on it.
+///
+/// \return The makespan, i.e. the time the last task finishes at.
+double ReplayTrace(const std::vector<TraceTask> &trace, const std::vector<int> &cores,
+                   PlacementScorer *scorer) {
+  // The times the cores of each node become free at.
+  std::vector<std::priority_queue<double, std::vector<double>, std::greater<double>>>
+      free_cores(cores.size());
+  // The times the tasks placed on each node finish at.
+  std::vector<std::multiset<double>> finish_times(cores.size());
+  for (size_t node = 0; node < cores.size(); node++) {
+    for (int i = 0; i < cores[node]; i++) {
+      free_cores[node].push(0);
+    }
+  }
+
+  double makespan = 0;
+  for (const auto &task : trace) {
+    std::vector<PlacementCandidate> candidates;
+    for (size_t node = 0; node < cores.size(); node++) {
+      auto &finished = finish_times[node];
+      finished.erase(finished.begin(), finished.upper_bound(task.arrival_time));
+      candidates.push_back({static_cast<double>(cores[node]) - finished.size(),
+                            static_cast<double>(cores[node])});
+    }
+    int64_t node = scorer->Pick(candidates);
+    double start_time = std::max(task.arrival_time, free_cores[node].top());
+    free_cores[node].pop();
+    double finish_time = start_time + task.duration;
+    free_cores[node].push(finish_time);
+    finish_times[node].insert(finish_time);
+    makespan = std::max(makespan, finish_time);
+  }
+  return makespan;
+}
+
+TEST(PlacementScorerTest, TestCreate) {
+  ASSERT_EQ(PlacementScorer::Create(""), nullptr);
+  for (const auto &type : kPlacementStrategies) {
+    auto scorer = PlacementScorer::Create(type, 0);
+    ASSERT_NE(scorer, nullptr);
+    ASSERT_EQ(scorer->Pick({}), -1);
+    ASSERT_EQ(scorer->Pick({{1, 1}}), 0);
+  }
+}
+
+TEST(PlacementScorerTest, TestLeastLoaded) {
+  auto scorer = PlacementScorer::Create("least_loaded", 0);
+  // Loads of 0.5, 0.25 and 1.5.
+  ASSERT_EQ(scorer->Pick({{4, 8}, {72, 96}, {-4, 8}}), 1);
+}
+
+TEST(PlacementScorerTest, TestCapacityWeighted) {
+  auto scorer = PlacementScorer::Create("capacity_weighted", 0);
+  int picked_large = 0;
+  for (int i = 0; i < 10000; i++) {
+    picked_large += scorer->Pick({{8, 8}, {88, 96}});
+  }
+  ASSERT_NEAR(picked_large / 10000.0, 88.0 / 96, 0.02);
+  // Full nodes are weighted by their total capacity.
+  picked_large = 0;
+  for (int i = 0; i < 10000; i++) {
+    picked_large += scorer->Pick({{0, 8}, {-10, 24}});
+  }
+  ASSERT_NEAR(picked_large / 10000.0, 0.75, 0.02);
+}
+
+TEST(PlacementScorerTest, TestPowerOfTwo) {
+  auto scorer = PlacementScorer::Create("power_of_two", 0);
+  int picked_idle = 0;
+  for (int i = 0; i < 10000; i++) {
+    picked_idle += scorer->Pick({{0, 8}, {8, 8}});
+  }
+  // The loaded node is only picked if it is sampled twice.
+  ASSERT_NEAR(picked_idle / 10000.0, 0.75, 0.02);
+}
+
+TEST(PlacementScorerTest, TestHeterogeneousClusterMakespan) {
+  // Eight nodes with 8 cores and two with 96 cores, loaded at 90% of their capacity.
+  std::vector<int> cores(8, 8);
+  cores.push_back(96);
+  cores.push_back(96);
+  int total_cores = 8 * 8 + 2 * 96;
+  std::vector<TraceTask> trace;
+  std::mt19937_64 gen(0);
+  std::exponential_distribution<double> interval(0.9 * total_cores);
+  std::uniform_real_distribution<double> duration(0.5, 1.5);
+  double time = 0;
+  for (int i = 0; i < 20000; i++) {
+    time += interval(gen);
+    trace.push_back({time, duration(gen)});
+  }
+
+  std::map<std::string, double> makespans;
+  for (const auto &type : kPlacementStrategies) {
+    auto scorer = PlacementScorer::Create(type, 0);
+    makespans[type] = ReplayTrace(trace, cores, scorer.get());
+    RAY_LOG(INFO) << "Makespan with " << type << " placement: " << makespans[type]
+                  << "s, last arrival at " << time << "s";
+  }
+  // Picking nodes uniformly gives as many tasks to the small nodes as to the large
+  // ones, so the small nodes fall behind.
+  ASSERT_GT(makespans["random"], 2 * time);
+  for (const auto &type : {"capacity_weighted", "power_of_two", "least_loaded"}) {
+    ASSERT_LT(makespans[type], time + 10) << type;
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
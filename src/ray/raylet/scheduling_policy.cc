@@ -18,15 +18,65 @@
 #include <chrono>
 #include <random>
 
+#include "ray/common/ray_config.h"
 #include "ray/util/logging.h"
 
 namespace ray {
 
 namespace raylet {
 
+namespace {
+
+/// Return a node as a placement candidate for a resource demand. The resources used by
+/// the tasks placed on the node since its last heartbeat count as used.
+PlacementCandidate ToPlacementCandidate(const ResourceSet &resource_demand,
+                                        const SchedulingResources &node_resources) {
+  PlacementCandidate candidate{1, 1};
+  bool first = true;
+  for (const auto &demand : resource_demand.GetResourceAmounts()) {
+    double amount = demand.second.ToDouble();
+    if (amount <= 0) {
+      continue;
+    }
+    double available =
+        node_resources.GetAvailableResources().GetResource(demand.first).ToDouble() -
+        node_resources.GetLoadResources().GetResource(demand.first).ToDouble();
+    double total =
+        node_resources.GetTotalResources().GetResource(demand.first).ToDouble();
+    if (first || available / amount < candidate.free_slots) {
+      candidate.free_slots = available / amount;
+    }
+    if (first || total / amount < candidate.total_slots) {
+      candidate.total_slots = total / amount;
+    }
+    first = false;
+  }
+  return candidate;
+}
+
+}  // namespace
+
 SchedulingPolicy::SchedulingPolicy(const SchedulingQueue &scheduling_queue)
     : scheduling_queue_(scheduling_queue),
-      gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {}
+      gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
+      placement_scorer_(PlacementScorer::Create(
+          RayConfig::instance().scheduler_placement_strategy(), gen_())) {}
+
+const NodeID &SchedulingPolicy::PickNode(
+    const std::vector<NodeID> &client_keys, const ResourceSet &resource_demand,
+    const std::unordered_map<NodeID, SchedulingResources> &cluster_resources) {
+  if (placement_scorer_ == nullptr) {
+    // Initialize a uniform integer distribution over the key space.
+    std::uniform_int_distribution<int> distribution(0, client_keys.size() - 1);
+    return client_keys[distribution(gen_)];
+  }
+  std::vector<PlacementCandidate> candidates;
+  for (const auto &client_id : client_keys) {
+    candidates.push_back(
+        ToPlacementCandidate(resource_demand, cluster_resources.at(client_id)));
+  }
+  return client_keys[placement_scorer_->Pick(candidates)];
+}
 
 std::unordered_map<TaskID, NodeID> SchedulingPolicy::Schedule(
     std::unordered_map<NodeID, SchedulingResources> &cluster_resources,
@@ -53,7 +103,38 @@ std::unordered_map<TaskID, NodeID> SchedulingPolicy::Schedule(
     const auto &resource_demand = spec.GetRequiredPlacementResources();
     const TaskID &task_id = spec.TaskId();
 
-    // Try to place tasks locally first.
+    // Try to place tasks on the nodes that hold most of their arguments first. These
+    // nodes hold the same number of argument bytes, so the local node is tried first
+    // among them, like in ClusterResourceScheduler::GetBestSchedulableNode.
+    NodeID preferred_client_id = NodeID::Nil();
+    auto preferred_nodes = spec.GetPreferredNodes(
+        RayConfig::instance().locality_aware_scheduling_min_bytes());
+    auto local_it =
+        std::find(preferred_nodes.begin(), preferred_nodes.end(), local_client_id);
+    if (local_it != preferred_nodes.end()) {
+      std::iter_swap(preferred_nodes.begin(), local_it);
+    }
+    for (const auto &node_id : preferred_nodes) {
+      auto it = cluster_resources.find(node_id);
+      if (it == cluster_resources.end()) {
+        continue;
+      }
+      ResourceSet available_node_resources(it->second.GetAvailableResources());
+      available_node_resources.SubtractResources(it->second.GetLoadResources());
+      if (resource_demand.IsSubset(available_node_resources)) {
+        preferred_client_id = node_id;
+        break;
+      }
+    }
+    if (!preferred_client_id.IsNil()) {
+      decision[task_id] = preferred_client_id;
+      ResourceSet new_load(cluster_resources[preferred_client_id].GetLoadResources());
+      new_load.AddResources(resource_demand);
+      cluster_resources[preferred_client_id].SetLoadResources(std::move(new_load));
+      continue;
+    }
+
+    // Then try to place tasks locally.
     const auto &local_resources = cluster_resources[local_client_id];
     ResourceSet available_local_resources =
         ResourceSet(local_resources.GetAvailableResources());
@@ -97,12 +178,8 @@ std::unordered_map<TaskID, NodeID> SchedulingPolicy::Schedule(
     }
 
     if (!client_keys.empty()) {
-      // Choose index at random.
-      // Initialize a uniform integer distribution over the key space.
-      // TODO(atumanov): change uniform random to discrete, weighted by resource capacity.
-      std::uniform_int_distribution<int> distribution(0, client_keys.size() - 1);
-      int client_key_index = distribution(gen_);
-      const NodeID &dst_client_id = client_keys[client_key_index];
+      const NodeID &dst_client_id =
+          PickNode(client_keys, resource_demand, cluster_resources);
       decision[task_id] = dst_client_id;
       // Update dst_client_id's load to keep track of remote task load until
       // the next heartbeat.
@@ -122,13 +199,8 @@ std::unordered_map<TaskID, NodeID> SchedulingPolicy::Schedule(
       }
       // client candidate list constructed, pick randomly.
       if (!client_keys.empty()) {
-        // Choose index at random.
-        // Initialize a uniform integer distribution over the key space.
-        // TODO(atumanov): change uniform random to discrete, weighted by resource
-        // capacity.
-        std::uniform_int_distribution<int> distribution(0, client_keys.size() - 1);
-        int client_key_index = distribution(gen_);
-        const NodeID &dst_client_id = client_keys[client_key_index];
+        const NodeID &dst_client_id =
+            PickNode(client_keys, resource_demand, cluster_resources);
         decision[task_id] = dst_client_id;
         // Update dst_client_id's load to keep track of remote task load until
         // the next heartbeat.
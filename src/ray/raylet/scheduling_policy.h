@@ -19,6 +19,7 @@
 
 #include "ray/common/bundle_spec.h"
 #include "ray/common/task/scheduling_resources.h"
+#include "ray/raylet/scheduling/placement_scorer.h"
 #include "ray/raylet/scheduling_queue.h"
 
 namespace ray {
@@ -83,10 +84,23 @@ class SchedulingPolicy {
   virtual ~SchedulingPolicy();
 
  private:
+  /// Choose the node to place a task on.
+  ///
+  /// \param client_keys The nodes that can run the task.
+  /// \param resource_demand The resources the task needs to be placed.
+  /// \param cluster_resources The resources and load of the nodes.
+  /// \return One of client_keys.
+  const NodeID &PickNode(
+      const std::vector<NodeID> &client_keys, const ResourceSet &resource_demand,
+      const std::unordered_map<NodeID, SchedulingResources> &cluster_resources);
+
   /// An immutable reference to the scheduling task queues.
   const SchedulingQueue &scheduling_queue_;
   /// Internally maintained random number generator.
   std::mt19937_64 gen_;
+  /// Chooses among the nodes that can run a task. If null, a node is chosen
+  /// uniformly at random.
+  std::unique_ptr<PlacementScorer> placement_scorer_;
 };
 
 }  // namespace raylet
@@ -63,10 +63,54 @@ namespace ray {
 
 namespace raylet {
 
+int64_t TaskList::Append(const Task &task) {
+  int64_t slot;
+  if (free_slots_.empty()) {
+    slot = slots_.size();
+    slots_.push_back(Slot{task, tail_, kNoSlot});
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    slots_[slot] = Slot{task, tail_, kNoSlot};
+  }
+  if (tail_ == kNoSlot) {
+    head_ = slot;
+  } else {
+    slots_[tail_].next = slot;
+  }
+  tail_ = slot;
+  size_++;
+  return slot;
+}
+
+Task TaskList::Remove(int64_t slot) {
+  auto &entry = slots_[slot];
+  if (entry.prev == kNoSlot) {
+    head_ = entry.next;
+  } else {
+    slots_[entry.prev].next = entry.next;
+  }
+  if (entry.next == kNoSlot) {
+    tail_ = entry.prev;
+  } else {
+    slots_[entry.next].prev = entry.prev;
+  }
+  // The slot keeps the moved-from task until it is reused.
+  Task task = std::move(entry.task);
+  size_--;
+  if (size_ == 0) {
+    // Release the memory of a backlog that was drained.
+    std::deque<Slot>().swap(slots_);
+    std::vector<int64_t>().swap(free_slots_);
+  } else {
+    free_slots_.push_back(slot);
+  }
+  return task;
+}
+
 bool TaskQueue::AppendTask(const TaskID &task_id, const Task &task) {
   RAY_CHECK(task_map_.find(task_id) == task_map_.end());
-  auto list_iterator = task_list_.insert(task_list_.end(), task);
-  task_map_[task_id] = list_iterator;
+  task_map_[task_id] = task_list_.Append(task);
   // Resource bookkeeping
   total_resource_load_.AddResources(task.GetTaskSpecification().GetRequiredResources());
   const auto &scheduling_class = task.GetTaskSpecification().GetSchedulingClass();
@@ -86,24 +130,25 @@ bool TaskQueue::RemoveTask(const TaskID &task_id, std::vector<Task> *removed_tas
     return false;
   }
 
-  auto it = task_found_iterator->second;
+  auto slot = task_found_iterator->second;
+  const auto &task = task_list_.Get(slot);
   // Resource bookkeeping
   total_resource_load_.SubtractResourcesStrict(
-      it->GetTaskSpecification().GetRequiredResources());
-  auto scheduling_class = it->GetTaskSpecification().GetSchedulingClass();
+      task.GetTaskSpecification().GetRequiredResources());
+  auto scheduling_class = task.GetTaskSpecification().GetSchedulingClass();
   resource_load_by_shape_[scheduling_class]--;
   if (resource_load_by_shape_[scheduling_class] == 0) {
     resource_load_by_shape_.erase(scheduling_class);
   }
-  request_backlog_by_shape_[scheduling_class] -= it->BacklogSize();
+  request_backlog_by_shape_[scheduling_class] -= task.BacklogSize();
   if (request_backlog_by_shape_[scheduling_class] <= 0) {
     request_backlog_by_shape_.erase(scheduling_class);
   }
+  task_map_.erase(task_found_iterator);
+  auto removed_task = task_list_.Remove(slot);
   if (removed_tasks) {
-    removed_tasks->push_back(std::move(*it));
+    removed_tasks->push_back(std::move(removed_task));
   }
-  task_map_.erase(task_found_iterator);
-  task_list_.erase(it);
   return true;
 }
 
@@ -111,12 +156,12 @@ bool TaskQueue::HasTask(const TaskID &task_id) const {
   return task_map_.find(task_id) != task_map_.end();
 }
 
-const std::list<Task> &TaskQueue::GetTasks() const { return task_list_; }
+const TaskList &TaskQueue::GetTasks() const { return task_list_; }
 
 const Task &TaskQueue::GetTask(const TaskID &task_id) const {
   auto it = task_map_.find(task_id);
   RAY_CHECK(it != task_map_.end());
-  return *it->second;
+  return task_list_.Get(it->second);
 }
 
 const ResourceSet &TaskQueue::GetTotalResourceLoad() const {
@@ -140,9 +185,10 @@ bool ReadyQueue::AppendTask(const TaskID &task_id, const Task &task) {
 }
 
 bool ReadyQueue::RemoveTask(const TaskID &task_id, std::vector<Task> *removed_tasks) {
-  if (task_map_.find(task_id) != task_map_.end()) {
+  auto it = task_map_.find(task_id);
+  if (it != task_map_.end()) {
     const auto &scheduling_class =
-        task_map_[task_id]->GetTaskSpecification().GetSchedulingClass();
+        task_list_.Get(it->second).GetTaskSpecification().GetSchedulingClass();
     tasks_by_class_[scheduling_class].erase(task_id);
   }
   return TaskQueue::RemoveTask(task_id, removed_tasks);
@@ -153,7 +199,7 @@ const std::unordered_map<SchedulingClass, ordered_set<TaskID>>
   return tasks_by_class_;
 }
 
-const std::list<Task> &SchedulingQueue::GetTasks(TaskState task_state) const {
+const TaskList &SchedulingQueue::GetTasks(TaskState task_state) const {
   const auto &queue = GetTaskQueue(task_state);
   return queue->GetTasks();
 }
@@ -177,18 +223,46 @@ ResourceSet SchedulingQueue::GetTotalResourceLoad() const {
   return load;
 }
 
+const SchedulingQueue::ResourceShape &SchedulingQueue::GetResourceShape(
+    SchedulingClass scheduling_class) const {
+  auto it = resource_shapes_.find(scheduling_class);
+  if (it == resource_shapes_.end()) {
+    it = resource_shapes_.emplace(scheduling_class, ResourceShape()).first;
+    const auto &descriptor =
+        TaskSpecification::GetSchedulingClassDescriptor(scheduling_class);
+    for (const auto &resource_pair : descriptor.GetResourceMap()) {
+      it->second[resource_pair.first] = resource_pair.second;
+    }
+  }
+  return it->second;
+}
+
 rpc::ResourceLoad SchedulingQueue::GetResourceLoadByShape(
     int64_t max_shapes, bool report_worker_backlog) const {
-  std::unordered_map<SchedulingClass, rpc::ResourceDemand> load;
-  auto infeasible_queue_load =
+  const auto &infeasible_queue_load =
       task_queues_[static_cast<int>(TaskState::INFEASIBLE)]->GetResourceLoadByShape();
-  auto ready_queue_load = ready_queue_->GetResourceLoadByShape();
-  auto backlog_size_load = ready_queue_->GetRequestBacklogByShape();
+  const auto &ready_queue_load = ready_queue_->GetResourceLoadByShape();
+  const auto &backlog_size_load = ready_queue_->GetRequestBacklogByShape();
   size_t max_shapes_to_add = ready_queue_load.size() + infeasible_queue_load.size();
   if (max_shapes >= 0) {
     max_shapes_to_add = max_shapes;
   }
 
+  // The demands are built in place, in the order in which their shapes are first
+  // added. The per-shape counts are kept up to date by the task queues, and the shapes
+  // are cached, so this only depends on the number of shapes.
+  rpc::ResourceLoad load_proto;
+  std::unordered_map<SchedulingClass, rpc::ResourceDemand *> load;
+  auto get_demand = [this, &load, &load_proto](SchedulingClass scheduling_class) {
+    auto it = load.find(scheduling_class);
+    if (it == load.end()) {
+      auto demand = load_proto.add_resource_demands();
+      *demand->mutable_shape() = GetResourceShape(scheduling_class);
+      it = load.emplace(scheduling_class, demand).first;
+    }
+    return it->second;
+  };
+
   // Always collect the 1-CPU resource shape stats, if the specified max shapes
   // allows.
   static const ResourceSet one_cpu_resource_set(
@@ -196,18 +270,19 @@ rpc::ResourceLoad SchedulingQueue::GetResourceLoadByShape(
   static const SchedulingClass one_cpu_scheduling_cls(
       TaskSpecification::GetSchedulingClass(one_cpu_resource_set));
   if (max_shapes_to_add > 0) {
-    if (infeasible_queue_load.count(one_cpu_scheduling_cls) > 0) {
-      load[one_cpu_scheduling_cls].set_num_infeasible_requests_queued(
-          infeasible_queue_load.at(one_cpu_scheduling_cls));
+    auto infeasible_it = infeasible_queue_load.find(one_cpu_scheduling_cls);
+    if (infeasible_it != infeasible_queue_load.end()) {
+      get_demand(one_cpu_scheduling_cls)
+          ->set_num_infeasible_requests_queued(infeasible_it->second);
     }
-    if (ready_queue_load.count(one_cpu_scheduling_cls) > 0) {
-      load[one_cpu_scheduling_cls].set_num_ready_requests_queued(
-          ready_queue_load.at(one_cpu_scheduling_cls));
+    auto ready_it = ready_queue_load.find(one_cpu_scheduling_cls);
+    if (ready_it != ready_queue_load.end()) {
+      get_demand(one_cpu_scheduling_cls)->set_num_ready_requests_queued(ready_it->second);
     }
     if (report_worker_backlog) {
-      if (backlog_size_load.count(one_cpu_scheduling_cls) > 0) {
-        load[one_cpu_scheduling_cls].set_backlog_size(
-            backlog_size_load.at(one_cpu_scheduling_cls));
+      auto backlog_it = backlog_size_load.find(one_cpu_scheduling_cls);
+      if (backlog_it != backlog_size_load.end()) {
+        get_demand(one_cpu_scheduling_cls)->set_backlog_size(backlog_it->second);
       }
     }
   }
@@ -216,14 +291,15 @@ rpc::ResourceLoad SchedulingQueue::GetResourceLoadByShape(
   auto infeasible_it = infeasible_queue_load.begin();
   while (infeasible_it != infeasible_queue_load.end() &&
          load.size() < max_shapes_to_add) {
-    load[infeasible_it->first].set_num_infeasible_requests_queued(infeasible_it->second);
+    get_demand(infeasible_it->first)
+        ->set_num_infeasible_requests_queued(infeasible_it->second);
     infeasible_it++;
   }
 
   // Collect the ready queue's load.
   auto ready_it = ready_queue_load.begin();
   while (ready_it != ready_queue_load.end() && load.size() < max_shapes_to_add) {
-    load[ready_it->first].set_num_ready_requests_queued(ready_it->second);
+    get_demand(ready_it->first)->set_num_ready_requests_queued(ready_it->second);
     ready_it++;
   }
 
@@ -231,23 +307,11 @@ rpc::ResourceLoad SchedulingQueue::GetResourceLoadByShape(
     // Collect the backlog size.
     auto backlog_it = backlog_size_load.begin();
     while (backlog_it != backlog_size_load.end() && load.size() < max_shapes_to_add) {
-      load[backlog_it->first].set_backlog_size(backlog_it->second);
+      get_demand(backlog_it->first)->set_backlog_size(backlog_it->second);
       backlog_it++;
     }
   }
 
-  // Set the resource shapes.
-  rpc::ResourceLoad load_proto;
-  for (auto &demand : load) {
-    auto demand_proto = load_proto.add_resource_demands();
-    demand_proto->Swap(&demand.second);
-    const auto &resource_map =
-        TaskSpecification::GetSchedulingClassDescriptor(demand.first).GetResourceMap();
-    for (const auto &resource_pair : resource_map) {
-      (*demand_proto->mutable_shape())[resource_pair.first] = resource_pair.second;
-    }
-  }
-
   return load_proto;
 }
 
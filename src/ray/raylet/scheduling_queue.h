@@ -15,7 +15,8 @@
 #pragma once
 
 #include <array>
-#include <list>
+#include <deque>
+#include <iterator>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -58,6 +59,82 @@ enum class TaskState {
   DRIVER,
 };
 
+/// The tasks of a task queue, in the order in which they were added.
+///
+/// Tasks are stored in the slots of a pool that grows by chunks, and are linked
+/// through the indices of their slots. The slots of removed tasks are reused, so that
+/// moving tasks between queues does not allocate, and a task stays at the same address
+/// until it is removed.
+class TaskList {
+ private:
+  static const int64_t kNoSlot = -1;
+
+  struct Slot {
+    Task task;
+    int64_t prev = kNoSlot;
+    int64_t next = kNoSlot;
+  };
+
+ public:
+  /// Iterates over the tasks in the order in which they were added.
+  class ConstIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Task;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Task *;
+    using reference = const Task &;
+
+    ConstIterator(const std::deque<Slot> *slots, int64_t slot)
+        : slots_(slots), slot_(slot) {}
+
+    const Task &operator*() const { return (*slots_)[slot_].task; }
+    const Task *operator->() const { return &(*slots_)[slot_].task; }
+    ConstIterator &operator++() {
+      slot_ = (*slots_)[slot_].next;
+      return *this;
+    }
+    bool operator==(const ConstIterator &other) const { return slot_ == other.slot_; }
+    bool operator!=(const ConstIterator &other) const { return slot_ != other.slot_; }
+
+   private:
+    const std::deque<Slot> *slots_;
+    int64_t slot_;
+  };
+
+  /// Append a task.
+  ///
+  /// \param task The task to append.
+  /// \return The slot of the task, which identifies it until it is removed.
+  int64_t Append(const Task &task);
+
+  /// Remove a task.
+  ///
+  /// \param slot The slot of the task, as returned by Append.
+  /// \return The task that was removed.
+  Task Remove(int64_t slot);
+
+  /// Get a task.
+  ///
+  /// \param slot The slot of the task, as returned by Append.
+  /// \return The task.
+  const Task &Get(int64_t slot) const { return slots_[slot].task; }
+
+  ConstIterator begin() const { return ConstIterator(&slots_, head_); }
+  ConstIterator end() const { return ConstIterator(&slots_, kNoSlot); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  /// The slots of the tasks, and of the tasks that were removed.
+  std::deque<Slot> slots_;
+  /// The slots of the tasks that were removed, which are reused first.
+  std::vector<int64_t> free_slots_;
+  int64_t head_ = kNoSlot;
+  int64_t tail_ = kNoSlot;
+  size_t size_ = 0;
+};
+
 class TaskQueue {
  public:
   /// TaskQueue destructor.
@@ -89,7 +166,7 @@ class TaskQueue {
   /// \brief Return the task list of the queue.
   ///
   /// \return A list of tasks contained in this queue.
-  const std::list<Task> &GetTasks() const;
+  const TaskList &GetTasks() const;
 
   /// Get a task from the queue. The caller must ensure that the task is in
   /// the queue.
@@ -116,9 +193,9 @@ class TaskQueue {
 
  protected:
   /// A list of tasks.
-  std::list<Task> task_list_;
-  /// A hash to speed up looking up a task.
-  std::unordered_map<TaskID, std::list<Task>::iterator> task_map_;
+  TaskList task_list_;
+  /// A hash to speed up looking up a task. This maps a task to its slot in the list.
+  std::unordered_map<TaskID, int64_t> task_map_;
   /// Aggregate resources of all the tasks in this queue.
   ResourceSet total_resource_load_;
   /// Required resources for all the tasks in this queue. This is a
@@ -200,7 +277,7 @@ class SchedulingQueue {
   ///
   /// \param task_state The requested task state. This must correspond to one
   /// of the task queues (has value < TaskState::kNumTaskQueues).
-  const std::list<Task> &GetTasks(TaskState task_state) const;
+  const TaskList &GetTasks(TaskState task_state) const;
 
   /// Get a reference to the queue of ready tasks.
   ///
@@ -335,6 +412,8 @@ class SchedulingQueue {
   void RecordMetrics() const;
 
  private:
+  using ResourceShape = google::protobuf::Map<std::string, double>;
+
   /// Get the task queue in the given state. The requested task state must
   /// correspond to one of the task queues (has value <
   /// TaskState::kNumTaskQueues).
@@ -353,6 +432,12 @@ class SchedulingQueue {
   void FilterStateFromQueue(std::unordered_set<ray::TaskID> &task_ids,
                             TaskState task_state) const;
 
+  /// Get the shape of a scheduling class, as reported in resource loads.
+  ///
+  /// \param scheduling_class The scheduling class.
+  /// \return The resources required by the tasks of the class.
+  const ResourceShape &GetResourceShape(SchedulingClass scheduling_class) const;
+
   // A pointer to the ready queue.
   const std::shared_ptr<ReadyQueue> ready_queue_;
   /// Track the breakdown of tasks by class in the RUNNING queue.
@@ -367,6 +452,9 @@ class SchedulingQueue {
   /// The set of currently running driver tasks. These are empty tasks that are
   /// started by a driver process on initialization.
   std::unordered_set<TaskID> driver_task_ids_;
+  /// The shapes of the scheduling classes that were reported in resource loads. The
+  /// descriptor of a class never changes, so its shape is only computed once.
+  mutable std::unordered_map<SchedulingClass, ResourceShape> resource_shapes_;
 };
 
 }  // namespace raylet
@@ -0,0 +1,167 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling_queue.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+Task CreateTask(const std::unordered_map<std::string, double> &required_resources,
+                int64_t backlog_size = -1) {
+  rpc::Task message;
+  auto spec = message.mutable_task_spec();
+  spec->set_task_id(TaskID::ForFakeTask().Binary());
+  for (const auto &resource : required_resources) {
+    (*spec->mutable_required_resources())[resource.first] = resource.second;
+  }
+  return Task(message, backlog_size);
+}
+
+TaskID GetTaskId(const Task &task) { return task.GetTaskSpecification().TaskId(); }
+
+TEST(SchedulingQueueTest, TestTaskList) {
+  TaskList task_list;
+  std::vector<Task> tasks;
+  std::vector<int64_t> slots;
+  for (int i = 0; i < 5; i++) {
+    tasks.push_back(CreateTask({{"CPU", 1}}));
+    slots.push_back(task_list.Append(tasks.back()));
+  }
+  const Task &last = task_list.Get(slots[4]);
+  ASSERT_EQ(GetTaskId(task_list.Remove(slots[0])), GetTaskId(tasks[0]));
+  ASSERT_EQ(GetTaskId(task_list.Remove(slots[2])), GetTaskId(tasks[2]));
+
+  // The slots of removed tasks are reused, and the other tasks do not move.
+  tasks.push_back(CreateTask({{"CPU", 1}}));
+  slots.push_back(task_list.Append(tasks.back()));
+  ASSERT_TRUE(slots.back() == slots[0] || slots.back() == slots[2]);
+  ASSERT_EQ(&last, &task_list.Get(slots[4]));
+
+  // Tasks are iterated in the order in which they were added.
+  std::vector<TaskID> task_ids;
+  for (const auto &task : task_list) {
+    task_ids.push_back(GetTaskId(task));
+  }
+  ASSERT_EQ(task_ids, std::vector<TaskID>({GetTaskId(tasks[1]), GetTaskId(tasks[3]),
+                                           GetTaskId(tasks[4]), GetTaskId(tasks[5])}));
+  ASSERT_EQ(task_list.size(), 4);
+
+  for (int i : {1, 3, 4, 5}) {
+    task_list.Remove(slots[i]);
+  }
+  ASSERT_TRUE(task_list.empty());
+  ASSERT_TRUE(task_list.begin() == task_list.end());
+}
+
+TEST(SchedulingQueueTest, TestResourceLoadByShape) {
+  SchedulingQueue queue;
+  std::vector<Task> ready_tasks = {CreateTask({{"CPU", 1}}, 3), CreateTask({{"CPU", 1}}),
+                                   CreateTask({{"GPU", 1}}, 2)};
+  std::vector<Task> infeasible_tasks = {CreateTask({{"CPU", 1}}),
+                                        CreateTask({{"custom", 2}})};
+  queue.QueueTasks(ready_tasks, TaskState::READY);
+  queue.QueueTasks(infeasible_tasks, TaskState::INFEASIBLE);
+  ASSERT_EQ(queue.GetTotalResourceLoad(),
+            ResourceSet({"CPU", "GPU", "custom"}, {3, 1, 2}));
+
+  auto load = queue.GetResourceLoadByShape();
+  ASSERT_EQ(load.resource_demands_size(), 3);
+  // The 1-CPU shape is reported first.
+  const auto &cpu_demand = load.resource_demands(0);
+  ASSERT_EQ(cpu_demand.shape().size(), 1);
+  ASSERT_EQ(cpu_demand.shape().at("CPU"), 1);
+  ASSERT_EQ(cpu_demand.num_ready_requests_queued(), 2);
+  ASSERT_EQ(cpu_demand.num_infeasible_requests_queued(), 1);
+  ASSERT_EQ(cpu_demand.backlog_size(), 3);
+  for (int i = 1; i < 3; i++) {
+    const auto &demand = load.resource_demands(i);
+    if (demand.shape().count("GPU")) {
+      ASSERT_EQ(demand.num_ready_requests_queued(), 1);
+      ASSERT_EQ(demand.backlog_size(), 2);
+    } else {
+      ASSERT_EQ(demand.shape().at("custom"), 2);
+      ASSERT_EQ(demand.num_infeasible_requests_queued(), 1);
+    }
+  }
+  ASSERT_EQ(queue.GetResourceLoadByShape(/*max_shapes=*/1).resource_demands_size(), 1);
+  auto load_without_backlog =
+      queue.GetResourceLoadByShape(/*max_shapes=*/-1, /*report_worker_backlog=*/false);
+  ASSERT_EQ(load_without_backlog.resource_demands(0).backlog_size(), 0);
+
+  // Removed tasks are not reported.
+  Task removed_task;
+  ASSERT_TRUE(queue.RemoveTask(GetTaskId(ready_tasks[0]), &removed_task));
+  ASSERT_EQ(GetTaskId(removed_task), GetTaskId(ready_tasks[0]));
+  ASSERT_TRUE(queue.RemoveTask(GetTaskId(infeasible_tasks[1]), &removed_task));
+  load = queue.GetResourceLoadByShape();
+  ASSERT_EQ(load.resource_demands_size(), 2);
+  ASSERT_EQ(load.resource_demands(0).num_ready_requests_queued(), 1);
+  ASSERT_EQ(load.resource_demands(0).backlog_size(), 0);
+  ASSERT_EQ(queue.GetTotalResourceLoad(), ResourceSet({"CPU", "GPU"}, {2, 1}));
+}
+
+/// Measure the time to build a heartbeat, and to move tasks between queues, as the
+/// number of queued tasks grows.
+TEST(SchedulingQueueTest, DISABLED_TestBacklogPerf) {
+  const int num_shapes = 10;
+  for (int num_tasks : {1000, 100000, 1000000}) {
+    SchedulingQueue queue;
+    std::vector<Task> tasks;
+    std::unordered_set<TaskID> task_ids;
+    for (int i = 0; i < num_tasks; i++) {
+      tasks.push_back(CreateTask({{"CPU", 1 + i % num_shapes}}, 1));
+      task_ids.insert(GetTaskId(tasks.back()));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    queue.QueueTasks(tasks, TaskState::WAITING);
+    queue.MoveTasks(task_ids, TaskState::WAITING, TaskState::READY);
+    auto queued = std::chrono::steady_clock::now();
+    const int num_heartbeats = 1000;
+    for (int i = 0; i < num_heartbeats; i++) {
+      auto load = queue.GetTotalResourceLoad();
+      auto load_by_shape = queue.GetResourceLoadByShape();
+      RAY_CHECK(load_by_shape.resource_demands_size() == num_shapes);
+    }
+    auto heartbeats = std::chrono::steady_clock::now();
+    RAY_LOG(INFO) << num_tasks << " tasks: queue and move "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(queued - start)
+                             .count() /
+                         num_tasks
+                  << "ns per task, heartbeat "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(heartbeats -
+                                                                           queued)
+                             .count() /
+                         static_cast<double>(num_heartbeats)
+                  << "us";
+  }
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
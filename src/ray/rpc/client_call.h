@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <grpcpp/generic/generic_stub.h>
 #include <grpcpp/grpcpp.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
 
 #include <boost/asio.hpp>
 
@@ -114,6 +116,71 @@ class ClientCallImpl : public ClientCall {
   friend class ClientCallManager;
 };
 
+/// Implementation of the `ClientCall` for a raw method, see `RawRequestHandler`. The
+/// request is sent as is, and the reply is parsed into a `Reply` message.
+///
+/// \tparam Reply Type of the Reply message.
+template <class Reply>
+class RawClientCallImpl : public ClientCall {
+ public:
+  /// Constructor.
+  ///
+  /// \param[in] callback The callback function to handle the reply.
+  explicit RawClientCallImpl(const ClientCallback<Reply> &callback)
+      : callback_(callback) {}
+
+  Status GetStatus() override {
+    absl::MutexLock lock(&mutex_);
+    return return_status_;
+  }
+
+  void SetReturnStatus() override {
+    absl::MutexLock lock(&mutex_);
+    return_status_ = GrpcStatusToRayStatus(status_);
+  }
+
+  void OnReplyReceived() override {
+    ray::Status status;
+    {
+      absl::MutexLock lock(&mutex_);
+      status = return_status_;
+    }
+    Reply reply;
+    if (status.ok() &&
+        !grpc::SerializationTraits<Reply>::Deserialize(&reply_buffer_, &reply).ok()) {
+      status = Status::IOError("Failed to parse the reply.");
+    }
+    if (callback_ != nullptr) {
+      callback_(status, reply);
+    }
+  }
+
+ private:
+  /// The reply bytes.
+  grpc::ByteBuffer reply_buffer_;
+
+  /// The callback function to handle the reply.
+  ClientCallback<Reply> callback_;
+
+  /// The response reader.
+  std::unique_ptr<grpc_impl::ClientAsyncResponseReader<grpc::ByteBuffer>>
+      response_reader_;
+
+  /// gRPC status of this request.
+  grpc::Status status_;
+
+  /// Mutex to protect the return_status_ field.
+  absl::Mutex mutex_;
+
+  /// This is the status to be returned from GetStatus(), see `ClientCallImpl`.
+  ray::Status return_status_ GUARDED_BY(mutex_);
+
+  /// Context for the client.
+  grpc::ClientContext context_;
+
+  friend class ClientCallManager;
+};
+
 /// This class wraps a `ClientCall`, and is used as the `tag` of gRPC's `CompletionQueue`.
 ///
 /// The lifecycle of a `ClientCallTag` is as follows.
@@ -221,6 +288,30 @@ class ClientCallManager {
     return call;
   }
 
+  /// Create a new `ClientCall` for a raw method and send the request as is.
+  ///
+  /// \tparam Reply Type of the reply message.
+  ///
+  /// \param[in] stub The generic stub of the channel.
+  /// \param[in] method The full name of the raw method, e.g. "/ray.rpc.FooService/Bar".
+  /// \param[in] request The request bytes.
+  /// \param[in] callback The callback function that handles reply.
+  ///
+  /// \return A `ClientCall` representing the request that was just sent.
+  template <class Reply>
+  std::shared_ptr<ClientCall> CreateRawCall(grpc::GenericStub &stub,
+                                            const std::string &method,
+                                            const grpc::ByteBuffer &request,
+                                            const ClientCallback<Reply> &callback) {
+    auto call = std::make_shared<RawClientCallImpl<Reply>>(callback);
+    call->response_reader_ = stub.PrepareUnaryCall(&call->context_, method, request,
+                                                   &cqs_[rr_index_++ % num_threads_]);
+    call->response_reader_->StartCall();
+    auto tag = new ClientCallTag(call);
+    call->response_reader_->Finish(&call->reply_buffer_, &call->status_, (void *)tag);
+    return call;
+  }
+
  private:
   /// This function runs in a background thread. It keeps polling events from the
   /// `CompletionQueue`, and dispatches the event to the callbacks via the `ClientCall`
@@ -54,6 +54,7 @@ class GrpcClient {
         grpc::CreateCustomChannel(address + ":" + std::to_string(port),
                                   grpc::InsecureChannelCredentials(), argument);
     stub_ = GrpcService::NewStub(channel);
+    generic_stub_.reset(new grpc::GenericStub(channel));
   }
 
   GrpcClient(const std::string &address, const int port, ClientCallManager &call_manager,
@@ -70,6 +71,7 @@ class GrpcClient {
         grpc::CreateCustomChannel(address + ":" + std::to_string(port),
                                   grpc::InsecureChannelCredentials(), argument);
     stub_ = GrpcService::NewStub(channel);
+    generic_stub_.reset(new grpc::GenericStub(channel));
   }
 
   /// Create a new `ClientCall` and send request.
@@ -92,10 +94,27 @@ class GrpcClient {
     RAY_CHECK(call != nullptr);
   }
 
+  /// Create a new `ClientCall` for a raw method and send the request as is.
+  ///
+  /// \tparam Reply Type of the reply message.
+  ///
+  /// \param[in] method The full name of the raw method.
+  /// \param[in] request The request bytes.
+  /// \param[in] callback The callback function that handles reply.
+  template <class Reply>
+  void CallRawMethod(const std::string &method, const grpc::ByteBuffer &request,
+                     const ClientCallback<Reply> &callback) {
+    auto call = client_call_manager_.CreateRawCall<Reply>(*generic_stub_, method,
+                                                          request, callback);
+    RAY_CHECK(call != nullptr);
+  }
+
  private:
   ClientCallManager &client_call_manager_;
   /// The gRPC-generated stub.
   std::unique_ptr<typename GrpcService::Stub> stub_;
+  /// The stub for the raw methods.
+  std::unique_ptr<grpc::GenericStub> generic_stub_;
 };
 
 }  // namespace rpc
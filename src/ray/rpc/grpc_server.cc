@@ -51,6 +51,9 @@ void GrpcServer::Run() {
     for (auto &entry : services_) {
       builder.RegisterService(&entry.get());
     }
+    if (!raw_methods_.empty()) {
+      builder.RegisterAsyncGenericService(&generic_service_);
+    }
     // Get hold of the completion queue used for the asynchronous communication
     // with the gRPC runtime.
     for (int i = 0; i < num_threads_; i++) {
@@ -73,6 +76,13 @@ void GrpcServer::Run() {
          "ray.init() to pick a specific port";
   RAY_LOG(INFO) << name_ << " server started, listening on port " << port_ << ".";
 
+  if (!raw_methods_.empty()) {
+    for (int i = 0; i < num_threads_; i++) {
+      server_call_factories_.emplace_back(
+          new RawServerCallFactory(generic_service_, raw_methods_, cqs_[i]));
+    }
+  }
+
   // Create calls for all the server call factories.
   for (auto &entry : server_call_factories_) {
     for (int i = 0; i < num_threads_; i++) {
@@ -98,6 +108,7 @@ void GrpcServer::RegisterService(GrpcService &service) {
   for (int i = 0; i < num_threads_; i++) {
     service.InitServerCallFactories(cqs_[i], &server_call_factories_);
   }
+  service.InitRawMethods(&raw_methods_);
 }
 
 void GrpcServer::PollEventsFromCompletionQueue(int index) {
@@ -50,7 +50,8 @@ class GrpcService;
 ///
 /// Subclasses can register one or multiple services to a `GrpcServer`, see
 /// `RegisterServices`. And they should also implement `InitServerCallFactories` to decide
-/// which kinds of requests this server should accept.
+/// which kinds of requests this server should accept. The raw methods of all the
+/// services, see `GrpcService::InitRawMethods`, are served by one `AsyncGenericService`.
 class GrpcServer {
  public:
   /// Construct a gRPC server that listens on a TCP port.
@@ -109,6 +110,10 @@ class GrpcServer {
   std::vector<std::reference_wrapper<grpc::Service>> services_;
   /// The `ServerCallFactory` objects.
   std::vector<std::unique_ptr<ServerCallFactory>> server_call_factories_;
+  /// The raw methods of the registered services.
+  RawMethods raw_methods_;
+  /// The service that serves the raw methods, if there are any.
+  grpc::AsyncGenericService generic_service_;
   /// The number of completion queues the server is polling from.
   int num_threads_;
   /// The `ServerCompletionQueue` object used for polling events.
@@ -151,6 +156,13 @@ class GrpcService {
       const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
       std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) = 0;
 
+  /// Subclasses can implement this method to add raw methods, whose requests and
+  /// replies are not protobuf messages, see `RawRequestHandler`. The name of a raw
+  /// method must not be the name of a method of the gRPC-generated service.
+  ///
+  /// \param[out] raw_methods The raw methods of the server.
+  virtual void InitRawMethods(RawMethods *raw_methods) {}
+
   /// The main event loop, to which the service handler functions will be posted.
   boost::asio::io_service &main_service_;
 
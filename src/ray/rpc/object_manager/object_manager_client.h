@@ -22,6 +22,7 @@
 
 #include "ray/common/status.h"
 #include "ray/rpc/grpc_client.h"
+#include "ray/rpc/object_manager/push_chunk.h"
 #include "ray/util/logging.h"
 #include "src/ray/protobuf/object_manager.grpc.pb.h"
 #include "src/ray/protobuf/object_manager.pb.h"
@@ -57,6 +58,17 @@ class ObjectManagerClient {
   VOID_RPC_CLIENT_METHOD(ObjectManagerService, Push,
                          grpc_clients_[push_rr_index_++ % num_connections_], )
 
+  /// Push an object chunk to remote object manager without copying it, see
+  /// `kPushChunkMethod`.
+  ///
+  /// \param request The request encoded by `EncodePushChunk`.
+  /// \param callback The callback function that handles reply from server
+  void PushChunk(const grpc::ByteBuffer &request,
+                 const ClientCallback<PushReply> &callback) {
+    grpc_clients_[push_rr_index_++ % num_connections_]->CallRawMethod<PushReply>(
+        kPushChunkMethod, request, callback);
+  }
+
   /// Pull object from remote object manager
   ///
   /// \param request The request message
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "ray/rpc/grpc_server.h"
+#include "ray/rpc/object_manager/push_chunk.h"
 #include "ray/rpc/server_call.h"
 #include "src/ray/protobuf/object_manager.grpc.pb.h"
 #include "src/ray/protobuf/object_manager.pb.h"
@@ -40,6 +41,13 @@ class ObjectManagerServiceHandler {
   /// \param[in] send_reply_callback The callback to be called when the request is done.
   virtual void HandlePush(const PushRequest &request, PushReply *reply,
                           SendReplyCallback send_reply_callback) = 0;
+  /// Handle a chunk pushed with `kPushChunkMethod`.
+  ///
+  /// \param[in] chunk The chunk. This is only valid during the call.
+  /// \param[out] reply The reply message.
+  /// \param[in] send_reply_callback The callback to be called when the request is done.
+  virtual void HandlePushChunk(const PushChunk &chunk, PushReply *reply,
+                               SendReplyCallback send_reply_callback) = 0;
   /// Handle a `Pull` request
   virtual void HandlePull(const PullRequest &request, PullReply *reply,
                           SendReplyCallback send_reply_callback) = 0;
@@ -69,6 +77,32 @@ class ObjectManagerGrpcService : public GrpcService {
     RAY_OBJECT_MANAGER_RPC_HANDLERS
   }
 
+  void InitRawMethods(RawMethods *raw_methods) override {
+    (*raw_methods)[kPushChunkMethod] = {
+        [this](const grpc::ByteBuffer &request, grpc::ByteBuffer *reply_buffer,
+               SendReplyCallback send_reply_callback) {
+          PushChunk chunk;
+          auto status = chunk.Parse(request);
+          if (!status.ok()) {
+            send_reply_callback(status, nullptr, nullptr);
+            return;
+          }
+          auto reply = std::make_shared<PushReply>();
+          service_handler_.HandlePushChunk(
+              chunk, reply.get(),
+              [reply, reply_buffer, send_reply_callback](
+                  Status status, std::function<void()> success,
+                  std::function<void()> failure) {
+                bool own_buffer;
+                RAY_CHECK(grpc::SerializationTraits<PushReply>::Serialize(
+                              *reply, reply_buffer, &own_buffer)
+                              .ok());
+                send_reply_callback(status, std::move(success), std::move(failure));
+              });
+        },
+        &main_service_};
+  }
+
  private:
   /// The grpc async service object.
   ObjectManagerService::AsyncService service_;
@@ -0,0 +1,154 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ray/common/status.h"
+#include "src/ray/protobuf/object_manager.pb.h"
+
+namespace ray {
+namespace rpc {
+
+/// The raw method that object chunks are pushed with, see `RawRequestHandler`.
+///
+/// A `Push` request holds the chunk in a protobuf string, so the sender copies the
+/// chunk out of plasma into the request and gRPC copies it again when serializing the
+/// request, and the receiver copies it into a string and then into plasma. Instead, the
+/// request of this method is the length of a `PushRequest` header as a 32-bit little
+/// endian integer, the header without data, and then the chunk. The sender hands the
+/// plasma memory of the chunk to gRPC, and the receiver copies the chunk from the
+/// buffers gRPC received it into straight into plasma.
+constexpr char kPushChunkMethod[] = "/ray.rpc.ObjectManagerService/PushChunk";
+
+/// Encode a pushed chunk into the request of `kPushChunkMethod`.
+///
+/// \param header The header of the chunk. Its data must be empty.
+/// \param data The chunk. This is referenced, not copied, so it must stay valid until
+/// `release` is called.
+/// \param size The size of the chunk in bytes.
+/// \param release Called once gRPC does not reference the chunk anymore. It may be
+/// called from any thread.
+/// \return The request.
+inline grpc::ByteBuffer EncodePushChunk(const PushRequest &header, const uint8_t *data,
+                                        size_t size, std::function<void()> release) {
+  std::string prefix(sizeof(uint32_t), '\0');
+  header.AppendToString(&prefix);
+  uint32_t header_size = static_cast<uint32_t>(prefix.size() - sizeof(uint32_t));
+  for (size_t i = 0; i < sizeof(uint32_t); i++) {
+    prefix[i] = static_cast<char>((header_size >> (8 * i)) & 0xff);
+  }
+  std::vector<grpc::Slice> slices;
+  slices.emplace_back(prefix);
+  if (size > 0) {
+    slices.emplace_back(
+        const_cast<uint8_t *>(data), size,
+        +[](void *user_data) {
+          auto release = static_cast<std::function<void()> *>(user_data);
+          (*release)();
+          delete release;
+        },
+        new std::function<void()>(std::move(release)));
+  } else {
+    release();
+  }
+  // This references the slices rather than copying them.
+  return grpc::ByteBuffer(slices.data(), slices.size());
+}
+
+/// A chunk decoded from the request of `kPushChunkMethod`. This references the buffers
+/// the request was received into, without copying the chunk.
+class PushChunk {
+ public:
+  /// Decode a request.
+  ///
+  /// \param request The request.
+  /// \return An error if the request is malformed.
+  Status Parse(const grpc::ByteBuffer &request) {
+    if (!request.Dump(&slices_).ok()) {
+      return Status::Invalid("Failed to read the pushed chunk.");
+    }
+    size_t total_size = 0;
+    for (const auto &slice : slices_) {
+      total_size += slice.size();
+    }
+    uint8_t prefix[sizeof(uint32_t)];
+    if (total_size < sizeof(prefix)) {
+      return Status::Invalid("Malformed pushed chunk.");
+    }
+    Copy(0, sizeof(prefix), prefix);
+    size_t header_size = 0;
+    for (size_t i = 0; i < sizeof(prefix); i++) {
+      header_size |= static_cast<size_t>(prefix[i]) << (8 * i);
+    }
+    data_offset_ = sizeof(prefix) + header_size;
+    if (total_size < data_offset_) {
+      return Status::Invalid("Malformed pushed chunk.");
+    }
+    std::string header(header_size, '\0');
+    Copy(sizeof(prefix), header_size, reinterpret_cast<uint8_t *>(&header[0]));
+    if (!header_.ParseFromString(header)) {
+      return Status::Invalid("Malformed pushed chunk header.");
+    }
+    data_size_ = total_size - data_offset_;
+    return Status::OK();
+  }
+
+  /// The header of the chunk.
+  const PushRequest &Header() const { return header_; }
+
+  /// The size of the chunk in bytes.
+  size_t DataSize() const { return data_size_; }
+
+  /// Copy the chunk.
+  ///
+  /// \param[out] out The chunk is copied here. This must hold `DataSize()` bytes.
+  void CopyData(uint8_t *out) const { Copy(data_offset_, data_size_, out); }
+
+ private:
+  /// Copy bytes of the request, which may span several slices.
+  void Copy(size_t offset, size_t size, uint8_t *out) const {
+    for (const auto &slice : slices_) {
+      if (size == 0) {
+        break;
+      }
+      if (offset >= slice.size()) {
+        offset -= slice.size();
+        continue;
+      }
+      size_t length = std::min(size, slice.size() - offset);
+      std::memcpy(out, slice.begin() + offset, length);
+      out += length;
+      size -= length;
+      offset = 0;
+    }
+  }
+
+  /// The slices of the request.
+  std::vector<grpc::Slice> slices_;
+  PushRequest header_;
+  /// The offset of the chunk in the request.
+  size_t data_offset_ = 0;
+  size_t data_size_ = 0;
+};
+
+}  // namespace rpc
+}  // namespace ray
@@ -14,9 +14,11 @@
 
 #pragma once
 
+#include <grpcpp/generic/async_generic_service.h>
 #include <grpcpp/grpcpp.h>
 
 #include <boost/asio.hpp>
+#include <unordered_map>
 
 #include "ray/common/grpc_util.h"
 #include "ray/common/status.h"
@@ -308,5 +310,177 @@ class ServerCallFactoryImpl : public ServerCallFactory {
   boost::asio::io_service &io_service_;
 };
 
+/// Represents the signature of a handler of a raw method, whose request and reply are
+/// the bytes that gRPC receives and sends, rather than protobuf messages. This allows
+/// the handler to avoid copying large payloads.
+///
+/// \param request The bytes of the request.
+/// \param[out] reply The bytes of the reply, which must be set before
+/// `send_reply_callback` is called with an OK status.
+/// \param send_reply_callback The callback to be called when the request is done.
+using RawRequestHandler =
+    std::function<void(const grpc::ByteBuffer &request, grpc::ByteBuffer *reply,
+                       SendReplyCallback send_reply_callback)>;
+
+/// A raw method that a `GrpcService` handles.
+struct RawMethod {
+  /// The handler of the requests.
+  RawRequestHandler handler;
+  /// The event loop to which the handler is posted.
+  boost::asio::io_service *io_service;
+};
+
+/// The raw methods of a `GrpcServer`, keyed by the full name of the method, e.g.
+/// "/ray.rpc.FooService/Bar".
+using RawMethods = std::unordered_map<std::string, RawMethod>;
+
+/// Implementation of `ServerCall` for the raw methods, which are served by a gRPC
+/// `AsyncGenericService`.
+///
+/// Unlike `ServerCallImpl`, gRPC does not read the request before the call is accepted.
+/// So the call goes through the PENDING state twice: once to accept the call, and once
+/// to read the request. `HandleRequest` is invoked after each of them.
+class RawServerCall : public ServerCall {
+ public:
+  /// Constructor.
+  ///
+  /// \param[in] factory The factory which created this call.
+  /// \param[in] raw_methods The raw methods of the server.
+  RawServerCall(const ServerCallFactory &factory, const RawMethods &raw_methods)
+      : state_(ServerCallState::PENDING),
+        factory_(factory),
+        raw_methods_(raw_methods),
+        stream_(&context_) {}
+
+  ServerCallState GetState() const override { return state_; }
+
+  void SetState(const ServerCallState &new_state) override { state_ = new_state; }
+
+  void HandleRequest() override {
+    if (!request_read_) {
+      // Create a new `ServerCall` to accept the next incoming call, and read the
+      // request of this one.
+      factory_.CreateCall();
+      request_read_ = true;
+      state_ = ServerCallState::PENDING;
+      stream_.Read(&request_, this);
+      return;
+    }
+    auto it = raw_methods_.find(context_.method());
+    if (it == raw_methods_.end()) {
+      SendReply(Status::NotImplemented("Unknown method " + context_.method()));
+      return;
+    }
+    method_ = &it->second;
+    if (!method_->io_service->stopped()) {
+      method_->io_service->post([this] { HandleRequestImpl(); });
+    } else {
+      RAY_LOG(DEBUG) << "Handle service has been closed.";
+      SendReply(Status::Invalid("HandleServiceClosed"));
+    }
+  }
+
+  void HandleRequestImpl() {
+    state_ = ServerCallState::PROCESSING;
+    method_->handler(request_, &reply_,
+                     [this](Status status, std::function<void()> success,
+                            std::function<void()> failure) {
+                       send_reply_success_callback_ = std::move(success);
+                       send_reply_failure_callback_ = std::move(failure);
+                       SendReply(status);
+                     });
+  }
+
+  void OnReplySent() override {
+    if (send_reply_success_callback_ && !method_->io_service->stopped()) {
+      auto callback = std::move(send_reply_success_callback_);
+      method_->io_service->post([callback]() { callback(); });
+    }
+  }
+
+  void OnReplyFailed() override {
+    if (send_reply_failure_callback_ && !method_->io_service->stopped()) {
+      auto callback = std::move(send_reply_failure_callback_);
+      method_->io_service->post([callback]() { callback(); });
+    }
+  }
+
+ private:
+  /// Tell gRPC to finish this request and send reply asynchronously.
+  void SendReply(const Status &status) {
+    state_ = ServerCallState::SENDING_REPLY;
+    if (status.ok()) {
+      stream_.WriteAndFinish(reply_, grpc::WriteOptions(), grpc::Status::OK, this);
+    } else {
+      stream_.Finish(RayStatusToGrpcStatus(status), this);
+    }
+  }
+
+  /// State of this call.
+  ServerCallState state_;
+
+  /// The factory which created this call.
+  const ServerCallFactory &factory_;
+
+  /// The raw methods of the server.
+  const RawMethods &raw_methods_;
+
+  /// The method of this call, once the request is read.
+  const RawMethod *method_ = nullptr;
+
+  /// Whether the request was read, or is being read.
+  bool request_read_ = false;
+
+  /// Context for the request, which also holds the name of the method.
+  grpc::GenericServerContext context_;
+
+  /// The stream the request is read from and the reply is written to.
+  grpc::GenericServerAsyncReaderWriter stream_;
+
+  /// The request bytes.
+  grpc::ByteBuffer request_;
+
+  /// The reply bytes.
+  grpc::ByteBuffer reply_;
+
+  /// The callback when sending reply successes.
+  std::function<void()> send_reply_success_callback_ = nullptr;
+
+  /// The callback when sending reply fails.
+  std::function<void()> send_reply_failure_callback_ = nullptr;
+
+  friend class RawServerCallFactory;
+};
+
+/// Implementation of `ServerCallFactory` for the raw methods.
+class RawServerCallFactory : public ServerCallFactory {
+ public:
+  /// Constructor.
+  ///
+  /// \param[in] service The gRPC `AsyncGenericService`.
+  /// \param[in] raw_methods The raw methods of the server.
+  /// \param[in] cq The `CompletionQueue`.
+  RawServerCallFactory(grpc::AsyncGenericService &service, const RawMethods &raw_methods,
+                       const std::unique_ptr<grpc::ServerCompletionQueue> &cq)
+      : service_(service), raw_methods_(raw_methods), cq_(cq) {}
+
+  void CreateCall() const override {
+    // Create a new `ServerCall`. This object will eventually be deleted by
+    // `GrpcServer::PollEventsFromCompletionQueue`.
+    auto call = new RawServerCall(*this, raw_methods_);
+    service_.RequestCall(&call->context_, &call->stream_, cq_.get(), cq_.get(), call);
+  }
+
+ private:
+  /// The gRPC `AsyncGenericService`.
+  grpc::AsyncGenericService &service_;
+
+  /// The raw methods of the server.
+  const RawMethods &raw_methods_;
+
+  /// The `CompletionQueue`.
+  const std::unique_ptr<grpc::ServerCompletionQueue> &cq_;
+};
+
 }  // namespace rpc
 }  // namespace ray
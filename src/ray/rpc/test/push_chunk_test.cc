@@ -0,0 +1,229 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/rpc/object_manager/push_chunk.h"
+
+#include <grpcpp/generic/generic_stub.h>
+
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/rpc/client_call.h"
+#include "ray/rpc/grpc_server.h"
+
+namespace ray {
+namespace rpc {
+
+PushRequest MakeHeader() {
+  PushRequest header;
+  header.set_push_id(std::string(20, 'p'));
+  header.set_object_id(std::string(28, 'o'));
+  header.set_chunk_index(7);
+  header.set_data_size(1 << 20);
+  return header;
+}
+
+/// Split a request into slices of at most `slice_size` bytes, like gRPC may receive
+/// it.
+grpc::ByteBuffer Resplit(const grpc::ByteBuffer &buffer, size_t slice_size) {
+  std::vector<grpc::Slice> slices;
+  RAY_CHECK(buffer.Dump(&slices).ok());
+  std::string bytes;
+  for (const auto &slice : slices) {
+    bytes.append(reinterpret_cast<const char *>(slice.begin()), slice.size());
+  }
+  std::vector<grpc::Slice> split;
+  for (size_t offset = 0; offset < bytes.size(); offset += slice_size) {
+    split.emplace_back(bytes.substr(offset, slice_size));
+  }
+  return grpc::ByteBuffer(split.data(), split.size());
+}
+
+/// Make a request out of raw bytes.
+grpc::ByteBuffer MakeBuffer(const std::string &bytes) {
+  grpc::Slice slice(bytes);
+  return grpc::ByteBuffer(&slice, 1);
+}
+
+TEST(PushChunkTest, TestRoundTrip) {
+  for (size_t size : {0, 1, 1 << 20}) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+      data[i] = static_cast<uint8_t>(i * 31);
+    }
+    bool released = false;
+    {
+      auto request = EncodePushChunk(MakeHeader(), data.data(), size,
+                                     [&released]() { released = true; });
+      // The chunk is referenced by the request until it is destroyed.
+      ASSERT_EQ(released, size == 0);
+      for (size_t slice_size : {size_t(0), size_t(1), size_t(5), size_t(4096)}) {
+        PushChunk chunk;
+        ASSERT_TRUE(
+            chunk.Parse(slice_size == 0 ? request : Resplit(request, slice_size)).ok());
+        ASSERT_EQ(chunk.Header().SerializeAsString(), MakeHeader().SerializeAsString());
+        ASSERT_EQ(chunk.DataSize(), size);
+        std::vector<uint8_t> out(size);
+        chunk.CopyData(out.data());
+        ASSERT_EQ(out, data);
+      }
+    }
+    ASSERT_TRUE(released);
+  }
+}
+
+TEST(PushChunkTest, TestMalformed) {
+  std::vector<uint8_t> data(100, 1);
+  auto request = EncodePushChunk(MakeHeader(), data.data(), data.size(), []() {});
+  std::vector<grpc::Slice> slices;
+  ASSERT_TRUE(request.Dump(&slices).ok());
+  std::string bytes;
+  for (const auto &slice : slices) {
+    bytes.append(reinterpret_cast<const char *>(slice.begin()), slice.size());
+  }
+  const size_t header_size = MakeHeader().ByteSizeLong();
+
+  PushChunk chunk;
+  // Shorter than the length of the header.
+  ASSERT_TRUE(chunk.Parse(MakeBuffer(bytes.substr(0, 3))).IsInvalid());
+  // Truncated in the header.
+  ASSERT_TRUE(chunk.Parse(MakeBuffer(bytes.substr(0, 4 + header_size - 1))).IsInvalid());
+  // A length that is larger than the request.
+  std::string too_long = bytes;
+  too_long[3] = '\x7f';
+  ASSERT_TRUE(chunk.Parse(MakeBuffer(too_long)).IsInvalid());
+  // A header that is not a protobuf message.
+  std::string garbage(4 + 11, '\xff');
+  garbage[0] = 11;
+  garbage[1] = garbage[2] = garbage[3] = 0;
+  ASSERT_TRUE(chunk.Parse(MakeBuffer(garbage)).IsInvalid());
+  // Truncated in the chunk, which only makes the chunk shorter.
+  ASSERT_TRUE(chunk.Parse(MakeBuffer(bytes.substr(0, bytes.size() - 10))).ok());
+  ASSERT_EQ(chunk.DataSize(), data.size() - 10);
+}
+
+/// A service that only has the raw PushChunk method.
+class PushChunkService : public GrpcService {
+ public:
+  explicit PushChunkService(boost::asio::io_service &io_service)
+      : GrpcService(io_service) {}
+
+  /// The chunks that were received.
+  std::vector<std::vector<uint8_t>> chunks;
+
+ protected:
+  grpc::Service &GetGrpcService() override { return service_; }
+
+  void InitServerCallFactories(
+      const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
+      std::vector<std::unique_ptr<ServerCallFactory>> *server_call_factories) override {}
+
+  void InitRawMethods(RawMethods *raw_methods) override {
+    (*raw_methods)[kPushChunkMethod] = {
+        [this](const grpc::ByteBuffer &request, grpc::ByteBuffer *reply,
+               SendReplyCallback send_reply_callback) {
+          PushChunk chunk;
+          auto status = chunk.Parse(request);
+          if (status.ok()) {
+            chunks.emplace_back(chunk.DataSize());
+            chunk.CopyData(chunks.back().data());
+            bool own_buffer;
+            RAY_CHECK(grpc::SerializationTraits<PushReply>::Serialize(
+                          PushReply(), reply, &own_buffer)
+                          .ok());
+          }
+          send_reply_callback(status, nullptr, nullptr);
+        },
+        &main_service_};
+  }
+
+ private:
+  grpc::Service service_;
+};
+
+class RawCallTest : public ::testing::Test {
+ public:
+  RawCallTest()
+      : work_(io_service_),
+        server_("push_chunk_test", 0),
+        service_(io_service_),
+        client_call_manager_(io_service_) {
+    io_thread_ = std::thread([this]() { io_service_.run(); });
+    server_.RegisterService(service_);
+    server_.Run();
+    channel_ = grpc::CreateChannel("127.0.0.1:" + std::to_string(server_.GetPort()),
+                                   grpc::InsecureChannelCredentials());
+    stub_.reset(new grpc::GenericStub(channel_));
+  }
+
+  ~RawCallTest() {
+    server_.Shutdown();
+    io_service_.stop();
+    io_thread_.join();
+  }
+
+  /// Send a raw request and wait for the status of the reply.
+  Status Call(const std::string &method, const grpc::ByteBuffer &request) {
+    std::promise<Status> status;
+    client_call_manager_.CreateRawCall<PushReply>(
+        *stub_, method, request,
+        [&status](const Status &reply_status, const PushReply &reply) {
+          status.set_value(reply_status);
+        });
+    return status.get_future().get();
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  boost::asio::io_service::work work_;
+  std::thread io_thread_;
+  GrpcServer server_;
+  PushChunkService service_;
+  ClientCallManager client_call_manager_;
+  std::shared_ptr<grpc::Channel> channel_;
+  std::unique_ptr<grpc::GenericStub> stub_;
+};
+
+TEST_F(RawCallTest, TestPushChunk) {
+  std::vector<uint8_t> data(1 << 20);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  ASSERT_TRUE(
+      Call(kPushChunkMethod,
+           EncodePushChunk(MakeHeader(), data.data(), data.size(), []() {}))
+          .ok());
+  ASSERT_EQ(service_.chunks.size(), 1);
+  ASSERT_EQ(service_.chunks[0], data);
+}
+
+TEST_F(RawCallTest, TestErrors) {
+  // A malformed request is answered with the error of the handler.
+  ASSERT_FALSE(Call(kPushChunkMethod, MakeBuffer("xy")).ok());
+  // A method that the server does not have.
+  ASSERT_FALSE(
+      Call("/ray.rpc.ObjectManagerService/NoSuchMethod", MakeBuffer("xy")).ok());
+  ASSERT_TRUE(service_.chunks.empty());
+  // The server still serves requests after the errors.
+  std::vector<uint8_t> data(10, 1);
+  ASSERT_TRUE(
+      Call(kPushChunkMethod,
+           EncodePushChunk(MakeHeader(), data.data(), data.size(), []() {}))
+          .ok());
+  ASSERT_EQ(service_.chunks.size(), 1);
+}
+
+}  // namespace rpc
+}  // namespace ray
@@ -175,6 +175,10 @@ class CoreWorkerClientInterface {
                                  const ClientCallback<WaitForRefRemovedReply> &callback) {
   }
 
+  virtual void WaitForRefsRemoved(
+      const WaitForRefsRemovedRequest &request,
+      const ClientCallback<WaitForRefsRemovedReply> &callback) {}
+
   virtual void SpillObjects(const SpillObjectsRequest &request,
                             const ClientCallback<SpillObjectsReply> &callback) {}
 
@@ -241,6 +245,8 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, WaitForRefRemoved, grpc_client_, override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, WaitForRefsRemoved, grpc_client_, override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, SpillObjects, grpc_client_, override)
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, RestoreSpilledObjects, grpc_client_, override)
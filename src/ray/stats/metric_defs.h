@@ -89,6 +89,16 @@ static Gauge ObjectManagerProfileEvents("object_manager_num_buffered_profile_eve
                                         "Number of locally-buffered profile events.",
                                         "events");
 
+static Gauge ObjectManagerReceiveThroughput(
+    "object_manager_receive_throughput",
+    "Average rate at which objects were recently received from other nodes.",
+    "bytes/s");
+
+static Gauge ObjectManagerChunksPerTransfer(
+    "object_manager_chunks_per_transfer",
+    "Average number of chunks of the objects recently received from other nodes.",
+    "chunks");
+
 static Gauge NumSubscribedTasks(
     "num_subscribed_tasks",
     "The number of tasks that are subscribed to object dependencies.", "tasks");